@@ -390,25 +390,26 @@ void BN_mod_word(
 	*r = tmp_r;
 }
 
+/*
+	Knuth's algorithm D with the divisor normalized so that the high bit
+	of its top word is set. Each quotient word is estimated from the top
+	two words of the remainder, corrected with the third one, and fixed
+	by adding the divisor back if it was still one too large.
+	x is at most BN_arr_size * 2 + 1 words.
+*/
 void BN_div(
 	BN_t* q,
 	BN_t* r,
 	BN_t* x, int x_digit_count_alloc,
 	BN_t* y, int y_digit_count_alloc)
 {
-	BN_t a_norm[BN_arr_size * 4];
-	BN_t b_norm[BN_arr_size * 4];
-	BN_t q_buf[BN_arr_size * 2];
-	BN_t r_buf[BN_arr_size * 2];
+	BN_t a_norm[BN_arr_size * 2 + 2];
+	BN_t b_norm[BN_arr_size * 2 + 1];
+	BN_t q_buf[BN_arr_size * 2 + 1];
+	BN_t r_buf[BN_arr_size * 2 + 1];
 
-	BN_init(a_norm, BN_arr_size * 4);
-	BN_init(b_norm, BN_arr_size * 4);
-
-	BN_init(q_buf, BN_arr_size * 2);
-	BN_init(r_buf, BN_arr_size * 2);
-
-	BN_copy(a_norm, x, x_digit_count_alloc);
-	BN_copy(b_norm, y, x_digit_count_alloc);
+	BN_init(q_buf, BN_arr_size * 2 + 1);
+	BN_init(r_buf, BN_arr_size * 2 + 1);
 
 	int a_ndig = _BN_get_ndigits(x, x_digit_count_alloc);
 	int b_ndig = _BN_get_ndigits(y, y_digit_count_alloc);
@@ -419,52 +420,79 @@ void BN_div(
 	BN_stmp_t carry = 0;
 	BN_stmp_t t;
 
-	int begin_cmp_res = BN_cmp(x, y, BN_arr_size);
-	if (begin_cmp_res == BN_CMP_EQUAL) {
-		q_buf[0] = 1;
+	if (b_ndig == 0) {
+		//NOTE(dima): Division by zero gives zero quotient and remainder
+	}
+	else if (a_ndig < b_ndig) {
+		BN_copy(r_buf, x, a_ndig);
 	}
 	else if (b_ndig == 1) {
+		BN_utmp_t rem = 0;
 
 		for (j = a_ndig - 1; j >= 0; j--) {
-			q_buf[j] = (BN_t)((carry * mod_bn + x[j]) / y[0]);
-			carry = (carry * mod_bn + x[j]) - q_buf[j] * y[0];
+			BN_utmp_t cur = rem * mod_bn + x[j];
+			q_buf[j] = (BN_t)(cur / y[0]);
+			rem = cur - (BN_utmp_t)q_buf[j] * y[0];
 		}
 
-		r_buf[0] = (BN_t)carry;
+		r_buf[0] = (BN_t)rem;
 	}
 	else {
+		int norm_val = 0;
+		BN_t top_word = y[b_ndig - 1];
+		while (!(top_word & BN_HIGH_BIT_SET)) {
+			top_word = (BN_t)(top_word << 1);
+			norm_val++;
+		}
+
+		if (norm_val) {
+			a_norm[a_ndig] = (BN_t)(x[a_ndig - 1] >> (BN_SZWORD_BITS - norm_val));
+			for (i = a_ndig - 1; i > 0; i--) {
+				a_norm[i] = (BN_t)((x[i] << norm_val) | (x[i - 1] >> (BN_SZWORD_BITS - norm_val)));
+			}
+			a_norm[0] = (BN_t)(x[0] << norm_val);
+
+			for (i = b_ndig - 1; i > 0; i--) {
+				b_norm[i] = (BN_t)((y[i] << norm_val) | (y[i - 1] >> (BN_SZWORD_BITS - norm_val)));
+			}
+			b_norm[0] = (BN_t)(y[0] << norm_val);
+		}
+		else {
+			BN_copy(a_norm, x, a_ndig);
+			a_norm[a_ndig] = 0;
+			BN_copy(b_norm, y, b_ndig);
+		}
+
+		BN_utmp_t b_top = b_norm[b_ndig - 1];
+		BN_utmp_t b_next = b_norm[b_ndig - 2];
+
 		for (j = a_ndig - b_ndig; j >= 0; j--) {
-			BN_utmp_t c_pred, r_pred;
-			BN_utmp_t asd =
-				((BN_utmp_t)a_norm[j + b_ndig] * mod_bn) +
+			BN_utmp_t top =
+				((BN_utmp_t)a_norm[j + b_ndig] << BN_SZWORD_BITS) |
 				(BN_utmp_t)a_norm[j + b_ndig - 1];
 
-			c_pred = asd / b_norm[b_ndig - 1];
-			r_pred = asd - c_pred * b_norm[b_ndig - 1];
-
-			do {
-				p = 0;
-				if (
-					(c_pred >= mod_bn) ||
-					((c_pred * (BN_utmp_t)b_norm[b_ndig - 2]) > (mod_bn * r_pred + (BN_utmp_t)a_norm[j + b_ndig - 2])))
-				{
-					c_pred--;
-					r_pred += b_norm[b_ndig - 1];
-					if (r_pred < mod_bn) {
-						p = 1;
-					}
+			BN_utmp_t c_pred = top / b_top;
+			BN_utmp_t r_pred = top - c_pred * b_top;
+
+			while (c_pred >= mod_bn ||
+				c_pred * b_next > ((r_pred << BN_SZWORD_BITS) | a_norm[j + b_ndig - 2]))
+			{
+				c_pred--;
+				r_pred += b_top;
+				if (r_pred >= mod_bn) {
+					break;
 				}
-			} while (p);
+			}
 
 			carry = 0;
 			for (i = 0; i < b_ndig; i++) {
 				p = c_pred * b_norm[i];
-				t = a_norm[i + j] - carry - (p & BN_MAX_VAL);
+				t = (BN_stmp_t)a_norm[i + j] - carry - (BN_stmp_t)(p & BN_MAX_VAL);
 				a_norm[i + j] = (BN_t)t;
-				carry = (p >> BN_SZWORD_BITS) - (t >> BN_SZWORD_BITS);
+				carry = (BN_stmp_t)(p >> BN_SZWORD_BITS) - (t >> BN_SZWORD_BITS);
 			}
 
-			t = a_norm[j + b_ndig] - carry;
+			t = (BN_stmp_t)a_norm[j + b_ndig] - carry;
 			a_norm[j + b_ndig] = (BN_t)t;
 			q_buf[j] = (BN_t)c_pred;
 
@@ -472,7 +500,7 @@ void BN_div(
 				q_buf[j]--;
 				carry = 0;
 				for (i = 0; i < b_ndig; i++) {
-					t = a_norm[i + j] + b_norm[i] + carry;
+					t = (BN_stmp_t)a_norm[i + j] + b_norm[i] + carry;
 					a_norm[i + j] = (BN_t)t;
 					carry = t >> BN_SZWORD_BITS;
 				}
@@ -480,11 +508,10 @@ void BN_div(
 			}
 		}
 
-		if (begin_cmp_res == BN_CMP_SMALLER) {
-			int asdfg = 1;
+		for (i = 0; i < b_ndig - 1; i++) {
+			r_buf[i] = (BN_t)((a_norm[i] >> norm_val) | (a_norm[i + 1] << (BN_SZWORD_BITS - norm_val)));
 		}
-
-		BN_copy(r_buf, a_norm, BN_arr_size);
+		r_buf[b_ndig - 1] = (BN_t)(a_norm[b_ndig - 1] >> norm_val);
 	}
 
 	if (q) {
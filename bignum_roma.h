@@ -1,6 +1,9 @@
 #ifndef BN_H_INCLUDED
 #define BN_H_INCLUDED
 
+#include <stdint.h>
+#include <stddef.h>
+
 #define BN_SZWORD 1
 #define BN_arr_size 32
 
@@ -82,7 +85,6 @@ extern "C" {
 	void EC_load_stb128(EC_curve* crv);
 	void EC_pt_mul( EC_point* p_result, EC_point *p_point, BN_t *p_scalar, EC_curve* crv);
 	void EC_pt_mul_jacobian( EC_point* r, EC_point* p, BN_t* s, EC_curve* crv);
-	void EC_pt_mul_monty( EC_point* p_result, EC_point *p_point, BN_t *p_scalar, EC_curve* crv);
 
 
 	void EC_pt_add(EC_point* r, EC_point* a, EC_point* b, EC_curve* crv);
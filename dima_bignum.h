@@ -55,7 +55,6 @@
 
 #include <stdint.h>
 #include <stdbool.h>
-#include <stdio.h>
 #include <assert.h>
 
 /* This macro defines the word size in bytes of the array that constitues the big-number data structure. */
@@ -66,6 +65,23 @@
 /* Size of big-numbers in bytes */
 #define DBN_SZARR    (512 / DBN_SZWORD)
 
+/* Operands shorter than this count of words are multiplied by schoolbook method in Karatsuba */
+#ifndef DBN_KARATSUBA_CUTOFF
+#define DBN_KARATSUBA_CUTOFF 32
+#endif
+
+#ifndef DBN_KARATSUBA_SQR_CUTOFF
+#define DBN_KARATSUBA_SQR_CUTOFF 48
+#endif
+
+/* Largest window of bignum_pow() and bignum_pow_mod(), the table of odd powers takes 2 ^ (DBN_POW_WINDOW_MAX - 1) numbers on the stack */
+#ifndef DBN_POW_WINDOW_MAX
+#define DBN_POW_WINDOW_MAX 6
+#endif
+
+/* Count of DBN_T words of the scratch buffer for bignum_mul_karatsuba() and bignum_sqr_karatsuba() */
+#define DBN_KARATSUBA_SCRATCH_LEN (6 * DBN_SZARR + 256)
+
 
 /* Here comes the compile-time specialization for how large the underlying array size should be. */
 /* The choices are 1, 2 and 4 bytes in size with uint32, uint64 for DBN_SZWORD==4, as temporary. */
@@ -75,30 +91,23 @@
   /* Data type of array in structure */
 #define DBN_T                    uint8_t
 /* bitmask for getting MSB */
-#define DBN_T_MSB                ((DBN_T_TMP)(0x80))
+#define DBN_T_MSB                ((DBN_T_UTMP)(0x80))
 /* Data-type larger than DBN_T, for holding intermediate results of calculations */
 #define DBN_T_UTMP                uint32_t
 #define DBN_T_STMP                int32_t
-/* sprintf format string */
-#define SPRINTF_FORMAT_STR       "%.02x"
-#define SSCANF_FORMAT_STR        "%2hhx"
 /* Max value of integer type */
-#define DBN_MAX_VAL                  ((DBN_T_TMP)0xFF)
+#define DBN_MAX_VAL                  ((DBN_T_UTMP)0xFF)
 #elif (DBN_SZWORD == 2)
 #define DBN_T                    uint16_t
 #define DBN_T_STMP               int32_t
 #define DBN_T_UTMP               uint32_t
-#define DBN_T_MSB                ((DBN_T_TMP)(0x8000))
-#define SPRINTF_FORMAT_STR       "%.04x"
-#define SSCANF_FORMAT_STR        "%4hx"
-#define DBN_MAX_VAL                  ((DBN_T_TMP)0xFFFF)
+#define DBN_T_MSB                ((DBN_T_UTMP)(0x8000))
+#define DBN_MAX_VAL                  ((DBN_T_UTMP)0xFFFF)
 #elif (DBN_SZWORD == 4)
 #define DBN_T                    uint32_t
 #define DBN_T_STMP               int64_t
 #define DBN_T_UTMP               uint64_t
-#define DBN_T_MSB                ((DBN_T_TMP)(0x80000000))
-#define SPRINTF_FORMAT_STR       "%.08x"
-#define SSCANF_FORMAT_STR        "%8x"
+#define DBN_T_MSB                ((DBN_T_UTMP)(0x80000000))
 #define DBN_MAX_VAL                  ((DBN_T_UTMP)0xFFFFFFFF)
 #endif
 #ifndef DBN_T
@@ -114,6 +123,9 @@
 /*Custom macro for getting the biggest number from two numbers*/
 #define DIMA_BIGNUM_MAX(a, b) (((a) > (b)) ? (a) : (b))
 
+/*Custom macro for getting the smallest number from two numbers*/
+#define DIMA_BIGNUM_MIN(a, b) (((a) < (b)) ? (a) : (b))
+
 /* Data-holding structure: array of DBN_Ts */
 struct bn
 {
@@ -145,9 +157,18 @@ extern "C" {
 	DIMA_BIGNUM_DEF void bignum_from_int(struct bn* n, DBN_T_STMP i);
 	DIMA_BIGNUM_DEF int  bignum_to_int(struct bn* n);
 	DIMA_BIGNUM_DEF void bignum_from_string(struct bn* n, char* str, int nbytes);
-	DIMA_BIGNUM_DEF void bignum_to_string(struct bn* n, char* str, int maxsize);
+	DIMA_BIGNUM_DEF void bignum_to_string(struct bn* n, char* str, int maxsize);       /* Hex digits as bignum_to_hex(), "" if they do not fit */
 	DIMA_BIGNUM_DEF void bignum_from_data(struct bn* n, void* data, int datasizeinbytes);
 	DIMA_BIGNUM_DEF void bignum_to_data(struct bn* n, void* data, int maxsize);
+
+	/* Hex import and export. Digits are most significant first, no prefix, any case on input, lowercase on output. Zero is the empty string */
+	DIMA_BIGNUM_DEF int  bignum_hex_size(struct bn* n);                                 /* Count of hex digits of n without leading zeros */
+	DIMA_BIGNUM_DEF int  bignum_from_hex(struct bn* n, const char* str, int nchars);    /* Returns 1, or 0 (and n = 0) on a bad digit or a number that does not fit */
+	DIMA_BIGNUM_DEF int  bignum_to_hex(struct bn* n, char* str, int maxsize);           /* Zero-terminated, returns count of digits, or -1 (and "" if maxsize > 0) if maxsize <= bignum_hex_size(n) */
+
+	/* Big-endian byte import and export (keys, signatures). bignum_to_bytes_be() left-pads with zeros to nbytes */
+	DIMA_BIGNUM_DEF void bignum_from_bytes_be(struct bn* n, const void* data, int nbytes);
+	DIMA_BIGNUM_DEF void bignum_to_bytes_be(struct bn* n, void* data, int nbytes);
 	DIMA_BIGNUM_DEF void bignum_copy(struct bn* dst, struct bn* src);        /* Copy src into dst -- dst := src */
 	DIMA_BIGNUM_DEF void bignum_set_sign(struct bn* dst, int32_t sign);
 
@@ -158,6 +179,10 @@ extern "C" {
 	DIMA_BIGNUM_DEF void bignum_div(struct bn* a, struct bn* b, struct bn* c); /* c = a / b */
 	DIMA_BIGNUM_DEF void bignum_mod(struct bn* a, struct bn* b, struct bn* c); /* c = a % b */
 
+	/* c = a * b and c = a ^ 2. scratch is array of DBN_KARATSUBA_SCRATCH_LEN words */
+	DIMA_BIGNUM_DEF void bignum_mul_karatsuba(struct bn* a, struct bn* b, struct bn* c, DBN_T* scratch);
+	DIMA_BIGNUM_DEF void bignum_sqr_karatsuba(struct bn* a, struct bn* c, DBN_T* scratch);
+
 	/* Bitwise operations: */
 	DIMA_BIGNUM_DEF void bignum_and(struct bn* a, struct bn* b, struct bn* c); /* c = a & b */
 	DIMA_BIGNUM_DEF void bignum_or(struct bn* a, struct bn* b, struct bn* c);  /* c = a | b */
@@ -171,6 +196,7 @@ extern "C" {
 	DIMA_BIGNUM_DEF void bignum_inc(struct bn* n);                             /* Increment: add one to n */
 	DIMA_BIGNUM_DEF void bignum_dec(struct bn* n);                             /* Decrement: subtract one from n */
 	DIMA_BIGNUM_DEF void bignum_pow(struct bn* a, struct bn* b, struct bn* c); /* Calculate a^b -- e.g. 2^10 => 1024 */
+	DIMA_BIGNUM_DEF void bignum_pow_mod(struct bn* a, struct bn* b, struct bn* m, struct bn* c); /* c = (a ^ b) % m, sliding window, Montgomery for odd m */
 
 	DIMA_BIGNUM_DEF void bignum_mul_pow2(struct bn* a, int32_t k, struct bn* c); /* Calculate c=a*(2^k) */
 
@@ -374,29 +400,170 @@ int bignum_to_int(struct bn* n)
 }
 
 
-void bignum_from_string(struct bn* n, char* str, int nbytes)
+/*
+	Hex conversion is table driven: one lookup per input digit and one
+	per output byte, no sscanf()/sprintf() (they are slow and depend on
+	the locale). Values of the table are 0..15 for digits and 0xFF for
+	anything else, so OR of all looked up values tells if the string was
+	valid without a branch per digit.
+*/
+static const uint8_t _bn_hex_values[256] = {
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF
+};
+
+/* Two lowercase digits of every byte value */
+static const char _bn_hex_pairs[513] =
+	"000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f"
+	"202122232425262728292a2b2c2d2e2f303132333435363738393a3b3c3d3e3f"
+	"404142434445464748494a4b4c4d4e4f505152535455565758595a5b5c5d5e5f"
+	"606162636465666768696a6b6c6d6e6f707172737475767778797a7b7c7d7e7f"
+	"808182838485868788898a8b8c8d8e8f909192939495969798999a9b9c9d9e9f"
+	"a0a1a2a3a4a5a6a7a8a9aaabacadaeafb0b1b2b3b4b5b6b7b8b9babbbcbdbebf"
+	"c0c1c2c3c4c5c6c7c8c9cacbcccdcecfd0d1d2d3d4d5d6d7d8d9dadbdcdddedf"
+	"e0e1e2e3e4e5e6e7e8e9eaebecedeeeff0f1f2f3f4f5f6f7f8f9fafbfcfdfeff";
+
+
+int bignum_hex_size(struct bn* n)
 {
 	require(n, "n is null");
-	require(str, "str is null");
-	require(nbytes > 0, "nbytes must be positive");
-	require((nbytes & 1) == 0, "string format must be in hex -> equal number of bytes");
+
+	int nwords = _get_szbytes(n);
+	if (nwords == 0) {
+		return(0);
+	}
+
+	DBN_T_UTMP top = n->array[nwords - 1];
+	int ndigits = 0;
+	while (top) {
+		ndigits++;
+		top >>= 4;
+	}
+
+	return((nwords - 1) * 2 * DBN_SZWORD + ndigits);
+}
+
+
+int bignum_from_hex(struct bn* n, const char* str, int nchars)
+{
+	require(n, "n is null");
+	require((str || (nchars == 0)), "str is null");
+	require(nchars >= 0, "nchars must not be negative");
 
 	bignum_init(n);
 
-	DBN_T tmp;                        /* DBN_T is defined in bn.h - uint{8,16,32,64}_t */
-	int i = nbytes - (2 * DBN_SZWORD); /* index into string */
-	int j = 0;                        /* index into array */
+	/* Leading zeros do not count against the capacity */
+	while ((nchars > 0) && (*str == '0')) {
+		str++;
+		nchars--;
+	}
 
-	/* reading last hex-byte "MSB" from string first -> big endian */
-	/* MSB ~= most significant byte / block ? :) */
-	while (i >= 0)
+	if (nchars > 2 * DBN_SZWORD * DBN_SZARR) {
+		return(0);
+	}
+
+	const uint8_t* at = (const uint8_t*)str + nchars; /* reading least significant digits first */
+	unsigned bad = 0;
+	int j = 0;
+
+	while (nchars > 0)
 	{
-		tmp = 0;
-		sscanf(&str[i], SSCANF_FORMAT_STR, &tmp);
-		n->array[j] = tmp;
-		i -= (2 * DBN_SZWORD); /* step DBN_SZWORD hex-byte(s) back in the string. */
-		j += 1;               /* step one element forward in the array. */
+		int count = DIMA_BIGNUM_MIN(nchars, 2 * DBN_SZWORD);
+		const uint8_t* from = at - count;
+
+		DBN_T_UTMP w = 0;
+		for (int i = 0; i < count; i++) {
+			unsigned v = _bn_hex_values[from[i]];
+			bad |= v;
+			w = (w << 4) | (v & 0xF);
+		}
+
+		n->array[j++] = (DBN_T)w;
+		at = from;
+		nchars -= count;
 	}
+
+	if (bad & 0xF0) {
+		bignum_init(n);
+		return(0);
+	}
+
+	return(1);
+}
+
+
+int bignum_to_hex(struct bn* n, char* str, int maxsize)
+{
+	require(n, "n is null");
+	require(str, "str is null");
+
+	/* Checked in release builds too: maxsize comes from the caller */
+	int ndigits = bignum_hex_size(n);
+	if (ndigits >= maxsize) {
+		if (maxsize > 0) {
+			str[0] = 0;
+		}
+		return(-1);
+	}
+
+	char* to = str;
+	int j = (ndigits + 2 * DBN_SZWORD - 1) / (2 * DBN_SZWORD) - 1; /* most significant nonzero word */
+
+	if (j >= 0) {
+		/* Top word: only its significant digits, odd one first */
+		DBN_T_UTMP w = n->array[j];
+		int count = ndigits - j * 2 * DBN_SZWORD;
+		if (count & 1) {
+			*to++ = _bn_hex_pairs[2 * ((w >> (4 * (count - 1))) & 0xF) + 1];
+			count--;
+		}
+		for (int shift = 4 * (count - 2); shift >= 0; shift -= 8) {
+			unsigned byte = (unsigned)(w >> shift) & 0xFF;
+			*to++ = _bn_hex_pairs[2 * byte];
+			*to++ = _bn_hex_pairs[2 * byte + 1];
+		}
+
+		/* Full words */
+		for (j = j - 1; j >= 0; j--) {
+			w = n->array[j];
+			for (int shift = 8 * (DBN_SZWORD - 1); shift >= 0; shift -= 8) {
+				unsigned byte = (unsigned)(w >> shift) & 0xFF;
+				*to++ = _bn_hex_pairs[2 * byte];
+				*to++ = _bn_hex_pairs[2 * byte + 1];
+			}
+		}
+	}
+
+	*to = 0;
+
+	return(ndigits);
+}
+
+
+void bignum_from_string(struct bn* n, char* str, int nbytes)
+{
+	require(n, "n is null");
+	require(str, "str is null");
+	require(nbytes > 0, "nbytes must be positive");
+	require((nbytes & 1) == 0, "string format must be in hex -> equal number of bytes");
+
+	int ok = bignum_from_hex(n, str, nbytes);
+	require(ok, "string is not a hex number that fits");
+	(void)ok;
 }
 
 
@@ -407,32 +574,68 @@ void bignum_to_string(struct bn* n, char* str, int nbytes)
 	require(nbytes > 0, "nbytes must be positive");
 	require((nbytes & 1) == 0, "string format must be in hex -> equal number of bytes");
 
-	int j = DBN_SZARR - 1; /* index into array - reading "MSB" first -> big-endian */
-	int i = 0;                 /* index into string representation. */
+	bignum_to_hex(n, str, nbytes);
+}
 
-	/* reading last array-element "MSB" first -> big endian */
-	while ((j >= 0) && (nbytes > (i + 1)))
-	{
-		sprintf(&str[i], SPRINTF_FORMAT_STR, n->array[j]);
-		i += (2 * DBN_SZWORD); /* step DBN_SZWORD hex-byte(s) forward in the string. */
-		j -= 1;               /* step one element back in the array. */
-	}
 
-	/* Count leading zeros: */
-	j = 0;
-	while (str[j] == '0')
+/*
+	Words are assembled from bytes with shifts, so this works the same on
+	any host endianness. bignum_from_data() and bignum_to_data() are the
+	plain copies of the native layout (little-endian words).
+*/
+void bignum_from_bytes_be(struct bn* n, const void* data, int nbytes)
+{
+	require(n, "n is null");
+	require((data || (nbytes == 0)), "data is null");
+	require((nbytes >= 0) && (nbytes <= DBN_SZARR * DBN_SZWORD), "nbytes does not fit into bignum");
+
+	bignum_init(n);
+
+	const uint8_t* at = (const uint8_t*)data + nbytes; /* least significant byte is the last one */
+	int j = 0;
+
+	while (nbytes > 0)
 	{
-		j += 1;
+		int count = DIMA_BIGNUM_MIN(nbytes, DBN_SZWORD);
+
+		DBN_T_UTMP w = 0;
+		for (int i = 0; i < count; i++) {
+			w |= (DBN_T_UTMP)at[-1 - i] << (8 * i);
+		}
+
+		n->array[j++] = (DBN_T)w;
+		at -= count;
+		nbytes -= count;
 	}
+}
+
+
+void bignum_to_bytes_be(struct bn* n, void* data, int nbytes)
+{
+	require(n, "n is null");
+	require((data || (nbytes == 0)), "data is null");
+	require((nbytes >= 0) && ((bignum_hex_size(n) + 1) / 2 <= nbytes), "nbytes is not big enough for the number");
 
-	/* Move string j places ahead, effectively skipping leading zeros */
-	for (i = 0; i < (nbytes - j); ++i)
+	uint8_t* to = (uint8_t*)data + nbytes; /* least significant byte goes last */
+	int j = 0;
+
+	while ((nbytes > 0) && (j < DBN_SZARR))
 	{
-		str[i] = str[i + j];
+		int count = DIMA_BIGNUM_MIN(nbytes, DBN_SZWORD);
+
+		DBN_T_UTMP w = n->array[j++];
+		for (int i = 0; i < count; i++) {
+			to[-1 - i] = (uint8_t)(w >> (8 * i));
+		}
+
+		to -= count;
+		nbytes -= count;
 	}
 
-	/* Zero-terminate string */
-	str[i] = 0;
+	/* Padding */
+	while (nbytes-- > 0) {
+		*--to = 0;
+	}
 }
 
 
@@ -638,67 +841,292 @@ void bignum_mul(struct bn* a, struct bn* b, struct bn* c)
 #endif
 }
 
-void bignum_mul_karatsuba(struct bn* a, struct bn* b, struct bn* res) {
-	/*
-		procedure karatsuba(num1, num2)
-			if (num1 < 10) or (num2 < 10)
-				return num1*num2
-			//calculates the size of the numbers
-			m = max(size_base10(num1), size_base10(num2))
-			m2 = m / 2
-			split the digit sequences about the middle
-			high1, low1 = split_at(num1, m2)
-			high2, low2 = split_at(num2, m2)
-			//3 calls made to numbers approximately half the size
-			z0 = karatsuba(low1, low2)
-			z1 = karatsuba((low1 + high1), (low2 + high2))
-			z2 = karatsuba(high1, high2)
-			return (z2 * 10 ^ (2 * m2)) + ((z1 - z2 - z0) * 10 ^ (m2)) + (z0)
-	*/
+/*
+	Word array helpers for Karatsuba. Words beyond the given
+	lengths of operands are treated as zeros.
+*/
+static DBN_T _words_add(DBN_T* r, DBN_T* a, int na, DBN_T* b, int nb, int n)
+{
+	DBN_T_UTMP tmp;
+	DBN_T carry = 0;
+	int i;
 
-	int a_szbytes = _get_szbytes(a);
-	int b_szbytes = _get_szbytes(b);
+	for (i = 0; i < n; ++i)
+	{
+		tmp = (DBN_T_UTMP)(i < na ? a[i] : 0) + (DBN_T_UTMP)(i < nb ? b[i] : 0) + carry;
+		r[i] = (DBN_T)tmp;
+		carry = (DBN_T)(tmp >> (DBN_SZWORD * 8));
+	}
+
+	return carry;
+}
+
+
+static DBN_T _words_sub(DBN_T* r, DBN_T* a, int na, DBN_T* b, int nb, int n)
+{
+	DBN_T_UTMP tmp;
+	DBN_T borrow = 0;
+	int i;
+
+	for (i = 0; i < n; ++i)
+	{
+		tmp = (DBN_T_UTMP)(i < na ? a[i] : 0) - (DBN_T_UTMP)(i < nb ? b[i] : 0) - borrow;
+		r[i] = (DBN_T)tmp;
+		borrow = (DBN_T)((tmp >> (DBN_SZWORD * 8)) & 1);
+	}
+
+	return borrow;
+}
+
+
+/* r = |a - b| in n words. Returns 1 if a < b */
+static int _words_abs_diff(DBN_T* r, DBN_T* a, int na, DBN_T* b, int nb, int n)
+{
+	int i;
+	for (i = n - 1; i >= 0; --i)
+	{
+		DBN_T ai = (i < na ? a[i] : 0);
+		DBN_T bi = (i < nb ? b[i] : 0);
+		if (ai != bi)
+		{
+			break;
+		}
+	}
+
+	int is_negative = (i >= 0) && ((i < na ? a[i] : 0) < (i < nb ? b[i] : 0));
+	if (is_negative)
+	{
+		_words_sub(r, b, nb, a, na, n);
+	}
+	else
+	{
+		_words_sub(r, a, na, b, nb, n);
+	}
+
+	return is_negative;
+}
+
+
+/* r[0, nr) += a[0, na), na <= nr */
+static void _words_add_to(DBN_T* r, int nr, DBN_T* a, int na)
+{
+	DBN_T carry = _words_add(r, r, nr, a, na, na);
+	int i;
+
+	for (i = na; (i < nr) && carry; ++i)
+	{
+		r[i] += 1;
+		carry = (r[i] == 0);
+	}
+}
+
+
+/* Schoolbook r = a * b, r has na + nb words */
+static void _words_mul(DBN_T* r, DBN_T* a, int na, DBN_T* b, int nb)
+{
+	DBN_T_UTMP tmp;
+	DBN_T_UTMP carry;
+	int i, j;
+
+	for (i = 0; i < na + nb; ++i)
+	{
+		r[i] = 0;
+	}
+
+	for (i = 0; i < na; ++i)
+	{
+		carry = 0;
+		for (j = 0; j < nb; ++j)
+		{
+			tmp = (DBN_T_UTMP)a[i] * (DBN_T_UTMP)b[j] + r[i + j] + carry;
+			r[i + j] = (DBN_T)tmp;
+			carry = tmp >> (DBN_SZWORD * 8);
+		}
+		r[i + nb] = (DBN_T)carry;
+	}
+}
+
+
+/* Schoolbook r = a ^ 2, r has 2 * n words. Cross products are computed once and doubled */
+static void _words_sqr(DBN_T* r, DBN_T* a, int n)
+{
+	DBN_T_UTMP tmp;
+	DBN_T_UTMP carry;
+	int i, j;
+
+	for (i = 0; i < 2 * n; ++i)
+	{
+		r[i] = 0;
+	}
+
+	for (i = 0; i < n; ++i)
+	{
+		carry = 0;
+		for (j = i + 1; j < n; ++j)
+		{
+			tmp = (DBN_T_UTMP)a[i] * (DBN_T_UTMP)a[j] + r[i + j] + carry;
+			r[i + j] = (DBN_T)tmp;
+			carry = tmp >> (DBN_SZWORD * 8);
+		}
+		r[i + n] = (DBN_T)carry;
+	}
+
+	for (i = 2 * n - 1; i > 0; --i)
+	{
+		r[i] = (DBN_T)((r[i] << 1) | (r[i - 1] >> ((DBN_SZWORD * 8) - 1)));
+	}
+	r[0] = (DBN_T)(r[0] << 1);
+
+	carry = 0;
+	for (i = 0; i < n; ++i)
+	{
+		tmp = (DBN_T_UTMP)a[i] * (DBN_T_UTMP)a[i] + r[2 * i] + carry;
+		r[2 * i] = (DBN_T)tmp;
+		tmp = (DBN_T_UTMP)r[2 * i + 1] + (tmp >> (DBN_SZWORD * 8));
+		r[2 * i + 1] = (DBN_T)tmp;
+		carry = tmp >> (DBN_SZWORD * 8);
+	}
+}
+
+
+/*
+	r = a * b for n-word operands, r has 2 * n words. With halves of h words
+	a = a1 * B ^ h + a0 the middle term is
+	a0 * b1 + a1 * b0 = a0 * b0 + a1 * b1 - (a0 - a1) * (b0 - b1),
+	which keeps all three products h words long with no carry word.
+	Needs 6 * h + 1 words of scratch per level of recursion.
+*/
+static void _words_mul_karatsuba(DBN_T* r, DBN_T* a, DBN_T* b, int n, DBN_T* scratch)
+{
+	if (n < DBN_KARATSUBA_CUTOFF)
+	{
+		_words_mul(r, a, n, b, n);
+		return;
+	}
+
+	int h = (n + 1) / 2;
+	int l = n - h;
+
+	DBN_T* da = scratch;
+	DBN_T* db = da + h;
+	DBN_T* zm = db + h;
+	DBN_T* t = zm + 2 * h;
+	DBN_T* next = t + 2 * h + 1;
+
+	int neg_a = _words_abs_diff(da, a, h, a + h, l, h);
+	int neg_b = _words_abs_diff(db, b, h, b + h, l, h);
+
+	_words_mul_karatsuba(r, a, b, h, next);
+	_words_mul_karatsuba(r + 2 * h, a + h, b + h, l, next);
+	_words_mul_karatsuba(zm, da, db, h, next);
+
+	/* t = z0 + z2 -/+ zm */
+	t[2 * h] = _words_add(t, r, 2 * h, r + 2 * h, 2 * l, 2 * h);
+	if (neg_a != neg_b)
+	{
+		_words_add(t, t, 2 * h + 1, zm, 2 * h, 2 * h + 1);
+	}
+	else
+	{
+		_words_sub(t, t, 2 * h + 1, zm, 2 * h, 2 * h + 1);
+	}
+
+	/* Top words of t are zero when they do not fit, as the product fits 2 * n words */
+	_words_add_to(r + h, 2 * n - h, t, DIMA_BIGNUM_MIN(2 * h + 1, 2 * n - h));
+}
+
+
+/* r = a ^ 2, the same as _words_mul_karatsuba() with (a0 - a1) ^ 2 as the middle product */
+static void _words_sqr_karatsuba(DBN_T* r, DBN_T* a, int n, DBN_T* scratch)
+{
+	if (n < DBN_KARATSUBA_SQR_CUTOFF)
+	{
+		_words_sqr(r, a, n);
+		return;
+	}
+
+	int h = (n + 1) / 2;
+	int l = n - h;
 
-	if ((a_szbytes <= 1) || 
-		(b_szbytes <= 1)) 
+	DBN_T* da = scratch;
+	DBN_T* zm = da + h;
+	DBN_T* t = zm + 2 * h;
+	DBN_T* next = t + 2 * h + 1;
+
+	_words_abs_diff(da, a, h, a + h, l, h);
+
+	_words_sqr_karatsuba(r, a, h, next);
+	_words_sqr_karatsuba(r + 2 * h, a + h, l, next);
+	_words_sqr_karatsuba(zm, da, h, next);
+
+	t[2 * h] = _words_add(t, r, 2 * h, r + 2 * h, 2 * l, 2 * h);
+	_words_sub(t, t, 2 * h + 1, zm, 2 * h, 2 * h + 1);
+
+	_words_add_to(r + h, 2 * n - h, t, DIMA_BIGNUM_MIN(2 * h + 1, 2 * n - h));
+}
+
+
+void bignum_mul_karatsuba(struct bn* a, struct bn* b, struct bn* c, DBN_T* scratch)
+{
+	require(a, "a is null");
+	require(b, "b is null");
+	require(c, "c is null");
+	require(scratch, "scratch is null");
+
+	DBN_T res[2 * DBN_SZARR];
+	int i;
+
+	int na = _get_szbytes(a);
+	int nb = _get_szbytes(b);
+	int n = DIMA_BIGNUM_MAX(na, nb);
+
+	for (i = 0; i < 2 * DBN_SZARR; ++i)
 	{
-		return bignum_mul(a, b, res);
+		res[i] = 0;
 	}
 
-	int32_t m = DIMA_BIGNUM_MAX(_get_szbytes(a), _get_szbytes(b));
-	int32_t m2 = m / 2;
+	/* Splitting unbalanced operands does not pay off, short one is padded with zeros otherwise */
+	if (DIMA_BIGNUM_MIN(na, nb) < DBN_KARATSUBA_CUTOFF)
+	{
+		_words_mul(res, a->array, na, b->array, nb);
+	}
+	else
+	{
+		_words_mul_karatsuba(res, a->array, b->array, n, scratch);
+	}
 
-	struct bn high1, low1;
-	struct bn high2, low2;
+	/* Product is truncated to DBN_SZARR words, as in bignum_mul() */
+	for (i = 0; i < DBN_SZARR; ++i)
+	{
+		c->array[i] = res[i];
+	}
+	c->sign = a->sign * b->sign;
+}
 
-	struct bn z0, z1, z2;
 
-	int32_t split_at = m2;
+void bignum_sqr_karatsuba(struct bn* a, struct bn* c, DBN_T* scratch)
+{
+	require(a, "a is null");
+	require(c, "c is null");
+	require(scratch, "scratch is null");
 
-	/*Splitting first number*/
-	bignum_from_data(&low1, (uint8_t*)a->array, split_at);
-	bignum_from_data(&high1, (uint8_t*)a->array + split_at, a_szbytes - split_at);
+	DBN_T res[2 * DBN_SZARR];
+	int i;
 
-	/*Splitting second number*/
-	bignum_from_data(&low2, (uint8_t*)b->array, split_at);
-	bignum_from_data(&high2, (uint8_t*)b->array + split_at, b_szbytes - split_at);
+	int n = _get_szbytes(a);
 
-	/*Use of z0 and z1 as a temp variables*/
-	bignum_add(&low1, &high1, &z0);
-	bignum_add(&low2, &high2, &z2);
-	bignum_mul_karatsuba(&z0, &z2, &z1);
-	
-	/*Reusing them for algo*/
-	bignum_mul_karatsuba(&low1, &low2, &z0);
-	bignum_mul_karatsuba(&high1, &high2, &z2);
-	
-	bignum_mul_pow2(&z2, 2 * m2 * (DBN_SZWORD << 3), &high1);
+	for (i = 0; i < 2 * DBN_SZARR; ++i)
+	{
+		res[i] = 0;
+	}
 
-	bignum_sub(&z1, &z2, &low1);
-	bignum_sub(&low1, &z0, &high2);
-	bignum_mul_pow2(&high2, m2 * (DBN_SZWORD << 3), &low1);
+	_words_sqr_karatsuba(res, a->array, n, scratch);
 
-	bignum_add(&high1, &low1, &high2);
+	for (i = 0; i < DBN_SZARR; ++i)
+	{
+		c->array[i] = res[i];
+	}
+	c->sign = 1;
 }
 
 void bignum_div(struct bn* a, struct bn* b, struct bn* c)
@@ -910,45 +1338,353 @@ int bignum_is_zero(struct bn* n)
 }
 
 
+/*
+	Montgomery arithmetic for bignum_pow_mod(). Modulus m is odd and n words
+	long, R = 2 ^ (n * DBN_SZWORD * 8). Numbers in Montgomery form are
+	n-word arrays a * R mod m, products are 2 * n words.
+*/
+struct _bn_mont
+{
+	DBN_T m[DBN_SZARR];
+	DBN_T m_inv; /* -(m ^ -1) mod 2 ^ (DBN_SZWORD * 8) */
+	int n;
+	DBN_T scratch[DBN_KARATSUBA_SCRATCH_LEN];
+};
+
+
+/* r = t / R mod m, t has 2 * n words and is destroyed, t < m * R */
+static void _bn_mont_reduce(DBN_T* r, DBN_T* t, struct _bn_mont* ctx)
+{
+	DBN_T_UTMP tmp;
+	DBN_T_UTMP carry;
+	DBN_T carry_hi = 0;
+	DBN_T q;
+	int n = ctx->n;
+	int i, j;
+
+	for (i = 0; i < n; ++i)
+	{
+		/* t += q * m * B ^ i makes i-th word zero */
+		q = (DBN_T)((DBN_T_UTMP)t[i] * ctx->m_inv);
+
+		carry = 0;
+		for (j = 0; j < n; ++j)
+		{
+			tmp = (DBN_T_UTMP)q * ctx->m[j] + t[i + j] + carry;
+			t[i + j] = (DBN_T)tmp;
+			carry = tmp >> (DBN_SZWORD * 8);
+		}
+
+		/* Carry of the row is added where the next row ends */
+		tmp = (DBN_T_UTMP)t[i + n] + carry + carry_hi;
+		t[i + n] = (DBN_T)tmp;
+		carry_hi = (DBN_T)(tmp >> (DBN_SZWORD * 8));
+	}
+
+	/* Result is less than 2 * m, one subtraction is enough */
+	if (_words_sub(r, t + n, n, ctx->m, n, n) && !carry_hi)
+	{
+		for (i = 0; i < n; ++i)
+		{
+			r[i] = t[n + i];
+		}
+	}
+}
+
+
+static void _bn_mont_mul(DBN_T* r, DBN_T* a, DBN_T* b, struct _bn_mont* ctx)
+{
+	DBN_T t[2 * DBN_SZARR];
+
+	_words_mul_karatsuba(t, a, b, ctx->n, ctx->scratch);
+	_bn_mont_reduce(r, t, ctx);
+}
+
+
+static void _bn_mont_sqr(DBN_T* r, DBN_T* a, struct _bn_mont* ctx)
+{
+	DBN_T t[2 * DBN_SZARR];
+
+	_words_sqr_karatsuba(t, a, ctx->n, ctx->scratch);
+	_bn_mont_reduce(r, t, ctx);
+}
+
+
+/* a = 2 * a mod m, a < m */
+static void _bn_mont_dbl(DBN_T* a, struct _bn_mont* ctx)
+{
+	DBN_T t[DBN_SZARR];
+	int n = ctx->n;
+	int i;
+
+	DBN_T carry = _words_add(a, a, n, a, n, n);
+	DBN_T borrow = _words_sub(t, a, n, ctx->m, n, n);
+
+	if (carry || !borrow)
+	{
+		for (i = 0; i < n; ++i)
+		{
+			a[i] = t[i];
+		}
+	}
+}
+
+
+/* rr = R ^ 2 mod m */
+static void _bn_mont_init(struct _bn_mont* ctx, struct bn* m, DBN_T* rr)
+{
+	DBN_T_UTMP inv;
+	int i;
+
+	ctx->n = _get_szbytes(m);
+	for (i = 0; i < DBN_SZARR; ++i)
+	{
+		ctx->m[i] = m->array[i];
+	}
+
+	/* Newton iteration doubles count of correct low bits of m[0] ^ -1 */
+	inv = m->array[0];
+	for (i = 0; i < 5; ++i)
+	{
+		inv = (inv * (2 - (DBN_T_UTMP)m->array[0] * inv)) & DBN_MAX_VAL;
+	}
+	ctx->m_inv = (DBN_T)(0 - inv);
+
+	/* R mod m and then R ^ 2 mod m by doublings, done only once */
+	for (i = 0; i < ctx->n; ++i)
+	{
+		rr[i] = 0;
+	}
+	rr[0] = 1;
+	for (i = 0; i < 2 * ctx->n * DBN_SZWORD * 8; ++i)
+	{
+		_bn_mont_dbl(rr, ctx);
+	}
+}
+
+
+/*
+	Sliding window exponentiation. Table keeps odd powers a, a ^ 3, ...,
+	a ^ (2 ^ w - 1), so every window of the exponent that starts and ends
+	with 1 costs one multiplication and zero bits cost only squarings.
+	mul gets ctx of the caller, c may be the same as a or b.
+*/
+typedef void _bn_pow_mul_type(struct bn* a, struct bn* b, struct bn* c, void* ctx);
+
+
+static int _bn_pow_window_bits(int e_nbits)
+{
+	int result = 1;
+
+	if (e_nbits > 671)
+	{
+		result = 6;
+	}
+	else if (e_nbits > 239)
+	{
+		result = 5;
+	}
+	else if (e_nbits > 79)
+	{
+		result = 4;
+	}
+	else if (e_nbits > 23)
+	{
+		result = 3;
+	}
+
+	return DIMA_BIGNUM_MIN(result, DBN_POW_WINDOW_MAX);
+}
+
+
+static inline int _bn_testbit(struct bn* a, int bitnum)
+{
+	return (a->array[bitnum / (DBN_SZWORD * 8)] >> (bitnum % (DBN_SZWORD * 8))) & 1;
+}
+
+
+static void _bn_pow_window(struct bn* a, struct bn* e, struct bn* one, struct bn* c, _bn_pow_mul_type* mul, void* ctx)
+{
+	struct bn table[1 << (DBN_POW_WINDOW_MAX - 1)];
+	struct bn a2;
+	struct bn acc;
+	int e_nbits = 0;
+	int started = 0;
+	int w, i, j, k;
+	int val;
+
+	for (i = _get_szbytes(e) * DBN_SZWORD * 8 - 1; i >= 0; --i)
+	{
+		if (_bn_testbit(e, i))
+		{
+			e_nbits = i + 1;
+			break;
+		}
+	}
+
+	if (e_nbits == 0)
+	{
+		bignum_copy(c, one);
+		return;
+	}
+
+	w = _bn_pow_window_bits(e_nbits);
+
+	/* Montgomery functions write only n words, the rest is kept zero */
+	for (i = 0; i < (1 << (w - 1)); ++i)
+	{
+		bignum_init(&table[i]);
+	}
+	bignum_init(&a2);
+	bignum_init(&acc);
+
+	bignum_copy(&table[0], a);
+	if (w > 1)
+	{
+		mul(a, a, &a2, ctx);
+		for (i = 1; i < (1 << (w - 1)); ++i)
+		{
+			mul(&table[i - 1], &a2, &table[i], ctx);
+		}
+	}
+
+	i = e_nbits - 1;
+	while (i >= 0)
+	{
+		if (!_bn_testbit(e, i))
+		{
+			mul(&acc, &acc, &acc, ctx);
+			--i;
+			continue;
+		}
+
+		/* Longest window [j, i] of at most w bits that ends with 1 */
+		j = DIMA_BIGNUM_MAX(i - w + 1, 0);
+		while (!_bn_testbit(e, j))
+		{
+			++j;
+		}
+
+		val = 0;
+		for (k = i; k >= j; --k)
+		{
+			val = (val << 1) | _bn_testbit(e, k);
+		}
+
+		if (started)
+		{
+			for (k = i; k >= j; --k)
+			{
+				mul(&acc, &acc, &acc, ctx);
+			}
+			mul(&acc, &table[val >> 1], &acc, ctx);
+		}
+		else
+		{
+			bignum_copy(&acc, &table[val >> 1]);
+			started = 1;
+		}
+
+		i = j - 1;
+	}
+
+	bignum_copy(c, &acc);
+}
+
+
+static void _bn_pow_mul_mont(struct bn* a, struct bn* b, struct bn* c, void* ctx)
+{
+	if (a == b)
+	{
+		_bn_mont_sqr(c->array, a->array, (struct _bn_mont*)ctx);
+	}
+	else
+	{
+		_bn_mont_mul(c->array, a->array, b->array, (struct _bn_mont*)ctx);
+	}
+}
+
+
+static void _bn_pow_mul_mod(struct bn* a, struct bn* b, struct bn* c, void* ctx)
+{
+	struct bn tmp;
+
+	bignum_mul(a, b, &tmp);
+	bignum_mod(&tmp, (struct bn*)ctx, c);
+}
+
+
+static void _bn_pow_mul(struct bn* a, struct bn* b, struct bn* c, void* ctx)
+{
+	struct bn tmp;
+	(void)ctx;
+
+	bignum_mul(a, b, &tmp);
+	bignum_copy(c, &tmp);
+}
+
+
 void bignum_pow(struct bn* a, struct bn* b, struct bn* c)
 {
 	require(a, "a is null");
 	require(b, "b is null");
 	require(c, "c is null");
 
-	struct bn tmp;
+	struct bn one;
+	bignum_from_uint(&one, 1);
+
+	_bn_pow_window(a, b, &one, c, _bn_pow_mul, 0);
+}
 
-	bignum_init(c);
 
-	if (bignum_cmp(b, c) == DIMA_BIGNUM_CMP_EQUAL)
+void bignum_pow_mod(struct bn* a, struct bn* b, struct bn* m, struct bn* c)
+{
+	require(a, "a is null");
+	require(b, "b is null");
+	require(m, "m is null");
+	require(c, "c is null");
+	require(!bignum_is_zero(m), "m is zero");
+
+	struct bn base;
+	struct bn one;
+
+	bignum_mod(a, m, &base);
+	base.sign = 1;
+
+	bignum_from_uint(&one, 1);
+	if (bignum_cmp(m, &one) != DIMA_BIGNUM_CMP_LARGER)
 	{
-		/* Return 1 when exponent is 0 -- n^0 = 1 */
-		bignum_inc(c);
+		bignum_init(c);
+		return;
 	}
-	else
-	{
-		/* Copy a -> tmp */
-		bignum_copy(&tmp, a);
 
-		bignum_dec(b);
+	if (m->array[0] & 1)
+	{
+		struct _bn_mont ctx;
+		struct bn rr;
 
-		/* Begin summing products: */
-		while (!bignum_is_zero(b))
-		{
+		bignum_init(&rr);
+		_bn_mont_init(&ctx, m, rr.array);
 
-			/* c = tmp * tmp */
-			bignum_mul(&tmp, a, c);
-			/* Decrement b by one */
-			bignum_dec(b);
+		/* to Montgomery form: x * R ^ 2 / R = x * R */
+		_bn_mont_mul(base.array, base.array, rr.array, &ctx);
+		_bn_mont_mul(one.array, one.array, rr.array, &ctx);
 
-			bignum_copy(&tmp, c);
-		}
+		_bn_pow_window(&base, b, &one, c, _bn_pow_mul_mont, &ctx);
 
-		/* c = tmp */
-		bignum_copy(c, &tmp);
+		/* from Montgomery form: x * 1 / R */
+		bignum_from_uint(&one, 1);
+		_bn_mont_mul(c->array, c->array, one.array, &ctx);
+		c->sign = 1;
+	}
+	else
+	{
+		/* Even moduli have no Montgomery form, products should fit DBN_SZARR words */
+		_bn_pow_window(&base, b, &one, c, _bn_pow_mul_mod, m);
 	}
 }
 
+
 void bignum_mul_pow2(struct bn* a, int32_t k, struct bn* c) 
 {
 	require(a, "a is null");
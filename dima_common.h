@@ -4,6 +4,26 @@
 #include <stdio.h>
 #include <stdint.h>
 #include <math.h>
+#include <float.h>
+
+/*
+	SIMD versions of the matrix functions: AVX and SSE on x86, NEON on
+	ARM64. Define DIMA_COMMON_NO_SIMD to use the plain versions. Every
+	path does the same multiplications and additions in the same order.
+*/
+#if !defined(DIMA_COMMON_NO_SIMD)
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 1))
+#define DIMA_COMMON_SSE
+#include <xmmintrin.h>
+#if defined(__AVX__)
+#define DIMA_COMMON_AVX
+#include <immintrin.h>
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define DIMA_COMMON_NEON
+#include <arm_neon.h>
+#endif
+#endif
 
 #ifndef INTERNAL_FUNCTION
 #define INTERNAL_FUNCTION static
@@ -144,9 +164,34 @@ inline float Sqrt(float Value) {
 	return(Result);
 }
 
+/*
+	NOTE(dima): Hardware estimate refined with one Newton-Raphson step
+	y = y * (1.5 - 0.5 * x * y * y). That is within a couple of ulps of
+	1 / sqrt(x). NEON estimate is only 8 bits so it takes two steps.
+	The step gives NaN for 0 and inf and wrong values for denormals, so
+	values outside of [FLT_MIN, FLT_MAX] (and NaN) go to 1 / sqrtf.
+*/
 inline float RSqrt(float Value) {
 	float Result;
+	if (!(Value >= FLT_MIN && Value <= FLT_MAX)) {
+		Result = 1.0f / sqrtf(Value);
+		return(Result);
+	}
+#if defined(DIMA_COMMON_SSE)
+	__m128 X = _mm_set_ss(Value);
+	__m128 Y = _mm_rsqrt_ss(X);
+	__m128 HalfXYY = _mm_mul_ss(_mm_mul_ss(_mm_set_ss(0.5f), X), _mm_mul_ss(Y, Y));
+	Y = _mm_mul_ss(Y, _mm_sub_ss(_mm_set_ss(1.5f), HalfXYY));
+	Result = _mm_cvtss_f32(Y);
+#elif defined(DIMA_COMMON_NEON)
+	float32x2_t X = vdup_n_f32(Value);
+	float32x2_t Y = vrsqrte_f32(X);
+	Y = vmul_f32(Y, vrsqrts_f32(vmul_f32(X, Y), Y));
+	Y = vmul_f32(Y, vrsqrts_f32(vmul_f32(X, Y), Y));
+	Result = vget_lane_f32(Y, 0);
+#else
 	Result = 1.0f / sqrtf(Value);
+#endif
 	return(Result);
 }
 
@@ -271,7 +316,7 @@ inline v3 Cross(v3 A, v3 B){
     R.x = A.y * B.z - B.y * A.z;
     R.y = A.z * B.x - B.z * A.x;
     R.z = A.x * B.y - B.x * A.y;
-    return(A);
+    return(R);
 }
 
 /*Add operation*/
@@ -474,8 +519,58 @@ inline v4 Lerp(v4 A, v4 B, float t){ return((1.0f - t) * A + B * t); }
 
 /*Matrix 4x4 functions and operators*/
 inline mat4 Multiply(mat4 M1, mat4 M2){
-	mat4 Result = {};
+	mat4 Result;
+
+#if defined(DIMA_COMMON_AVX)
+	/*NOTE(dima): Two rows of the result at once, rows of M2 are in both halves*/
+	__m256 B0 = _mm256_broadcast_ps((__m128*)&M2.Rows[0]);
+	__m256 B1 = _mm256_broadcast_ps((__m128*)&M2.Rows[1]);
+	__m256 B2 = _mm256_broadcast_ps((__m128*)&M2.Rows[2]);
+	__m256 B3 = _mm256_broadcast_ps((__m128*)&M2.Rows[3]);
+
+	for(int RowIndex = 0; RowIndex < 4; RowIndex += 2){
+		__m256 A = _mm256_loadu_ps(&M1.E[RowIndex * 4]);
+
+		__m256 R = _mm256_mul_ps(_mm256_shuffle_ps(A, A, 0x00), B0);
+		R = _mm256_add_ps(R, _mm256_mul_ps(_mm256_shuffle_ps(A, A, 0x55), B1));
+		R = _mm256_add_ps(R, _mm256_mul_ps(_mm256_shuffle_ps(A, A, 0xAA), B2));
+		R = _mm256_add_ps(R, _mm256_mul_ps(_mm256_shuffle_ps(A, A, 0xFF), B3));
+
+		_mm256_storeu_ps(&Result.E[RowIndex * 4], R);
+	}
+#elif defined(DIMA_COMMON_SSE)
+	__m128 B0 = _mm_loadu_ps(&M2.E[0]);
+	__m128 B1 = _mm_loadu_ps(&M2.E[4]);
+	__m128 B2 = _mm_loadu_ps(&M2.E[8]);
+	__m128 B3 = _mm_loadu_ps(&M2.E[12]);
+
+	for(int RowIndex = 0; RowIndex < 4; RowIndex++){
+		float* A = &M1.E[RowIndex * 4];
+
+		__m128 R = _mm_mul_ps(_mm_set1_ps(A[0]), B0);
+		R = _mm_add_ps(R, _mm_mul_ps(_mm_set1_ps(A[1]), B1));
+		R = _mm_add_ps(R, _mm_mul_ps(_mm_set1_ps(A[2]), B2));
+		R = _mm_add_ps(R, _mm_mul_ps(_mm_set1_ps(A[3]), B3));
+
+		_mm_storeu_ps(&Result.E[RowIndex * 4], R);
+	}
+#elif defined(DIMA_COMMON_NEON)
+	float32x4_t B0 = vld1q_f32(&M2.E[0]);
+	float32x4_t B1 = vld1q_f32(&M2.E[4]);
+	float32x4_t B2 = vld1q_f32(&M2.E[8]);
+	float32x4_t B3 = vld1q_f32(&M2.E[12]);
+
+	for(int RowIndex = 0; RowIndex < 4; RowIndex++){
+		float* A = &M1.E[RowIndex * 4];
 
+		float32x4_t R = vmulq_n_f32(B0, A[0]);
+		R = vaddq_f32(R, vmulq_n_f32(B1, A[1]));
+		R = vaddq_f32(R, vmulq_n_f32(B2, A[2]));
+		R = vaddq_f32(R, vmulq_n_f32(B3, A[3]));
+
+		vst1q_f32(&Result.E[RowIndex * 4], R);
+	}
+#else
 	Result.E[0] = M1.E[0] * M2.E[0] + M1.E[1] * M2.E[4] + M1.E[2] * M2.E[8] + M1.E[3] * M2.E[12];
 	Result.E[1] = M1.E[0] * M2.E[1] + M1.E[1] * M2.E[5] + M1.E[2] * M2.E[9] + M1.E[3] * M2.E[13];
 	Result.E[2] = M1.E[0] * M2.E[2] + M1.E[1] * M2.E[6] + M1.E[2] * M2.E[10] + M1.E[3] * M2.E[14];
@@ -495,21 +590,164 @@ inline mat4 Multiply(mat4 M1, mat4 M2){
 	Result.E[13] = M1.E[12] * M2.E[1] + M1.E[13] * M2.E[5] + M1.E[14] * M2.E[9] + M1.E[15] * M2.E[13];
 	Result.E[14] = M1.E[12] * M2.E[2] + M1.E[13] * M2.E[6] + M1.E[14] * M2.E[10] + M1.E[15] * M2.E[14];
 	Result.E[15] = M1.E[12] * M2.E[3] + M1.E[13] * M2.E[7] + M1.E[14] * M2.E[11] + M1.E[15] * M2.E[15];
+#endif
 
 	return(Result);
 }
 
+/*Result[i] = Dot(M.Rows[i], V)*/
 inline v4 Multiply(mat4 M, v4 V){
 	v4 Result;
 
-	Result.E[0] = V.E[0] * M.E[0] + V.E[0] * M.E[1] + V.E[0] * M.E[2] + V.E[0] * M.E[3];
-	Result.E[1] = V.E[1] * M.E[4] + V.E[1] * M.E[5] + V.E[1] * M.E[6] + V.E[1] * M.E[7];
-	Result.E[2] = V.E[2] * M.E[8] + V.E[2] * M.E[9] + V.E[2] * M.E[10] + V.E[2] * M.E[11];
-	Result.E[3] = V.E[3] * M.E[12] + V.E[3] * M.E[13] + V.E[3] * M.E[14] + V.E[3] * M.E[15];
+#if defined(DIMA_COMMON_SSE)
+	/*NOTE(dima): Sum of columns of M scaled by components of V, transposition does not depend on V*/
+	__m128 C0 = _mm_loadu_ps(&M.E[0]);
+	__m128 C1 = _mm_loadu_ps(&M.E[4]);
+	__m128 C2 = _mm_loadu_ps(&M.E[8]);
+	__m128 C3 = _mm_loadu_ps(&M.E[12]);
+	_MM_TRANSPOSE4_PS(C0, C1, C2, C3);
+
+	__m128 Vec = _mm_loadu_ps(V.E);
+	__m128 R = _mm_mul_ps(C0, _mm_shuffle_ps(Vec, Vec, 0x00));
+	R = _mm_add_ps(R, _mm_mul_ps(C1, _mm_shuffle_ps(Vec, Vec, 0x55)));
+	R = _mm_add_ps(R, _mm_mul_ps(C2, _mm_shuffle_ps(Vec, Vec, 0xAA)));
+	R = _mm_add_ps(R, _mm_mul_ps(C3, _mm_shuffle_ps(Vec, Vec, 0xFF)));
+	_mm_storeu_ps(Result.E, R);
+#elif defined(DIMA_COMMON_NEON)
+	/*NOTE(dima): vld4q_f32 deinterleaves, so C[j] holds column j of M*/
+	float32x4x4_t C = vld4q_f32(M.E);
+	float32x4_t R = vmulq_n_f32(C.val[0], V.E[0]);
+	R = vaddq_f32(R, vmulq_n_f32(C.val[1], V.E[1]));
+	R = vaddq_f32(R, vmulq_n_f32(C.val[2], V.E[2]));
+	R = vaddq_f32(R, vmulq_n_f32(C.val[3], V.E[3]));
+	vst1q_f32(Result.E, R);
+#else
+	Result.E[0] = M.E[0] * V.E[0] + M.E[1] * V.E[1] + M.E[2] * V.E[2] + M.E[3] * V.E[3];
+	Result.E[1] = M.E[4] * V.E[0] + M.E[5] * V.E[1] + M.E[6] * V.E[2] + M.E[7] * V.E[3];
+	Result.E[2] = M.E[8] * V.E[0] + M.E[9] * V.E[1] + M.E[10] * V.E[2] + M.E[11] * V.E[3];
+	Result.E[3] = M.E[12] * V.E[0] + M.E[13] * V.E[1] + M.E[14] * V.E[2] + M.E[15] * V.E[3];
+#endif
 
 	return(Result);
 }
 
+/*
+	Batched Dst[i] = M * Src[i]. Src and Dst can be the same array.
+	Columns of M are loaded once, then each vector is a sum of columns
+	scaled by its components; AVX path takes two vectors per step.
+*/
+inline void TransformArray(mat4 M, v4* Src, v4* Dst, int Count){
+	int Index = 0;
+
+#if defined(DIMA_COMMON_SSE)
+	__m128 C0 = _mm_loadu_ps(&M.E[0]);
+	__m128 C1 = _mm_loadu_ps(&M.E[4]);
+	__m128 C2 = _mm_loadu_ps(&M.E[8]);
+	__m128 C3 = _mm_loadu_ps(&M.E[12]);
+	_MM_TRANSPOSE4_PS(C0, C1, C2, C3);
+
+#if defined(DIMA_COMMON_AVX)
+	__m256 WideC0 = _mm256_insertf128_ps(_mm256_castps128_ps256(C0), C0, 1);
+	__m256 WideC1 = _mm256_insertf128_ps(_mm256_castps128_ps256(C1), C1, 1);
+	__m256 WideC2 = _mm256_insertf128_ps(_mm256_castps128_ps256(C2), C2, 1);
+	__m256 WideC3 = _mm256_insertf128_ps(_mm256_castps128_ps256(C3), C3, 1);
+
+	for(; Index + 2 <= Count; Index += 2){
+		__m256 V = _mm256_loadu_ps(Src[Index].E);
+
+		__m256 R = _mm256_mul_ps(WideC0, _mm256_shuffle_ps(V, V, 0x00));
+		R = _mm256_add_ps(R, _mm256_mul_ps(WideC1, _mm256_shuffle_ps(V, V, 0x55)));
+		R = _mm256_add_ps(R, _mm256_mul_ps(WideC2, _mm256_shuffle_ps(V, V, 0xAA)));
+		R = _mm256_add_ps(R, _mm256_mul_ps(WideC3, _mm256_shuffle_ps(V, V, 0xFF)));
+
+		_mm256_storeu_ps(Dst[Index].E, R);
+	}
+#endif
+
+	for(; Index < Count; Index++){
+		__m128 V = _mm_loadu_ps(Src[Index].E);
+
+		__m128 R = _mm_mul_ps(C0, _mm_shuffle_ps(V, V, 0x00));
+		R = _mm_add_ps(R, _mm_mul_ps(C1, _mm_shuffle_ps(V, V, 0x55)));
+		R = _mm_add_ps(R, _mm_mul_ps(C2, _mm_shuffle_ps(V, V, 0xAA)));
+		R = _mm_add_ps(R, _mm_mul_ps(C3, _mm_shuffle_ps(V, V, 0xFF)));
+
+		_mm_storeu_ps(Dst[Index].E, R);
+	}
+#elif defined(DIMA_COMMON_NEON)
+	float32x4x4_t C = vld4q_f32(M.E);
+
+	for(; Index < Count; Index++){
+		float32x4_t V = vld1q_f32(Src[Index].E);
+
+		float32x4_t R = vmulq_laneq_f32(C.val[0], V, 0);
+		R = vaddq_f32(R, vmulq_laneq_f32(C.val[1], V, 1));
+		R = vaddq_f32(R, vmulq_laneq_f32(C.val[2], V, 2));
+		R = vaddq_f32(R, vmulq_laneq_f32(C.val[3], V, 3));
+
+		vst1q_f32(Dst[Index].E, R);
+	}
+#else
+	for(; Index < Count; Index++){
+		Dst[Index] = Multiply(M, Src[Index]);
+	}
+#endif
+}
+
+/*
+	Batched Dst[i] = (M * V4(Src[i], W)).xyz without perspective division.
+	W = 1 transforms points, W = 0 transforms directions.
+*/
+inline void TransformArray(mat4 M, v3* Src, v3* Dst, int Count, float W = 1.0f){
+	int Index = 0;
+
+#if defined(DIMA_COMMON_SSE)
+	__m128 C0 = _mm_loadu_ps(&M.E[0]);
+	__m128 C1 = _mm_loadu_ps(&M.E[4]);
+	__m128 C2 = _mm_loadu_ps(&M.E[8]);
+	__m128 C3 = _mm_loadu_ps(&M.E[12]);
+	_MM_TRANSPOSE4_PS(C0, C1, C2, C3);
+	C3 = _mm_mul_ps(C3, _mm_set1_ps(W));
+
+	for(; Index < Count; Index++){
+		/*NOTE(dima): 16-byte load is safe while the next element exists, Dst is written by 12 bytes so Src = Dst works*/
+		__m128 V;
+		if(Index + 1 < Count){
+			V = _mm_loadu_ps(Src[Index].E);
+		}
+		else{
+			V = _mm_set_ps(0.0f, Src[Index].z, Src[Index].y, Src[Index].x);
+		}
+
+		__m128 R = _mm_mul_ps(C0, _mm_shuffle_ps(V, V, 0x00));
+		R = _mm_add_ps(R, _mm_mul_ps(C1, _mm_shuffle_ps(V, V, 0x55)));
+		R = _mm_add_ps(R, _mm_mul_ps(C2, _mm_shuffle_ps(V, V, 0xAA)));
+		R = _mm_add_ps(R, C3);
+
+		_mm_storel_pi((__m64*)Dst[Index].E, R);
+		_mm_store_ss(&Dst[Index].z, _mm_movehl_ps(R, R));
+	}
+#elif defined(DIMA_COMMON_NEON)
+	float32x4x4_t C = vld4q_f32(M.E);
+	float32x4_t CW = vmulq_n_f32(C.val[3], W);
+
+	for(; Index < Count; Index++){
+		float32x4_t R = vmulq_n_f32(C.val[0], Src[Index].x);
+		R = vaddq_f32(R, vmulq_n_f32(C.val[1], Src[Index].y));
+		R = vaddq_f32(R, vmulq_n_f32(C.val[2], Src[Index].z));
+		R = vaddq_f32(R, CW);
+
+		vst1_f32(Dst[Index].E, vget_low_f32(R));
+		Dst[Index].z = vgetq_lane_f32(R, 2);
+	}
+#else
+	for(; Index < Count; Index++){
+		v4 R = Multiply(M, V4(Src[Index].x, Src[Index].y, Src[Index].z, W));
+		Dst[Index] = R.xyz;
+	}
+#endif
+}
+
 inline mat4 Identity(){
 	mat4 Result;
 
@@ -906,7 +1144,7 @@ inline quat Slerp(quat A, quat B, float Delta){
 	float InvDelta = 1.0f - Delta;
 
 	if(dot < 0.0f){
-		B = Quat(-B.x, -B.y -B.z, -B.w);
+		B = Mul(B, -1.0f);
 		dot = -dot;
 	}
 
@@ -934,4 +1172,400 @@ inline quat Slerp(quat A, quat B, float Delta){
 }
 #endif /*Quaternions implementation*/
 
+#if !defined(DO_NOT_IMPLEMENT_STREAMS) && !defined(STREAMS_IMPLEMENTED)
+#define STREAMS_IMPLEMENTED
+
+/*
+	Structure-of-arrays streams. Each component has its own array, so
+	one register holds the same component of 8 (AVX) or 4 (SSE, NEON)
+	elements and the batch functions below never shuffle. Arrays are
+	DIMA_STREAM_ALIGN aligned (32 or 64) and padded to a whole number
+	of registers, so there is no scalar tail. The caller owns the memory:
+	get the size with SoAMemorySize and carve it with V3SoA, QuatSoA or
+	FloatSoA. Results may alias the sources.
+*/
+#ifndef DIMA_STREAM_ALIGN
+#define DIMA_STREAM_ALIGN 64
+#endif
+
+#define DIMA_STREAM_PAD (DIMA_STREAM_ALIGN / sizeof(float))
+
+struct v3_soa{
+	float* x;
+	float* y;
+	float* z;
+	int Count;
+};
+
+struct quat_soa{
+	float* x;
+	float* y;
+	float* z;
+	float* w;
+	int Count;
+};
+
+/*Lane type: one register of floats for the batch functions*/
+#if defined(DIMA_COMMON_AVX)
+#define DIMA_LANE_WIDTH 8
+struct lane_f32{ __m256 V; };
+
+inline lane_f32 LaneF32(float Value){ lane_f32 R; R.V = _mm256_set1_ps(Value); return(R); }
+inline lane_f32 LaneLoad(float* Src){ lane_f32 R; R.V = _mm256_load_ps(Src); return(R); }
+inline void LaneStore(float* Dst, lane_f32 A){ _mm256_store_ps(Dst, A.V); }
+
+inline lane_f32 operator+(lane_f32 A, lane_f32 B){ lane_f32 R; R.V = _mm256_add_ps(A.V, B.V); return(R); }
+inline lane_f32 operator-(lane_f32 A, lane_f32 B){ lane_f32 R; R.V = _mm256_sub_ps(A.V, B.V); return(R); }
+inline lane_f32 operator*(lane_f32 A, lane_f32 B){ lane_f32 R; R.V = _mm256_mul_ps(A.V, B.V); return(R); }
+inline lane_f32 operator&(lane_f32 A, lane_f32 B){ lane_f32 R; R.V = _mm256_and_ps(A.V, B.V); return(R); }
+inline lane_f32 operator^(lane_f32 A, lane_f32 B){ lane_f32 R; R.V = _mm256_xor_ps(A.V, B.V); return(R); }
+
+/*All bits set where A > B*/
+inline lane_f32 LaneGreater(lane_f32 A, lane_f32 B){ lane_f32 R; R.V = _mm256_cmp_ps(A.V, B.V, _CMP_GT_OQ); return(R); }
+
+/*Lanes outside of [FLT_MIN, FLT_MAX] are taken from 1 / sqrt, as in RSqrt*/
+inline lane_f32 LaneRSqrt(lane_f32 A){
+	__m256 Y = _mm256_rsqrt_ps(A.V);
+	__m256 HalfXYY = _mm256_mul_ps(_mm256_mul_ps(_mm256_set1_ps(0.5f), A.V), _mm256_mul_ps(Y, Y));
+	lane_f32 R;
+	R.V = _mm256_mul_ps(Y, _mm256_sub_ps(_mm256_set1_ps(1.5f), HalfXYY));
+
+	__m256 IsNormal = _mm256_and_ps(
+		_mm256_cmp_ps(A.V, _mm256_set1_ps(FLT_MIN), _CMP_GE_OQ),
+		_mm256_cmp_ps(A.V, _mm256_set1_ps(FLT_MAX), _CMP_LE_OQ));
+	if(_mm256_movemask_ps(IsNormal) != 0xFF){
+		__m256 Exact = _mm256_div_ps(_mm256_set1_ps(1.0f), _mm256_sqrt_ps(A.V));
+		R.V = _mm256_blendv_ps(Exact, R.V, IsNormal);
+	}
+	return(R);
+}
+#elif defined(DIMA_COMMON_SSE)
+#define DIMA_LANE_WIDTH 4
+struct lane_f32{ __m128 V; };
+
+inline lane_f32 LaneF32(float Value){ lane_f32 R; R.V = _mm_set1_ps(Value); return(R); }
+inline lane_f32 LaneLoad(float* Src){ lane_f32 R; R.V = _mm_load_ps(Src); return(R); }
+inline void LaneStore(float* Dst, lane_f32 A){ _mm_store_ps(Dst, A.V); }
+
+inline lane_f32 operator+(lane_f32 A, lane_f32 B){ lane_f32 R; R.V = _mm_add_ps(A.V, B.V); return(R); }
+inline lane_f32 operator-(lane_f32 A, lane_f32 B){ lane_f32 R; R.V = _mm_sub_ps(A.V, B.V); return(R); }
+inline lane_f32 operator*(lane_f32 A, lane_f32 B){ lane_f32 R; R.V = _mm_mul_ps(A.V, B.V); return(R); }
+inline lane_f32 operator&(lane_f32 A, lane_f32 B){ lane_f32 R; R.V = _mm_and_ps(A.V, B.V); return(R); }
+inline lane_f32 operator^(lane_f32 A, lane_f32 B){ lane_f32 R; R.V = _mm_xor_ps(A.V, B.V); return(R); }
+
+inline lane_f32 LaneGreater(lane_f32 A, lane_f32 B){ lane_f32 R; R.V = _mm_cmpgt_ps(A.V, B.V); return(R); }
+
+inline lane_f32 LaneRSqrt(lane_f32 A){
+	__m128 Y = _mm_rsqrt_ps(A.V);
+	__m128 HalfXYY = _mm_mul_ps(_mm_mul_ps(_mm_set1_ps(0.5f), A.V), _mm_mul_ps(Y, Y));
+	lane_f32 R;
+	R.V = _mm_mul_ps(Y, _mm_sub_ps(_mm_set1_ps(1.5f), HalfXYY));
+
+	__m128 IsNormal = _mm_and_ps(_mm_cmpge_ps(A.V, _mm_set1_ps(FLT_MIN)), _mm_cmple_ps(A.V, _mm_set1_ps(FLT_MAX)));
+	if(_mm_movemask_ps(IsNormal) != 0xF){
+		__m128 Exact = _mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(A.V));
+		R.V = _mm_or_ps(_mm_and_ps(IsNormal, R.V), _mm_andnot_ps(IsNormal, Exact));
+	}
+	return(R);
+}
+#elif defined(DIMA_COMMON_NEON)
+#define DIMA_LANE_WIDTH 4
+struct lane_f32{ float32x4_t V; };
+
+inline lane_f32 LaneF32(float Value){ lane_f32 R; R.V = vdupq_n_f32(Value); return(R); }
+inline lane_f32 LaneLoad(float* Src){ lane_f32 R; R.V = vld1q_f32(Src); return(R); }
+inline void LaneStore(float* Dst, lane_f32 A){ vst1q_f32(Dst, A.V); }
+
+inline lane_f32 operator+(lane_f32 A, lane_f32 B){ lane_f32 R; R.V = vaddq_f32(A.V, B.V); return(R); }
+inline lane_f32 operator-(lane_f32 A, lane_f32 B){ lane_f32 R; R.V = vsubq_f32(A.V, B.V); return(R); }
+inline lane_f32 operator*(lane_f32 A, lane_f32 B){ lane_f32 R; R.V = vmulq_f32(A.V, B.V); return(R); }
+inline lane_f32 operator&(lane_f32 A, lane_f32 B){
+	lane_f32 R;
+	R.V = vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(A.V), vreinterpretq_u32_f32(B.V)));
+	return(R);
+}
+inline lane_f32 operator^(lane_f32 A, lane_f32 B){
+	lane_f32 R;
+	R.V = vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(A.V), vreinterpretq_u32_f32(B.V)));
+	return(R);
+}
+
+inline lane_f32 LaneGreater(lane_f32 A, lane_f32 B){ lane_f32 R; R.V = vreinterpretq_f32_u32(vcgtq_f32(A.V, B.V)); return(R); }
+
+inline lane_f32 LaneRSqrt(lane_f32 A){
+	float32x4_t Y = vrsqrteq_f32(A.V);
+	Y = vmulq_f32(Y, vrsqrtsq_f32(vmulq_f32(A.V, Y), Y));
+	Y = vmulq_f32(Y, vrsqrtsq_f32(vmulq_f32(A.V, Y), Y));
+
+	uint32x4_t IsNormal = vandq_u32(vcgeq_f32(A.V, vdupq_n_f32(FLT_MIN)), vcleq_f32(A.V, vdupq_n_f32(FLT_MAX)));
+	if(vminvq_u32(IsNormal) == 0){
+		float32x4_t Exact = vdivq_f32(vdupq_n_f32(1.0f), vsqrtq_f32(A.V));
+		Y = vbslq_f32(IsNormal, Y, Exact);
+	}
+
+	lane_f32 R;
+	R.V = Y;
+	return(R);
+}
+#else
+#define DIMA_LANE_WIDTH 1
+struct lane_f32{ float V; };
+
+inline lane_f32 LaneF32(float Value){ lane_f32 R; R.V = Value; return(R); }
+inline lane_f32 LaneLoad(float* Src){ lane_f32 R; R.V = *Src; return(R); }
+inline void LaneStore(float* Dst, lane_f32 A){ *Dst = A.V; }
+
+inline lane_f32 operator+(lane_f32 A, lane_f32 B){ lane_f32 R; R.V = A.V + B.V; return(R); }
+inline lane_f32 operator-(lane_f32 A, lane_f32 B){ lane_f32 R; R.V = A.V - B.V; return(R); }
+inline lane_f32 operator*(lane_f32 A, lane_f32 B){ lane_f32 R; R.V = A.V * B.V; return(R); }
+
+/*NOTE(dima): Bit operations go through a union so masks behave the same as in the SIMD paths*/
+union lane_bits{ float F; uint32_t U; };
+inline lane_f32 operator&(lane_f32 A, lane_f32 B){
+	lane_bits a, b;
+	a.F = A.V; b.F = B.V;
+	a.U &= b.U;
+	return(LaneF32(a.F));
+}
+inline lane_f32 operator^(lane_f32 A, lane_f32 B){
+	lane_bits a, b;
+	a.F = A.V; b.F = B.V;
+	a.U ^= b.U;
+	return(LaneF32(a.F));
+}
+
+inline lane_f32 LaneGreater(lane_f32 A, lane_f32 B){
+	lane_bits Mask;
+	Mask.U = (A.V > B.V) ? 0xFFFFFFFF : 0;
+	return(LaneF32(Mask.F));
+}
+
+inline lane_f32 LaneRSqrt(lane_f32 A){ return(LaneF32(1.0f / sqrtf(A.V))); }
+#endif
+
+/*Stream memory*/
+inline int SoAPaddedCount(int Count){
+	int Result = (Count + (int)DIMA_STREAM_PAD - 1) & ~((int)DIMA_STREAM_PAD - 1);
+	return(Result);
+}
+
+/*Bytes needed for Components arrays of Count floats, alignment slack included*/
+inline memory_index SoAMemorySize(int Count, int Components){
+	memory_index Result = (memory_index)SoAPaddedCount(Count) * Components * sizeof(float) + (DIMA_STREAM_ALIGN - 1);
+	return(Result);
+}
+
+/*Aligns Memory, zeroes the arrays and returns the first one; array I starts I * padded count floats later*/
+inline float* SoAArrays(void* Memory, int Count, int Components){
+	float* Result = (float*)(((umm)Memory + (DIMA_STREAM_ALIGN - 1)) & ~(umm)(DIMA_STREAM_ALIGN - 1));
+
+	int Total = SoAPaddedCount(Count) * Components;
+	for(int Index = 0; Index < Total; Index++){
+		Result[Index] = 0.0f;
+	}
+
+	return(Result);
+}
+
+inline float* FloatSoA(void* Memory, int Count){
+	return(SoAArrays(Memory, Count, 1));
+}
+
+inline v3_soa V3SoA(void* Memory, int Count){
+	v3_soa Result;
+
+	int Padded = SoAPaddedCount(Count);
+	Result.x = SoAArrays(Memory, Count, 3);
+	Result.y = Result.x + Padded;
+	Result.z = Result.y + Padded;
+	Result.Count = Count;
+
+	return(Result);
+}
+
+inline quat_soa QuatSoA(void* Memory, int Count){
+	quat_soa Result;
+
+	int Padded = SoAPaddedCount(Count);
+	Result.x = SoAArrays(Memory, Count, 4);
+	Result.y = Result.x + Padded;
+	Result.z = Result.y + Padded;
+	Result.w = Result.z + Padded;
+	Result.Count = Count;
+
+	return(Result);
+}
+
+/*Element access*/
+inline v3 V3(v3_soa* S, int Index){ return(V3(S->x[Index], S->y[Index], S->z[Index])); }
+
+inline void Put(v3_soa* S, int Index, v3 V){
+	S->x[Index] = V.x;
+	S->y[Index] = V.y;
+	S->z[Index] = V.z;
+}
+
+inline quat Quat(quat_soa* S, int Index){
+	quat Result;
+
+	Result.x = S->x[Index];
+	Result.y = S->y[Index];
+	Result.z = S->z[Index];
+	Result.w = S->w[Index];
+
+	return(Result);
+}
+
+inline void Put(quat_soa* S, int Index, quat Q){
+	S->x[Index] = Q.x;
+	S->y[Index] = Q.y;
+	S->z[Index] = Q.z;
+	S->w[Index] = Q.w;
+}
+
+/*Batch vector functions. They run over A->Count elements*/
+inline void Dot(v3_soa* A, v3_soa* B, float* Result){
+	for(int Index = 0; Index < A->Count; Index += DIMA_LANE_WIDTH){
+		lane_f32 Ax = LaneLoad(A->x + Index), Ay = LaneLoad(A->y + Index), Az = LaneLoad(A->z + Index);
+		lane_f32 Bx = LaneLoad(B->x + Index), By = LaneLoad(B->y + Index), Bz = LaneLoad(B->z + Index);
+
+		LaneStore(Result + Index, Ax * Bx + Ay * By + Az * Bz);
+	}
+}
+
+inline void Cross(v3_soa* A, v3_soa* B, v3_soa* Result){
+	for(int Index = 0; Index < A->Count; Index += DIMA_LANE_WIDTH){
+		lane_f32 Ax = LaneLoad(A->x + Index), Ay = LaneLoad(A->y + Index), Az = LaneLoad(A->z + Index);
+		lane_f32 Bx = LaneLoad(B->x + Index), By = LaneLoad(B->y + Index), Bz = LaneLoad(B->z + Index);
+
+		LaneStore(Result->x + Index, Ay * Bz - By * Az);
+		LaneStore(Result->y + Index, Az * Bx - Bz * Ax);
+		LaneStore(Result->z + Index, Ax * By - Bx * Ay);
+	}
+}
+
+inline void Normalize(v3_soa* A, v3_soa* Result){
+	for(int Index = 0; Index < A->Count; Index += DIMA_LANE_WIDTH){
+		lane_f32 Ax = LaneLoad(A->x + Index), Ay = LaneLoad(A->y + Index), Az = LaneLoad(A->z + Index);
+
+		lane_f32 Scale = LaneRSqrt(Ax * Ax + Ay * Ay + Az * Az);
+
+		LaneStore(Result->x + Index, Ax * Scale);
+		LaneStore(Result->y + Index, Ay * Scale);
+		LaneStore(Result->z + Index, Az * Scale);
+	}
+}
+
+/*Zero length vectors come out as zero*/
+inline void NOZ(v3_soa* A, v3_soa* Result){
+	for(int Index = 0; Index < A->Count; Index += DIMA_LANE_WIDTH){
+		lane_f32 Ax = LaneLoad(A->x + Index), Ay = LaneLoad(A->y + Index), Az = LaneLoad(A->z + Index);
+
+		lane_f32 SqMag = Ax * Ax + Ay * Ay + Az * Az;
+		lane_f32 Scale = LaneRSqrt(SqMag) & LaneGreater(SqMag, LaneF32(0.0f));
+
+		LaneStore(Result->x + Index, Ax * Scale);
+		LaneStore(Result->y + Index, Ay * Scale);
+		LaneStore(Result->z + Index, Az * Scale);
+	}
+}
+
+inline void Lerp(v3_soa* A, v3_soa* B, float t, v3_soa* Result){
+	lane_f32 T = LaneF32(t);
+	lane_f32 InvT = LaneF32(1.0f - t);
+
+	for(int Index = 0; Index < A->Count; Index += DIMA_LANE_WIDTH){
+		LaneStore(Result->x + Index, InvT * LaneLoad(A->x + Index) + LaneLoad(B->x + Index) * T);
+		LaneStore(Result->y + Index, InvT * LaneLoad(A->y + Index) + LaneLoad(B->y + Index) * T);
+		LaneStore(Result->z + Index, InvT * LaneLoad(A->z + Index) + LaneLoad(B->z + Index) * T);
+	}
+}
+
+/*Batch quaternion functions*/
+inline void Mul(quat_soa* A, quat_soa* B, quat_soa* Result){
+	for(int Index = 0; Index < A->Count; Index += DIMA_LANE_WIDTH){
+		lane_f32 Ax = LaneLoad(A->x + Index), Ay = LaneLoad(A->y + Index), Az = LaneLoad(A->z + Index), Aw = LaneLoad(A->w + Index);
+		lane_f32 Bx = LaneLoad(B->x + Index), By = LaneLoad(B->y + Index), Bz = LaneLoad(B->z + Index), Bw = LaneLoad(B->w + Index);
+
+		LaneStore(Result->x + Index, Aw * Bx + Ax * Bw + Ay * Bz - Az * By);
+		LaneStore(Result->y + Index, Aw * By - Ax * Bz + Ay * Bw + Az * Bx);
+		LaneStore(Result->z + Index, Aw * Bz + Ax * By - Ay * Bx + Az * Bw);
+		LaneStore(Result->w + Index, Aw * Bw - Ax * Bx - Ay * By - Az * Bz);
+	}
+}
+
+inline void Normalize(quat_soa* A, quat_soa* Result){
+	for(int Index = 0; Index < A->Count; Index += DIMA_LANE_WIDTH){
+		lane_f32 Ax = LaneLoad(A->x + Index), Ay = LaneLoad(A->y + Index), Az = LaneLoad(A->z + Index), Aw = LaneLoad(A->w + Index);
+
+		lane_f32 Scale = LaneRSqrt(Ax * Ax + Ay * Ay + Az * Az + Aw * Aw);
+
+		LaneStore(Result->x + Index, Ax * Scale);
+		LaneStore(Result->y + Index, Ay * Scale);
+		LaneStore(Result->z + Index, Az * Scale);
+		LaneStore(Result->w + Index, Aw * Scale);
+	}
+}
+
+/*
+	NOTE(dima): sin and atan2 have no SIMD instruction, so the batch Slerp
+	uses Eberly's polynomial form ("A Fast and Accurate Algorithm for
+	Computing SLERP"): sin(t * theta) / sin(theta) as nested terms in
+	(cos(theta) - 1) and t*t. Only multiplies and adds, no branches, and
+	no small-angle special case. Twelve terms keep the error around 1e-6
+	for any pair of unit quaternions. Delta is in [0, 1].
+*/
+#define DIMA_SLERP_TERMS 12
+#define DIMA_SLERP_LAST_SCALE 1.89372497f
+
+inline void Slerp(quat_soa* A, quat_soa* B, float Delta, quat_soa* Result){
+	lane_f32 One = LaneF32(1.0f);
+	lane_f32 SignBit = LaneF32(-0.0f);
+	lane_f32 T = LaneF32(Delta);
+	lane_f32 InvT = LaneF32(1.0f - Delta);
+
+	/*
+		NOTE(dima): Term i is (u * t * t - v) * (cos(theta) - 1) with
+		u = 1 / (i * (2i + 1)) and v = i / (2i + 1). The last term is
+		scaled to absorb the rest of the series. The u * t * t parts are
+		the same for every lane.
+	*/
+	lane_f32 UT[DIMA_SLERP_TERMS], UInvT[DIMA_SLERP_TERMS], V[DIMA_SLERP_TERMS];
+	for(int i = 0; i < DIMA_SLERP_TERMS; i++){
+		float n = (float)(i + 1);
+		float Scale = (i == DIMA_SLERP_TERMS - 1) ? DIMA_SLERP_LAST_SCALE : 1.0f;
+		float U = Scale / (n * (2.0f * n + 1.0f));
+
+		UT[i] = LaneF32(U * Delta * Delta);
+		UInvT[i] = LaneF32(U * (1.0f - Delta) * (1.0f - Delta));
+		V[i] = LaneF32(Scale * n / (2.0f * n + 1.0f));
+	}
+
+	for(int Index = 0; Index < A->Count; Index += DIMA_LANE_WIDTH){
+		lane_f32 Ax = LaneLoad(A->x + Index), Ay = LaneLoad(A->y + Index), Az = LaneLoad(A->z + Index), Aw = LaneLoad(A->w + Index);
+		lane_f32 Bx = LaneLoad(B->x + Index), By = LaneLoad(B->y + Index), Bz = LaneLoad(B->z + Index), Bw = LaneLoad(B->w + Index);
+
+		/*Take the short way: flip B where the dot product is negative*/
+		lane_f32 CosTheta = Ax * Bx + Ay * By + Az * Bz + Aw * Bw;
+		lane_f32 Sign = CosTheta & SignBit;
+		CosTheta = CosTheta ^ Sign;
+		lane_f32 CosM1 = CosTheta - One;
+
+		lane_f32 K0 = One, K1 = One;
+		for(int i = DIMA_SLERP_TERMS - 1; i >= 0; i--){
+			K0 = One + (UInvT[i] - V[i]) * CosM1 * K0;
+			K1 = One + (UT[i] - V[i]) * CosM1 * K1;
+		}
+		K0 = InvT * K0;
+		K1 = (T * K1) ^ Sign;
+
+		LaneStore(Result->x + Index, Ax * K0 + Bx * K1);
+		LaneStore(Result->y + Index, Ay * K0 + By * K1);
+		LaneStore(Result->z + Index, Az * K0 + Bz * K1);
+		LaneStore(Result->w + Index, Aw * K0 + Bw * K1);
+	}
+}
+
+#endif /*Streams implementation*/
+
 #endif /*ORIGIN_DIMA*/
\ No newline at end of file
@@ -3,21 +3,23 @@
 
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
 
 #define DIMA_JSON_WRITER_MAX_DEPTH 64
 #define DIMA_JSON_WRITER_DEFAULT_BUF_LEN 512
-#define DIMA_JSON_WRITER_REALLOC_DIFF 512
 
-#ifndef DIMA_JSON_WRITER_USE_STB_SPRINTF
-#ifdef _CRT_SECURE_NO_WARNINGS
-#define DIMA_JSON_WRITER_SPRINTF sprintf
-#else
-#define DIMA_JSON_WRITER_SPRINTF sprintf
-#endif
-#else
-#define DIMA_JSON_WRITER_SPRINTF stbsp_sprintf
+/*
+	In streaming mode buffered output is passed to the sink
+	once this many bytes are ready
+*/
+#ifndef DIMA_JSON_WRITER_DEFAULT_FLUSH_SIZE
+#define DIMA_JSON_WRITER_DEFAULT_FLUSH_SIZE (64 * 1024)
 #endif
 
+/* How many input bytes JSONAddDataHex converts before it may flush */
+#define DIMA_JSON_WRITER_HEX_CHUNK 4096
+
 #ifndef DIMA_JSON_WRITER_DEF
 #ifdef DIMA_JSON_WRITER_STATIC
 #define DIMA_JSON_WRITER_DEF static
@@ -31,17 +33,28 @@ enum {
 	JSONWriterFlag_Pretty,
 };
 
+/* Receives finished output in streaming mode */
+typedef void json_writer_sink(void* User, char* Data, int32_t DataLen);
+
 struct json_writer {
 	char* Buf;
 	int32_t BufSize;
 
 	int32_t CurrentIndex;
+	/*
+		Everything before this index is final. Next line can only
+		rewind to it to insert comma
+	*/
 	int32_t LastPossibleCommaIndex;
 
 	int32_t CurrentLayer;
 	int32_t LayerElements[DIMA_JSON_WRITER_MAX_DEPTH];
 
 	uint32_t Flags;
+
+	json_writer_sink* Sink;
+	void* SinkUser;
+	int32_t FlushSize;
 };
 
 #ifdef __cplusplus
@@ -49,6 +62,16 @@ extern "C" {
 #endif
 
 	DIMA_JSON_WRITER_DEF void JSONInit(json_writer* Writer, uint32_t Flags = JSONWriterFlag_None);
+	/*
+		Streaming mode. Output is passed to Sink in pieces of about FlushSize
+		bytes (0 means default) instead of being kept in memory. JSONFlush
+		must be called after the last element.
+	*/
+	DIMA_JSON_WRITER_DEF void JSONInitSink(json_writer* Writer, uint32_t Flags, json_writer_sink* Sink, void* SinkUser, int32_t FlushSize);
+	DIMA_JSON_WRITER_DEF void JSONInitFILE(json_writer* Writer, uint32_t Flags, FILE* File);
+	DIMA_JSON_WRITER_DEF void JSONInitFD(json_writer* Writer, uint32_t Flags, int FD);
+	/* Passes all buffered output to the sink. Does nothing without a sink */
+	DIMA_JSON_WRITER_DEF void JSONFlush(json_writer* Writer);
 	DIMA_JSON_WRITER_DEF void JSONFree(json_writer* Writer);
 
 	DIMA_JSON_WRITER_DEF void JSONBegin(json_writer* Writer);
@@ -68,6 +91,7 @@ extern "C" {
 
 	DIMA_JSON_WRITER_DEF void JSONAddDataHex(json_writer* Writer, char* Key, uint8_t* Value, int32_t ValueLen);
 
+	/* In streaming mode holds only the part not yet passed to the sink */
 	DIMA_JSON_WRITER_DEF char* JSONGetBuf(json_writer* Writer);
 #ifdef __cplusplus
 }
@@ -79,31 +103,83 @@ extern "C" {
 #if defined(DIMA_JSON_WRITER_IMPLEMENTATION) && !defined(DIMA_JSON_WRITER_IMPLEMENTATION_DONE)
 #define DIMA_JSON_WRITER_IMPLEMENTATION_DONE
 
-static void JSONReallocIfNeeded(json_writer* Writer) {
-	if (Writer->CurrentIndex > Writer->BufSize - 128) {
-		Writer->Buf = (char*)realloc(Writer->Buf, Writer->BufSize + DIMA_JSON_WRITER_REALLOC_DIFF);
-		Writer->BufSize += DIMA_JSON_WRITER_REALLOC_DIFF;
+#if defined(_WIN32)
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+/* "00" ... "99" for writing two decimal digits at once */
+static const char JSONDecPairs[201] =
+	"0001020304050607080910111213141516171819"
+	"2021222324252627282930313233343536373839"
+	"4041424344454647484950515253545556575859"
+	"6061626364656667686970717273747576777879"
+	"8081828384858687888990919293949596979899";
+
+/* "00" ... "FF" for writing one byte as two hex digits */
+static const char JSONHexPairs[513] =
+	"000102030405060708090A0B0C0D0E0F101112131415161718191A1B1C1D1E1F"
+	"202122232425262728292A2B2C2D2E2F303132333435363738393A3B3C3D3E3F"
+	"404142434445464748494A4B4C4D4E4F505152535455565758595A5B5C5D5E5F"
+	"606162636465666768696A6B6C6D6E6F707172737475767778797A7B7C7D7E7F"
+	"808182838485868788898A8B8C8D8E8F909192939495969798999A9B9C9D9E9F"
+	"A0A1A2A3A4A5A6A7A8A9AAABACADAEAFB0B1B2B3B4B5B6B7B8B9BABBBCBDBEBF"
+	"C0C1C2C3C4C5C6C7C8C9CACBCCCDCECFD0D1D2D3D4D5D6D7D8D9DADBDCDDDEDF"
+	"E0E1E2E3E4E5E6E7E8E9EAEBECEDEEEFF0F1F2F3F4F5F6F7F8F9FAFBFCFDFEFF";
+
+/*
+	Makes room for Bytes more chars and terminating zero.
+	Buffer grows twice so that large documents are built in linear time
+*/
+static void JSONReserve(json_writer* Writer, int32_t Bytes) {
+	int32_t Needed = Writer->CurrentIndex + Bytes + 1;
+
+	if (Needed > Writer->BufSize) {
+		int32_t NewSize = Writer->BufSize * 2;
+		while (NewSize < Needed) {
+			NewSize *= 2;
+		}
+
+		Writer->Buf = (char*)realloc(Writer->Buf, NewSize);
+		Writer->BufSize = NewSize;
 	}
 }
 
-static void JSONCopyCharToBuf(json_writer* Writer, char ToWrite) {
-	JSONReallocIfNeeded(Writer);
-	Writer->Buf[Writer->CurrentIndex++] = ToWrite;
-}
+/* Passes final part of the buffer to the sink and moves the rest to the beginning */
+static void JSONEmit(json_writer* Writer) {
+	int32_t EmitLen = Writer->LastPossibleCommaIndex;
 
-static void JSONCopyStrToBuf(json_writer* Writer, char* ToWrite) {
-	char* At = ToWrite;
-	while (*At) {
-		JSONCopyCharToBuf(Writer, *At);
+	if (EmitLen > 0) {
+		Writer->Sink(Writer->SinkUser, Writer->Buf, EmitLen);
 
-		At++;
+		memmove(Writer->Buf, Writer->Buf + EmitLen, Writer->CurrentIndex - EmitLen);
+		Writer->CurrentIndex -= EmitLen;
+		Writer->LastPossibleCommaIndex = 0;
+		Writer->Buf[Writer->CurrentIndex] = 0;
 	}
 }
 
-static void JSONWriteLine(json_writer* Writer, char* Str) {
-	int32_t StrLen = strlen(Str);
+static void JSONFlushIfNeeded(json_writer* Writer) {
+	if (Writer->Sink && Writer->LastPossibleCommaIndex >= Writer->FlushSize) {
+		JSONEmit(Writer);
+	}
+}
 
-	if (Str[StrLen - 1] != '}' && Str[StrLen - 1] != ']') {
+static void JSONCopyCharToBuf(json_writer* Writer, char ToWrite) {
+	JSONReserve(Writer, 1);
+	Writer->Buf[Writer->CurrentIndex++] = ToWrite;
+}
+
+static void JSONCopyBytesToBuf(json_writer* Writer, char* ToWrite, int32_t Len) {
+	JSONReserve(Writer, Len);
+	memcpy(Writer->Buf + Writer->CurrentIndex, ToWrite, Len);
+	Writer->CurrentIndex += Len;
+}
+
+/* Comma after previous element and tabulation. Closing brackets don't need comma */
+static void JSONBeginLine(json_writer* Writer, int IsClosing) {
+	if (!IsClosing) {
 		if (Writer->LayerElements[Writer->CurrentLayer] > 0) {
 			Writer->CurrentIndex = Writer->LastPossibleCommaIndex;
 			JSONCopyCharToBuf(Writer, ',');
@@ -115,26 +191,88 @@ static void JSONWriteLine(json_writer* Writer, char* Str) {
 	}
 
 	if (Writer->Flags & JSONWriterFlag_Pretty) {
-		for (int TabulationIndex = 0;
-			TabulationIndex < Writer->CurrentLayer;
-			TabulationIndex++)
-		{
-			JSONCopyCharToBuf(Writer, '\t');
-		}
+		JSONReserve(Writer, Writer->CurrentLayer);
+		memset(Writer->Buf + Writer->CurrentIndex, '\t', Writer->CurrentLayer);
+		Writer->CurrentIndex += Writer->CurrentLayer;
 	}
 
-	JSONCopyStrToBuf(Writer, Str);
+	Writer->LastPossibleCommaIndex = Writer->CurrentIndex;
+}
 
+static void JSONEndLine(json_writer* Writer) {
 	Writer->LastPossibleCommaIndex = Writer->CurrentIndex;
 
 	if (Writer->Flags & JSONWriterFlag_Pretty) {
 		JSONCopyCharToBuf(Writer, '\n');
 	}
+	Writer->Buf[Writer->CurrentIndex] = 0;
+
+	JSONFlushIfNeeded(Writer);
+}
+
+static void JSONWriteKey(json_writer* Writer, char* Key) {
+	int32_t KeyLen = (int32_t)strlen(Key);
+
+	JSONReserve(Writer, KeyLen + 4);
+	char* To = Writer->Buf + Writer->CurrentIndex;
+	*To++ = '\"';
+	memcpy(To, Key, KeyLen);
+	To += KeyLen;
+	*To++ = '\"';
+	*To++ = ':';
+	*To++ = ' ';
+	Writer->CurrentIndex = (int32_t)(To - Writer->Buf);
+}
+
+/* Decimal digits of Value straight to the buffer, two at a time */
+static void JSONWriteU64(json_writer* Writer, uint64_t Value) {
+	int32_t Len = 1;
+	for (uint64_t Temp = Value; Temp >= 10; Temp /= 10) {
+		Len++;
+	}
+
+	JSONReserve(Writer, Len);
+	char* To = Writer->Buf + Writer->CurrentIndex + Len;
+
+	while (Value >= 100) {
+		uint32_t Pair = (uint32_t)(Value % 100) * 2;
+		Value /= 100;
+
+		*--To = JSONDecPairs[Pair + 1];
+		*--To = JSONDecPairs[Pair];
+	}
+
+	if (Value >= 10) {
+		*--To = JSONDecPairs[Value * 2 + 1];
+		*--To = JSONDecPairs[Value * 2];
+	}
+	else {
+		*--To = (char)('0' + Value);
+	}
+
+	Writer->CurrentIndex += Len;
+}
+
+static void JSONWriteS64(json_writer* Writer, int64_t Value) {
+	if (Value < 0) {
+		JSONCopyCharToBuf(Writer, '-');
+		JSONWriteU64(Writer, 0 - (uint64_t)Value);
+	}
+	else {
+		JSONWriteU64(Writer, (uint64_t)Value);
+	}
+}
+
+static void JSONWriteLine(json_writer* Writer, char* Str, int32_t StrLen) {
+	JSONBeginLine(Writer, Str[StrLen - 1] == '}' || Str[StrLen - 1] == ']');
+	JSONCopyBytesToBuf(Writer, Str, StrLen);
+	JSONEndLine(Writer);
 }
 
 void JSONInit(json_writer* Writer, uint32_t Flags) {
 	Writer->Buf = (char*)malloc(DIMA_JSON_WRITER_DEFAULT_BUF_LEN * sizeof(char));
 	Writer->BufSize = DIMA_JSON_WRITER_DEFAULT_BUF_LEN;
+	Writer->Buf[0] = 0;
 
 	Writer->CurrentIndex = 0;
 	Writer->LastPossibleCommaIndex = 0;
@@ -147,6 +285,55 @@ void JSONInit(json_writer* Writer, uint32_t Flags) {
 	{
 		Writer->LayerElements[LayerIndex] = 0;
 	}
+
+	Writer->Sink = 0;
+	Writer->SinkUser = 0;
+	Writer->FlushSize = 0;
+}
+
+void JSONInitSink(json_writer* Writer, uint32_t Flags, json_writer_sink* Sink, void* SinkUser, int32_t FlushSize) {
+	JSONInit(Writer, Flags);
+
+	Writer->Sink = Sink;
+	Writer->SinkUser = SinkUser;
+	Writer->FlushSize = FlushSize > 0 ? FlushSize : DIMA_JSON_WRITER_DEFAULT_FLUSH_SIZE;
+}
+
+static void JSONSinkFILE(void* User, char* Data, int32_t DataLen) {
+	fwrite(Data, 1, DataLen, (FILE*)User);
+}
+
+static void JSONSinkFD(void* User, char* Data, int32_t DataLen) {
+	int FD = (int)(intptr_t)User;
+
+	while (DataLen > 0) {
+#if defined(_WIN32)
+		int Written = _write(FD, Data, DataLen);
+#else
+		int Written = (int)write(FD, Data, DataLen);
+#endif
+		if (Written <= 0) {
+			break;
+		}
+
+		Data += Written;
+		DataLen -= Written;
+	}
+}
+
+void JSONInitFILE(json_writer* Writer, uint32_t Flags, FILE* File) {
+	JSONInitSink(Writer, Flags, JSONSinkFILE, File, 0);
+}
+
+void JSONInitFD(json_writer* Writer, uint32_t Flags, int FD) {
+	JSONInitSink(Writer, Flags, JSONSinkFD, (void*)(intptr_t)FD, 0);
+}
+
+void JSONFlush(json_writer* Writer) {
+	if (Writer->Sink) {
+		Writer->LastPossibleCommaIndex = Writer->CurrentIndex;
+		JSONEmit(Writer);
+	}
 }
 
 void JSONFree(json_writer* Writer) {
@@ -154,16 +341,16 @@ void JSONFree(json_writer* Writer) {
 }
 
 void JSONBegin(json_writer* Writer) {
-	JSONWriteLine(Writer, "{");
+	JSONWriteLine(Writer, (char*)"{", 1);
 
 	Writer->CurrentLayer++;
 }
 
 void JSONBeginName(json_writer* Writer, char* Name) {
-	char LineBuf[256];
-	DIMA_JSON_WRITER_SPRINTF(LineBuf, "\"%s\": {", Name);
-
-	JSONWriteLine(Writer, LineBuf);
+	JSONBeginLine(Writer, 0);
+	JSONWriteKey(Writer, Name);
+	JSONCopyCharToBuf(Writer, '{');
+	JSONEndLine(Writer);
 
 	Writer->CurrentLayer++;
 }
@@ -172,17 +359,16 @@ void JSONEnd(json_writer* Writer) {
 	Writer->LayerElements[Writer->CurrentLayer] = 0;
 	Writer->CurrentLayer--;
 
-	JSONWriteLine(Writer, "}");
-	Writer->Buf[Writer->CurrentIndex] = 0;
+	JSONWriteLine(Writer, (char*)"}", 1);
 
 	Writer->LayerElements[Writer->CurrentLayer]++;
 }
 
 void JSONBeginArr(json_writer* Writer, char* Name) {
-	char LineBuf[256];
-	DIMA_JSON_WRITER_SPRINTF(LineBuf, "\"%s\": [", Name);
-
-	JSONWriteLine(Writer, LineBuf);
+	JSONBeginLine(Writer, 0);
+	JSONWriteKey(Writer, Name);
+	JSONCopyCharToBuf(Writer, '[');
+	JSONEndLine(Writer);
 
 	Writer->CurrentLayer++;
 }
@@ -191,144 +377,113 @@ void JSONEndArr(json_writer* Writer) {
 	Writer->LayerElements[Writer->CurrentLayer] = 0;
 	Writer->CurrentLayer--;
 
-	JSONWriteLine(Writer, "]");
+	JSONWriteLine(Writer, (char*)"]", 1);
 
 	Writer->LayerElements[Writer->CurrentLayer]++;
 }
 
 void JSONAddU32(json_writer* Writer, char* Key, uint32_t Value) {
-	char LineBuf[256];
-	DIMA_JSON_WRITER_SPRINTF(LineBuf, "\"%s\": %u", Key, Value);
-
-	JSONWriteLine(Writer, LineBuf);
+	JSONBeginLine(Writer, 0);
+	JSONWriteKey(Writer, Key);
+	JSONWriteU64(Writer, Value);
+	JSONEndLine(Writer);
 
 	Writer->LayerElements[Writer->CurrentLayer]++;
 }
 
 void JSONAddS32(json_writer* Writer, char* Key, int32_t Value) {
-	char LineBuf[256];
-	DIMA_JSON_WRITER_SPRINTF(LineBuf, "\"%s\": %d", Key, Value);
-
-	JSONWriteLine(Writer, LineBuf);
+	JSONBeginLine(Writer, 0);
+	JSONWriteKey(Writer, Key);
+	JSONWriteS64(Writer, Value);
+	JSONEndLine(Writer);
 
 	Writer->LayerElements[Writer->CurrentLayer]++;
 }
 
 void JSONAddU64(json_writer* Writer, char* Key, uint64_t Value) {
-	char LineBuf[256];
-	DIMA_JSON_WRITER_SPRINTF(LineBuf, "\"%s\": %llu", Key, Value);
-
-	JSONWriteLine(Writer, LineBuf);
+	JSONBeginLine(Writer, 0);
+	JSONWriteKey(Writer, Key);
+	JSONWriteU64(Writer, Value);
+	JSONEndLine(Writer);
 
 	Writer->LayerElements[Writer->CurrentLayer]++;
 }
 
 void JSONAddS64(json_writer* Writer, char* Key, int64_t Value) {
-	char LineBuf[256];
-	DIMA_JSON_WRITER_SPRINTF(LineBuf, "\"%s\": %lld", Key, Value);
-
-	JSONWriteLine(Writer, LineBuf);
+	JSONBeginLine(Writer, 0);
+	JSONWriteKey(Writer, Key);
+	JSONWriteS64(Writer, Value);
+	JSONEndLine(Writer);
 
 	Writer->LayerElements[Writer->CurrentLayer]++;
 }
 
-
-/*
-void add_str(char* Key, char* Value) {
-	char LineBuf[256];
-	DIMA_JSON_WRITER_SPRINTF(LineBuf, "\"%s\": \"%s\"", Key, Value);
-
-	write_line(LineBuf);
-
-	this->LayerElements[this->CurrentLayer]++;
-}
-*/
-
-void JSONAddSTR(json_writer* Writer, char* Key, char* Value) {
-	int32_t KeyLen = strlen(Key);
-	int32_t ValueLen = strlen(Value);
-
-	char* LineBuf = (char*)malloc(KeyLen + ValueLen + 16);
-	if (Value) {
-		DIMA_JSON_WRITER_SPRINTF(LineBuf, "\"%s\": \"%s\"", Key, Value);
-	}
-	else {
-		DIMA_JSON_WRITER_SPRINTF(LineBuf, "\"%s\": 0", Key);
-	}
-
-	JSONWriteLine(Writer, LineBuf);
-
-	Writer->LayerElements[Writer->CurrentLayer]++;
-
-	free(LineBuf);
-}
-
 void JSONAddFixedSTR(json_writer* Writer, char* Key, char* Value, int32_t ValueLen) {
-	int32_t KeyLen = strlen(Key);
-	char* LineBuf = (char*)malloc(KeyLen + ValueLen + 16);
+	JSONBeginLine(Writer, 0);
+	JSONWriteKey(Writer, Key);
 
 	if (Value) {
-		char LinePart1[256];
-		DIMA_JSON_WRITER_SPRINTF(LinePart1, "\"%s\": \"", Key);
-
-		char LinePart2[256];
-		int i = 0;
-		for (i = 0; i < ValueLen; i++)
-		{
-			LinePart2[i] = Value[i];
-		}
-		LinePart2[i++] = '\"';
-		LinePart2[i] = 0;
-
-		DIMA_JSON_WRITER_SPRINTF(LineBuf, "%s%s", LinePart1, LinePart2);
+		JSONReserve(Writer, ValueLen + 2);
+		char* To = Writer->Buf + Writer->CurrentIndex;
+		*To++ = '\"';
+		memcpy(To, Value, ValueLen);
+		To += ValueLen;
+		*To++ = '\"';
+		Writer->CurrentIndex = (int32_t)(To - Writer->Buf);
 	}
 	else {
-		DIMA_JSON_WRITER_SPRINTF(LineBuf, "\"%s\": 0", Key);
+		JSONCopyCharToBuf(Writer, '0');
 	}
 
-	JSONWriteLine(Writer, LineBuf);
+	JSONEndLine(Writer);
 
 	Writer->LayerElements[Writer->CurrentLayer]++;
+}
 
-	free(LineBuf);
+void JSONAddSTR(json_writer* Writer, char* Key, char* Value) {
+	JSONAddFixedSTR(Writer, Key, Value, Value ? (int32_t)strlen(Value) : 0);
 }
 
 void JSONAddDataHex(json_writer* Writer, char* Key, uint8_t* Value, int32_t ValueLen) {
-	int32_t KeyLen = strlen(Key);
-
-	char* LineBuf = (char*)malloc(KeyLen + ValueLen * 2 + 16);
+	JSONBeginLine(Writer, 0);
+	JSONWriteKey(Writer, Key);
 
 	if (Value) {
-		char* To = LineBuf;
-		*To++ = '\"';
+		JSONCopyCharToBuf(Writer, '\"');
 
-		for (int i = 0; i < KeyLen; i++) {
-			*To++ = Key[i];
-		}
-		*To++ = '\"';
-		*To++ = ':';
-		*To++ = ' ';
-		*To++ = '\"';
+		//NOTE(dima): Converting by chunks so that big data can go to the sink before the line ends
+		for (int32_t ChunkBegin = 0;
+			ChunkBegin < ValueLen;
+			ChunkBegin += DIMA_JSON_WRITER_HEX_CHUNK)
+		{
+			int32_t ChunkLen = ValueLen - ChunkBegin;
+			if (ChunkLen > DIMA_JSON_WRITER_HEX_CHUNK) {
+				ChunkLen = DIMA_JSON_WRITER_HEX_CHUNK;
+			}
 
-		for (int i = 0; i < ValueLen; i++) {
-			char Temp[4];
-			DIMA_JSON_WRITER_SPRINTF(Temp, "%2.2X", Value[i]);
+			JSONReserve(Writer, ChunkLen * 2);
+			char* To = Writer->Buf + Writer->CurrentIndex;
+			uint8_t* From = Value + ChunkBegin;
+			for (int i = 0; i < ChunkLen; i++) {
+				memcpy(To, JSONHexPairs + From[i] * 2, 2);
+				To += 2;
+			}
+			Writer->CurrentIndex = (int32_t)(To - Writer->Buf);
 
-			*To++ = Temp[0];
-			*To++ = Temp[1];
+			//NOTE(dima): Comma can't go inside of the string so it's final
+			Writer->LastPossibleCommaIndex = Writer->CurrentIndex;
+			JSONFlushIfNeeded(Writer);
 		}
-		*To++ = '\"';
-		*To = 0;
+
+		JSONCopyCharToBuf(Writer, '\"');
 	}
 	else {
-		DIMA_JSON_WRITER_SPRINTF(LineBuf, "\"%s\": 0", Key);
+		JSONCopyCharToBuf(Writer, '0');
 	}
 
-	JSONWriteLine(Writer, LineBuf);
+	JSONEndLine(Writer);
 
 	Writer->LayerElements[Writer->CurrentLayer]++;
-
-	free(LineBuf);
 }
 
 char* JSONGetBuf(json_writer* Writer) {
@@ -337,4 +492,4 @@ char* JSONGetBuf(json_writer* Writer) {
 	return(Result);
 }
 
-#endif
\ No newline at end of file
+#endif
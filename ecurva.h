@@ -1,9 +1,30 @@
 #ifndef ECURVA_H
 #define ECURVA_H
 
-#include "stdint.h"
+/*
+	NOTE(dima): Elliptic curves over GF(p) of bee2 (STB 34.101.45) cut down
+	to what bignStart() and ecMulA() need. Header-only: define
+	ECURVA_IMPLEMENTATION in one translation unit before including.
+
+	All memory is given by the caller. Sizes come from the *_keep()
+	functions (state of objects) and *_deep() functions (stack of calls):
+
+		bign_params params;
+		bignStdParams(&params, "1.2.112.0.2.0.34.101.45.3.1");
+		ec_o* ec = (ec_o*)malloc(bignStart_keep(params.l, 0));
+		bignStart(ec, &params);
+		void* stack = malloc(ecMulA_deep(ec->f->n, ec->d, ec->deep, m));
+		ecMulA(b, ec->base, ec, d, m, stack);
+
+	Word size follows the platform (B_PER_W). Field elements are stored
+	in Montgomery form, or as is when p = 2^{B_PER_W * n} - c with small c
+	(like p of STB curves).
+*/
 
-typedef uint16_t word;
+#include <stdint.h>
+#include <stddef.h>
+#include <limits.h>
+#include <string.h>
 
 /*!	\brief Булев тип */
 typedef int bool_t;
@@ -219,6 +240,10 @@ typedef unsigned char octet;
 	#error "Unsupported size_t size"
 #endif
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 
 /*
 *******************************************************************************
@@ -240,6 +265,15 @@ typedef u32 err_t;
 /*!	\brief Максимальный код ошибки */
 #define ERR_MAX	(ERR_OK - (err_t)1)
 
+/*!	\brief Неверные входные данные */
+#define ERR_BAD_INPUT	((err_t)109)
+
+/*!	\brief Объект (файл, стандартные параметры) не найден */
+#define ERR_FILE_NOT_FOUND	((err_t)202)
+
+/*!	\brief Неверные параметры */
+#define ERR_BAD_PARAMS	((err_t)501)
+
 
 
 
@@ -799,6 +833,9 @@ void memRev(
 */
 #define LAST_OF(a) ((a)[COUNT_OF(a) - 1])
 
+/*!	\brief Перестановка значений целочисленных переменных a и b */
+#define SWAP(a, b) ((a) ^= (b), (b) ^= (a), (a) ^= (b))
+
 /*!	\brief Компиляция с проверкой условия
 	
 	Для отладочной версии вычислить e и завершить компиляцию, если e == 0.
@@ -848,8 +885,595 @@ void memRev(
 */
 #define EXPECT(a) 
 
+/*!	\brief Утверждение
+	При e == 0 выводится сообщение с именем файла file и номером строки line,
+	после чего выполнение завершается.
+*/
+void utilAssert(
+	int e,				/*!< [in] проверяемое условие */
+	const char* file,	/*!< [in] имя файла */
+	int line			/*!< [in] номер строки */
+);
+
+/*!	\brief Максимум
+	Определяется максимум из n чисел типа size_t, которые передаются
+	вслед за n.
+	\pre n > 0.
+	\return Максимум.
+*/
+size_t utilMax(
+	size_t n,			/*!< [in] число аргументов */
+	...					/*!< [in] аргументы */
+);
+
+/*
+*******************************************************************************
+Объекты
+
+Объект -- непрерывный блок памяти, который начинается с заголовка obj_hdr_t.
+За заголовком следует таблица из p_count указателей на данные объекта.
+Первые o_count указателей таблицы указывают на вложенные объекты.
+Указатели таблицы могут указывать внутрь объекта: при перемещении
+объекта внутренние указатели перенастраиваются.
+*******************************************************************************
+*/
+
+/*!	\brief Заголовок объекта */
+typedef struct
+{
+	size_t keep;		/*!< размер объекта в октетах */
+	size_t p_count;		/*!< число указателей в таблице */
+	size_t o_count;		/*!< число указателей на объекты */
+} obj_hdr_t;
+
+/*!	\brief Заголовок объекта obj */
+#define objHdr(obj) ((obj_hdr_t*)(obj))
+
+/*!	\brief Размер объекта obj */
+#define objKeep(obj) (objHdr(obj)->keep)
+
+/*!	\brief Число указателей в таблице объекта obj */
+#define objPCount(obj) (objHdr(obj)->p_count)
+
+/*!	\brief Число указателей на объекты в таблице объекта obj */
+#define objOCount(obj) (objHdr(obj)->o_count)
+
+/*!	\brief i-й указатель таблицы объекта obj */
+#define objPtr(obj, i) (((void**)(objHdr(obj) + 1))[i])
+
+/*!	\brief Работоспособный объект?
+	Проверяется, что заголовок объекта obj корректен и что вложенные
+	объекты работоспособны.
+	\return Проверяемый признак.
+*/
+bool_t objIsOperable(
+	const void* obj		/*!< [in] объект */
+);
+
+/*!	\brief Присоединение объекта
+	Объект obj1 копируется в конец объекта obj, и на копию настраивается
+	i-й указатель таблицы obj. Размер obj увеличивается на размер obj1.
+	\pre Объекты obj и obj1 работоспособны.
+	\pre i < objOCount(obj).
+	\pre За obj зарезервировано objKeep(obj1) октетов памяти.
+	\remark Объект obj1 может уже находиться в конце obj.
+*/
+void objAppend(
+	void* obj,			/*!< [in/out] объект */
+	const void* obj1,	/*!< [in] присоединяемый объект */
+	size_t i			/*!< [in] номер указателя */
+);
+
+/*
+*******************************************************************************
+Массивы машинных слов (ww)
+
+Массив [n]a из n слов задает число
+	a[0] + a[1] 2^B_PER_W + ... + a[n - 1] 2^{B_PER_W (n - 1)}.
+*******************************************************************************
+*/
+
+/*!	\brief Загрузка из буфера памяти
+	Буфер [count]a преобразуется в массив [W_OF_O(count)]b.
+*/
+void wwFrom(
+	word b[],			/*!< [out] приемник */
+	const void* a,		/*!< [in] источник */
+	size_t count		/*!< [in] число октетов */
+);
+
+/*!	\brief Выгрузка в буфер памяти
+	Буфер [count]b формируется по массиву [W_OF_O(count)]a.
+*/
+void wwTo(
+	void* b,			/*!< [out] приемник */
+	size_t count,		/*!< [in] число октетов */
+	const word a[]		/*!< [in] источник */
+);
+
+/*!	\brief Копирование: [n]b <- [n]a
+	\pre Буферы a и b либо не пересекаются, либо совпадают.
+*/
+void wwCopy(
+	word b[],			/*!< [out] приемник */
+	const word a[],		/*!< [in] источник */
+	size_t n			/*!< [in] длина массивов */
+);
+
+/*!	\brief Обнуление: [n]a <- 0 */
+void wwSetZero(
+	word a[],			/*!< [out] массив */
+	size_t n			/*!< [in] длина массива */
+);
+
+/*!	\brief Установка: [n]a <- w */
+void wwSetW(
+	word a[],			/*!< [out] массив */
+	size_t n,			/*!< [in] длина массива */
+	word w				/*!< [in] значение */
+);
+
+/*!	\brief Нулевой массив?
+	\return Признак [n]a == 0.
+	\safe Функция регулярна.
+*/
+bool_t wwIsZero(
+	const word a[],		/*!< [in] массив */
+	size_t n			/*!< [in] длина массива */
+);
+
+/*!	\brief Сравнение массивов
+	\return < 0, если [n]a < [n]b, 0, если [n]a == [n]b, > 0 в остальных
+	случаях. Массивы сравниваются как числа.
+	\safe Функция нерегулярна.
+*/
+int wwCmp(
+	const word a[],		/*!< [in] первый массив */
+	const word b[],		/*!< [in] второй массив */
+	size_t n			/*!< [in] длина массивов */
+);
+
+/*!	\brief Сравнение массива со словом
+	\return < 0, если [n]a < w, 0, если [n]a == w, > 0 в остальных случаях.
+	\safe Функция нерегулярна.
+*/
+int wwCmpW(
+	const word a[],		/*!< [in] массив */
+	size_t n,			/*!< [in] длина массива */
+	word w				/*!< [in] слово */
+);
+
+/*!	\brief Проверка бита
+	\return Значение бита массива a с номером pos.
+*/
+bool_t wwTestBit(
+	const word a[],		/*!< [in] массив */
+	size_t pos			/*!< [in] номер бита */
+);
+
+/*!	\brief Чтение битов
+	\return Слово из битов a с номерами pos, pos + 1,..., pos + width - 1
+	(младший бит слова -- бит pos).
+	\pre width <= B_PER_W.
+	\pre Биты с указанными номерами лежат в массиве a.
+*/
+word wwGetBits(
+	const word a[],		/*!< [in] массив */
+	size_t pos,			/*!< [in] номер первого бита */
+	size_t width		/*!< [in] число битов */
+);
+
+/*!	\brief Запись битов
+	Биты a с номерами pos, pos + 1,..., pos + width - 1 заменяются
+	младшими битами val.
+	\pre width <= B_PER_W.
+*/
+void wwSetBits(
+	word a[],			/*!< [in/out] массив */
+	size_t pos,			/*!< [in] номер первого бита */
+	size_t width,		/*!< [in] число битов */
+	word val			/*!< [in] значение */
+);
+
+/*!	\brief Битовая длина
+	\return Номер старшего ненулевого бита [n]a плюс 1 или 0, если a == 0.
+*/
+size_t wwBitSize(
+	const word a[],		/*!< [in] массив */
+	size_t n			/*!< [in] длина массива */
+);
+
+/*!	\brief Оконная несмежная форма (NAF)
+	Для числа [n]a строится NAF ширины w. Символы NAF записываются в
+	[2 * n + 1]naf начиная со старшего. Нулевой символ занимает один бит.
+	Ненулевой символ d занимает w битов: младшие w - 1 битов содержат |d|,
+	старший бит -- признак d < 0.
+	\pre 2 <= w < B_PER_W.
+	\return Число символов NAF (0, если a == 0).
+	\safe Функция нерегулярна.
+*/
+size_t wwNAF(
+	word naf[],			/*!< [out] NAF */
+	const word a[],		/*!< [in] число */
+	size_t n,			/*!< [in] длина a */
+	size_t w			/*!< [in] ширина окна */
+);
+
+/*
+*******************************************************************************
+Натуральные числа (zz)
+*******************************************************************************
+*/
+
+/*!	\brief Число [n]a четное? */
+#define zzIsEven(a, n) (((a)[0] & 1) == 0)
+
+/*!	\brief Число [n]a нечетное? */
+#define zzIsOdd(a, n) (((a)[0] & 1) == 1)
+
+/*!	\brief Сложение: [n]c <- [n]a + [n]b
+	\return Слово переноса.
+*/
+word zzAdd(
+	word c[],			/*!< [out] сумма */
+	const word a[],		/*!< [in] первое слагаемое */
+	const word b[],		/*!< [in] второе слагаемое */
+	size_t n			/*!< [in] длина чисел */
+);
+
+/*!	\brief Сложение со словом: [n]b <- [n]a + w
+	\return Слово переноса.
+*/
+word zzAddW(
+	word b[],			/*!< [out] сумма */
+	const word a[],		/*!< [in] первое слагаемое */
+	size_t n,			/*!< [in] длина a */
+	word w				/*!< [in] второе слагаемое */
+);
+
+/*!	\brief Добавление слова: [n]a <- [n]a + w
+	\return Слово переноса.
+*/
+word zzAddW2(
+	word a[],			/*!< [in/out] слагаемое / сумма */
+	size_t n,			/*!< [in] длина a */
+	word w				/*!< [in] добавляемое слово */
+);
+
+/*!	\brief Условное добавление: [n]b <- [n]b + ([n]a & w)
+	\remark При w == 0 число b не меняется, при w == WORD_MAX к b
+	добавляется a.
+	\return Слово переноса.
+	\safe Функция регулярна.
+*/
+word zzAddAndW(
+	word b[],			/*!< [in/out] слагаемое / сумма */
+	const word a[],		/*!< [in] добавляемое число */
+	size_t n,			/*!< [in] длина чисел */
+	word w				/*!< [in] маска */
+);
+
+/*!	\brief Вычитание: [n]c <- [n]a - [n]b
+	\return Слово заема.
+*/
+word zzSub(
+	word c[],			/*!< [out] разность */
+	const word a[],		/*!< [in] уменьшаемое */
+	const word b[],		/*!< [in] вычитаемое */
+	size_t n			/*!< [in] длина чисел */
+);
+
+/*!	\brief Уменьшение: [n]b <- [n]b - [n]a
+	\return Слово заема.
+*/
+word zzSub2(
+	word b[],			/*!< [in/out] уменьшаемое / разность */
+	const word a[],		/*!< [in] вычитаемое */
+	size_t n			/*!< [in] длина чисел */
+);
+
+/*!	\brief Уменьшение на слово: [n]a <- [n]a - w
+	\return Слово заема.
+*/
+word zzSubW2(
+	word a[],			/*!< [in/out] уменьшаемое / разность */
+	size_t n,			/*!< [in] длина a */
+	word w				/*!< [in] вычитаемое */
+);
+
+/*!	\brief Сложение с произведением: [n]b <- [n]b + [n]a * w
+	\return Слово переноса.
+*/
+word zzAddMulW(
+	word b[],			/*!< [in/out] слагаемое / сумма */
+	const word a[],		/*!< [in] первый множитель */
+	size_t n,			/*!< [in] длина чисел */
+	word w				/*!< [in] второй множитель */
+);
+
+/*!	\brief Умножение: [n + m]c <- [n]a * [m]b
+	\pre Буфер c не пересекается с буферами a и b.
+*/
+void zzMul(
+	word c[],			/*!< [out] произведение */
+	const word a[],		/*!< [in] первый множитель */
+	size_t n,			/*!< [in] длина a */
+	const word b[],		/*!< [in] второй множитель */
+	size_t m,			/*!< [in] длина b */
+	void* stack			/*!< [in] вспомогательная память */
+);
+
+/*!	\brief Возведение в квадрат: [2 * n]b <- [n]a^2
+	\pre Буфер b не пересекается с буфером a.
+*/
+void zzSqr(
+	word b[],			/*!< [out] квадрат */
+	const word a[],		/*!< [in] число */
+	size_t n,			/*!< [in] длина a */
+	void* stack			/*!< [in] вспомогательная память */
+);
+
+/*!	\brief Сложение по модулю: [n]c <- ([n]a + [n]b) mod [n]mod
+	\pre a, b < mod.
+	\safe Функция регулярна.
+*/
+void zzAddMod(
+	word c[],			/*!< [out] сумма */
+	const word a[],		/*!< [in] первое слагаемое */
+	const word b[],		/*!< [in] второе слагаемое */
+	const word mod[],	/*!< [in] модуль */
+	size_t n			/*!< [in] длина чисел */
+);
+
+/*!	\brief Вычитание по модулю: [n]c <- ([n]a - [n]b) mod [n]mod
+	\pre a, b < mod.
+	\safe Функция регулярна.
+*/
+void zzSubMod(
+	word c[],			/*!< [out] разность */
+	const word a[],		/*!< [in] уменьшаемое */
+	const word b[],		/*!< [in] вычитаемое */
+	const word mod[],	/*!< [in] модуль */
+	size_t n			/*!< [in] длина чисел */
+);
+
+/*!	\brief Аддитивное обращение по модулю: [n]b <- -[n]a mod [n]mod
+	\pre a < mod.
+	\safe Функция регулярна.
+*/
+void zzNegMod(
+	word b[],			/*!< [out] обратное число */
+	const word a[],		/*!< [in] обращаемое число */
+	const word mod[],	/*!< [in] модуль */
+	size_t n			/*!< [in] длина чисел */
+);
+
+/*!	\brief Удвоение по модулю: [n]b <- 2 [n]a mod [n]mod */
+#define zzDoubleMod(b, a, mod, n) zzAddMod(b, a, a, mod, n)
+
+/*!	\brief Обратное слово
+	\return -w^{-1} mod 2^B_PER_W.
+	\pre w нечетно.
+*/
+word wordNegInv(
+	word w				/*!< [in] обращаемое слово */
+);
+
+/*!	\brief Редукция Монтгомери
+	Число [2 * n]a заменяется на число [n]a == a R^{-1} mod [n]mod,
+	где R = 2^{B_PER_W * n}.
+	\pre mod нечетно, mont_param == wordNegInv(mod[0]).
+	\pre a < mod R.
+	\safe Функция регулярна.
+*/
+void zzRedMont(
+	word a[],			/*!< [in/out] редуцируемое число / результат */
+	const word mod[],	/*!< [in] модуль */
+	size_t n,			/*!< [in] длина mod */
+	word mont_param,	/*!< [in] параметр Монтгомери */
+	void* stack			/*!< [in] вспомогательная память */
+);
+
+/*!	\brief Редукция по модулю Крэндалла
+	Число [2 * n]a заменяется на число [n]a == a mod [n]mod, где
+	mod = 2^{B_PER_W * n} - c.
+	\pre c < 2^{B_PER_W / 2}: mod[1] == ... == mod[n - 1] == WORD_MAX,
+	mod[0] > WORD_MAX - WORD_BIT_HALF.
+	\safe Функция регулярна.
+*/
+void zzRedCrand(
+	word a[],			/*!< [in/out] редуцируемое число / результат */
+	const word mod[],	/*!< [in] модуль */
+	size_t n,			/*!< [in] длина mod */
+	void* stack			/*!< [in] вспомогательная память */
+);
+
+/*
+*******************************************************************************
+Кольца вычетов (qr)
+
+Элементы кольца -- массивы [r->n]. Функции from и to преобразуют элементы
+из октетов [r->no] во внутреннее представление и обратно.
+*******************************************************************************
+*/
+
+struct qr_o;
+
+/*!	\brief Импорт элемента кольца
+	\return TRUE, если [r->no]a задает элемент кольца, и FALSE в противном
+	случае.
+*/
+typedef bool_t (*qr_from_i)(
+	word b[],				/*!< [out] элемент */
+	const octet a[],		/*!< [in] октеты */
+	const struct qr_o* r,	/*!< [in] кольцо */
+	void* stack				/*!< [in] вспомогательная память */
+);
+
+/*!	\brief Экспорт элемента кольца */
+typedef void (*qr_to_i)(
+	octet b[],				/*!< [out] октеты */
+	const word a[],			/*!< [in] элемент */
+	const struct qr_o* r,	/*!< [in] кольцо */
+	void* stack				/*!< [in] вспомогательная память */
+);
+
+/*!	\brief Сложение (вычитание): c <- a + b (c <- a - b) */
+typedef void (*qr_add_i)(
+	word c[],				/*!< [out] сумма (разность) */
+	const word a[],			/*!< [in] первый операнд */
+	const word b[],			/*!< [in] второй операнд */
+	const struct qr_o* r	/*!< [in] кольцо */
+);
+
+/*!	\brief Аддитивное обращение: b <- -a */
+typedef void (*qr_neg_i)(
+	word b[],				/*!< [out] обратный элемент */
+	const word a[],			/*!< [in] обращаемый элемент */
+	const struct qr_o* r	/*!< [in] кольцо */
+);
+
+/*!	\brief Умножение: c <- a b */
+typedef void (*qr_mul_i)(
+	word c[],				/*!< [out] произведение */
+	const word a[],			/*!< [in] первый множитель */
+	const word b[],			/*!< [in] второй множитель */
+	const struct qr_o* r,	/*!< [in] кольцо */
+	void* stack				/*!< [in] вспомогательная память */
+);
+
+/*!	\brief Возведение в квадрат (обращение): b <- a^2 (b <- a^{-1}) */
+typedef void (*qr_sqr_i)(
+	word b[],				/*!< [out] квадрат (обратный элемент) */
+	const word a[],			/*!< [in] элемент */
+	const struct qr_o* r,	/*!< [in] кольцо */
+	void* stack				/*!< [in] вспомогательная память */
+);
+
+/*!	\brief Деление: b <- divident / a */
+typedef void (*qr_div_i)(
+	word b[],				/*!< [out] частное */
+	const word divident[],	/*!< [in] делимое */
+	const word a[],			/*!< [in] делитель */
+	const struct qr_o* r,	/*!< [in] кольцо */
+	void* stack				/*!< [in] вспомогательная память */
+);
+
+/*!	\brief Описание кольца вычетов
+	\remark В таблицу указателей описания входят поля mod, unity, params.
+*/
+typedef struct qr_o
+{
+	obj_hdr_t hdr;			/*!< заголовок */
+// ptr_table {
+	word* mod;				/*!< модуль */
+	word* unity;			/*!< единица кольца */
+	void* params;			/*!< дополнительные параметры */
+// }
+	size_t n;				/*!< длина элементов в словах */
+	size_t no;				/*!< длина элементов в октетах */
+	qr_from_i from;			/*!< функция импорта */
+	qr_to_i to;				/*!< функция экспорта */
+	qr_add_i add;			/*!< функция сложения */
+	qr_add_i sub;			/*!< функция вычитания */
+	qr_neg_i neg;			/*!< функция аддитивного обращения */
+	qr_mul_i mul;			/*!< функция умножения */
+	qr_sqr_i sqr;			/*!< функция возведения в квадрат */
+	qr_sqr_i inv;			/*!< функция обращения */
+	qr_div_i div;			/*!< функция деления */
+	size_t deep;			/*!< максимальная глубина стека функций */
+	octet descr[];			/*!< память для размещения данных */
+} qr_o;
+
+#define qrFrom(b, a, r, stack) (r)->from(b, a, r, stack)
+#define qrTo(b, a, r, stack) (r)->to(b, a, r, stack)
+#define qrAdd(c, a, b, r) (r)->add(c, a, b, r)
+#define qrSub(c, a, b, r) (r)->sub(c, a, b, r)
+#define qrNeg(b, a, r) (r)->neg(b, a, r)
+#define qrMul(c, a, b, r, stack) (r)->mul(c, a, b, r, stack)
+#define qrSqr(b, a, r, stack) (r)->sqr(b, a, r, stack)
+#define qrInv(b, a, r, stack) (r)->inv(b, a, r, stack)
+#define qrDiv(b, divident, a, r, stack) (r)->div(b, divident, a, r, stack)
+
+#define qrCopy(b, a, r) wwCopy(b, a, (r)->n)
+#define qrSetZero(a, r) wwSetZero(a, (r)->n)
+#define qrSetUnity(a, r) wwCopy(a, (r)->unity, (r)->n)
+#define qrIsZero(a, r) wwIsZero(a, (r)->n)
+#define qrCmp(a, b, r) wwCmp(a, b, (r)->n)
+
+/*!	\brief Работоспособное описание кольца?
+	\return Проверяемый признак.
+*/
+bool_t qrIsOperable(
+	const qr_o* r		/*!< [in] описание кольца */
+);
+
+/*
+*******************************************************************************
+Кольцо Z / (mod) (zm)
+
+Сложение и вычитание не зависят от представления элементов (обычного или
+Монтгомери), поэтому выполняются напрямую, без таблицы функций.
+*******************************************************************************
+*/
+
+#define zmAdd(c, a, b, r) zzAddMod(c, a, b, (r)->mod, (r)->n)
+#define zmSub(c, a, b, r) zzSubMod(c, a, b, (r)->mod, (r)->n)
+#define zmNeg(b, a, r) zzNegMod(b, a, (r)->mod, (r)->n)
+
+/*
+*******************************************************************************
+Простое поле GF(p) (gfp)
+*******************************************************************************
+*/
+
+/*!	\brief Создание поля
+	По модулю [no]p создается описание f поля GF(p). Если
+	p = 2^{B_PER_W * n} - c и c < 2^{B_PER_W / 2}, то элементы хранятся в
+	обычном представлении и редуцируются по Крэндаллу, иначе -- в
+	представлении Монтгомери.
+	\pre Буфер f содержит gfpCreate_keep(no) октетов.
+	\pre Буфер stack содержит gfpCreate_deep(no) октетов.
+	\expect p -- простое.
+	\return TRUE, если p нечетно, p >= 3 и p[no - 1] != 0, и FALSE
+	в противном случае.
+*/
+bool_t gfpCreate(
+	qr_o* f,			/*!< [out] описание поля */
+	const octet p[],	/*!< [in] модуль */
+	size_t no,			/*!< [in] длина p в октетах */
+	void* stack			/*!< [in] вспомогательная память */
+);
+
+/*!	\brief Размер описания поля
+	\return Размер описания поля с модулем из no октетов.
+*/
+size_t gfpCreate_keep(
+	size_t no			/*!< [in] длина модуля в октетах */
+);
+
+/*!	\brief Глубина стека функций поля
+	\return Глубина стека функций gfpCreate() и функций созданного поля.
+*/
+size_t gfpCreate_deep(
+	size_t no			/*!< [in] длина модуля в октетах */
+);
+
+/*!	\brief Работоспособное описание поля?
+	\return Проверяемый признак.
+*/
+bool_t gfpIsOperable(
+	const qr_o* f		/*!< [in] описание поля */
+);
+
+/*!	\brief Удвоение: b <- 2a */
+#define gfpDouble(b, a, f) zzDoubleMod(b, a, (f)->mod, (f)->n)
+
+
 
 
+struct ec_o;
+
 /*!	\brief Импорт из аффинной точки
 
 	По аффинной точке [2 * ec->f->n]a эллиптической кривой ec строится 
@@ -1057,9 +1681,6 @@ typedef void (*ec_tpl_i)(
 	void* stack				/*!< [in] вспомогательная память */
 );
 
-struct ec_o;
-
-
 /*!	\brief Описание эллиптической кривой
 
 	Описывается эллиптическая кривая, правила представления ее элементов, 
@@ -1153,48 +1774,245 @@ typedef struct ec_o
 #define ecIsO(a, ec)\
 	wwIsZero(ecZ(a, (ec)->f->n), (ec)->f->n)
 
-#endif
+/*
+*******************************************************************************
+Общие функции
+*******************************************************************************
+*/
 
+/*!	\brief Работоспособное описание кривой?
+	\return Проверяемый признак.
+*/
+bool_t ecIsOperable(
+	const ec_o* ec		/*!< [in] описание кривой */
+);
 
+/*!	\brief Создание группы точек
+	В описании ec настраиваются базовая точка (xG, yG), порядок q и
+	кофактор группы точек.
+	\pre Описание ec работоспособно, кроме, может быть, описания группы.
+	\remark Нулевой указатель xG (yG) задает нулевую координату.
+	\return TRUE, если координаты лежат в базовом поле и q помещается в
+	ec->f->n + 1 слов, и FALSE в противном случае.
+*/
+bool_t ecCreateGroup(
+	ec_o* ec,			/*!< [in/out] описание кривой */
+	const octet xG[],	/*!< [in] x-координата базовой точки */
+	const octet yG[],	/*!< [in] y-координата базовой точки */
+	const octet q[],	/*!< [in] порядок группы */
+	size_t no,			/*!< [in] длина q в октетах */
+	u32 cofactor,		/*!< [in] кофактор */
+	void* stack			/*!< [in] вспомогательная память */
+);
 
-#ifndef OS_APPLE
-	#include <malloc.h>
-#else
-	#include <stdlib.h>
-#endif
-#ifdef OS_WIN
-	#include <windows.h>
-#endif
+size_t ecCreateGroup_deep(size_t f_deep);
+
+/*!	\brief Ширина NAF
+	\return Ширина оконной NAF для кратности из l битов, при которой
+	ecMulA() выполняет меньше всего операций.
+*/
+size_t ecNAFWidth(
+	size_t l			/*!< [in] длина кратности в битах */
+);
+
+/*!	\brief Кратная точка
+	Определяется аффинная точка [2 * ec->f->n]b = [m]d * [2 * ec->f->n]a.
+	\pre Описание ec работоспособно.
+	\return TRUE, если b не является бесконечно удаленной точкой, и FALSE
+	в противном случае.
+*/
+int ecMulA(
+	word b[],			/*!< [out] кратная точка */
+	word a[],			/*!< [in] аффинная точка */
+	ec_o* ec,			/*!< [in] описание кривой */
+	word d[],			/*!< [in] кратность */
+	size_t m,			/*!< [in] длина d в словах */
+	void* stack			/*!< [in] вспомогательная память */
+);
+
+size_t ecMulA_deep(size_t n, size_t ec_d, size_t ec_deep, size_t m);
 
 /*
 *******************************************************************************
-Проверка
-\todo Реализовать полноценную проверку корректности памяти.
+Кривая y^2 = x^3 + A x + B над GF(p) в якобиевых координатах (ecp)
+
+Точка (X : Y : Z) соответствует аффинной точке (X / Z^2, Y / Z^3),
+точка с Z == 0 -- бесконечно удаленная. Функции ecpXXX_deep(n, f_deep)
+возвращают глубину стека функций ecpXXX.
 *******************************************************************************
 */
 
-bool_t memIsValid(const void* buf, size_t count)
-{
-	return count == 0 || buf != 0;
-}
+/*!	\brief Создание кривой
+	По коэффициентам [f->no]A и [f->no]B создается описание ec кривой над
+	полем f. Если A == -3, то для удвоения и утроения выбираются
+	ускоренные функции.
+	\pre Буфер ec содержит ecpCreateJ_keep(f->n) октетов.
+	\return TRUE, если A и B лежат в поле, и FALSE в противном случае.
+	\remark Описание группы точек создается затем функцией ecCreateGroup().
+*/
+bool_t ecpCreateJ(
+	ec_o* ec,			/*!< [out] описание кривой */
+	const qr_o* f,		/*!< [in] базовое поле */
+	const octet A[],	/*!< [in] коэффициент A */
+	const octet B[],	/*!< [in] коэффициент B */
+	void* stack			/*!< [in] вспомогательная память */
+);
+
+size_t ecpCreateJ_keep(size_t n);
+size_t ecpCreateJ_deep(size_t n, size_t f_deep);
+
+bool_t ecpFromAJ(word b[], const word a[], const ec_o* ec, void* stack);
+bool_t ecpToAJ(word b[], const word a[], const ec_o* ec, void* stack);
+size_t ecpToAJ_deep(size_t n, size_t f_deep);
+void ecpNegJ(word b[], const word a[], const ec_o* ec, void* stack);
+void ecpAddJ(word c[], const word a[], const word b[], const ec_o* ec,
+	void* stack);
+size_t ecpAddJ_deep(size_t n, size_t f_deep);
+void ecpAddAJ(word c[], const word a[], const word b[], const ec_o* ec,
+	void* stack);
+size_t ecpAddAJ_deep(size_t n, size_t f_deep);
+void ecpSubJ(word c[], const word a[], const word b[], const ec_o* ec,
+	void* stack);
+size_t ecpSubJ_deep(size_t n, size_t f_deep);
+void ecpSubAJ(word c[], const word a[], const word b[], const ec_o* ec,
+	void* stack);
+size_t ecpSubAJ_deep(size_t n, size_t f_deep);
+void ecpDblJ(word b[], const word a[], const ec_o* ec, void* stack);
+size_t ecpDblJ_deep(size_t n, size_t f_deep);
+void ecpDblJA3(word b[], const word a[], const ec_o* ec, void* stack);
+size_t ecpDblJA3_deep(size_t n, size_t f_deep);
+void ecpDblAJ(word b[], const word a[], const ec_o* ec, void* stack);
+size_t ecpDblAJ_deep(size_t n, size_t f_deep);
+void ecpTplJ(word b[], const word a[], const ec_o* ec, void* stack);
+size_t ecpTplJ_deep(size_t n, size_t f_deep);
+void ecpTplJA3(word b[], const word a[], const ec_o* ec, void* stack);
+size_t ecpTplJA3_deep(size_t n, size_t f_deep);
 
 /*
 *******************************************************************************
-Стандартные функции
-\remark Перед вызовом memcpy(), memmove(), memset() проверяется, 
-что count != 0: при count == 0 поведение стандартных функций непредсказуемо
-(см. https://www.imperialviolet.org/2016/06/26/nonnull.html).
-\remark Прямое обращение к функции ядра HeapAlloc() решает проблему 
-с освобождением памяти в плагине bee2evp, связывающем bee2 с OpenSSL (1.1.0).
+Параметры bign (СТБ 34.101.45)
 *******************************************************************************
 */
 
-void memCopy(void* dest, const void* src, size_t count)
+/*!	\brief Долговременные параметры
+	Числа и координаты записываются в октеты от младших к старшим.
+*/
+typedef struct
 {
-	ASSERT(memIsDisjoint(src, dest, count));
-	if (count)
-		memcpy(dest, src, count);
-}
+	u32 l;				/*!< уровень стойкости (128, 192 или 256) */
+	octet p[64];		/*!< модуль p */
+	octet a[64];		/*!< коэффициент a */
+	octet b[64];		/*!< коэффициент b */
+	octet q[64];		/*!< порядок q */
+	octet yG[64];		/*!< y-координата базовой точки (x-координата 0) */
+	octet seed[8];		/*!< параметр seed */
+} bign_params;
+
+/*!	\brief Глубина стека вызывающей функции
+	\return Глубина стека функции, которая работает с кривой, созданной
+	bignStart().
+*/
+typedef size_t (*bign_deep_i)(
+	size_t n,			/*!< [in] длина элементов поля в словах */
+	size_t f_deep,		/*!< [in] глубина стека функций поля */
+	size_t ec_d,		/*!< [in] размерность точек */
+	size_t ec_deep		/*!< [in] глубина стека функций кривой */
+);
+
+/*!	\brief Стандартные параметры
+	В params загружаются стандартные параметры с именем name.
+	Поддерживается имя "1.2.112.0.2.0.34.101.45.3.1" (bign-curve256v1,
+	уровень 128, кривая gorec_load_stb128() из gor_bignum.h).
+	\return ERR_OK или ERR_FILE_NOT_FOUND, если параметры не найдены.
+*/
+err_t bignStdParams(
+	bign_params* params,	/*!< [out] параметры */
+	const char* name		/*!< [in] имя параметров */
+);
+
+/*!	\brief Создание кривой
+	По параметрам params в state создается описание кривой (ec_o) с
+	присоединенным описанием поля.
+	\pre Буфер state содержит bignStart_keep(params->l, 0) октетов.
+	\return ERR_OK или ERR_BAD_PARAMS, если параметры некорректны.
+*/
+err_t bignStart(
+	void* state,				/*!< [out] описание кривой */
+	const bign_params* params	/*!< [in] параметры */
+);
+
+/*!	\brief Размер описания кривой
+	\return Размер state для bignStart() вместе с вложенным стеком, к
+	которому при deep != 0 добавляется стек функции deep.
+*/
+size_t bignStart_keep(
+	size_t l,			/*!< [in] уровень стойкости */
+	bign_deep_i deep	/*!< [in] глубина стека вызывающей функции */
+);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ECURVA_H */
+
+#if defined(ECURVA_IMPLEMENTATION) && !defined(ECURVA_IMPLEMENTATION_DONE)
+#define ECURVA_IMPLEMENTATION_DONE
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#ifdef OS_WIN
+	#include <windows.h>
+#endif
+
+//NOTE(dima): wide paths of the mem* functions, define ECURVA_NO_SIMD to drop them
+#if !defined(ECURVA_NO_SIMD)
+	#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+		#define ECURVA_SSE2
+		#include <emmintrin.h>
+	#endif
+	#if defined(ECURVA_SSE2) && defined(__AVX2__)
+		#define ECURVA_AVX2
+		#include <immintrin.h>
+	#endif
+#endif
+
+//NOTE(dima): register is removed in C++17, the code below is C, keep it
+#if defined(__cplusplus) && (__cplusplus >= 201703L)
+#define ECURVA_REGISTER_UNDEF
+#define register
+#endif
+
+/*
+*******************************************************************************
+Проверка
+\todo Реализовать полноценную проверку корректности памяти.
+*******************************************************************************
+*/
+
+bool_t memIsValid(const void* buf, size_t count)
+{
+	return count == 0 || buf != 0;
+}
+
+/*
+*******************************************************************************
+Стандартные функции
+\remark Перед вызовом memcpy(), memmove(), memset() проверяется, 
+что count != 0: при count == 0 поведение стандартных функций непредсказуемо
+(см. https://www.imperialviolet.org/2016/06/26/nonnull.html).
+\remark Прямое обращение к функции ядра HeapAlloc() решает проблему 
+с освобождением памяти в плагине bee2evp, связывающем bee2 с OpenSSL (1.1.0).
+*******************************************************************************
+*/
+
+void memCopy(void* dest, const void* src, size_t count)
+{
+	ASSERT(memIsDisjoint(src, dest, count));
+	if (count)
+		memcpy(dest, src, count);
+}
 
 void memMove(void* dest, const void* src, size_t count)
 {
@@ -1273,16 +2091,108 @@ void memFree(void* buf)
 *******************************************************************************
 */
 
-bool_t SAFE(memEq)(const void* buf1, const void* buf2, size_t count)
+/*
+	NOTE(dima): The functions below do not depend on the arithmetic word.
+	They go through memw (64 bits wherever u64 exists) and, when the
+	compiler targets them, through SSE2 (16 octets) and AVX2 (32 octets)
+	blocks. Loads and stores are unaligned (memcpy, loadu/storeu): that is
+	legal on every platform and costs nothing on current x86. Only
+	memWipe() aligns, because it writes through a volatile pointer.
+	The SAFE versions OR the differences into a register and look at it
+	once at the end, so the running time depends only on count.
+*/
+
+#if defined(U64_SUPPORT)
+	typedef u64 memw;
+#else
+	typedef u32 memw;
+#endif
+
+#define O_PER_MW sizeof(memw)
+#define B_PER_MW (O_PER_MW * 8)
+
+static memw memwLoad(const void* buf)
 {
-	register word diff = 0;
-	ASSERT(memIsValid(buf1, count));
-	ASSERT(memIsValid(buf2, count));
-	for (; count >= O_PER_W; count -= O_PER_W)
+	memw w;
+	memcpy(&w, buf, O_PER_MW);
+	return w;
+}
+
+static void memwStore(void* buf, memw w)
+{
+	memcpy(buf, &w, O_PER_MW);
+}
+
+// 1, если w == 0, и 0 в противном случае (без ветвлений)
+static bool_t memwIsZero01(memw w)
+{
+	return (bool_t)(((w | ((memw)0 - w)) >> (B_PER_MW - 1)) ^ 1);
+}
+
+// октет o, повторенный в каждом октете слова
+static memw memwRep(octet o)
+{
+	return (memw)o * ((memw)-1 / 255);
+}
+
+#ifdef ECURVA_SSE2
+static memw memwFold128(__m128i v)
+{
+	memw t[16 / O_PER_MW];
+	memw w = 0;
+	size_t i;
+	_mm_storeu_si128((__m128i*)t, v);
+	for (i = 0; i < COUNT_OF(t); ++i)
+		w |= t[i];
+	return w;
+}
+#endif
+
+#ifdef ECURVA_AVX2
+static memw memwFold256(__m256i v)
+{
+	return memwFold128(_mm_or_si128(_mm256_castsi256_si128(v),
+		_mm256_extracti128_si256(v, 1)));
+}
+#endif
+
+// OR всех октетов [count]buf1 ^ [count]buf2
+static memw memOrXor(const void* buf1, const void* buf2, size_t count)
+{
+	register memw diff = 0;
+#ifdef ECURVA_AVX2
+	__m256i d256 = _mm256_setzero_si256();
+#endif
+#ifdef ECURVA_SSE2
+	__m128i d128 = _mm_setzero_si128();
+#endif
+#ifdef ECURVA_AVX2
+	for (; count >= 32; count -= 32)
 	{
-		diff |= *(const word*)buf1 ^ *(const word*)buf2;
-		buf1 = (const word*)buf1 + 1;
-		buf2 = (const word*)buf2 + 1;
+		d256 = _mm256_or_si256(d256, _mm256_xor_si256(
+			_mm256_loadu_si256((const __m256i*)buf1),
+			_mm256_loadu_si256((const __m256i*)buf2)));
+		buf1 = (const octet*)buf1 + 32;
+		buf2 = (const octet*)buf2 + 32;
+	}
+	diff |= memwFold256(d256);
+#endif
+#ifdef ECURVA_SSE2
+	for (; count >= 16; count -= 16)
+	{
+		d128 = _mm_or_si128(d128, _mm_xor_si128(
+			_mm_loadu_si128((const __m128i*)buf1),
+			_mm_loadu_si128((const __m128i*)buf2)));
+		buf1 = (const octet*)buf1 + 16;
+		buf2 = (const octet*)buf2 + 16;
+	}
+	diff |= memwFold128(d128);
+#endif
+	for (; count >= O_PER_MW; count -= O_PER_MW)
+	{
+		diff |= memwLoad(buf1) ^ memwLoad(buf2);
+		buf1 = (const octet*)buf1 + O_PER_MW;
+		buf2 = (const octet*)buf2 + O_PER_MW;
 	}
 	while (count--)
 	{
@@ -1290,7 +2200,58 @@ bool_t SAFE(memEq)(const void* buf1, const void* buf2, size_t count)
 		buf1 = (const octet*)buf1 + 1;
 		buf2 = (const octet*)buf2 + 1;
 	}
-	return wordEq(diff, 0);
+	return diff;
+}
+
+// OR всех октетов [count]buf ^ o
+static memw memOrRep(const void* buf, octet o, size_t count)
+{
+	register memw diff = 0;
+	register memw rep = memwRep(o);
+#ifdef ECURVA_AVX2
+	__m256i d256 = _mm256_setzero_si256();
+	__m256i r256 = _mm256_set1_epi8((char)o);
+#endif
+#ifdef ECURVA_SSE2
+	__m128i d128 = _mm_setzero_si128();
+	__m128i r128 = _mm_set1_epi8((char)o);
+#endif
+#ifdef ECURVA_AVX2
+	for (; count >= 32; count -= 32)
+	{
+		d256 = _mm256_or_si256(d256, _mm256_xor_si256(
+			_mm256_loadu_si256((const __m256i*)buf), r256));
+		buf = (const octet*)buf + 32;
+	}
+	diff |= memwFold256(d256);
+#endif
+#ifdef ECURVA_SSE2
+	for (; count >= 16; count -= 16)
+	{
+		d128 = _mm_or_si128(d128, _mm_xor_si128(
+			_mm_loadu_si128((const __m128i*)buf), r128));
+		buf = (const octet*)buf + 16;
+	}
+	diff |= memwFold128(d128);
+#endif
+	for (; count >= O_PER_MW; count -= O_PER_MW)
+	{
+		diff |= memwLoad(buf) ^ rep;
+		buf = (const octet*)buf + O_PER_MW;
+	}
+	while (count--)
+	{
+		diff |= *(const octet*)buf ^ o;
+		buf = (const octet*)buf + 1;
+	}
+	return diff;
+}
+
+bool_t SAFE(memEq)(const void* buf1, const void* buf2, size_t count)
+{
+	ASSERT(memIsValid(buf1, count));
+	ASSERT(memIsValid(buf2, count));
+	return memwIsZero01(memOrXor(buf1, buf2, count));
 }
 
 bool_t FAST(memEq)(const void* buf1, const void* buf2, size_t count)
@@ -1357,9 +2318,14 @@ void memWipe(void* buf, size_t count)
 	size_t i = count;
 	ASSERT(memIsValid(buf, count));
 	// вычисления, которые должны показаться полезными оптимизатору
+	for (; i && ((size_t)p % O_PER_MW); --i)
+		*(p++) = (octet)ctr, ctr += 17 + ((size_t)p & 15);
+	// выровненные слова: один шаг счетчика на слово
+	for (; i >= O_PER_MW; i -= O_PER_MW, p += O_PER_MW)
+		*(volatile memw*)p = memwRep((octet)ctr), ctr += 17 + ((size_t)p & 15);
 	while (i--)
 		*(p++) = (octet)ctr, ctr += 17 + ((size_t)p & 15);
-	p = memchr(buf, (octet)ctr, count);
+	p = (volatile octet*)memchr(buf, (octet)ctr, count);
 	if (p)
 		ctr += (63 + (size_t)p);
 	wipe_ctr = (octet)ctr;
@@ -1367,26 +2333,31 @@ void memWipe(void* buf, size_t count)
 
 bool_t SAFE(memIsZero)(const void* buf, size_t count)
 {
-	register word diff = 0;
 	ASSERT(memIsValid(buf, count));
-	for (; count >= O_PER_W; count -= O_PER_W)
-	{
-		diff |= *(const word*)buf;
-		buf = (const word*)buf + 1;
-	}
-	while (count--)
-	{
-		diff |= *(const octet*)buf;
-		buf = (const octet*)buf + 1;
-	}
-	return (bool_t)wordEq(diff, 0);
+	return memwIsZero01(memOrRep(buf, 0, count));
 }
 
 bool_t FAST(memIsZero)(const void* buf, size_t count)
 {
 	ASSERT(memIsValid(buf, count));
-	for (; count >= O_PER_W; count -= O_PER_W, buf = (const word*)buf + 1)
-		if (*(const word*)buf)
+#ifdef ECURVA_AVX2
+	for (; count >= 32; count -= 32, buf = (const octet*)buf + 32)
+	{
+		__m256i v = _mm256_loadu_si256((const __m256i*)buf);
+		if (!_mm256_testz_si256(v, v))
+			return FALSE;
+	}
+#endif
+#ifdef ECURVA_SSE2
+	for (; count >= 16; count -= 16, buf = (const octet*)buf + 16)
+	{
+		__m128i v = _mm_loadu_si128((const __m128i*)buf);
+		if (_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_setzero_si128())) != 0xFFFF)
+			return FALSE;
+	}
+#endif
+	for (; count >= O_PER_MW; count -= O_PER_MW, buf = (const octet*)buf + O_PER_MW)
+		if (memwLoad(buf))
 			return FALSE;
 	for (; count--; buf = (const octet*)buf + 1)
 		if (*(const octet*)buf)
@@ -1405,11 +2376,8 @@ size_t memNonZeroSize(const void* buf, size_t count)
 
 bool_t SAFE(memIsRep)(const void* buf, size_t count, octet o)
 {
-	register word diff = 0;
 	ASSERT(memIsValid(buf, count));
-	for (; count--; buf = (const octet*)buf + 1)
-		diff |= *(const octet*)buf ^ o;
-	return wordEq(diff, 0);
+	return memwIsZero01(memOrRep(buf, o, count));
 }
 
 bool_t FAST(memIsRep)(const void* buf, size_t count, octet o)
@@ -1532,12 +2500,34 @@ void memXor(void* dest, const void* src1, const void* src2, size_t count)
 {
 	ASSERT(memIsSameOrDisjoint(src1, dest, count));
 	ASSERT(memIsSameOrDisjoint(src2, dest, count));
-	for (; count >= O_PER_W; count -= O_PER_W)
+#ifdef ECURVA_AVX2
+	for (; count >= 32; count -= 32)
+	{
+		_mm256_storeu_si256((__m256i*)dest, _mm256_xor_si256(
+			_mm256_loadu_si256((const __m256i*)src1),
+			_mm256_loadu_si256((const __m256i*)src2)));
+		src1 = (const octet*)src1 + 32;
+		src2 = (const octet*)src2 + 32;
+		dest = (octet*)dest + 32;
+	}
+#endif
+#ifdef ECURVA_SSE2
+	for (; count >= 16; count -= 16)
+	{
+		_mm_storeu_si128((__m128i*)dest, _mm_xor_si128(
+			_mm_loadu_si128((const __m128i*)src1),
+			_mm_loadu_si128((const __m128i*)src2)));
+		src1 = (const octet*)src1 + 16;
+		src2 = (const octet*)src2 + 16;
+		dest = (octet*)dest + 16;
+	}
+#endif
+	for (; count >= O_PER_MW; count -= O_PER_MW)
 	{
-		*(word*)dest = *(const word*)src1 ^ *(const word*)src2;
-		src1 = (const word*)src1 + 1;
-		src2 = (const word*)src2 + 1;
-		dest = (word*)dest + 1;
+		memwStore(dest, memwLoad(src1) ^ memwLoad(src2));
+		src1 = (const octet*)src1 + O_PER_MW;
+		src2 = (const octet*)src2 + O_PER_MW;
+		dest = (octet*)dest + O_PER_MW;
 	}
 	while (count--)
 	{
@@ -1551,28 +2541,41 @@ void memXor(void* dest, const void* src1, const void* src2, size_t count)
 void memXor2(void* dest, const void* src, size_t count)
 {
 	ASSERT(memIsSameOrDisjoint(src, dest, count));
-	for (; count >= O_PER_W; count -= O_PER_W)
-	{
-		*(word*)dest ^= *(const word*)src;
-		src = (const word*)src + 1;
-		dest = (word*)dest + 1;
-	}
-	while (count--)
-	{
-		*(octet*)dest ^= *(const octet*)src;
-		src = (const octet*)src + 1;
-		dest = (octet*)dest + 1;
-	}
+	memXor(dest, dest, src, count);
 }
 
 void memSwap(void* buf1, void* buf2, size_t count)
 {
 	ASSERT(memIsDisjoint(buf1, buf2, count));
-	for (; count >= O_PER_W; count -= O_PER_W)
+#ifdef ECURVA_AVX2
+	for (; count >= 32; count -= 32)
+	{
+		__m256i v1 = _mm256_loadu_si256((const __m256i*)buf1);
+		__m256i v2 = _mm256_loadu_si256((const __m256i*)buf2);
+		_mm256_storeu_si256((__m256i*)buf1, v2);
+		_mm256_storeu_si256((__m256i*)buf2, v1);
+		buf1 = (octet*)buf1 + 32;
+		buf2 = (octet*)buf2 + 32;
+	}
+#endif
+#ifdef ECURVA_SSE2
+	for (; count >= 16; count -= 16)
+	{
+		__m128i v1 = _mm_loadu_si128((const __m128i*)buf1);
+		__m128i v2 = _mm_loadu_si128((const __m128i*)buf2);
+		_mm_storeu_si128((__m128i*)buf1, v2);
+		_mm_storeu_si128((__m128i*)buf2, v1);
+		buf1 = (octet*)buf1 + 16;
+		buf2 = (octet*)buf2 + 16;
+	}
+#endif
+	for (; count >= O_PER_MW; count -= O_PER_MW)
 	{
-		SWAP(*(word*)buf1, *(word*)buf2);
-		buf1 = (word*)buf1 + 1;
-		buf2 = (word*)buf2 + 1;
+		memw w1 = memwLoad(buf1);
+		memwStore(buf1, memwLoad(buf2));
+		memwStore(buf2, w1);
+		buf1 = (octet*)buf1 + O_PER_MW;
+		buf2 = (octet*)buf2 + O_PER_MW;
 	}
 	while (count--)
 	{
@@ -1601,111 +2604,1509 @@ void memRev(void* buf, size_t count)
 }
 
 
-bool_t ecpCreateJ(ec_o* ec, const qr_o* f, const octet A[], const octet B[], 
-	void* stack)
-{
-	register bool_t bA3;
-	word* t;
-	// pre
-	ASSERT(memIsValid(ec, sizeof(ec_o)));
-	ASSERT(gfpIsOperable(f));
-	ASSERT(memIsValid(A, f->no)); 
-	ASSERT(memIsValid(B, f->no)); 
-	// обнулить
-	memSetZero(ec, sizeof(ec_o));
-	// зафикисровать размерности
-	ec->d = 3;
-	// запомнить базовое поле
-	ec->f = f;
-	// сохранить коэффициенты
-	ec->A = (word*)ec->descr;
-	ec->B = ec->A + f->n;
-	if (!qrFrom(ec->A, A, ec->f, stack) || !qrFrom(ec->B, B, ec->f, stack))
-		return FALSE;
-	// t <- -3
-	t = (word*)stack;
-	gfpDouble(t, f->unity, f);
-	zmAdd(t, t, f->unity, f);
-	zmNeg(t, t, f);
-	// bA3 <- A == -3?
-	bA3 = qrCmp(t, ec->A, f) == 0;
-	// подготовить буферы для описания группы точек
-	ec->base = ec->B + f->n;
-	ec->order = ec->base + 2 * f->n;
-	// настроить интерфейсы
-	ec->froma = ecpFromAJ;
-	ec->toa = ecpToAJ;
-	ec->neg = ecpNegJ;
-	ec->add = ecpAddJ;
-	ec->adda = ecpAddAJ;
-	ec->sub = ecpSubJ;
-	ec->suba = ecpSubAJ;
-	ec->dbl = bA3 ? ecpDblJA3 : ecpDblJ;
-	ec->dbla = ecpDblAJ;
-	ec->tpl = bA3 ? ecpTplJA3 : ecpTplJ;
-	ec->deep = utilMax(9,
-		ecpToAJ_deep(f->n, f->deep),
-		ecpAddJ_deep(f->n, f->deep),
-		ecpAddAJ_deep(f->n, f->deep),
-		ecpSubJ_deep(f->n, f->deep),
-		ecpSubAJ_deep(f->n, f->deep),
-		bA3 ? ecpDblJA3_deep(f->n, f->deep) : ecpDblJ_deep(f->n, f->deep),
-		ecpDblAJ_deep(f->n, f->deep),
-		bA3 ? ecpTplJA3_deep(f->n, f->deep) : ecpTplJ_deep(f->n, f->deep));
-	// настроить
-	ec->hdr.keep = sizeof(ec_o) + O_OF_W(5 * f->n + 1);
-	ec->hdr.p_count = 6;
-	ec->hdr.o_count = 1;
-	// все нормально
-	bA3 = 0;
-	return TRUE;
-}
+/*
+*******************************************************************************
+Утилиты
+*******************************************************************************
+*/
 
-size_t ecpCreateJ_keep(size_t n)
+void utilAssert(int e, const char* file, int line)
 {
-	return sizeof(ec_o) + O_OF_W(5 * n + 1);
+	if (!e)
+	{
+		fprintf(stderr, "Assertion in %s::%d\n", file, line);
+		abort();
+	}
 }
 
-size_t ecpCreateJ_deep(size_t n, size_t f_deep)
+size_t utilMax(size_t n, ...)
 {
-	return utilMax(11,
-		O_OF_W(n),
-		ecpToAJ_deep(n, f_deep),
-		ecpAddJ_deep(n, f_deep),
-		ecpAddAJ_deep(n, f_deep),
-		ecpSubJ_deep(n, f_deep),
-		ecpSubAJ_deep(n, f_deep),
-		ecpDblJ_deep(n, f_deep),
-		ecpDblJA3_deep(n, f_deep),
-		ecpDblAJ_deep(n, f_deep),
-		ecpTplJ_deep(n, f_deep),
-		ecpTplJA3_deep(n, f_deep));
+	size_t ret = 0;
+	size_t t;
+	va_list marker;
+	ASSERT(n > 0);
+	va_start(marker, n);
+	while (n--)
+	{
+		t = va_arg(marker, size_t);
+		if (t > ret)
+			ret = t;
+	}
+	va_end(marker);
+	return ret;
 }
 
-
 /*
 *******************************************************************************
-Создание / закрытие эллиптической кривой
+Объекты
 *******************************************************************************
 */
 
-err_t bignStart(void* state, const bign_params* params)
+static bool_t objIsOperable2(const void* obj)
 {
-	// размерности
-	size_t no, n;
-	size_t f_keep;
-	size_t ec_keep;
-	// состояние
-	qr_o* f;		/* поле */
-	ec_o* ec;		/* кривая */
-	void* stack;	/* вложенный стек */
-	// pre
-	ASSERT(memIsValid(params, sizeof(bign_params)));
-	ASSERT(params->l == 128 || params->l == 192  || params->l == 256);
-	ASSERT(memIsValid(state, bignStart_keep(params->l, 0)));
-	// определить размерности
-	no = O_OF_B(2 * params->l);
-	n = W_OF_B(2 * params->l);
+	return memIsValid(obj, sizeof(obj_hdr_t)) &&
+		objOCount(obj) <= objPCount(obj) &&
+		objKeep(obj) >= sizeof(obj_hdr_t) + objPCount(obj) * sizeof(void*) &&
+		memIsValid(obj, objKeep(obj));
+}
+
+bool_t objIsOperable(const void* obj)
+{
+	size_t i;
+	if (!objIsOperable2(obj))
+		return FALSE;
+	for (i = 0; i < objOCount(obj); ++i)
+		if (!objIsOperable(objPtr(obj, i)))
+			return FALSE;
+	return TRUE;
+}
+
+/*
+	Объект obj перемещен из [keep]old (вместе с вложенными объектами).
+	Указатели внутрь old сдвигаются на diff.
+*/
+static void objShiftPtrs(void* obj, const octet* old, size_t keep,
+	ptrdiff_t diff)
+{
+	const octet* ptr;
+	size_t i;
+	for (i = 0; i < objPCount(obj); ++i)
+	{
+		ptr = (const octet*)objPtr(obj, i);
+		if (ptr >= old && ptr < old + keep)
+		{
+			objPtr(obj, i) = (void*)(ptr + diff);
+			if (i < objOCount(obj))
+				objShiftPtrs(objPtr(obj, i), old, keep, diff);
+		}
+	}
+}
+
+void objAppend(void* obj, const void* obj1, size_t i)
+{
+	size_t keep1;
+	octet* dest;
+	// pre
+	ASSERT(objIsOperable2(obj));
+	ASSERT(objIsOperable(obj1));
+	ASSERT(i < objOCount(obj));
+	// скопировать obj1 в конец obj
+	keep1 = objKeep(obj1);
+	dest = (octet*)obj + objKeep(obj);
+	if (dest != (const octet*)obj1)
+	{
+		memMove(dest, obj1, keep1);
+		objShiftPtrs(dest, (const octet*)obj1, keep1,
+			dest - (const octet*)obj1);
+	}
+	// встроить копию
+	objPtr(obj, i) = dest;
+	objHdr(obj)->keep += keep1;
+}
+
+/*
+*******************************************************************************
+Слова
+*******************************************************************************
+*/
+
+#if (B_PER_W == 16)
+
+void u16Rev2(u16 buf[], size_t count)
+{
+	while (count--)
+		buf[count] = u16Rev(buf[count]);
+}
+
+void u16From(u16 dest[], const void* src, size_t count)
+{
+	wwFrom(dest, src, count);
+}
+
+void u16To(void* dest, size_t count, const u16 src[])
+{
+	wwTo(dest, count, src);
+}
+
+#elif (B_PER_W == 32)
+
+void u32Rev2(u32 buf[], size_t count)
+{
+	while (count--)
+		buf[count] = u32Rev(buf[count]);
+}
+
+void u32From(u32 dest[], const void* src, size_t count)
+{
+	wwFrom(dest, src, count);
+}
+
+void u32To(void* dest, size_t count, const u32 src[])
+{
+	wwTo(dest, count, src);
+}
+
+#else
+
+void u64Rev2(u64 buf[], size_t count)
+{
+	while (count--)
+		buf[count] = u64Rev(buf[count]);
+}
+
+void u64From(u64 dest[], const void* src, size_t count)
+{
+	wwFrom(dest, src, count);
+}
+
+void u64To(void* dest, size_t count, const u64 src[])
+{
+	wwTo(dest, count, src);
+}
+
+#endif /* B_PER_W */
+
+word wordNegInv(register word w)
+{
+	register word ret = w;
+	// w w == 1 (mod 8) => ret -- обратное к w (mod 2^3).
+	// Итерация Ньютона удваивает число верных битов
+	ASSERT(w & 1);
+	ret *= 2 - w * ret;
+	ret *= 2 - w * ret;
+	ret *= 2 - w * ret;
+#if (B_PER_W > 32)
+	ret *= 2 - w * ret;
+#endif
+#if (B_PER_W > 16)
+	ret *= 2 - w * ret;
+#endif
+	return WORD_0 - ret;
+}
+
+/*
+*******************************************************************************
+Массивы слов
+*******************************************************************************
+*/
+
+void wwFrom(word b[], const void* a, size_t count)
+{
+	size_t i;
+	ASSERT(memIsValid(a, count));
+	ASSERT(memIsDisjoint2(a, count, b, O_OF_W(W_OF_O(count))));
+	wwSetZero(b, W_OF_O(count));
+	for (i = 0; i < count; ++i)
+		b[i / O_PER_W] |= (word)((const octet*)a)[i] << 8 * (i % O_PER_W);
+}
+
+void wwTo(void* b, size_t count, const word a[])
+{
+	size_t i;
+	ASSERT(memIsValid(b, count));
+	ASSERT(memIsDisjoint2(a, O_OF_W(W_OF_O(count)), b, count));
+	for (i = 0; i < count; ++i)
+		((octet*)b)[i] = (octet)(a[i / O_PER_W] >> 8 * (i % O_PER_W));
+}
+
+void wwCopy(word b[], const word a[], size_t n)
+{
+	ASSERT(memIsSameOrDisjoint(a, b, O_OF_W(n)));
+	if (a != b)
+		while (n--)
+			b[n] = a[n];
+}
+
+void wwSetZero(word a[], size_t n)
+{
+	while (n--)
+		a[n] = 0;
+}
+
+void wwSetW(word a[], size_t n, register word w)
+{
+	ASSERT(n > 0);
+	a[0] = w;
+	while (--n)
+		a[n] = 0;
+}
+
+bool_t wwIsZero(const word a[], size_t n)
+{
+	register word diff = 0;
+	while (n--)
+		diff |= a[n];
+	return wordEq(diff, 0);
+}
+
+int wwCmp(const word a[], const word b[], size_t n)
+{
+	while (n--)
+		if (a[n] != b[n])
+			return a[n] > b[n] ? 1 : -1;
+	return 0;
+}
+
+int wwCmpW(const word a[], size_t n, register word w)
+{
+	if (n == 0)
+		return w ? -1 : 0;
+	while (--n)
+		if (a[n])
+			return 1;
+	return a[0] > w ? 1 : (a[0] < w ? -1 : 0);
+}
+
+bool_t wwTestBit(const word a[], size_t pos)
+{
+	return (bool_t)(a[pos / B_PER_W] >> pos % B_PER_W & WORD_1);
+}
+
+word wwGetBits(const word a[], size_t pos, size_t width)
+{
+	register word ret;
+	const size_t n = pos / B_PER_W;
+	ASSERT(width <= B_PER_W);
+	pos %= B_PER_W;
+	ret = a[n] >> pos;
+	if (pos + width > B_PER_W)
+		ret |= a[n + 1] << (B_PER_W - pos);
+	if (width < B_PER_W)
+		ret &= WORD_BIT_POS(width) - 1;
+	return ret;
+}
+
+void wwSetBits(word a[], size_t pos, size_t width, register word val)
+{
+	register word mask;
+	const size_t n = pos / B_PER_W;
+	ASSERT(width <= B_PER_W);
+	pos %= B_PER_W;
+	mask = width < B_PER_W ? WORD_BIT_POS(width) - 1 : WORD_MAX;
+	val &= mask;
+	a[n] = (a[n] & ~(mask << pos)) | val << pos;
+	if (pos + width > B_PER_W)
+		a[n + 1] = (a[n + 1] & ~(mask >> (B_PER_W - pos))) |
+			val >> (B_PER_W - pos);
+}
+
+size_t wwBitSize(const word a[], size_t n)
+{
+	register word w;
+	size_t ret;
+	while (n && a[n - 1] == 0)
+		--n;
+	if (n == 0)
+		return 0;
+	ret = B_OF_W(n - 1);
+	for (w = a[n - 1]; w; w >>= 1)
+		++ret;
+	return ret;
+}
+
+/*
+	Символы NAF получаются от младших к старшим. Окно window содержит
+	текущий остаток числа по модулю 2^w (и, может быть, перенос 2^w).
+	Нечетное окно дает символ window или window - 2^w (если старший бит
+	окна ненулевой), после вычитания символа окно становится равным 0
+	или 2^w. Четное окно дает нулевой символ. Затем окно сдвигается на
+	один бит и пополняется следующим битом числа.
+
+	Символы записываются начиная со старшего, поэтому сначала
+	определяется длина NAF в битах, а затем символы записываются с конца.
+*/
+size_t wwNAF(word naf[], const word a[], size_t n, size_t w)
+{
+	const word next_bit = WORD_BIT_POS(w);
+	const word hi_bit = next_bit >> 1;
+	const size_t a_len = wwBitSize(a, n);
+	register word window;
+	register size_t naf_len;
+	register size_t naf_size;
+	size_t pos;
+	size_t i;
+	// pre
+	ASSERT(2 <= w && w < B_PER_W);
+	ASSERT(memIsDisjoint2(a, O_OF_W(n), naf, O_OF_W(2 * n + 1)));
+	// naf <- 0
+	wwSetZero(naf, 2 * n + 1);
+	if (a_len == 0)
+		return 0;
+	// длина NAF
+	naf_len = naf_size = 0;
+	window = wwGetBits(a, 0, w);
+	for (i = w; window || i < a_len; ++i)
+	{
+		if (window & 1)
+			window = (window & hi_bit) ? next_bit : 0, naf_len += w;
+		else
+			++naf_len;
+		++naf_size;
+		window >>= 1;
+		if (i < a_len)
+			window += (word)wwTestBit(a, i) << (w - 1);
+	}
+	// запись символов от младших (в конце naf) к старшим
+	pos = naf_len;
+	window = wwGetBits(a, 0, w);
+	for (i = w; window || i < a_len; ++i)
+	{
+		if (window & 1)
+		{
+			pos -= w;
+			if (window & hi_bit)
+			{
+				wwSetBits(naf, pos, w, (next_bit - window) | hi_bit);
+				window = next_bit;
+			}
+			else
+			{
+				wwSetBits(naf, pos, w, window);
+				window = 0;
+			}
+		}
+		else
+			--pos;
+		window >>= 1;
+		if (i < a_len)
+			window += (word)wwTestBit(a, i) << (w - 1);
+	}
+	ASSERT(pos == 0);
+	window = 0;
+	return naf_size;
+}
+
+/*
+*******************************************************************************
+Натуральные числа
+*******************************************************************************
+*/
+
+word zzAdd(word c[], const word a[], const word b[], size_t n)
+{
+	register dword sum;
+	register word carry = 0;
+	size_t i;
+	for (i = 0; i < n; ++i)
+	{
+		sum = (dword)a[i] + b[i] + carry;
+		c[i] = (word)sum;
+		carry = (word)(sum >> B_PER_W);
+	}
+	sum = 0;
+	return carry;
+}
+
+word zzAddW(word b[], const word a[], size_t n, register word w)
+{
+	size_t i;
+	for (i = 0; i < n; ++i)
+	{
+		b[i] = a[i] + w;
+		w = wordLess01(b[i], w);
+	}
+	return w;
+}
+
+word zzAddW2(word a[], size_t n, register word w)
+{
+	return zzAddW(a, a, n, w);
+}
+
+word zzAddAndW(word b[], const word a[], size_t n, register word w)
+{
+	register dword sum;
+	register word carry = 0;
+	size_t i;
+	for (i = 0; i < n; ++i)
+	{
+		sum = (dword)b[i] + (a[i] & w) + carry;
+		b[i] = (word)sum;
+		carry = (word)(sum >> B_PER_W);
+	}
+	sum = 0;
+	return carry;
+}
+
+word zzSub(word c[], const word a[], const word b[], size_t n)
+{
+	register dword diff;
+	register word borrow = 0;
+	size_t i;
+	for (i = 0; i < n; ++i)
+	{
+		diff = (dword)a[i] - b[i] - borrow;
+		c[i] = (word)diff;
+		borrow = (word)(diff >> B_PER_W) & WORD_1;
+	}
+	diff = 0;
+	return borrow;
+}
+
+word zzSub2(word b[], const word a[], size_t n)
+{
+	return zzSub(b, b, a, n);
+}
+
+word zzSubW2(word a[], size_t n, register word w)
+{
+	register word t;
+	size_t i;
+	for (i = 0; i < n; ++i)
+	{
+		t = a[i];
+		a[i] = t - w;
+		w = wordLess01(t, w);
+	}
+	return w;
+}
+
+word zzAddMulW(word b[], const word a[], size_t n, register word w)
+{
+	register dword prod;
+	register word carry = 0;
+	size_t i;
+	for (i = 0; i < n; ++i)
+	{
+		prod = (dword)a[i] * w + b[i] + carry;
+		b[i] = (word)prod;
+		carry = (word)(prod >> B_PER_W);
+	}
+	prod = 0;
+	return carry;
+}
+
+void zzMul(word c[], const word a[], size_t n, const word b[], size_t m,
+	void* stack)
+{
+	size_t i;
+	(void)stack;
+	ASSERT(memIsDisjoint2(a, O_OF_W(n), c, O_OF_W(n + m)));
+	ASSERT(memIsDisjoint2(b, O_OF_W(m), c, O_OF_W(n + m)));
+	wwSetZero(c, n + m);
+	for (i = 0; i < n; ++i)
+		c[i + m] = zzAddMulW(c + i, b, m, a[i]);
+}
+
+void zzSqr(word b[], const word a[], size_t n, void* stack)
+{
+	register dword prod;
+	register word carry;
+	register word w;
+	size_t i;
+	(void)stack;
+	ASSERT(memIsDisjoint2(a, O_OF_W(n), b, O_OF_W(2 * n)));
+	// b <- \sum_{i < j} a[i] a[j] B^{i + j}
+	wwSetZero(b, 2 * n);
+	for (i = 0; i + 1 < n; ++i)
+		b[i + n] = zzAddMulW(b + 2 * i + 1, a + i + 1, n - i - 1, a[i]);
+	// b <- 2 b
+	for (i = 0, carry = 0; i < 2 * n; ++i)
+	{
+		w = b[i];
+		b[i] = w << 1 | carry;
+		carry = w >> (B_PER_W - 1);
+	}
+	// b <- b + \sum a[i]^2 B^{2i}
+	for (i = 0, carry = 0; i < n; ++i)
+	{
+		prod = (dword)a[i] * a[i] + b[2 * i] + carry;
+		b[2 * i] = (word)prod;
+		prod = (dword)b[2 * i + 1] + (word)(prod >> B_PER_W);
+		b[2 * i + 1] = (word)prod;
+		carry = (word)(prod >> B_PER_W);
+	}
+	prod = 0;
+	w = carry = 0;
+}
+
+void zzAddMod(word c[], const word a[], const word b[], const word mod[],
+	size_t n)
+{
+	register word carry;
+	register word borrow;
+	// c <- a + b - mod, при заеме без переноса c <- c + mod
+	carry = zzAdd(c, a, b, n);
+	borrow = zzSub2(c, mod, n);
+	zzAddAndW(c, mod, n, WORD_0 - (borrow & (carry ^ WORD_1)));
+	carry = borrow = 0;
+}
+
+void zzSubMod(word c[], const word a[], const word b[], const word mod[],
+	size_t n)
+{
+	register word borrow;
+	// c <- a - b, при заеме c <- c + mod
+	borrow = zzSub(c, a, b, n);
+	zzAddAndW(c, mod, n, WORD_0 - borrow);
+	borrow = 0;
+}
+
+void zzNegMod(word b[], const word a[], const word mod[], size_t n)
+{
+	register word mask = 0;
+	size_t i;
+	// mask <- a == 0 ? WORD_MAX : 0
+	for (i = 0; i < n; ++i)
+		mask |= a[i];
+	mask = wordEq0M(mask, 0);
+	// b <- a == 0 ? 0 : mod - a
+	zzSub(b, mod, a, n);
+	for (i = 0; i < n; ++i)
+		b[i] &= ~mask;
+	mask = 0;
+}
+
+void zzRedMont(word a[], const word mod[], size_t n, register word mont_param,
+	void* stack)
+{
+	register dword sum;
+	register word carry = 0;
+	register word w;
+	size_t i;
+	(void)stack;
+	ASSERT(zzIsOdd(mod, n));
+	// a <- (a + w mod B^i) / B^i для слов w, зануляющих младшие слова a
+	for (i = 0; i < n; ++i)
+	{
+		w = a[i] * mont_param;
+		sum = (dword)a[i + n] + zzAddMulW(a + i, mod, n, w) + carry;
+		a[i + n] = (word)sum;
+		carry = (word)(sum >> B_PER_W);
+	}
+	// a + carry B^n < 2 mod => вычесть mod
+	w = zzSub2(a + n, mod, n);
+	zzAddAndW(a + n, mod, n, WORD_0 - (w & (carry ^ WORD_1)));
+	wwCopy(a, a + n, n);
+	sum = 0;
+	carry = w = 0;
+}
+
+void zzRedCrand(word a[], const word mod[], size_t n, void* stack)
+{
+	register dword prod;
+	register word carry;
+	const word c = WORD_0 - mod[0];
+	(void)stack;
+	ASSERT(c < WORD_BIT_HALF);
+	// B^n == c (mod mod) => a <- a_lo + a_hi c, перенос carry <= c
+	carry = zzAddMulW(a, a + n, n, c);
+	// a <- a + carry c, carry c < B
+	prod = (dword)carry * c;
+	carry = zzAddW2(a, n, (word)prod);
+	// перенос B^n == c: a < c^2 до добавления, поэтому переноса нет
+	zzAddW2(a, n, c & (WORD_0 - carry));
+	// a >= mod <=> a + c >= B^n
+	carry = zzAddW(a + n, a, n, c);
+	for (prod = WORD_0 - carry, carry = 0; carry < n; ++carry)
+		a[carry] = ((word)prod & a[carry + n]) | (~(word)prod & a[carry]);
+	prod = 0;
+	carry = 0;
+}
+
+/*
+*******************************************************************************
+Простое поле
+
+Для модуля Крэндалла p = B^n - c в params хранится [1]c, для модуля
+Монтгомери -- [n + 1](mont_param || R^2 mod p). В unity хранится
+представление единицы: 1 или R mod p, R = B^n.
+*******************************************************************************
+*/
+
+static void zmAddMod(word c[], const word a[], const word b[],
+	const qr_o* r)
+{
+	zzAddMod(c, a, b, r->mod, r->n);
+}
+
+static void zmSubMod(word c[], const word a[], const word b[],
+	const qr_o* r)
+{
+	zzSubMod(c, a, b, r->mod, r->n);
+}
+
+static void zmNegMod(word b[], const word a[], const qr_o* r)
+{
+	zzNegMod(b, a, r->mod, r->n);
+}
+
+static bool_t zmFromCrand(word b[], const octet a[], const qr_o* r,
+	void* stack)
+{
+	(void)stack;
+	wwFrom(b, a, r->no);
+	return wwCmp(b, r->mod, r->n) < 0;
+}
+
+static void zmToCrand(octet b[], const word a[], const qr_o* r, void* stack)
+{
+	(void)stack;
+	wwTo(b, r->no, a);
+}
+
+static void zmMulCrand(word c[], const word a[], const word b[],
+	const qr_o* r, void* stack)
+{
+	word* prod = (word*)stack;
+	stack = prod + 2 * r->n;
+	zzMul(prod, a, r->n, b, r->n, stack);
+	zzRedCrand(prod, r->mod, r->n, stack);
+	wwCopy(c, prod, r->n);
+}
+
+static void zmSqrCrand(word b[], const word a[], const qr_o* r, void* stack)
+{
+	word* prod = (word*)stack;
+	stack = prod + 2 * r->n;
+	zzSqr(prod, a, r->n, stack);
+	zzRedCrand(prod, r->mod, r->n, stack);
+	wwCopy(b, prod, r->n);
+}
+
+static void zmMulMont(word c[], const word a[], const word b[],
+	const qr_o* r, void* stack)
+{
+	word* prod = (word*)stack;
+	stack = prod + 2 * r->n;
+	zzMul(prod, a, r->n, b, r->n, stack);
+	zzRedMont(prod, r->mod, r->n, *(const word*)r->params, stack);
+	wwCopy(c, prod, r->n);
+}
+
+static void zmSqrMont(word b[], const word a[], const qr_o* r, void* stack)
+{
+	word* prod = (word*)stack;
+	stack = prod + 2 * r->n;
+	zzSqr(prod, a, r->n, stack);
+	zzRedMont(prod, r->mod, r->n, *(const word*)r->params, stack);
+	wwCopy(b, prod, r->n);
+}
+
+static bool_t zmFromMont(word b[], const octet a[], const qr_o* r,
+	void* stack)
+{
+	wwFrom(b, a, r->no);
+	if (wwCmp(b, r->mod, r->n) >= 0)
+		return FALSE;
+	// b <- b R^2 R^{-1}
+	zmMulMont(b, b, (const word*)r->params + 1, r, stack);
+	return TRUE;
+}
+
+static void zmToMont(octet b[], const word a[], const qr_o* r, void* stack)
+{
+	word* t = (word*)stack;
+	stack = t + 2 * r->n;
+	// b <- a R^{-1}
+	wwCopy(t, a, r->n);
+	wwSetZero(t + r->n, r->n);
+	zzRedMont(t, r->mod, r->n, *(const word*)r->params, stack);
+	wwTo(b, r->no, t);
+}
+
+/*
+	Обращение возведением в степень p - 2 (малая теорема Ферма).
+	Показатель открыт, поэтому время обращения не зависит от a.
+*/
+static void zmInvFermat(word b[], const word a[], const qr_o* r,
+	void* stack)
+{
+	word* e = (word*)stack;
+	word* t = e + r->n;
+	size_t i;
+	stack = t + r->n;
+	// e <- p - 2
+	wwCopy(e, r->mod, r->n);
+	zzSubW2(e, r->n, 2);
+	// t <- a^e
+	qrSetUnity(t, r);
+	for (i = wwBitSize(e, r->n); i--;)
+	{
+		qrSqr(t, t, r, stack);
+		if (wwTestBit(e, i))
+			qrMul(t, t, a, r, stack);
+	}
+	qrCopy(b, t, r);
+}
+
+static void zmDivFermat(word b[], const word divident[], const word a[],
+	const qr_o* r, void* stack)
+{
+	word* t = (word*)stack;
+	stack = t + r->n;
+	zmInvFermat(t, a, r, stack);
+	qrMul(b, divident, t, r, stack);
+}
+
+bool_t qrIsOperable(const qr_o* r)
+{
+	return objIsOperable(r) &&
+		objPCount(r) >= 3 &&
+		r->n > 0 && r->no > 0 && r->no <= O_OF_W(r->n) &&
+		memIsValid(r->mod, O_OF_W(r->n)) &&
+		memIsValid(r->unity, O_OF_W(r->n)) &&
+		r->from != 0 && r->to != 0 &&
+		r->add != 0 && r->sub != 0 && r->neg != 0 &&
+		r->mul != 0 && r->sqr != 0 && r->inv != 0 && r->div != 0;
+}
+
+bool_t gfpCreate(qr_o* f, const octet p[], size_t no, void* stack)
+{
+	const size_t n = W_OF_O(no);
+	word* params;
+	size_t i;
+	(void)stack;
+	// pre
+	ASSERT(memIsValid(f, gfpCreate_keep(no)));
+	ASSERT(memIsValid(p, no));
+	// минимальные проверки p
+	if (no == 0 || p[no - 1] == 0 || p[0] % 2 == 0 || (no == 1 && p[0] < 3))
+		return FALSE;
+	// разметить описание
+	memSetZero(f, sizeof(qr_o));
+	f->n = n;
+	f->no = no;
+	f->mod = (word*)f->descr;
+	f->unity = f->mod + n;
+	f->params = params = f->unity + n;
+	wwFrom(f->mod, p, no);
+	// интерфейсы, не зависящие от представления
+	f->add = zmAddMod;
+	f->sub = zmSubMod;
+	f->neg = zmNegMod;
+	f->inv = zmInvFermat;
+	f->div = zmDivFermat;
+	// модуль Крэндалла?
+	for (i = 1; i < n && f->mod[i] == WORD_MAX; ++i);
+	if (i == n && WORD_0 - f->mod[0] < WORD_BIT_HALF)
+	{
+		params[0] = WORD_0 - f->mod[0];
+		wwSetW(f->unity, n, 1);
+		f->from = zmFromCrand;
+		f->to = zmToCrand;
+		f->mul = zmMulCrand;
+		f->sqr = zmSqrCrand;
+	}
+	else
+	{
+		params[0] = wordNegInv(f->mod[0]);
+		// unity <- R mod p, params + 1 <- R^2 mod p
+		wwSetW(f->unity, n, 1);
+		for (i = 0; i < B_OF_W(n); ++i)
+			zzDoubleMod(f->unity, f->unity, f->mod, n);
+		wwCopy(params + 1, f->unity, n);
+		for (i = 0; i < B_OF_W(n); ++i)
+			zzDoubleMod(params + 1, params + 1, f->mod, n);
+		f->from = zmFromMont;
+		f->to = zmToMont;
+		f->mul = zmMulMont;
+		f->sqr = zmSqrMont;
+	}
+	f->deep = gfpCreate_deep(no);
+	// настроить заголовок
+	f->hdr.keep = gfpCreate_keep(no);
+	f->hdr.p_count = 3;
+	f->hdr.o_count = 0;
+	return TRUE;
+}
+
+size_t gfpCreate_keep(size_t no)
+{
+	const size_t n = W_OF_O(no);
+	return sizeof(qr_o) + O_OF_W(3 * n + 1);
+}
+
+size_t gfpCreate_deep(size_t no)
+{
+	const size_t n = W_OF_O(no);
+	// zmDivFermat(): t, e, t, произведение
+	return O_OF_W(5 * n);
+}
+
+bool_t gfpIsOperable(const qr_o* f)
+{
+	return qrIsOperable(f) &&
+		zzIsOdd(f->mod, f->n) && wwCmpW(f->mod, f->n, 3) >= 0 &&
+		f->mod[f->n - 1] != 0;
+}
+
+/*
+*******************************************************************************
+Общие функции кривых
+*******************************************************************************
+*/
+
+bool_t ecIsOperable(const ec_o* ec)
+{
+	return objIsOperable(ec) &&
+		objPCount(ec) >= 6 && objOCount(ec) >= 1 &&
+		qrIsOperable(ec->f) &&
+		ec->d >= 3 &&
+		memIsValid(ec->A, O_OF_W(ec->f->n)) &&
+		memIsValid(ec->B, O_OF_W(ec->f->n)) &&
+		memIsValid(ec->base, O_OF_W(2 * ec->f->n)) &&
+		memIsValid(ec->order, O_OF_W(ec->f->n + 1)) &&
+		ec->froma != 0 && ec->toa != 0 && ec->neg != 0 &&
+		ec->add != 0 && ec->adda != 0 && ec->sub != 0 && ec->suba != 0 &&
+		ec->dbl != 0 && ec->dbla != 0;
+}
+
+bool_t ecCreateGroup(ec_o* ec, const octet xG[], const octet yG[],
+	const octet q[], size_t no, u32 cofactor, void* stack)
+{
+	const size_t n = ec->f->n;
+	// pre
+	ASSERT(memIsValid(ec, sizeof(ec_o)));
+	ASSERT(memIsNullOrValid(xG, ec->f->no));
+	ASSERT(memIsNullOrValid(yG, ec->f->no));
+	ASSERT(memIsValid(q, no));
+	// порядок помещается в n + 1 слов?
+	if (W_OF_O(no) > n + 1)
+		return FALSE;
+	// базовая точка
+	if (xG)
+	{
+		if (!qrFrom(ecX(ec->base), xG, ec->f, stack))
+			return FALSE;
+	}
+	else
+		qrSetZero(ecX(ec->base), ec->f);
+	if (yG)
+	{
+		if (!qrFrom(ecY(ec->base, n), yG, ec->f, stack))
+			return FALSE;
+	}
+	else
+		qrSetZero(ecY(ec->base, n), ec->f);
+	// порядок и кофактор
+	wwFrom(ec->order, q, no);
+	wwSetZero(ec->order + W_OF_O(no), n + 1 - W_OF_O(no));
+	ec->cofactor = (word)cofactor;
+	return TRUE;
+}
+
+size_t ecCreateGroup_deep(size_t f_deep)
+{
+	return f_deep;
+}
+
+/*
+	При ширине w ecMulA() выполняет около l / (w + 1) сложений и
+	2^{w - 2} сложений при расчете таблицы.
+*/
+size_t ecNAFWidth(size_t l)
+{
+	if (l >= 336)
+		return 6;
+	else if (l >= 120)
+		return 5;
+	else if (l >= 40)
+		return 4;
+	return 3;
+}
+
+/*
+*******************************************************************************
+Якобиевы координаты
+
+Формулы: удвоение -- dbl-1998-cmo-2, сложение -- add-1998-cmo-2,
+сложение с аффинной точкой -- madd-2004-hmv (см. Explicit-Formulas Database,
+https://hyperelliptic.org/EFD/g1p/auto-shortw-jacobian.html).
+Бесконечно удаленной точке соответствует Z == 0. Выходная точка
+записывается после того, как входные точки прочитаны, поэтому выходной
+буфер может совпадать со входным.
+*******************************************************************************
+*/
+
+bool_t ecpFromAJ(word b[], const word a[], const ec_o* ec, void* stack)
+{
+	const size_t n = ec->f->n;
+	(void)stack;
+	// pre
+	ASSERT(ecIsOperable(ec) && ec->d == 3);
+	// (x, y) -> (x : y : 1)
+	qrCopy(ecX(b), ecX(a), ec->f);
+	qrCopy(ecY(b, n), ecY(a, n), ec->f);
+	qrSetUnity(ecZ(b, n), ec->f);
+	return TRUE;
+}
+
+bool_t ecpToAJ(word b[], const word a[], const ec_o* ec, void* stack)
+{
+	const size_t n = ec->f->n;
+	// переменные в stack
+	word* t1 = (word*)stack;
+	word* t2 = t1 + n;
+	stack = t2 + n;
+	// pre
+	ASSERT(ecIsOperable(ec) && ec->d == 3);
+	// a == O => b == O
+	if (ecIsO(a, ec))
+		return FALSE;
+	// t1 <- Z^{-1}
+	qrInv(t1, ecZ(a, n), ec->f, stack);
+	// t2 <- t1^2
+	qrSqr(t2, t1, ec->f, stack);
+	// xb <- X t2
+	qrMul(ecX(b), ecX(a), t2, ec->f, stack);
+	// t2 <- t2 t1
+	qrMul(t2, t2, t1, ec->f, stack);
+	// yb <- Y t2
+	qrMul(ecY(b, n), ecY(a, n), t2, ec->f, stack);
+	return TRUE;
+}
+
+size_t ecpToAJ_deep(size_t n, size_t f_deep)
+{
+	return O_OF_W(2 * n) + f_deep;
+}
+
+void ecpNegJ(word b[], const word a[], const ec_o* ec, void* stack)
+{
+	const size_t n = ec->f->n;
+	(void)stack;
+	// pre
+	ASSERT(ecIsOperable(ec) && ec->d == 3);
+	// (X : Y : Z) -> (X : -Y : Z)
+	qrCopy(ecX(b), ecX(a), ec->f);
+	zmNeg(ecY(b, n), ecY(a, n), ec->f);
+	qrCopy(ecZ(b, n), ecZ(a, n), ec->f);
+}
+
+void ecpDblJ(word b[], const word a[], const ec_o* ec, void* stack)
+{
+	const size_t n = ec->f->n;
+	// переменные в stack
+	word* t1 = (word*)stack;
+	word* t2 = t1 + n;
+	word* t3 = t2 + n;
+	word* t4 = t3 + n;
+	stack = t4 + n;
+	// pre
+	ASSERT(ecIsOperable(ec) && ec->d == 3);
+	// t1 <- Z^2
+	qrSqr(t1, ecZ(a, n), ec->f, stack);
+	// t2 <- A Z^4
+	qrSqr(t2, t1, ec->f, stack);
+	qrMul(t2, t2, ec->A, ec->f, stack);
+	// t3 <- 3 X^2 + A Z^4 (M)
+	qrSqr(t1, ecX(a), ec->f, stack);
+	gfpDouble(t3, t1, ec->f);
+	zmAdd(t3, t3, t1, ec->f);
+	zmAdd(t3, t3, t2, ec->f);
+	// t4 <- 2 Y Z (Z3)
+	qrMul(t4, ecY(a, n), ecZ(a, n), ec->f, stack);
+	gfpDouble(t4, t4, ec->f);
+	// t1 <- Y^2
+	qrSqr(t1, ecY(a, n), ec->f, stack);
+	// t2 <- 4 X Y^2 (S)
+	qrMul(t2, ecX(a), t1, ec->f, stack);
+	gfpDouble(t2, t2, ec->f);
+	gfpDouble(t2, t2, ec->f);
+	// t1 <- 8 Y^4
+	qrSqr(t1, t1, ec->f, stack);
+	gfpDouble(t1, t1, ec->f);
+	gfpDouble(t1, t1, ec->f);
+	gfpDouble(t1, t1, ec->f);
+	// Xb <- M^2 - 2 S
+	qrSqr(ecX(b), t3, ec->f, stack);
+	zmSub(ecX(b), ecX(b), t2, ec->f);
+	zmSub(ecX(b), ecX(b), t2, ec->f);
+	// Yb <- M (S - Xb) - 8 Y^4
+	zmSub(t2, t2, ecX(b), ec->f);
+	qrMul(t2, t2, t3, ec->f, stack);
+	zmSub(ecY(b, n), t2, t1, ec->f);
+	// Zb <- Z3
+	qrCopy(ecZ(b, n), t4, ec->f);
+}
+
+size_t ecpDblJ_deep(size_t n, size_t f_deep)
+{
+	return O_OF_W(4 * n) + f_deep;
+}
+
+void ecpDblJA3(word b[], const word a[], const ec_o* ec, void* stack)
+{
+	const size_t n = ec->f->n;
+	// переменные в stack
+	word* t1 = (word*)stack;
+	word* t2 = t1 + n;
+	word* t3 = t2 + n;
+	word* t4 = t3 + n;
+	stack = t4 + n;
+	// pre
+	ASSERT(ecIsOperable(ec) && ec->d == 3);
+	// t1 <- Z^2
+	qrSqr(t1, ecZ(a, n), ec->f, stack);
+	// t3 <- 3 (X - Z^2)(X + Z^2) (M)
+	zmSub(t2, ecX(a), t1, ec->f);
+	zmAdd(t1, ecX(a), t1, ec->f);
+	qrMul(t3, t1, t2, ec->f, stack);
+	gfpDouble(t1, t3, ec->f);
+	zmAdd(t3, t3, t1, ec->f);
+	// t4 <- 2 Y Z (Z3)
+	qrMul(t4, ecY(a, n), ecZ(a, n), ec->f, stack);
+	gfpDouble(t4, t4, ec->f);
+	// t1 <- Y^2
+	qrSqr(t1, ecY(a, n), ec->f, stack);
+	// t2 <- 4 X Y^2 (S)
+	qrMul(t2, ecX(a), t1, ec->f, stack);
+	gfpDouble(t2, t2, ec->f);
+	gfpDouble(t2, t2, ec->f);
+	// t1 <- 8 Y^4
+	qrSqr(t1, t1, ec->f, stack);
+	gfpDouble(t1, t1, ec->f);
+	gfpDouble(t1, t1, ec->f);
+	gfpDouble(t1, t1, ec->f);
+	// Xb <- M^2 - 2 S
+	qrSqr(ecX(b), t3, ec->f, stack);
+	zmSub(ecX(b), ecX(b), t2, ec->f);
+	zmSub(ecX(b), ecX(b), t2, ec->f);
+	// Yb <- M (S - Xb) - 8 Y^4
+	zmSub(t2, t2, ecX(b), ec->f);
+	qrMul(t2, t2, t3, ec->f, stack);
+	zmSub(ecY(b, n), t2, t1, ec->f);
+	// Zb <- Z3
+	qrCopy(ecZ(b, n), t4, ec->f);
+}
+
+size_t ecpDblJA3_deep(size_t n, size_t f_deep)
+{
+	return O_OF_W(4 * n) + f_deep;
+}
+
+void ecpDblAJ(word b[], const word a[], const ec_o* ec, void* stack)
+{
+	const size_t n = ec->f->n;
+	// переменные в stack
+	word* t1 = (word*)stack;
+	word* t2 = t1 + n;
+	word* t3 = t2 + n;
+	word* t4 = t3 + n;
+	stack = t4 + n;
+	// pre
+	ASSERT(ecIsOperable(ec) && ec->d == 3);
+	// t3 <- 3 x^2 + A (M)
+	qrSqr(t1, ecX(a), ec->f, stack);
+	gfpDouble(t3, t1, ec->f);
+	zmAdd(t3, t3, t1, ec->f);
+	zmAdd(t3, t3, ec->A, ec->f);
+	// t4 <- 2 y (Z3)
+	gfpDouble(t4, ecY(a, n), ec->f);
+	// t1 <- y^2
+	qrSqr(t1, ecY(a, n), ec->f, stack);
+	// t2 <- 4 x y^2 (S)
+	qrMul(t2, ecX(a), t1, ec->f, stack);
+	gfpDouble(t2, t2, ec->f);
+	gfpDouble(t2, t2, ec->f);
+	// t1 <- 8 y^4
+	qrSqr(t1, t1, ec->f, stack);
+	gfpDouble(t1, t1, ec->f);
+	gfpDouble(t1, t1, ec->f);
+	gfpDouble(t1, t1, ec->f);
+	// Xb <- M^2 - 2 S
+	qrSqr(ecX(b), t3, ec->f, stack);
+	zmSub(ecX(b), ecX(b), t2, ec->f);
+	zmSub(ecX(b), ecX(b), t2, ec->f);
+	// Yb <- M (S - Xb) - 8 y^4
+	zmSub(t2, t2, ecX(b), ec->f);
+	qrMul(t2, t2, t3, ec->f, stack);
+	zmSub(ecY(b, n), t2, t1, ec->f);
+	// Zb <- Z3
+	qrCopy(ecZ(b, n), t4, ec->f);
+}
+
+size_t ecpDblAJ_deep(size_t n, size_t f_deep)
+{
+	return O_OF_W(4 * n) + f_deep;
+}
+
+void ecpAddJ(word c[], const word a[], const word b[], const ec_o* ec,
+	void* stack)
+{
+	const size_t n = ec->f->n;
+	// переменные в stack
+	word* t1 = (word*)stack;
+	word* t2 = t1 + n;
+	word* t3 = t2 + n;
+	word* t4 = t3 + n;
+	word* t5 = t4 + n;
+	word* t6 = t5 + n;
+	stack = t6 + n;
+	// pre
+	ASSERT(ecIsOperable(ec) && ec->d == 3);
+	// a == O => c <- b, b == O => c <- a
+	if (ecIsO(a, ec))
+	{
+		wwCopy(c, b, 3 * n);
+		return;
+	}
+	if (ecIsO(b, ec))
+	{
+		wwCopy(c, a, 3 * n);
+		return;
+	}
+	// t1 <- Za^2, t2 <- Zb^2
+	qrSqr(t1, ecZ(a, n), ec->f, stack);
+	qrSqr(t2, ecZ(b, n), ec->f, stack);
+	// t3 <- Xa Zb^2 (U1), t4 <- Xb Za^2 (U2)
+	qrMul(t3, ecX(a), t2, ec->f, stack);
+	qrMul(t4, ecX(b), t1, ec->f, stack);
+	// t5 <- Ya Zb^3 (S1), t6 <- Yb Za^3 (S2)
+	qrMul(t5, t2, ecZ(b, n), ec->f, stack);
+	qrMul(t5, t5, ecY(a, n), ec->f, stack);
+	qrMul(t6, t1, ecZ(a, n), ec->f, stack);
+	qrMul(t6, t6, ecY(b, n), ec->f, stack);
+	// t4 <- U2 - U1 (H), t6 <- S2 - S1 (R)
+	zmSub(t4, t4, t3, ec->f);
+	zmSub(t6, t6, t5, ec->f);
+	// H == 0 => a == \pm b
+	if (qrIsZero(t4, ec->f))
+	{
+		if (qrIsZero(t6, ec->f))
+			ecDbl(c, a, ec, stack);
+		else
+			ecSetO(c, ec);
+		return;
+	}
+	// t1 <- Za Zb H (Z3)
+	qrMul(t1, ecZ(a, n), ecZ(b, n), ec->f, stack);
+	qrMul(t1, t1, t4, ec->f, stack);
+	// t2 <- H^2, t4 <- H^3
+	qrSqr(t2, t4, ec->f, stack);
+	qrMul(t4, t4, t2, ec->f, stack);
+	// t3 <- U1 H^2 (V), t5 <- S1 H^3
+	qrMul(t3, t3, t2, ec->f, stack);
+	qrMul(t5, t5, t4, ec->f, stack);
+	// Xc <- R^2 - H^3 - 2 V
+	qrSqr(ecX(c), t6, ec->f, stack);
+	zmSub(ecX(c), ecX(c), t4, ec->f);
+	zmSub(ecX(c), ecX(c), t3, ec->f);
+	zmSub(ecX(c), ecX(c), t3, ec->f);
+	// Yc <- R (V - Xc) - S1 H^3
+	zmSub(t3, t3, ecX(c), ec->f);
+	qrMul(t3, t3, t6, ec->f, stack);
+	zmSub(ecY(c, n), t3, t5, ec->f);
+	// Zc <- Z3
+	qrCopy(ecZ(c, n), t1, ec->f);
+}
+
+size_t ecpAddJ_deep(size_t n, size_t f_deep)
+{
+	return O_OF_W(6 * n) +
+		utilMax(2,
+			f_deep,
+			ecpDblJ_deep(n, f_deep));
+}
+
+void ecpAddAJ(word c[], const word a[], const word b[], const ec_o* ec,
+	void* stack)
+{
+	const size_t n = ec->f->n;
+	// переменные в stack
+	word* t1 = (word*)stack;
+	word* t2 = t1 + n;
+	word* t3 = t2 + n;
+	word* t4 = t3 + n;
+	word* t5 = t4 + n;
+	stack = t5 + n;
+	// pre
+	ASSERT(ecIsOperable(ec) && ec->d == 3);
+	// a == O => c <- (xb : yb : 1)
+	if (ecIsO(a, ec))
+	{
+		qrCopy(ecX(c), ecX(b), ec->f);
+		qrCopy(ecY(c, n), ecY(b, n), ec->f);
+		qrSetUnity(ecZ(c, n), ec->f);
+		return;
+	}
+	// t1 <- Za^2
+	qrSqr(t1, ecZ(a, n), ec->f, stack);
+	// t2 <- yb Za^3 (S2)
+	qrMul(t2, t1, ecZ(a, n), ec->f, stack);
+	qrMul(t2, t2, ecY(b, n), ec->f, stack);
+	// t1 <- xb Za^2 (U2)
+	qrMul(t1, t1, ecX(b), ec->f, stack);
+	// t1 <- U2 - Xa (H), t2 <- S2 - Ya (R)
+	zmSub(t1, t1, ecX(a), ec->f);
+	zmSub(t2, t2, ecY(a, n), ec->f);
+	// H == 0 => a == \pm b
+	if (qrIsZero(t1, ec->f))
+	{
+		if (qrIsZero(t2, ec->f))
+			ecDblA(c, b, ec, stack);
+		else
+			ecSetO(c, ec);
+		return;
+	}
+	// t3 <- Za H (Z3)
+	qrMul(t3, ecZ(a, n), t1, ec->f, stack);
+	// t4 <- H^2, t1 <- H^3
+	qrSqr(t4, t1, ec->f, stack);
+	qrMul(t1, t1, t4, ec->f, stack);
+	// t4 <- Xa H^2 (V), t5 <- Ya H^3
+	qrMul(t4, t4, ecX(a), ec->f, stack);
+	qrMul(t5, t1, ecY(a, n), ec->f, stack);
+	// Xc <- R^2 - H^3 - 2 V
+	qrSqr(ecX(c), t2, ec->f, stack);
+	zmSub(ecX(c), ecX(c), t1, ec->f);
+	zmSub(ecX(c), ecX(c), t4, ec->f);
+	zmSub(ecX(c), ecX(c), t4, ec->f);
+	// Yc <- R (V - Xc) - Ya H^3
+	zmSub(t4, t4, ecX(c), ec->f);
+	qrMul(t4, t4, t2, ec->f, stack);
+	zmSub(ecY(c, n), t4, t5, ec->f);
+	// Zc <- Z3
+	qrCopy(ecZ(c, n), t3, ec->f);
+}
+
+size_t ecpAddAJ_deep(size_t n, size_t f_deep)
+{
+	return O_OF_W(5 * n) +
+		utilMax(2,
+			f_deep,
+			ecpDblAJ_deep(n, f_deep));
+}
+
+void ecpSubJ(word c[], const word a[], const word b[], const ec_o* ec,
+	void* stack)
+{
+	const size_t n = ec->f->n;
+	// переменные в stack
+	word* t = (word*)stack;
+	stack = t + 3 * n;
+	// c <- a + (-b)
+	ecpNegJ(t, b, ec, stack);
+	ecpAddJ(c, a, t, ec, stack);
+}
+
+size_t ecpSubJ_deep(size_t n, size_t f_deep)
+{
+	return O_OF_W(3 * n) + ecpAddJ_deep(n, f_deep);
+}
+
+void ecpSubAJ(word c[], const word a[], const word b[], const ec_o* ec,
+	void* stack)
+{
+	const size_t n = ec->f->n;
+	// переменные в stack
+	word* t = (word*)stack;
+	stack = t + 2 * n;
+	// c <- a + (xb, -yb)
+	qrCopy(ecX(t), ecX(b), ec->f);
+	zmNeg(ecY(t, n), ecY(b, n), ec->f);
+	ecpAddAJ(c, a, t, ec, stack);
+}
+
+size_t ecpSubAJ_deep(size_t n, size_t f_deep)
+{
+	return O_OF_W(2 * n) + ecpAddAJ_deep(n, f_deep);
+}
+
+void ecpTplJ(word b[], const word a[], const ec_o* ec, void* stack)
+{
+	const size_t n = ec->f->n;
+	// переменные в stack
+	word* t = (word*)stack;
+	stack = t + 3 * n;
+	// b <- 2a + a
+	ecpDblJ(t, a, ec, stack);
+	ecpAddJ(b, t, a, ec, stack);
+}
+
+size_t ecpTplJ_deep(size_t n, size_t f_deep)
+{
+	return O_OF_W(3 * n) + ecpAddJ_deep(n, f_deep);
+}
+
+void ecpTplJA3(word b[], const word a[], const ec_o* ec, void* stack)
+{
+	const size_t n = ec->f->n;
+	// переменные в stack
+	word* t = (word*)stack;
+	stack = t + 3 * n;
+	// b <- 2a + a
+	ecpDblJA3(t, a, ec, stack);
+	ecpAddJ(b, t, a, ec, stack);
+}
+
+size_t ecpTplJA3_deep(size_t n, size_t f_deep)
+{
+	return O_OF_W(3 * n) + ecpAddJ_deep(n, f_deep);
+}
+
+bool_t ecpCreateJ(ec_o* ec, const qr_o* f, const octet A[], const octet B[], 
+	void* stack)
+{
+	register bool_t bA3;
+	word* t;
+	// pre
+	ASSERT(memIsValid(ec, sizeof(ec_o)));
+	ASSERT(gfpIsOperable(f));
+	ASSERT(memIsValid(A, f->no)); 
+	ASSERT(memIsValid(B, f->no)); 
+	// обнулить
+	memSetZero(ec, sizeof(ec_o));
+	// зафикисровать размерности
+	ec->d = 3;
+	// запомнить базовое поле
+	ec->f = f;
+	// сохранить коэффициенты
+	ec->A = (word*)ec->descr;
+	ec->B = ec->A + f->n;
+	if (!qrFrom(ec->A, A, ec->f, stack) || !qrFrom(ec->B, B, ec->f, stack))
+		return FALSE;
+	// t <- -3
+	t = (word*)stack;
+	gfpDouble(t, f->unity, f);
+	zmAdd(t, t, f->unity, f);
+	zmNeg(t, t, f);
+	// bA3 <- A == -3?
+	bA3 = qrCmp(t, ec->A, f) == 0;
+	// подготовить буферы для описания группы точек
+	ec->base = ec->B + f->n;
+	ec->order = ec->base + 2 * f->n;
+	// настроить интерфейсы
+	ec->froma = ecpFromAJ;
+	ec->toa = ecpToAJ;
+	ec->neg = ecpNegJ;
+	ec->add = ecpAddJ;
+	ec->adda = ecpAddAJ;
+	ec->sub = ecpSubJ;
+	ec->suba = ecpSubAJ;
+	ec->dbl = bA3 ? ecpDblJA3 : ecpDblJ;
+	ec->dbla = ecpDblAJ;
+	ec->tpl = bA3 ? ecpTplJA3 : ecpTplJ;
+	ec->deep = utilMax(8,
+		ecpToAJ_deep(f->n, f->deep),
+		ecpAddJ_deep(f->n, f->deep),
+		ecpAddAJ_deep(f->n, f->deep),
+		ecpSubJ_deep(f->n, f->deep),
+		ecpSubAJ_deep(f->n, f->deep),
+		bA3 ? ecpDblJA3_deep(f->n, f->deep) : ecpDblJ_deep(f->n, f->deep),
+		ecpDblAJ_deep(f->n, f->deep),
+		bA3 ? ecpTplJA3_deep(f->n, f->deep) : ecpTplJ_deep(f->n, f->deep));
+	// настроить
+	ec->hdr.keep = sizeof(ec_o) + O_OF_W(5 * f->n + 1);
+	ec->hdr.p_count = 6;
+	ec->hdr.o_count = 1;
+	// все нормально
+	bA3 = 0;
+	return TRUE;
+}
+
+size_t ecpCreateJ_keep(size_t n)
+{
+	return sizeof(ec_o) + O_OF_W(5 * n + 1);
+}
+
+size_t ecpCreateJ_deep(size_t n, size_t f_deep)
+{
+	return utilMax(11,
+		O_OF_W(n),
+		ecpToAJ_deep(n, f_deep),
+		ecpAddJ_deep(n, f_deep),
+		ecpAddAJ_deep(n, f_deep),
+		ecpSubJ_deep(n, f_deep),
+		ecpSubAJ_deep(n, f_deep),
+		ecpDblJ_deep(n, f_deep),
+		ecpDblJA3_deep(n, f_deep),
+		ecpDblAJ_deep(n, f_deep),
+		ecpTplJ_deep(n, f_deep),
+		ecpTplJA3_deep(n, f_deep));
+}
+
+
+/*
+*******************************************************************************
+Стандартные параметры: кривая bign-curve256v1 (СТБ 34.101.45, приложение Б)
+*******************************************************************************
+*/
+
+static const char _curve256v1_name[] = "1.2.112.0.2.0.34.101.45.3.1";
+
+static const octet _curve256v1_p[32] = {
+	0x43, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+};
+
+static const octet _curve256v1_a[32] = {
+	0x40, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+};
+
+static const octet _curve256v1_b[32] = {
+	0xF1, 0x03, 0x9C, 0xD6, 0x6B, 0x7D, 0x2E, 0xB2,
+	0x53, 0x92, 0x8B, 0x97, 0x69, 0x50, 0xF5, 0x4C,
+	0xBE, 0xFB, 0xD8, 0xE4, 0xAB, 0x3A, 0xC1, 0xD2,
+	0xED, 0xA8, 0xF3, 0x15, 0x15, 0x6C, 0xCE, 0x77,
+};
+
+static const octet _curve256v1_seed[8] = {
+	0x5E, 0x38, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00,
+};
+
+static const octet _curve256v1_q[32] = {
+	0x07, 0x66, 0x3D, 0x26, 0x99, 0xBF, 0x5A, 0x7E,
+	0xFC, 0x4D, 0xFB, 0x0D, 0xD6, 0x8E, 0x5C, 0xD9,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+};
+
+static const octet _curve256v1_yG[32] = {
+	0x93, 0x6A, 0x51, 0x04, 0x18, 0xCF, 0x29, 0x1E,
+	0x52, 0xF6, 0x08, 0xC4, 0x66, 0x39, 0x91, 0x78,
+	0x5D, 0x83, 0xD6, 0x51, 0xA3, 0xC9, 0xE4, 0x5C,
+	0x9F, 0xD6, 0x16, 0xFB, 0x3C, 0xFC, 0xF7, 0x6B,
+};
+
+err_t bignStdParams(bign_params* params, const char* name)
+{
+	if (!memIsValid(params, sizeof(bign_params)) || name == 0)
+		return ERR_BAD_INPUT;
+	memSetZero(params, sizeof(bign_params));
+	if (strcmp(name, _curve256v1_name) == 0)
+	{
+		params->l = 128;
+		memCopy(params->p, _curve256v1_p, 32);
+		memCopy(params->a, _curve256v1_a, 32);
+		memCopy(params->seed, _curve256v1_seed, 8);
+		memCopy(params->b, _curve256v1_b, 32);
+		memCopy(params->q, _curve256v1_q, 32);
+		memCopy(params->yG, _curve256v1_yG, 32);
+		return ERR_OK;
+	}
+	return ERR_FILE_NOT_FOUND;
+}
+
+/*
+*******************************************************************************
+Создание / закрытие эллиптической кривой
+*******************************************************************************
+*/
+
+err_t bignStart(void* state, const bign_params* params)
+{
+	// размерности
+	size_t no, n;
+	size_t f_keep;
+	size_t ec_keep;
+	// состояние
+	qr_o* f;		/* поле */
+	ec_o* ec;		/* кривая */
+	void* stack;	/* вложенный стек */
+	// pre
+	ASSERT(memIsValid(params, sizeof(bign_params)));
+	ASSERT(params->l == 128 || params->l == 192  || params->l == 256);
+	ASSERT(memIsValid(state, bignStart_keep(params->l, 0)));
+	// определить размерности
+	no = O_OF_B(2 * params->l);
+	n = W_OF_B(2 * params->l);
 	f_keep = gfpCreate_keep(no);
 	ec_keep = ecpCreateJ_keep(n);
 	// создать поле и выполнить минимальные проверки p
@@ -1823,4 +4224,11 @@ size_t ecMulA_deep(size_t n, size_t ec_d, size_t ec_deep, size_t m)
 		O_OF_W(ec_d * n) +
 		O_OF_W(ec_d * n * naf_count) +
 		ec_deep;
-}
\ No newline at end of file
+}
+
+#ifdef ECURVA_REGISTER_UNDEF
+#undef register
+#undef ECURVA_REGISTER_UNDEF
+#endif
+
+#endif
@@ -51,8 +51,40 @@
 		Gorevoy Dmitry - github.com/gorevojd
 */
 
+/*
+	NOTE(dima): GORBN_SZWORD can be defined before including this file.
+	By default 64-bit words are used if compiler has 128-bit integer type.
+*/
+#ifndef GORBN_SZWORD
+#if defined(__SIZEOF_INT128__)
+#define GORBN_SZWORD 8
+#else
 #define GORBN_SZWORD 2
-#define GORBN_SZARR (32 / GORBN_SZWORD)
+#endif
+#endif
+
+/*
+	NOTE(dima): Maximum size of numbers in bits, all numbers are stored
+	in GORBN_SZARR words. Curves work only on the words that their p
+	takes (n of gorec_curve), so a build with GORBN_MAX_BITS 512 serves
+	256, 384 and 512-bit fields of all bign security levels.
+*/
+#ifndef GORBN_MAX_BITS
+#define GORBN_MAX_BITS 256
+#endif
+
+#define GORBN_SZARR (GORBN_MAX_BITS / (GORBN_SZWORD * 8))
+
+/*
+	NOTE(dima): Largest window of gorbn_pow_mod, table of odd powers takes
+	2 ^ (GORBN_POW_WINDOW_MAX - 1) numbers on the stack.
+*/
+#ifndef GORBN_POW_WINDOW_MAX
+#define GORBN_POW_WINDOW_MAX 6
+#endif
+
+/*NOTE(dima): Longest dividend of gorbn_div - product of two numbers and one more word*/
+#define GORBN_DIV_MAX_WORDS (GORBN_SZARR * 2 + 1)
 
 #ifndef GORBN_SZWORD
 #error GORBN_SZWORD must be defined
@@ -83,8 +115,20 @@
 #define GORBN_SZWORD_BITS_MINUS_ONE 31
 #define GORBN_HIGH_BIT_SET 0x80000000
 
-#elif
-#error GORBN_SZWORD must be defined to 1, 2 or 4
+#elif (GORBN_SZWORD == 8)
+#if !defined(__SIZEOF_INT128__)
+#error GORBN_SZWORD == 8 requires unsigned __int128 support
+#endif
+#define gorbn_t unsigned long long
+#define gorbn_utmp_t unsigned __int128
+#define gorbn_stmp_t __int128
+#define GORBN_MAX_VAL 0xFFFFFFFFFFFFFFFFULL
+#define GORBN_SZWORD_BITS 64
+#define GORBN_SZWORD_BITS_MINUS_ONE 63
+#define GORBN_HIGH_BIT_SET 0x8000000000000000ULL
+
+#else
+#error GORBN_SZWORD must be defined to 1, 2, 4 or 8
 #endif
 
 #define GORBN_SZARR_BITS_TOTAL (GORBN_SZARR * GORBN_SZWORD_BITS)
@@ -97,6 +141,142 @@ typedef struct gorec_point {
 	int is_inf;
 } gorec_point;
 
+#define GORBN_MUL_MOD(name) void name(gorbn_t* r, gorbn_t* a, gorbn_t* b, gorbn_t* m)
+typedef GORBN_MUL_MOD(gorbn_mul_mod_type);
+
+#define GORBN_SQR_MOD(name) void name(gorbn_t* r, gorbn_t* a, gorbn_t* m)
+typedef GORBN_SQR_MOD(gorbn_sqr_mod_type);
+
+#define GORBN_MULWORD_MOD(name) void name(gorbn_t* r, gorbn_t* a, gorbn_t w, gorbn_t* m)
+typedef GORBN_MULWORD_MOD(gorbn_mulword_mod_type);
+
+/*
+	NOTE(dima): Montgomery context for odd modulus m of n words. Numbers in
+	Montgomery domain are represented as a * R mod m, R = 2 ^ (n * GORBN_SZWORD_BITS).
+*/
+typedef struct gorbn_mont {
+	gorbn_t m[GORBN_SZARR];
+	gorbn_t rr[GORBN_SZARR]; /* R ^ 2 mod m */
+	gorbn_t one[GORBN_SZARR]; /* R mod m - unity in Montgomery domain */
+	gorbn_t m_inv; /* -(m ^ -1) mod 2 ^ GORBN_SZWORD_BITS */
+	int n; /* count of significant words of m */
+} gorbn_mont;
+
+/*
+	NOTE(dima): Barrett context for modulus m of n words, for moduli of
+	no special form (the group order q). Reduction costs two truncated
+	multiplications instead of a division.
+*/
+typedef struct gorbn_barrett {
+	gorbn_t m[GORBN_SZARR];
+	gorbn_t mu[GORBN_SZARR + 1]; /* floor(2 ^ (2 * n * GORBN_SZWORD_BITS) / m) */
+	int n; /* count of significant words of m */
+} gorbn_barrett;
+
+struct gorec_curve;
+
+/*
+	NOTE(dima): Number of comb teeth for fixed-base multiplication.
+	Table has 2 ^ GOREC_COMB_TEETH points and multiplication needs
+	(bits of scalar) / GOREC_COMB_TEETH doublings. GOREC_COMB_COLUMNS
+	is the count for the largest numbers.
+*/
+#ifndef GOREC_COMB_TEETH
+#define GOREC_COMB_TEETH 6
+#endif
+#define GOREC_COMB_TABLE_COUNT (1 << GOREC_COMB_TEETH)
+#define GOREC_COMB_COLUMNS ((GORBN_SZARR_BITS_TOTAL + GOREC_COMB_TEETH - 1) / GOREC_COMB_TEETH)
+
+/*
+	NOTE(dima): wNAF window width for g in double-scalar multiplication.
+	Table holds 2 ^ (GOREC_BASE_WNAF_W - 2) odd multiples of g.
+	Should not be greater than 7, as for gorec_compute_naf().
+*/
+#ifndef GOREC_BASE_WNAF_W
+#define GOREC_BASE_WNAF_W 6
+#endif
+#define GOREC_BASE_WNAF_COUNT (1 << (GOREC_BASE_WNAF_W - 2))
+
+/*
+	NOTE(dima): Window width of constant-time multiplication.
+	Table has 2 ^ (GOREC_CT_WINDOW_W - 1) odd multiples of the point.
+	GOREC_CT_DIGITS_COUNT is count of digits for the largest scalars.
+*/
+#ifndef GOREC_CT_WINDOW_W
+#define GOREC_CT_WINDOW_W 5
+#endif
+#define GOREC_CT_TABLE_COUNT (1 << (GOREC_CT_WINDOW_W - 1))
+#define GOREC_CT_DIGITS_COUNT ((GORBN_SZARR_BITS_TOTAL + GOREC_CT_WINDOW_W - 1) / GOREC_CT_WINDOW_W)
+
+/*
+	NOTE(dima): Lanes of gorec_pt_mul_batch(). GOREC_LANES points are
+	multiplied at once, limb i of 4 or 8 lanes in one register: one
+	__m512i with AVX-512F, two __m256i with AVX2 (steps of REDC wait for
+	each other, two independent registers hide that latency), a plain
+	array of 4 lanes otherwise or with GOREC_LANES_NO_SIMD defined. All
+	of them give the same bits. The plain version is for portability,
+	it is slower than gorec_pt_mul_ct().
+
+	Field elements are 9 limbs of 29 bits in 64-bit lanes, so limb
+	products of _mm256_mul_epu32 (32 x 32 -> 64 bits) are summed up in
+	columns without carries. Montgomery form with R = 2 ^ 261 keeps values
+	below 2p, which needs p below 2 ^ 259, other curves fall back to
+	gorec_pt_mul_ct().
+*/
+#if !defined(GOREC_LANES_NO_SIMD) && defined(__AVX512F__)
+#define GOREC_LANES_AVX512
+#include <immintrin.h>
+#define GOREC_LANES 8
+#define GOREC_LANES_REGS 1
+#elif !defined(GOREC_LANES_NO_SIMD) && defined(__AVX2__)
+#define GOREC_LANES_AVX2
+#include <immintrin.h>
+#define GOREC_LANES 8
+#define GOREC_LANES_REGS 2
+#else
+#define GOREC_LANES 4
+#define GOREC_LANES_REGS 1
+#endif
+#define GOREC_LANES_RADIX 29
+#define GOREC_LANES_LIMBS 9
+#define GOREC_LANES_MAX_BITS 259
+
+/*
+	NOTE(dima): gorec_pt_normalize_batch() keeps partial products on stack,
+	so points are normalized in chunks of this size with one inversion per chunk.
+*/
+#ifndef GOREC_NORMALIZE_BATCH_CHUNK
+#define GOREC_NORMALIZE_BATCH_CHUNK 64
+#endif
+
+/*
+	NOTE(dima): Largest wNAF window of gorec_pt_mul_wnaf_jacobian_w() and
+	gorec_pt_mul2(), tables of 2 ^ (GOREC_WNAF_W_MAX - 2) points are kept on stack.
+	Should not be greater than 7.
+*/
+#ifndef GOREC_WNAF_W_MAX
+#define GOREC_WNAF_W_MAX 6
+#endif
+#define GOREC_WNAF_TABLE_MAX (1 << (GOREC_WNAF_W_MAX - 2))
+
+/*NOTE(dima): Window width of inversion as a ^ (p - 2)*/
+#define GOREC_FERMAT_WINDOW_W 4
+
+#define GOREC_FIELD_MUL(name) void name(gorbn_t* r, gorbn_t* a, gorbn_t* b, struct gorec_curve* crv)
+typedef GOREC_FIELD_MUL(gorec_field_mul_type);
+
+#define GOREC_FIELD_UNARY(name) void name(gorbn_t* r, gorbn_t* a, struct gorec_curve* crv)
+typedef GOREC_FIELD_UNARY(gorec_field_unary_type);
+
+#define GOREC_FIELD_MULWORD(name) void name(gorbn_t* r, gorbn_t* a, gorbn_t w, struct gorec_curve* crv)
+typedef GOREC_FIELD_MULWORD(gorec_field_mulword_type);
+
+#define GOREC_PT_ADD(name) void name(gorec_point* r, gorec_point* a, gorec_point* b, struct gorec_curve* crv)
+typedef GOREC_PT_ADD(gorec_pt_add_type);
+
+#define GOREC_PT_DOUBLE(name) void name(gorec_point* r, gorec_point* a, struct gorec_curve* crv)
+typedef GOREC_PT_DOUBLE(gorec_pt_double_type);
+
 typedef struct gorec_curve {
 	gorbn_t a[GORBN_SZARR];
 	gorbn_t b[GORBN_SZARR];
@@ -105,8 +285,206 @@ typedef struct gorec_curve {
 	gorbn_t q[GORBN_SZARR];
 
 	gorec_point g;
+
+	/*
+		NOTE(dima): Count of significant words of p, set by gorec_curve_setup().
+		Field routines work on n words, and words of field elements
+		above n are kept zero.
+	*/
+	int n;
+
+	/*
+		NOTE(dima): Field arithmetic routines for p. They are chosen once
+		by gorec_curve_setup() depending on the form of p. Point routines
+		work on coordinates in the representation of these routines
+		(Montgomery domain for generic odd p), gorec_pt_mul* convert
+		the input and the output themselves.
+	*/
+	gorec_field_mul_type* mul_mod;
+	gorec_field_unary_type* sqr_mod;
+	gorec_field_mulword_type* mulword_mod;
+	gorec_field_unary_type* inv_mod;
+	gorec_field_unary_type* to_field;
+	gorec_field_unary_type* from_field;
+
+	/*NOTE(dima): a and b in the representation of the field routines*/
+	gorbn_t fa[GORBN_SZARR];
+	gorbn_t fb[GORBN_SZARR];
+
+	/*
+		NOTE(dima): Jacobian doubling routine. gorec_pt_double_jacobian_a3
+		if a = -3 (mod p), gorec_pt_double_jacobian otherwise.
+	*/
+	gorec_pt_double_type* pt_double;
+
+	gorbn_mont mont;
+	/*NOTE(dima): Barrett context for reductions modulo the group order q*/
+	gorbn_barrett q_barrett;
+
+	/*
+		NOTE(dima): Comb table for multiplication of g. Built by
+		gorec_curve_precompute_base(). Points are affine (z = 1) and
+		in the representation of the field routines. base_table[0] is
+		point at infinity.
+	*/
+	gorec_point base_table[GOREC_COMB_TABLE_COUNT];
+	/*NOTE(dima): Odd multiples g, 3g, 5g... normalized, for gorec_pt_mul2()*/
+	gorec_point base_wnaf_table[GOREC_BASE_WNAF_COUNT];
+	int base_table_ready;
+
+	/*
+		NOTE(dima): Tables of a blob loaded by gorec_curve_load(). They are
+		used instead of base_table and base_wnaf_table if not zero, and
+		the blob memory should live as long as the curve.
+	*/
+	gorec_point* mapped_base_table;
+	gorec_point* mapped_base_wnaf_table;
 } gorec_curve;
 
+/*
+	NOTE(dima): Serialized curve written by gorec_curve_save(). The blob
+	starts with this header, sections are at offsets aligned to
+	GOREC_CURVE_BLOB_ALIGN. Numbers and points are kept in the memory
+	layout of the build, so the blob can be mapped read-only and used
+	in place; header fields describing the layout are checked on load.
+*/
+#define GOREC_CURVE_BLOB_MAGIC 0x43455247 /* "GREC" */
+#define GOREC_CURVE_BLOB_VERSION 1
+#define GOREC_CURVE_BLOB_ALIGN 64
+
+typedef struct gorec_curve_blob_header {
+	uint32_t magic;
+	uint32_t version;
+	uint32_t blob_size;
+	uint32_t word_size;
+	uint32_t words_count;
+	uint32_t point_size;
+	uint32_t comb_teeth;
+	uint32_t base_wnaf_w;
+
+	uint32_t params_offset;
+	uint32_t params_size;
+	uint32_t base_table_offset;
+	uint32_t base_wnaf_table_offset;
+	uint32_t base_table_ready;
+
+	uint32_t reserved[3];
+} gorec_curve_blob_header;
+
+/*NOTE(dima): Parameters and reduction constants, everything derived from them is rebuilt on load*/
+typedef struct gorec_curve_blob_params {
+	gorbn_t a[GORBN_SZARR];
+	gorbn_t b[GORBN_SZARR];
+	gorbn_t p[GORBN_SZARR];
+	gorbn_t q[GORBN_SZARR];
+	gorec_point g;
+
+	gorbn_mont mont;
+	gorbn_barrett q_barrett;
+} gorec_curve_blob_params;
+
+#define _GOREC_CURVE_BLOB_ALIGN_UP(size) (((size) + GOREC_CURVE_BLOB_ALIGN - 1) & ~(GOREC_CURVE_BLOB_ALIGN - 1))
+#define GOREC_CURVE_BLOB_PARAMS_OFFSET _GOREC_CURVE_BLOB_ALIGN_UP(sizeof(gorec_curve_blob_header))
+#define GOREC_CURVE_BLOB_BASE_TABLE_OFFSET _GOREC_CURVE_BLOB_ALIGN_UP(GOREC_CURVE_BLOB_PARAMS_OFFSET + sizeof(gorec_curve_blob_params))
+#define GOREC_CURVE_BLOB_BASE_WNAF_TABLE_OFFSET _GOREC_CURVE_BLOB_ALIGN_UP(GOREC_CURVE_BLOB_BASE_TABLE_OFFSET + sizeof(gorec_point) * GOREC_COMB_TABLE_COUNT)
+#define GOREC_CURVE_BLOB_SIZE _GOREC_CURVE_BLOB_ALIGN_UP(GOREC_CURVE_BLOB_BASE_WNAF_TABLE_OFFSET + sizeof(gorec_point) * GOREC_BASE_WNAF_COUNT)
+
+#define GOREC_ARENA_TABLE_COUNT ((GOREC_CT_TABLE_COUNT > GOREC_WNAF_TABLE_MAX) ? GOREC_CT_TABLE_COUNT : GOREC_WNAF_TABLE_MAX)
+
+/*
+	NOTE(dima): Scratch memory of gorec_pt_mul_ct_arena() and
+	gorec_pt_mul2_arena(): tables of odd multiples and point temporaries,
+	which gorec_pt_mul_ct() and gorec_pt_mul2() keep on the stack.
+	gorec_pool workers own one each, so jobs take nothing from the stacks
+	of the threads but numbers. Size in bytes is gorec_arena_deep().
+*/
+typedef struct gorec_arena {
+	gorec_point table[GOREC_ARENA_TABLE_COUNT];
+	gorec_point table_g[GOREC_WNAF_TABLE_MAX];
+
+	gorec_point result;
+	gorec_point selected;
+	gorec_point doubled;
+	gorec_point pt;
+
+	/*NOTE(dima): Odd multiples of gorec_pt_mul_batch_arena(): x and y, limb i of every lane in a row*/
+	uint64_t lanes_table[GOREC_CT_TABLE_COUNT][2][GOREC_LANES_LIMBS][GOREC_LANES];
+
+	/*NOTE(dima): Output of a gorec_verify_batch() job*/
+	gorec_point job_result;
+} gorec_arena;
+
+/*
+	NOTE(dima): Thread pool for gorec_mul_batch() and gorec_verify_batch().
+	Opt-in, as it is the only part of the library that needs OS headers.
+	Define GOREC_THREAD_POOL before including this file to enable it.
+*/
+#ifdef GOREC_THREAD_POOL
+#if defined(_WIN32)
+#include <windows.h>
+#define GOREC_THREAD_HANDLE HANDLE
+#define GOREC_MUTEX SRWLOCK
+#define GOREC_CONDVAR CONDITION_VARIABLE
+#else
+#include <pthread.h>
+#define GOREC_THREAD_HANDLE pthread_t
+#define GOREC_MUTEX pthread_mutex_t
+#define GOREC_CONDVAR pthread_cond_t
+#endif
+
+#ifndef GOREC_POOL_MAX_THREADS
+#define GOREC_POOL_MAX_THREADS 64
+#endif
+
+/*NOTE(dima): Jobs are taken by workers in chunks of this size*/
+#ifndef GOREC_POOL_CHUNK
+#define GOREC_POOL_CHUNK 8
+#endif
+
+struct gorec_pool;
+
+#define GOREC_POOL_JOB(name) void name(struct gorec_pool* pool, int first, int count, gorec_arena* arena)
+typedef GOREC_POOL_JOB(gorec_pool_job_type);
+
+typedef struct gorec_pool_worker {
+	struct gorec_pool* pool;
+	int index;
+	gorec_arena* arena;
+} gorec_pool_worker;
+
+/*
+	NOTE(dima): Calling thread is worker 0, so threads_count - 1 threads
+	are started. Every worker runs its jobs in its own arena, cut from the
+	memory given to gorec_pool_init().
+
+	This is not work stealing: there are no per-worker queues. Workers
+	claim chunks of GOREC_POOL_CHUNK jobs from one shared atomic counter
+	next_chunk, which balances the load the same way for jobs of similar
+	cost (fast workers just claim more chunks) with one atomic increment
+	per chunk. gorec_pool can be used by one thread at a time.
+*/
+typedef struct gorec_pool {
+	int threads_count;
+
+	GOREC_THREAD_HANDLE threads[GOREC_POOL_MAX_THREADS];
+	gorec_pool_worker workers[GOREC_POOL_MAX_THREADS];
+
+	GOREC_MUTEX mutex;
+	GOREC_CONDVAR cond_work;
+	GOREC_CONDVAR cond_done;
+
+	int generation;
+	int working_count;
+	int quit;
+
+	gorec_pool_job_type* job;
+	void* job_data;
+	int jobs_count;
+	int chunks_count;
+	volatile long next_chunk;
+} gorec_pool;
+#endif
+
 /* Custom macro for getting absolute value of the signed integer*/
 #define GORBN_ABS(val) (((val) >= 0) ? (val) : (-(val)))
 
@@ -146,11 +524,63 @@ typedef struct gorec_curve {
 #define GORBN_DEF extern
 #endif
 
-#define GOREC_PT_ADD(name) void name(gorec_point* r, gorec_point* a, gorec_point* b, gorec_curve* crv)
-typedef GOREC_PT_ADD(gorec_pt_add_type);
+/*
+	NOTE(dima): Opt-in instrumentation of the hot routines. Define GORBN_STATS
+	before including this file to count calls and cycles of field
+	multiplication, squaring, inversion, division and point operations.
+	Counters are per thread, so there is no contention between threads.
+	Cycles are inclusive: gorbn_mul_mod() cycles contain its gorbn_div().
+	Without GORBN_STATS the counting macros expand to nothing.
+	Stats are dumped with dima_json_writer.h, its implementation
+	should be compiled in by the user. The writer is C++ only, so C code
+	gets the counters without gorbn_stats_dump().
+*/
+#ifdef GORBN_STATS
+#ifdef __cplusplus
+#include "dima_json_writer.h"
+#endif
 
-#define GOREC_PT_DOUBLE(name) void name(gorec_point* r, gorec_point* a, gorec_curve* crv)
-typedef GOREC_PT_DOUBLE(gorec_pt_double_type);
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define GORBN_THREAD_LOCAL __declspec(thread)
+#else
+#define GORBN_THREAD_LOCAL __thread
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+#endif
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define GORBN_READ_CYCLES() __rdtsc()
+#else
+/*NOTE(dima): No portable cycle counter, only calls are counted*/
+#define GORBN_READ_CYCLES() 0
+#endif
+
+#define GORBN_STAT_MUL_MOD 0
+#define GORBN_STAT_SQR_MOD 1
+#define GORBN_STAT_INV_MOD 2
+#define GORBN_STAT_DIV 3
+#define GORBN_STAT_PT_ADD 4
+#define GORBN_STAT_PT_ADD_MIXED 5
+#define GORBN_STAT_PT_DOUBLE 6
+#define GORBN_STAT_COUNT 7
+
+typedef struct gorbn_stat {
+	uint64_t calls;
+	uint64_t cycles;
+} gorbn_stat;
+
+typedef struct gorbn_stats {
+	gorbn_stat stats[GORBN_STAT_COUNT];
+} gorbn_stats;
+
+#define GORBN_STAT_BEGIN(id) uint64_t _gorbn_stat_start = GORBN_READ_CYCLES()
+#define GORBN_STAT_END(id) _gorbn_stat_end(id, _gorbn_stat_start)
+#else
+#define GORBN_STAT_BEGIN(id)
+#define GORBN_STAT_END(id)
+#endif
 
 #ifdef __cplusplus
 extern "C" {
@@ -196,7 +626,7 @@ extern "C" {
 
 	GORBN_DEF void gorbn_sqr(gorbn_t* r, gorbn_t* a);                  /* r = a ^ 2 */
 	GORBN_DEF void gorbn_mul_word(gorbn_t* r, gorbn_t* a, gorbn_t w);
-	GORBN_DEF void gorbn_pow(gorbn_t* r, gorbn_t* a, gorbn_t* b);
+	GORBN_DEF void gorbn_pow(gorbn_t* r, gorbn_t* a, gorbn_t* b); /* r = a ^ b, truncated to GORBN_SZARR words */
 	GORBN_DEF void gorbn_mul_pow2(gorbn_t* r, gorbn_t* a, int k); /* r = a * (2 ^ k) */
 	GORBN_DEF void gorbn_div_pow2(gorbn_t* r, gorbn_t* a, int k); /* r = a / (2 ^ k) */
 	//GORBN_DEF void gorbn_gcd(gorbn_t* r, gorbn_t* a, gorbn_t* b);
@@ -207,11 +637,48 @@ extern "C" {
 	GORBN_DEF void gorbn_inv_mod(gorbn_t* r, gorbn_t *a, gorbn_t* m); /* r = (a ^ -1) mod m */
 	//GORBN_DEF void gorbn_mul_inv_mod(gorbn_t* r, gorbn_t* a, gorbn_t* b, gorbn_t* m); /* r = a * (b ^ (-1)) mod m */
 	GORBN_DEF void gorbn_mod_pow2(gorbn_t* r, gorbn_t* a, int k);
+	GORBN_DEF void gorbn_pow_mod(gorbn_t* r, gorbn_t* a, gorbn_t* e, gorbn_t* m); /* r = (a ^ e) mod m */
 	//GORBN_DEF void gorbn_mod_word(gorbn_t* r, gorbn_t* n, gorbn_t w);
 
+	GORBN_DEF void gorbn_cmov(gorbn_t* r, gorbn_t* a, int cond); /* r = cond ? a : r, without branches */
 	GORBN_DEF void gorbn_sub_mod(gorbn_t* r, gorbn_t* a, gorbn_t* b, gorbn_t* m);
 	GORBN_DEF void gorbn_add_mod(gorbn_t* r, gorbn_t* a, gorbn_t* b, gorbn_t* m);
-	GORBN_DEF void gorbn_mul_mod(gorbn_t* r, gorbn_t* a, gorbn_t* b, gorbn_t* m);
+	GORBN_DEF GORBN_MUL_MOD(gorbn_mul_mod);
+	GORBN_DEF GORBN_SQR_MOD(gorbn_sqr_mod);
+	GORBN_DEF GORBN_MULWORD_MOD(gorbn_mulword_mod);
+
+	/*
+		Pseudo-Mersenne moduli m = 2 ^ GORBN_SZARR_BITS_TOTAL - c, where
+		c fits in one word (STB p = 2 ^ 256 - 189). Reduction is done by
+		folding the high half with multiplication by c instead of division.
+		The _n variants take m = 2 ^ (n * GORBN_SZWORD_BITS) - c.
+	*/
+	GORBN_DEF int gorbn_is_pseudo_mersenne(gorbn_t* m);
+	GORBN_DEF GORBN_MUL_MOD(gorbn_mul_mod_pm);
+	GORBN_DEF GORBN_SQR_MOD(gorbn_sqr_mod_pm);
+	GORBN_DEF GORBN_MULWORD_MOD(gorbn_mulword_mod_pm);
+
+	/*
+		Montgomery arithmetic. m should be odd. Numbers are ctx->n words
+		long, ctx->n is taken from the count of significant words of m.
+	*/
+	GORBN_DEF void gorbn_mont_init(gorbn_mont* ctx, gorbn_t* m);
+	GORBN_DEF void gorbn_mont_mul(gorbn_t* r, gorbn_t* a, gorbn_t* b, gorbn_mont* ctx); /* r = a * b / R mod m */
+	GORBN_DEF void gorbn_mont_sqr(gorbn_t* r, gorbn_t* a, gorbn_mont* ctx); /* r = a ^ 2 / R mod m */
+	GORBN_DEF void gorbn_to_mont(gorbn_t* r, gorbn_t* a, gorbn_mont* ctx); /* r = a * R mod m */
+	GORBN_DEF void gorbn_from_mont(gorbn_t* r, gorbn_t* a, gorbn_mont* ctx); /* r = a / R mod m */
+	GORBN_DEF void gorbn_mont_pow(gorbn_t* r, gorbn_t* a, gorbn_t* e, gorbn_mont* ctx); /* r = a ^ e, a and r in Montgomery domain */
+
+	/*
+		Barrett arithmetic. m > 1 and m should not be a power of
+		2 ^ GORBN_SZWORD_BITS. Numbers are ctx->n words long, x of
+		gorbn_barrett_reduce is 2 * ctx->n words. Results are fully reduced,
+		and the reduction does not branch on data.
+	*/
+	GORBN_DEF void gorbn_barrett_init(gorbn_barrett* ctx, gorbn_t* m);
+	GORBN_DEF void gorbn_barrett_reduce(gorbn_t* r, gorbn_t* x, gorbn_barrett* ctx); /* r = x mod m */
+	GORBN_DEF void gorbn_barrett_mul(gorbn_t* r, gorbn_t* a, gorbn_t* b, gorbn_barrett* ctx); /* r = a * b mod m */
+	GORBN_DEF void gorbn_barrett_sqr(gorbn_t* r, gorbn_t* a, gorbn_barrett* ctx); /* r = a ^ 2 mod m */
 
 	/* Bitwise operations: */
 	GORBN_DEF void gorbn_and(gorbn_t* r, gorbn_t* a, gorbn_t* b); /* r = a & b */
@@ -228,15 +695,62 @@ extern "C" {
 	GORBN_DEF int gorbn_is_zero(gorbn_t* num);
 	GORBN_DEF int gorbn_is_one(gorbn_t* num);
 
+	/*
+		Sized operations on numbers of n words, n <= GORBN_SZARR.
+		Only n words of operands are read and only n words of r are
+		written (2 * n for products, m of the modular operations
+		is n words too). Functions above work the same with n = GORBN_SZARR.
+	*/
+	GORBN_DEF void gorbn_copy_n(gorbn_t* dst, gorbn_t* src, int n);
+	GORBN_DEF int gorbn_is_zero_n(gorbn_t* num, int n);
+	GORBN_DEF int gorbn_cmp_n(gorbn_t* a, gorbn_t* b, int n);
+	GORBN_DEF void gorbn_cmov_n(gorbn_t* r, gorbn_t* a, int cond, int n);
+	GORBN_DEF int gorbn_add_n(gorbn_t* r, gorbn_t* a, gorbn_t* b, int n); /* returns carry */
+	GORBN_DEF int gorbn_sub_n(gorbn_t* r, gorbn_t* a, gorbn_t* b, int n); /* returns borrow */
+	GORBN_DEF void gorbn_mul_n(gorbn_t* r, gorbn_t* a, gorbn_t* b, int n); /* r = a * b, r is 2 * n words */
+	GORBN_DEF void gorbn_sqr_n(gorbn_t* r, gorbn_t* a, int n); /* r = a ^ 2, r is 2 * n words */
+	GORBN_DEF void gorbn_add_mod_n(gorbn_t* r, gorbn_t* a, gorbn_t* b, gorbn_t* m, int n);
+	GORBN_DEF void gorbn_sub_mod_n(gorbn_t* r, gorbn_t* a, gorbn_t* b, gorbn_t* m, int n);
+
+	/* m = 2 ^ (n * GORBN_SZWORD_BITS) - c */
+	GORBN_DEF int gorbn_is_pseudo_mersenne_n(gorbn_t* m, int n);
+	GORBN_DEF void gorbn_mul_mod_pm_n(gorbn_t* r, gorbn_t* a, gorbn_t* b, gorbn_t* m, int n);
+	GORBN_DEF void gorbn_sqr_mod_pm_n(gorbn_t* r, gorbn_t* a, gorbn_t* m, int n);
+	GORBN_DEF void gorbn_mulword_mod_pm_n(gorbn_t* r, gorbn_t* a, gorbn_t w, gorbn_t* m, int n);
+
 	/* Eliptic curve algorithms */
+	GORBN_DEF void gorec_curve_setup(gorec_curve* crv);
+	GORBN_DEF void gorec_curve_precompute_base(gorec_curve* crv);
 	GORBN_DEF void gorec_load_stb128(gorec_curve* crv);
 
+	/*
+		Saving curve with its Montgomery and Barrett constants and base
+		tables into GOREC_CURVE_BLOB_SIZE bytes of data. Returns the size
+		written or 0 if data_size is too small. A curve with g set to a
+		long-lived key point gives table for that key the same way.
+
+		gorec_curve_load() checks the header and takes the blob without
+		rebuilding anything: tables are used in place, so data can be a
+		read-only mapping of the file shared between processes, e.g.
+			data = mmap(0, size, PROT_READ, MAP_SHARED, fd, 0);
+		data should be aligned to GOREC_CURVE_BLOB_ALIGN and stay valid
+		while crv is in use. Returns 0 if the blob is malformed or was
+		written by a build with other word size or table parameters.
+	*/
+	GORBN_DEF uint32_t gorec_curve_save(void* data, uint32_t data_size, gorec_curve* crv);
+	GORBN_DEF int gorec_curve_load(gorec_curve* crv, void* data, uint32_t data_size);
+
 	GORBN_DEF void gorec_pt_mul(
 		gorec_point* p_result,
 		gorec_point *p_point,
 		gorbn_t *p_scalar,
 		gorec_curve* crv);
 
+	/*
+		Constant-time r = s * p by co-Z Montgomery ladder, s in [0, q - 1]
+		and p in the subgroup of order q. Timing and memory access pattern
+		do not depend on s. Falls back to wNAF if q of the curve is not set.
+	*/
 	GORBN_DEF void gorec_pt_mul_monty(
 		gorec_point* p_result,
 		gorec_point *p_point,
@@ -249,6 +763,191 @@ extern "C" {
 		gorbn_t *p_scalar,
 		gorec_curve* crv);
 
+	/*
+		wNAF multiplication with window width w in [2, GOREC_WNAF_W_MAX].
+		w = 0 chooses the width by gorec_wnaf_width() for the length of
+		the scalar, which gorec_pt_mul_wnaf_jacobian() does.
+	*/
+	GORBN_DEF void gorec_pt_mul_wnaf_jacobian_w(
+		gorec_point* p_result,
+		gorec_point *p_point,
+		gorbn_t *p_scalar,
+		int w,
+		gorec_curve* crv);
+
+	/*
+		Window width for a scalar of nbits bits. Multiplication takes about
+		nbits / (w + 1) additions and 2 ^ (w - 2) points of the table.
+	*/
+	GORBN_DEF int gorec_wnaf_width(int nbits);
+
+	/*
+		Point conversion to and from the representation of the curve
+		field routines. Normalization routines work in that representation.
+	*/
+	GORBN_DEF void gorec_pt_to_field(gorec_point* r, gorec_point* p, gorec_curve* crv);
+	GORBN_DEF void gorec_pt_from_field(gorec_point* r, gorec_point* p, gorec_curve* crv);
+
+	/* r = 2 * a in Jacobian coordinates. _a3 version is valid only for a = -3 */
+	GORBN_DEF GOREC_PT_DOUBLE(gorec_pt_double_jacobian);
+	GORBN_DEF GOREC_PT_DOUBLE(gorec_pt_double_jacobian_a3);
+
+	/* r = a + b and r = a - b, a in Jacobian coordinates, b is normalized (z = 1) */
+	GORBN_DEF void gorec_pt_add_mixed(gorec_point* r, gorec_point* a, gorec_point* b, gorec_curve* crv);
+	GORBN_DEF void gorec_pt_sub_mixed(gorec_point* r, gorec_point* a, gorec_point* b, gorec_curve* crv);
+
+	/* Jacobian point to affine point (z = 1) with one inversion */
+	GORBN_DEF void gorec_pt_normalize(gorec_point* r, gorec_point* p, gorec_curve* crv);
+	/* In-place normalization of pts_count points with one inversion per GOREC_NORMALIZE_BATCH_CHUNK points */
+	GORBN_DEF void gorec_pt_normalize_batch(gorec_point* pts, int pts_count, gorec_curve* crv);
+
+	/*
+		Constant-time r = s * p for secret s in [1, q - 1]. Timing and
+		memory access pattern do not depend on s.
+	*/
+	GORBN_DEF void gorec_pt_mul_ct(
+		gorec_point* p_result,
+		gorec_point *p_point,
+		gorbn_t *p_scalar,
+		gorec_curve* crv);
+
+	/*
+		gorec_pt_mul_ct() and gorec_pt_mul2() with tables and temporary
+		points in arena of gorec_arena_deep() bytes instead of the stack.
+		The arena holds no state between calls.
+	*/
+	GORBN_DEF uint32_t gorec_arena_deep(void);
+	GORBN_DEF void gorec_pt_mul_ct_arena(
+		gorec_point* p_result,
+		gorec_point *p_point,
+		gorbn_t *p_scalar,
+		gorec_curve* crv,
+		gorec_arena* arena);
+	GORBN_DEF void gorec_pt_mul2_arena(
+		gorec_point* p_result,
+		gorbn_t *p_scalar_g,
+		gorec_point *p_point,
+		gorbn_t *p_scalar_p,
+		gorec_curve* crv,
+		gorec_arena* arena);
+
+	/*
+		r[i] = s[i] * p[i] for i in [0, count), results are those of
+		gorec_pt_mul_ct() bit for bit and the same constant-time rules
+		hold: s is array of count numbers, each in [1, q - 1]. Points are
+		taken GOREC_LANES at a time and run in lockstep, a group that is
+		not full is padded with its first point.
+	*/
+	GORBN_DEF void gorec_pt_mul_batch(
+		gorec_point* p_results,
+		gorec_point* p_points,
+		gorbn_t* p_scalars,
+		int count,
+		gorec_curve* crv);
+	GORBN_DEF void gorec_pt_mul_batch_arena(
+		gorec_point* p_results,
+		gorec_point* p_points,
+		gorbn_t* p_scalars,
+		int count,
+		gorec_curve* crv,
+		gorec_arena* arena);
+
+	/* r = s * g for s in [0, q - 1] using comb table of the curve */
+	GORBN_DEF void gorec_pt_mul_base(
+		gorec_point* p_result,
+		gorbn_t *p_scalar,
+		gorec_curve* crv);
+
+	/* r = s1 * g + s2 * p with one shared doubling chain */
+	GORBN_DEF void gorec_pt_mul2(
+		gorec_point* p_result,
+		gorbn_t *p_scalar_g,
+		gorec_point *p_point,
+		gorbn_t *p_scalar_p,
+		gorec_curve* crv);
+
+	/*
+		Square root modulo p for p = 3 mod 4: r = a ^ ((p + 1) / 4).
+		a and r are ordinary numbers, a < p. Returns 1 and the root if a is
+		a quadratic residue, 0 otherwise or if p != 3 mod 4. The other
+		root is p - r.
+	*/
+	GORBN_DEF int gorec_sqrt_mod(gorbn_t* r, gorbn_t* a, gorec_curve* crv);
+
+	/* 1 if affine p is infinity or x, y < p and y ^ 2 = x ^ 3 + a * x + b */
+	GORBN_DEF int gorec_pt_is_on_curve(gorec_point* p, gorec_curve* crv);
+
+	/*
+		Affine point with given x and parity of y. Returns 0 if there is
+		no such point on the curve. Needs p = 3 mod 4.
+	*/
+	GORBN_DEF int gorec_pt_from_x(gorec_point* r, gorbn_t* x, int y_is_odd, gorec_curve* crv);
+
+	/*
+		Compressed encoding of affine points: one byte 0x02 | (y & 1)
+		followed by x in the byte order of gorbn_to_data(), zero padded to
+		the byte length of p. Point at infinity is a single zero byte
+		followed by zeros. Decompression fails with 0 on a wrong size or
+		prefix, on x >= p and on x which is not on the curve.
+	*/
+	GORBN_DEF int gorec_pt_compressed_size(gorec_curve* crv);
+	GORBN_DEF void gorec_pt_compress(void* data, gorec_point* p, gorec_curve* crv);
+	GORBN_DEF int gorec_pt_decompress(gorec_point* r, void* data, uint32_t data_size, gorec_curve* crv);
+
+#ifdef GORBN_STATS
+	/* Counters of the calling thread */
+	GORBN_DEF gorbn_stats* gorbn_stats_get(void);
+	GORBN_DEF void gorbn_stats_reset(void);
+	/* to += from. For summing up counters of several threads */
+	GORBN_DEF void gorbn_stats_add(gorbn_stats* to, gorbn_stats* from);
+#ifdef __cplusplus
+	/* Writes stats as JSON object name: { mul_mod: { calls, cycles }, ... } */
+	GORBN_DEF void gorbn_stats_dump(json_writer* writer, char* name, gorbn_stats* stats);
+#endif
+#endif
+
+#ifdef GOREC_THREAD_POOL
+	/*
+		Starts threads_count - 1 threads. stack is gorec_pool_deep(threads_count)
+		bytes, aligned like gorec_point, that should live until
+		gorec_pool_free(): it is cut into the arenas of the workers.
+		Returns 1 on success, 0 if threads could not be started.
+	*/
+	GORBN_DEF uint32_t gorec_pool_deep(int threads_count);
+	GORBN_DEF int gorec_pool_init(gorec_pool* pool, int threads_count, void* stack);
+	GORBN_DEF void gorec_pool_free(gorec_pool* pool);
+
+	/*
+		r[i] = s[i] * p[i] for i in [0, count) with gorec_pt_mul_batch_arena()
+		when SIMD lanes are built in and gorec_pt_mul_ct_arena() otherwise,
+		jobs are spread across the workers of pool. s is array of count
+		numbers, each in [1, q - 1].
+	*/
+	GORBN_DEF void gorec_mul_batch(
+		gorec_pool* pool,
+		gorec_point* p_results,
+		gorec_point* p_points,
+		gorbn_t* p_scalars,
+		int count,
+		gorec_curve* crv);
+
+	/*
+		results[i] = 1 if R = sg[i] * g + sp[i] * p[i] is not the point at
+		infinity and (R.x mod q) == rs[i], 0 otherwise. sg, sp and rs are
+		arrays of count numbers. Verification runs in variable time, every
+		job is one gorec_pt_mul2_arena().
+	*/
+	GORBN_DEF void gorec_verify_batch(
+		gorec_pool* pool,
+		int* p_results,
+		gorec_point* p_points,
+		gorbn_t* p_scalars_g,
+		gorbn_t* p_scalars_p,
+		gorbn_t* p_rs,
+		int count,
+		gorec_curve* crv);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -258,6 +957,62 @@ extern "C" {
 #if defined(GOR_BIGNUM_IMPLEMENTATION) && !defined(GOR_BIGNUM_IMPLEMENTATION_DONE)
 #define GOR_BIGNUM_IMPLEMENTATION_DONE
 
+#ifdef GORBN_STATS
+static GORBN_THREAD_LOCAL gorbn_stats _gorbn_thread_stats;
+
+static const char* _gorbn_stat_names[GORBN_STAT_COUNT] = {
+	"mul_mod",
+	"sqr_mod",
+	"inv_mod",
+	"div",
+	"pt_add",
+	"pt_add_mixed",
+	"pt_double",
+};
+
+static void _gorbn_stat_end(int id, uint64_t start) {
+	gorbn_stat* stat = &_gorbn_thread_stats.stats[id];
+
+	stat->calls++;
+	stat->cycles += GORBN_READ_CYCLES() - start;
+}
+
+gorbn_stats* gorbn_stats_get(void) {
+	return(&_gorbn_thread_stats);
+}
+
+void gorbn_stats_reset(void) {
+	int i;
+	for (i = 0; i < GORBN_STAT_COUNT; i++) {
+		_gorbn_thread_stats.stats[i].calls = 0;
+		_gorbn_thread_stats.stats[i].cycles = 0;
+	}
+}
+
+void gorbn_stats_add(gorbn_stats* to, gorbn_stats* from) {
+	int i;
+	for (i = 0; i < GORBN_STAT_COUNT; i++) {
+		to->stats[i].calls += from->stats[i].calls;
+		to->stats[i].cycles += from->stats[i].cycles;
+	}
+}
+
+#ifdef __cplusplus
+void gorbn_stats_dump(json_writer* writer, char* name, gorbn_stats* stats) {
+	int i;
+
+	JSONBeginName(writer, name);
+	for (i = 0; i < GORBN_STAT_COUNT; i++) {
+		JSONBeginName(writer, (char*)_gorbn_stat_names[i]);
+		JSONAddU64(writer, (char*)"calls", stats->stats[i].calls);
+		JSONAddU64(writer, (char*)"cycles", stats->stats[i].cycles);
+		JSONEnd(writer);
+	}
+	JSONEnd(writer);
+}
+#endif
+#endif
+
 void _gorbn_mem_copy(void* to, void* from, size_t byte_count) {
 	uint8_t* _to = (uint8_t*)to;
 	uint8_t* _from = (uint8_t*)from;
@@ -292,7 +1047,7 @@ static int _gorbn_get_ndigits(gorbn_t* a, int digit_count_alloc) {
 
 static int _gorbn_get_nbits(gorbn_t* a, int digit_count_alloc) {
 	int i;
-	int digit;
+	gorbn_t digit;
 
 	int num_digits = _gorbn_get_ndigits(a, digit_count_alloc);
 	if (num_digits == 0) {
@@ -309,7 +1064,7 @@ static int _gorbn_get_nbits(gorbn_t* a, int digit_count_alloc) {
 
 static int _gorbn_testbit(gorbn_t* a, int bitnum) {
 
-	int Result = (a[bitnum / GORBN_SZWORD_BITS] & (1 << (bitnum % GORBN_SZWORD_BITS)));
+	int Result = ((a[bitnum / GORBN_SZWORD_BITS] >> (bitnum % GORBN_SZWORD_BITS)) & 1);
 
 	return(Result);
 }
@@ -334,6 +1089,10 @@ int gorbn_is_zero(gorbn_t* num) {
 	return(_gorbn_is_zero_internal(num, GORBN_SZARR));
 }
 
+int gorbn_is_zero_n(gorbn_t* num, int n) {
+	return(_gorbn_is_zero_internal(num, n));
+}
+
 static int _gorbn_is_one_internal(gorbn_t* num, int num_digit_count) {
 	int i;
 
@@ -374,6 +1133,10 @@ void gorbn_copy(gorbn_t* dst, gorbn_t* src){
 	gorbn_copy_internal(dst, src, GORBN_SZARR);
 }
 
+void gorbn_copy_n(gorbn_t* dst, gorbn_t* src, int n) {
+	gorbn_copy_internal(dst, src, n);
+}
+
 
 void gorbn_from_uint(gorbn_t* n, gorbn_utmp_t i){
 	gorbn_init(n, GORBN_SZARR);
@@ -387,8 +1150,11 @@ void gorbn_from_uint(gorbn_t* n, gorbn_utmp_t i){
 	n[0] = i;
 	n[1] = i >> 16;
 #elif (GORBN_SZWORD == 4)
-	n->number[0] = i;
-	n->number[1] = i >> 32;
+	n[0] = (gorbn_t)i;
+	n[1] = (gorbn_t)(i >> 32);
+#elif (GORBN_SZWORD == 8)
+	n[0] = (gorbn_t)i;
+	n[1] = (gorbn_t)(i >> 64);
 #endif
 }
 
@@ -407,8 +1173,11 @@ void gorbn_from_int(gorbn_t* n, gorbn_stmp_t i){
 	n[0] = i;
 	n[1] = i >> 16;
 #elif (GORBN_SZWORD == 4)
-	n[0] = i;
-	n[1] = i >> 32;
+	n[0] = (gorbn_t)i;
+	n[1] = (gorbn_t)(i >> 32);
+#elif (GORBN_SZWORD == 8)
+	n[0] = (gorbn_t)i;
+	n[1] = (gorbn_t)(i >> 64);
 #endif
 }
 
@@ -425,18 +1194,14 @@ void gorbn_from_data(gorbn_t* n, void* data, uint32_t data_size){
 	}
 }
 
-void gorbn_to_data(void* data, uint32_t* written_datasize, uint32_t data_size, gorbn_t* n){
-	int i;
-
-	gorbn_t* at = n;
-	gorbn_t* to = (gorbn_t*)data;
+void gorbn_to_data(void* data, uint32_t data_size, gorbn_t* n){
+	uint32_t i;
 
-	for(i = 0; i < GORBN_SZARR; i++){
-		*to++ = *at++;
-	}
+	unsigned char* at = (unsigned char*)n;
+	unsigned char* to = (unsigned char*)data;
 
-	if (written_datasize) {
-		*written_datasize = i * GORBN_SZWORD;
+	for(i = 0; i < data_size; i++){
+		*to++ = (i < GORBN_SZARR * GORBN_SZWORD) ? *at++ : 0;
 	}
 }
 
@@ -493,7 +1258,7 @@ void gorbn_lshift_words(gorbn_t* a, int nwords) {
 void gorbn_rshift_words(gorbn_t* a, int nwords) {
 	int i;
 	if (nwords > 0) {
-		for (i = 0; i < nwords; i++) {
+		for (i = 0; i < (GORBN_SZARR - nwords); i++) {
 			a[i] = a[i + nwords];
 		}
 
@@ -504,13 +1269,13 @@ void gorbn_rshift_words(gorbn_t* a, int nwords) {
 }
 
 //NOTE(dima): Computes r = a + b, returning carry.
-int gorbn_add(gorbn_t* r, gorbn_t* a, gorbn_t* b) {
+int gorbn_add_n(gorbn_t* r, gorbn_t* a, gorbn_t* b, int n) {
 	int i;
 	gorbn_t carry = 0;
 
-	for (i = 0; i < GORBN_SZARR; i++) {
+	for (i = 0; i < n; i++) {
 #if 1
-		gorbn_utmp_t sum = a[i] + b[i] + carry;
+		gorbn_utmp_t sum = (gorbn_utmp_t)a[i] + b[i] + carry;
 		carry = (sum > GORBN_MAX_VAL);
 		r[i] = (sum & GORBN_MAX_VAL);
 #else
@@ -525,12 +1290,16 @@ int gorbn_add(gorbn_t* r, gorbn_t* a, gorbn_t* b) {
 	return(carry);
 }
 
-int gorbn_sub(gorbn_t* r, gorbn_t* a, gorbn_t* b) {
+int gorbn_add(gorbn_t* r, gorbn_t* a, gorbn_t* b) {
+	return(gorbn_add_n(r, a, b, GORBN_SZARR));
+}
+
+int gorbn_sub_n(gorbn_t* r, gorbn_t* a, gorbn_t* b, int n) {
 	int i;
 	int borrow = 0;
 	gorbn_utmp_t res;
 
-	for (i = 0; i < GORBN_SZARR; i++) {
+	for (i = 0; i < n; i++) {
 		gorbn_utmp_t tmp1 = (gorbn_utmp_t)a[i] + ((gorbn_utmp_t)GORBN_MAX_VAL + 1);
 		gorbn_utmp_t tmp2 = (gorbn_utmp_t)b[i] + borrow;
 		res = (tmp1 - tmp2);
@@ -541,6 +1310,10 @@ int gorbn_sub(gorbn_t* r, gorbn_t* a, gorbn_t* b) {
 	return(borrow);
 }
 
+int gorbn_sub(gorbn_t* r, gorbn_t* a, gorbn_t* b) {
+	return(gorbn_sub_n(r, a, b, GORBN_SZARR));
+}
+
 void gorbn_mul_word(gorbn_t* r, gorbn_t* a, gorbn_t w) {
 	_gorbn_zero_number(r, GORBN_SZARR + 1);
 
@@ -562,15 +1335,19 @@ void gorbn_mul_word(gorbn_t* r, gorbn_t* a, gorbn_t w) {
 	r[GORBN_SZARR] = c;
 }
 
-void gorbn_mul(gorbn_t* r, gorbn_t* a, gorbn_t* b) {
+void gorbn_mul_n(gorbn_t* r, gorbn_t* a, gorbn_t* b, int n) {
 	int i, j;
 	int a_ndigits;
 	int b_ndigits;
 
-	_gorbn_zero_number(r, GORBN_SZARR * 2);
+	_gorbn_zero_number(r, n * 2);
 
-	a_ndigits = _gorbn_get_ndigits(a, GORBN_SZARR);
-	b_ndigits = _gorbn_get_ndigits(b, GORBN_SZARR);
+	/*
+		NOTE(dima): Leading zero words are not skipped. Skipping them
+		leaks the size of operands through timing.
+	*/
+	a_ndigits = n;
+	b_ndigits = n;
 
 	for (i = 0; i < b_ndigits; i++) {
 		gorbn_utmp_t uv;
@@ -589,21 +1366,25 @@ void gorbn_mul(gorbn_t* r, gorbn_t* a, gorbn_t* b) {
 	}
 }
 
-void gorbn_sqr(gorbn_t* r, gorbn_t* a) {
+void gorbn_mul(gorbn_t* r, gorbn_t* a, gorbn_t* b) {
+	gorbn_mul_n(r, a, b, GORBN_SZARR);
+}
+
+void gorbn_sqr_n(gorbn_t* r, gorbn_t* a, int n) {
 	int i, j;
 	int a_ndigits;
-	int b_ndigits;
 
 	gorbn_utmp_t carry = 0;
 	gorbn_utmp_t carry1;
 
-	_gorbn_zero_number(r, GORBN_SZARR * 2);
+	_gorbn_zero_number(r, n * 2);
 
-	a_ndigits = _gorbn_get_ndigits(a, GORBN_SZARR);
+	//NOTE(dima): Leading zero words are not skipped, same as in gorbn_mul
+	a_ndigits = n;
 
 	for (i = 0; i < a_ndigits; i++) {
 		for (j = i + 1; j < a_ndigits; j++) {
-			gorbn_utmp_t tmp_mul = a[i] * a[j];
+			gorbn_utmp_t tmp_mul = (gorbn_utmp_t)a[i] * a[j];
 			tmp_mul += carry;
 			tmp_mul += r[i + j];
 			r[i + j] = (gorbn_t)tmp_mul;
@@ -620,7 +1401,7 @@ void gorbn_sqr(gorbn_t* r, gorbn_t* a) {
 	}
 
 	for (i = 0; i < a_ndigits; i++) {
-		gorbn_utmp_t tmp_mul = a[i] * a[i];
+		gorbn_utmp_t tmp_mul = (gorbn_utmp_t)a[i] * a[i];
 		tmp_mul += carry;
 		tmp_mul += r[i + i];
 		r[i + i] = (gorbn_t)tmp_mul;
@@ -631,6 +1412,10 @@ void gorbn_sqr(gorbn_t* r, gorbn_t* a) {
 	}
 }
 
+void gorbn_sqr(gorbn_t* r, gorbn_t* a) {
+	gorbn_sqr_n(r, a, GORBN_SZARR);
+}
+
 void gorbn_mul_pow2(gorbn_t* r, gorbn_t* a, int k) {
 	gorbn_lshift(r, a, k);
 }
@@ -684,117 +1469,166 @@ void gorbn_mod_word(
 
 
 /*
-	NOTE(Dima):
-		q - the quotient output param. Can be NULL.
-		r - the remainder output param. Can be NULL.
-		x - the divident input param.
-		y - the divisor input param.
+	NOTE(dima):
+		Knuth's algorithm D (TAOCP vol. 2, 4.3.1). Divisor is normalized
+		so that the high bit of its top word is set, then every quotient
+		word is estimated from the top two words of the remainder and
+		corrected with the third one. The estimate is too large by at most
+		one after that, which is fixed by adding the divisor back.
+		x is at most GORBN_DIV_MAX_WORDS words. q_buf gets x_n words,
+		r_buf gets y_n words. Division by zero gives q = r = 0.
 */
-void gorbn_div(
-	gorbn_t* q,
-	gorbn_t* r,
-	gorbn_t* x, int x_digit_count_alloc,
-	gorbn_t* y, int y_digit_count_alloc)
+static void _gorbn_div_core(
+	gorbn_t* q_buf,
+	gorbn_t* r_buf,
+	gorbn_t* x, int x_n,
+	gorbn_t* y, int y_n)
 {
-	gorbn_utmp_t c_pred, r_pred;
-
-	gorbn_t a_norm[GORBN_SZARR * 4];
-	gorbn_t b_norm[GORBN_SZARR * 4];
-	gorbn_t q_buf[GORBN_SZARR * 2];
-	gorbn_t r_buf[GORBN_SZARR * 2];
-
-	gorbn_init(a_norm, GORBN_SZARR * 4);
-	gorbn_init(b_norm, GORBN_SZARR * 4);
-
-	gorbn_init(q_buf, GORBN_SZARR * 2);
-	gorbn_init(r_buf, GORBN_SZARR * 2);
-
-	gorbn_copy_internal(a_norm, x, x_digit_count_alloc);
-	gorbn_copy_internal(b_norm, y, y_digit_count_alloc);
+	gorbn_t a_norm[GORBN_DIV_MAX_WORDS + 1];
+	gorbn_t b_norm[GORBN_DIV_MAX_WORDS];
 
-	int a_ndig = _gorbn_get_ndigits(x, x_digit_count_alloc);
-	int b_ndig = _gorbn_get_ndigits(y, y_digit_count_alloc);
+	int a_ndig = _gorbn_get_ndigits(x, x_n);
+	int b_ndig = _gorbn_get_ndigits(y, y_n);
 
 	int i, j;
 	gorbn_utmp_t mod_bn = (gorbn_utmp_t)GORBN_MAX_VAL + 1;
-	gorbn_utmp_t p = 0;
-	gorbn_stmp_t carry = 0;
+	gorbn_utmp_t p;
+	gorbn_stmp_t carry;
 	gorbn_stmp_t t;
 
-	int begin_cmp_res = gorbn_cmp(x, y);
-	if (begin_cmp_res == GORBN_CMP_EQUAL) {
-		//NOTE(DIMA): If divisor is equal to divident than return 1
-		q_buf[0] = 1;
+	_gorbn_zero_number(q_buf, x_n);
+	_gorbn_zero_number(r_buf, y_n);
+
+	if (b_ndig == 0) {
+		return;
+	}
+
+	if (a_ndig < b_ndig) {
+		gorbn_copy_internal(r_buf, x, a_ndig);
+		return;
 	}
-	else if (b_ndig == 1) {
+
+	if (b_ndig == 1) {
 		//NOTE(DIMA): If divisor is small number (== 1 word)
-		
+		gorbn_utmp_t rem = 0;
+
 		for (j = a_ndig - 1; j >= 0; j--) {
-			q_buf[j] = (gorbn_t)((carry * mod_bn + x[j]) / y[0]);
-			carry = (carry * mod_bn + x[j]) - q_buf[j] * y[0];
+			gorbn_utmp_t cur = rem * mod_bn + x[j];
+			q_buf[j] = (gorbn_t)(cur / y[0]);
+			rem = cur - (gorbn_utmp_t)q_buf[j] * y[0];
 		}
 
-		r_buf[0] = (gorbn_t)carry;
+		r_buf[0] = (gorbn_t)rem;
+		return;
+	}
+
+	int norm_val = 0;
+	gorbn_t top_word = y[b_ndig - 1];
+	while (!(top_word & GORBN_HIGH_BIT_SET)) {
+		top_word = (gorbn_t)(top_word << 1);
+		norm_val++;
+	}
+
+	if (norm_val) {
+		a_norm[a_ndig] = (gorbn_t)(x[a_ndig - 1] >> (GORBN_SZWORD_BITS - norm_val));
+		for (i = a_ndig - 1; i > 0; i--) {
+			a_norm[i] = (gorbn_t)((x[i] << norm_val) | (x[i - 1] >> (GORBN_SZWORD_BITS - norm_val)));
+		}
+		a_norm[0] = (gorbn_t)(x[0] << norm_val);
+
+		for (i = b_ndig - 1; i > 0; i--) {
+			b_norm[i] = (gorbn_t)((y[i] << norm_val) | (y[i - 1] >> (GORBN_SZWORD_BITS - norm_val)));
+		}
+		b_norm[0] = (gorbn_t)(y[0] << norm_val);
 	}
 	else {
+		gorbn_copy_internal(a_norm, x, a_ndig);
+		a_norm[a_ndig] = 0;
+		gorbn_copy_internal(b_norm, y, b_ndig);
+	}
 
-		//int b_nbits = _gorbn_get_nbits(y, y_digit_count_alloc);
-		//int norm_val = (GORBN_SZWORD_BITS - b_nbits & GORBN_SZWORD_BITS_MINUS_ONE) & GORBN_SZWORD_BITS_MINUS_ONE;
-		//gorbn_mul_pow2(a_norm, x, norm_val);
-
-		for (j = a_ndig - b_ndig; j >= 0; j--) {
-			int j_plus_b_ndig = j + b_ndig;
-			gorbn_utmp_t asd =
-				((gorbn_utmp_t)a_norm[j_plus_b_ndig] * mod_bn) +
-				(gorbn_utmp_t)a_norm[j_plus_b_ndig - 1];
-
-			c_pred = asd / b_norm[b_ndig - 1];
-			r_pred = asd - c_pred * b_norm[b_ndig - 1];
-
-			do {
-				p = 0;
-				if (
-					(c_pred >= mod_bn) ||
-					((c_pred * (gorbn_utmp_t)b_norm[b_ndig - 2]) > (mod_bn * r_pred + (gorbn_utmp_t)a_norm[j + b_ndig - 2])))
-				{
-					c_pred--;
-					r_pred += b_norm[b_ndig - 1];
-					if (r_pred < mod_bn) {
-						p = 1;
-					}
-				}
-			} while (p);
+	gorbn_utmp_t b_top = b_norm[b_ndig - 1];
+	gorbn_utmp_t b_next = b_norm[b_ndig - 2];
+
+	for (j = a_ndig - b_ndig; j >= 0; j--) {
+		gorbn_utmp_t top =
+			((gorbn_utmp_t)a_norm[j + b_ndig] << GORBN_SZWORD_BITS) |
+			(gorbn_utmp_t)a_norm[j + b_ndig - 1];
+
+		gorbn_utmp_t c_pred = top / b_top;
+		gorbn_utmp_t r_pred = top - c_pred * b_top;
+
+		//NOTE(dima): Runs at most twice
+		while (c_pred >= mod_bn ||
+			c_pred * b_next > ((r_pred << GORBN_SZWORD_BITS) | a_norm[j + b_ndig - 2]))
+		{
+			c_pred--;
+			r_pred += b_top;
+			if (r_pred >= mod_bn) {
+				break;
+			}
+		}
+
+		carry = 0;
+		for (i = 0; i < b_ndig; i++) {
+			p = c_pred * b_norm[i];
+			t = (gorbn_stmp_t)a_norm[i + j] - carry - (gorbn_stmp_t)(p & GORBN_MAX_VAL);
+			a_norm[i + j] = (gorbn_t)t;
+			carry = (gorbn_stmp_t)(p >> GORBN_SZWORD_BITS) - (t >> GORBN_SZWORD_BITS);
+		}
 
+		t = (gorbn_stmp_t)a_norm[j + b_ndig] - carry;
+		a_norm[j + b_ndig] = (gorbn_t)t;
+		q_buf[j] = (gorbn_t)c_pred;
+
+		if (t < 0) {
+			q_buf[j]--;
 			carry = 0;
 			for (i = 0; i < b_ndig; i++) {
-				p = c_pred * b_norm[i];
-				t = a_norm[i + j] - carry - (p & GORBN_MAX_VAL);
+				t = (gorbn_stmp_t)a_norm[i + j] + b_norm[i] + carry;
 				a_norm[i + j] = (gorbn_t)t;
-				carry = (p >> GORBN_SZWORD_BITS) - (t >> GORBN_SZWORD_BITS);
-			}
-
-			t = a_norm[j + b_ndig] - carry;
-			a_norm[j + b_ndig] = (gorbn_t)t;
-			q_buf[j] = (gorbn_t)c_pred;
-
-			if (t < 0) {
-				q_buf[j]--;
-				carry = 0;
-				for (i = 0; i < b_ndig; i++) {
-					t = a_norm[i + j] + b_norm[i] + carry;
-					a_norm[i + j] = (gorbn_t)t;
-					carry = t >> GORBN_SZWORD_BITS;
-				}
-				a_norm[j + b_ndig] = (gorbn_t)(a_norm[j + b_ndig] + carry);
+				carry = t >> GORBN_SZWORD_BITS;
 			}
+			a_norm[j + b_ndig] = (gorbn_t)(a_norm[j + b_ndig] + carry);
 		}
+	}
 
-		if (begin_cmp_res == GORBN_CMP_SMALLER) {
-			int asdfg = 1;
+	if (norm_val) {
+		for (i = 0; i < b_ndig - 1; i++) {
+			r_buf[i] = (gorbn_t)((a_norm[i] >> norm_val) | (a_norm[i + 1] << (GORBN_SZWORD_BITS - norm_val)));
 		}
-
-		gorbn_copy(r_buf, a_norm);
+		r_buf[b_ndig - 1] = (gorbn_t)(a_norm[b_ndig - 1] >> norm_val);
+	}
+	else {
+		gorbn_copy_internal(r_buf, a_norm, b_ndig);
 	}
+}
+
+/*
+	NOTE(Dima):
+		q - the quotient output param. Can be NULL.
+		r - the remainder output param. Can be NULL.
+		x - the divident input param.
+		y - the divisor input param.
+*/
+void gorbn_div(
+	gorbn_t* q,
+	gorbn_t* r,
+	gorbn_t* x, int x_digit_count_alloc,
+	gorbn_t* y, int y_digit_count_alloc)
+{
+	GORBN_STAT_BEGIN(GORBN_STAT_DIV);
+	gorbn_t q_buf[GORBN_DIV_MAX_WORDS];
+	gorbn_t r_buf[GORBN_DIV_MAX_WORDS];
+
+	//NOTE(dima): Short inputs are zero-extended, so both buffers have at least GORBN_SZARR words
+	_gorbn_zero_number(q_buf, GORBN_SZARR);
+	_gorbn_zero_number(r_buf, GORBN_SZARR);
+
+	_gorbn_div_core(
+		q_buf, r_buf,
+		x, x_digit_count_alloc,
+		y, y_digit_count_alloc);
 
 	if (q) {
 		gorbn_copy(q, q_buf);
@@ -803,6 +1637,7 @@ void gorbn_div(
 	if (r) {
 		gorbn_copy(r, r_buf);
 	}
+	GORBN_STAT_END(GORBN_STAT_DIV);
 }
 
 #if 0
@@ -862,33 +1697,97 @@ void gorbn_mod_pow2(gorbn_t* r, gorbn_t* a, int k) {
 	}
 
 	for (j = 0; j < nbits_rest; j++) {
-		last_word_mask |= (1 << i);
+		last_word_mask |= ((gorbn_t)1 << j);
 	}
 	
-	r_buf[i] = a[i] & last_word_mask;
+	if (i < GORBN_SZARR) {
+		r_buf[i] = a[i] & last_word_mask;
+	}
 
 	gorbn_copy(r, r_buf);
 }
 
+/*
+	r = cond ? a : r. Does not branch on cond, so it can be used
+	on secret data.
+*/
+void gorbn_cmov_n(gorbn_t* r, gorbn_t* a, int cond, int n) {
+	gorbn_t mask = (gorbn_t)0 - (gorbn_t)(cond != 0);
+	int i;
+
+	for (i = 0; i < n; i++) {
+		r[i] = (gorbn_t)((r[i] & ~mask) | (a[i] & mask));
+	}
+}
+
+void gorbn_cmov(gorbn_t* r, gorbn_t* a, int cond) {
+	gorbn_cmov_n(r, a, cond, GORBN_SZARR);
+}
+
+/*NOTE(dima): Modular addition and subtraction do not branch on data*/
+void gorbn_add_mod_n(gorbn_t* r, gorbn_t* a, gorbn_t* b, gorbn_t* m, int n) {
+	gorbn_t sum[GORBN_SZARR];
+	gorbn_t diff[GORBN_SZARR];
+	gorbn_utmp_t uv;
+	gorbn_utmp_t carry = 0;
+	gorbn_utmp_t borrow = 0;
+	int i;
+
+	for (i = 0; i < n; i++) {
+		uv = (gorbn_utmp_t)a[i] + b[i] + carry;
+		sum[i] = (gorbn_t)uv;
+		carry = uv >> GORBN_SZWORD_BITS;
+	}
+
+	for (i = 0; i < n; i++) {
+		uv = (gorbn_utmp_t)sum[i] - m[i] - borrow;
+		diff[i] = (gorbn_t)uv;
+		borrow = (uv >> GORBN_SZWORD_BITS) & 1;
+	}
+
+	//NOTE(dima): a + b - m is taken if a + b overflowed or a + b >= m
+	gorbn_t mask = (gorbn_t)0 - (gorbn_t)(carry | (borrow ^ 1));
+	for (i = 0; i < n; i++) {
+		r[i] = (gorbn_t)((sum[i] & ~mask) | (diff[i] & mask));
+	}
+}
+
 void gorbn_add_mod(gorbn_t* r, gorbn_t* a, gorbn_t* b, gorbn_t* m) {
-	int carry = gorbn_add(r, a, b);
-	if (carry || gorbn_cmp(r, m) >= 0) {
-		gorbn_sub(r, r, m);
+	gorbn_add_mod_n(r, a, b, m, GORBN_SZARR);
+}
+
+void gorbn_sub_mod_n(gorbn_t* r, gorbn_t* a, gorbn_t* b, gorbn_t* m, int n) {
+	gorbn_utmp_t uv;
+	gorbn_utmp_t carry = 0;
+	gorbn_utmp_t borrow = 0;
+	int i;
+
+	for (i = 0; i < n; i++) {
+		uv = (gorbn_utmp_t)a[i] - b[i] - borrow;
+		r[i] = (gorbn_t)uv;
+		borrow = (uv >> GORBN_SZWORD_BITS) & 1;
+	}
+
+	//NOTE(dima): m is added back only if a - b borrowed
+	gorbn_t mask = (gorbn_t)0 - (gorbn_t)borrow;
+	for (i = 0; i < n; i++) {
+		uv = (gorbn_utmp_t)r[i] + (m[i] & mask) + carry;
+		r[i] = (gorbn_t)uv;
+		carry = uv >> GORBN_SZWORD_BITS;
 	}
 }
 
 void gorbn_sub_mod(gorbn_t* r, gorbn_t* a, gorbn_t* b, gorbn_t* m) {
-	int borrow = gorbn_sub(r, a, b);
-	if (borrow) {
-		gorbn_add(r, r, m);
-	}
+	gorbn_sub_mod_n(r, a, b, m, GORBN_SZARR);
 }
 
 void gorbn_mul_mod(gorbn_t* r, gorbn_t* a, gorbn_t* b, gorbn_t* m) {
+	GORBN_STAT_BEGIN(GORBN_STAT_MUL_MOD);
 	gorbn_t mul_res[GORBN_SZARR * 2];
 	gorbn_mul(mul_res, a, b);
 
 	gorbn_div(0, r, mul_res, GORBN_SZARR * 2, m, GORBN_SZARR);
+	GORBN_STAT_END(GORBN_STAT_MUL_MOD);
 }
 
 void gorbn_mulword_mod(gorbn_t* r, gorbn_t* a, gorbn_t w, gorbn_t* m) {
@@ -899,619 +1798,3807 @@ void gorbn_mulword_mod(gorbn_t* r, gorbn_t* a, gorbn_t w, gorbn_t* m) {
 }
 
 void gorbn_sqr_mod(gorbn_t* r, gorbn_t* a, gorbn_t* m) {
+	GORBN_STAT_BEGIN(GORBN_STAT_SQR_MOD);
 	gorbn_t mul_res[GORBN_SZARR * 2];
 	//gorbn_mul(mul_res, a, a);
 	gorbn_sqr(mul_res, a);
 
 	gorbn_div(0, r, mul_res, GORBN_SZARR * 2, m, GORBN_SZARR);
+	GORBN_STAT_END(GORBN_STAT_SQR_MOD);
 }
 
-/* Getting inverse by modulo*/
-void gorbn_inv_mod(gorbn_t* result, gorbn_t *a, gorbn_t* m) {
-	gorbn_t u[GORBN_SZARR]; 
-	gorbn_t v[GORBN_SZARR];
-	gorbn_t r[GORBN_SZARR];
-	gorbn_t s[GORBN_SZARR];
-
-	gorbn_copy(u, m);
-	gorbn_copy(v, a);
-	gorbn_init(r, GORBN_SZARR);
-	gorbn_init(s, GORBN_SZARR);
-	s[0] = 1;
+int gorbn_is_pseudo_mersenne_n(gorbn_t* m, int n) {
+	int i;
 
-	while (!gorbn_is_zero(v)) {
-		if (GORBN_EVEN(u)) {
-			if (GORBN_EVEN(r)) {
-				gorbn_rshift_one_bit(u);
-				gorbn_rshift_one_bit(r);
-			}
-			else {
-				gorbn_rshift_one_bit(u);
-				int carry = gorbn_add(r, r, m);
-				gorbn_rshift_one_bit(r);
-				if (carry) {
-					r[GORBN_SZARR - 1] |= GORBN_HIGH_BIT_SET;
-				}
-			}
-		}
-		else if (GORBN_EVEN(v)) {
-			if (GORBN_EVEN(s)) {
-				gorbn_rshift_one_bit(v);
-				gorbn_rshift_one_bit(s);
-			}
-			else {
-				gorbn_rshift_one_bit(v);
-				int carry = gorbn_add(s, s, m);
-				gorbn_rshift_one_bit(s);
-				if (carry) {
-					s[GORBN_SZARR - 1] |= GORBN_HIGH_BIT_SET;
-				}
-			}
-		}
-		else {
-			if (gorbn_cmp(u, v) > 0) {
-				gorbn_sub(u, u, v);
-				int borrow = gorbn_sub(r, r, s);
-				if (borrow) {
-					gorbn_add(r, r, m);
-				}
-			}
-			else {
-				gorbn_sub(v, v, u);
-				int borrow = gorbn_sub(s, s, r);
-				if (borrow) {
-					gorbn_add(s, s, m);
-				}
-			}
-		}
+	/*NOTE(dima): c = 2 ^ N - m should be nonzero and fit in one word*/
+	if (n == 0 || m[0] == 0) {
+		return(0);
 	}
 
-	if (gorbn_cmp(r, m) > 0) {
-		gorbn_sub(r, r, m);
+	for (i = 1; i < n; i++) {
+		if (m[i] != GORBN_MAX_VAL) {
+			return(0);
+		}
 	}
 
-	gorbn_copy(result, r);
+	return(1);
 }
 
-/* logical AND */
-void gorbn_and(gorbn_t* r, gorbn_t* a, gorbn_t* b, int digit_count)
-{
-	int walk_count = digit_count;
+int gorbn_is_pseudo_mersenne(gorbn_t* m) {
+	return(gorbn_is_pseudo_mersenne_n(m, GORBN_SZARR));
+}
 
+/*
+	NOTE(dima): 
+		Reduces x modulo m = 2 ^ N - c, where N = n * GORBN_SZWORD_BITS.
+		x = H * 2 ^ N + L = H * c + L (mod m), so the high part is folded
+		down twice and then at most one subtraction of m is needed.
+		x_digit_count_alloc should not be greater than n * 2.
+*/
+static void _gorbn_reduce_pm(gorbn_t* r, gorbn_t* x, int x_digit_count_alloc, gorbn_t* m, int n) {
+	gorbn_t res[GORBN_SZARR];
+	gorbn_t c = (gorbn_t)(0 - m[0]);
+	gorbn_utmp_t uv;
+	gorbn_utmp_t carry = 0;
 	int i;
-	for (i = 0; i < walk_count; i++) {
-		r[i] = a[i] & b[i];
-	}
-}
 
-/* logical OR */
-void gorbn_or(gorbn_t* r, gorbn_t* a, gorbn_t* b, int digit_count) {
-	int walk_count = digit_count;
+	/*NOTE(dima): res + carry * 2 ^ N = L + H * c*/
+	for (i = 0; i < n; i++) {
+		uv = (gorbn_utmp_t)x[i] + carry;
+		if (i + n < x_digit_count_alloc) {
+			uv += (gorbn_utmp_t)x[i + n] * (gorbn_utmp_t)c;
+		}
+		res[i] = (gorbn_t)(uv & GORBN_MAX_VAL);
+		carry = uv >> GORBN_SZWORD_BITS;
+	}
 
-	int i;
-	for (i = 0; i < walk_count; i++) {
-		r[i] = a[i] | b[i];
+	/*
+		NOTE(dima): Folding the carry word once more. Loops do not stop
+		on zero carry so that timing does not depend on the value.
+	*/
+	carry = carry * (gorbn_utmp_t)c;
+	for (i = 0; i < n; i++) {
+		uv = (gorbn_utmp_t)res[i] + carry;
+		res[i] = (gorbn_t)(uv & GORBN_MAX_VAL);
+		carry = uv >> GORBN_SZWORD_BITS;
 	}
-}
 
-/* logical XOR */
-void gorbn_xor(gorbn_t* r, gorbn_t* a, gorbn_t* b, int digit_count) {
-	int walk_count = digit_count;
+	/*
+		NOTE(dima): If 2 ^ N overflowed again then res is small and
+		res + 2 ^ N - m = res + c is the result, which is also what
+		res - m gives modulo 2 ^ N. Otherwise res - m is taken only
+		if it does not borrow.
+	*/
+	gorbn_t diff[GORBN_SZARR];
+	gorbn_utmp_t borrow = 0;
+	for (i = 0; i < n; i++) {
+		uv = (gorbn_utmp_t)res[i] - m[i] - borrow;
+		diff[i] = (gorbn_t)uv;
+		borrow = (uv >> GORBN_SZWORD_BITS) & 1;
+	}
 
-	int i;
-	for (i = 0; i < walk_count; i++) {
-		r[i] = a[i] ^ b[i];
+	gorbn_t mask = (gorbn_t)0 - (gorbn_t)(carry | (borrow ^ 1));
+	for (i = 0; i < n; i++) {
+		r[i] = (gorbn_t)((res[i] & ~mask) | (diff[i] & mask));
 	}
 }
 
-/* Shifting big number to left with by nbits*/
-void gorbn_lshift(gorbn_t* r, gorbn_t* a, int nbits) {
-	int i;
-	gorbn_copy(r, a);
-
-	int words_count = nbits / GORBN_SZWORD_BITS;
-	int bit_offset = nbits & GORBN_SZWORD_BITS_MINUS_ONE;
+void gorbn_mul_mod_pm_n(gorbn_t* r, gorbn_t* a, gorbn_t* b, gorbn_t* m, int n) {
+	GORBN_STAT_BEGIN(GORBN_STAT_MUL_MOD);
+	gorbn_t mul_res[GORBN_SZARR * 2];
+	gorbn_mul_n(mul_res, a, b, n);
 
-	gorbn_lshift_words(r, words_count);
-	for (i = (GORBN_SZARR - 1); i > 0; --i) {
-		r[i] = (r[i] << bit_offset) | (r[i - 1] >> (GORBN_SZWORD_BITS - bit_offset));
-	}
-	r[0] <<= bit_offset;
+	_gorbn_reduce_pm(r, mul_res, n * 2, m, n);
+	GORBN_STAT_END(GORBN_STAT_MUL_MOD);
 }
 
-/* Shifting big number to right by nbits */
-void gorbn_rshift(gorbn_t* r, gorbn_t* b, int nbits) {
-	int i;
-	gorbn_copy(r, b);
-	
-	int words_count = nbits / GORBN_SZWORD_BITS;
-	int bit_offset = nbits & GORBN_SZWORD_BITS_MINUS_ONE;
+void gorbn_mulword_mod_pm_n(gorbn_t* r, gorbn_t* a, gorbn_t w, gorbn_t* m, int n) {
+	gorbn_t mul_res[GORBN_SZARR + 1];
+	gorbn_utmp_t uv;
+	gorbn_utmp_t c = 0;
+	int j;
 
-	gorbn_rshift_words(r, words_count);
-	for (i = 0; i < GORBN_SZARR - 1; i++) {
-		r[i] = (r[i] >> bit_offset) | (r[i + 1] << (GORBN_SZWORD_BITS - bit_offset));
+	for (j = 0; j < n; j++) {
+		uv = (gorbn_utmp_t)a[j] * (gorbn_utmp_t)w + c;
+		mul_res[j] = (gorbn_t)(uv & GORBN_MAX_VAL);
+		c = uv >> GORBN_SZWORD_BITS;
 	}
-	r[i] >>= bit_offset;
+	mul_res[n] = (gorbn_t)c;
+
+	_gorbn_reduce_pm(r, mul_res, n + 1, m, n);
 }
 
-/* Comparing two big numbers internal function */
-static int _gorbn_cmp_internal(gorbn_t* a, gorbn_t* b, int num_digits) {
-	int i;
+void gorbn_sqr_mod_pm_n(gorbn_t* r, gorbn_t* a, gorbn_t* m, int n) {
+	GORBN_STAT_BEGIN(GORBN_STAT_SQR_MOD);
+	gorbn_t mul_res[GORBN_SZARR * 2];
+	gorbn_sqr_n(mul_res, a, n);
 
-	for (i = num_digits - 1; i >= 0; --i) {
-		if (a[i] > b[i])
-		{
-			return(GORBN_CMP_LARGER);
-		}
-		else if (a[i] < b[i])
-		{
-			return(GORBN_CMP_SMALLER);
-		}
-	}
+	_gorbn_reduce_pm(r, mul_res, n * 2, m, n);
+	GORBN_STAT_END(GORBN_STAT_SQR_MOD);
+}
 
-	return(GORBN_CMP_EQUAL);
+void gorbn_mul_mod_pm(gorbn_t* r, gorbn_t* a, gorbn_t* b, gorbn_t* m) {
+	gorbn_mul_mod_pm_n(r, a, b, m, GORBN_SZARR);
 }
 
-/* Comparing two big numbers */
-int gorbn_cmp(
-	gorbn_t* a, 
-	gorbn_t* b)
-{
-	return(_gorbn_cmp_internal(a, b, GORBN_SZARR));
+void gorbn_mulword_mod_pm(gorbn_t* r, gorbn_t* a, gorbn_t w, gorbn_t* m) {
+	gorbn_mulword_mod_pm_n(r, a, w, m, GORBN_SZARR);
 }
 
-/* Comparing big number with word */
-int gorbn_cmp_word(
+void gorbn_sqr_mod_pm(gorbn_t* r, gorbn_t* a, gorbn_t* m) {
+	gorbn_sqr_mod_pm_n(r, a, m, GORBN_SZARR);
+}
+
+/*
+	NOTE(dima):
+		Montgomery reduction of the double width number x (2 * ctx->n words).
+		r = x / R mod m, x should be less than m * R.
+*/
+static void _gorbn_mont_reduce(gorbn_t* r, gorbn_t* x, gorbn_mont* ctx) {
+	gorbn_t t[GORBN_SZARR * 2 + 1];
+	gorbn_utmp_t uv;
+	gorbn_utmp_t c;
+	gorbn_utmp_t c_high = 0;
+	gorbn_t q;
+	int n = ctx->n;
+	int i, j;
+
+	gorbn_copy_internal(t, x, n * 2);
+	t[n * 2] = 0;
+
+	for (i = 0; i < n; i++) {
+		/*NOTE(dima): t += q * m * 2 ^ (i * w) makes i-th word zero*/
+		q = (gorbn_t)(((gorbn_utmp_t)t[i] * (gorbn_utmp_t)ctx->m_inv) & GORBN_MAX_VAL);
+
+		c = 0;
+		for (j = 0; j < n; j++) {
+			uv = (gorbn_utmp_t)t[i + j] + (gorbn_utmp_t)q * (gorbn_utmp_t)ctx->m[j] + c;
+			t[i + j] = (gorbn_t)(uv & GORBN_MAX_VAL);
+			c = uv >> GORBN_SZWORD_BITS;
+		}
+
+		/*
+			NOTE(dima): Carry out of this word belongs to the next word,
+			and that is exactly where the next row ends. So it is kept
+			and added there instead of being propagated now.
+		*/
+		uv = (gorbn_utmp_t)t[i + n] + c + c_high;
+		t[i + n] = (gorbn_t)(uv & GORBN_MAX_VAL);
+		c_high = uv >> GORBN_SZWORD_BITS;
+	}
+	t[n * 2] = (gorbn_t)c_high;
+
+	/*NOTE(dima): Result is less than 2 * m*/
+	gorbn_t diff[GORBN_SZARR];
+	gorbn_utmp_t borrow = 0;
+	for (i = 0; i < n; i++) {
+		uv = (gorbn_utmp_t)t[n + i] - ctx->m[i] - borrow;
+		diff[i] = (gorbn_t)uv;
+		borrow = (uv >> GORBN_SZWORD_BITS) & 1;
+	}
+
+	gorbn_t mask = (gorbn_t)0 - (gorbn_t)(c_high | (borrow ^ 1));
+	for (i = 0; i < n; i++) {
+		r[i] = (gorbn_t)((t[n + i] & ~mask) | (diff[i] & mask));
+	}
+}
+
+void gorbn_mont_init(gorbn_mont* ctx, gorbn_t* m) {
+	gorbn_utmp_t inv;
+	int i;
+
+	gorbn_copy(ctx->m, m);
+	ctx->n = _gorbn_get_ndigits(m, GORBN_SZARR);
+
+	/*NOTE(dima): Newton iteration doubles count of correct low bits of m[0] ^ -1*/
+	inv = m[0];
+	for (i = 0; i < 5; i++) {
+		inv = (inv * (2 - (gorbn_utmp_t)m[0] * inv)) & GORBN_MAX_VAL;
+	}
+	ctx->m_inv = (gorbn_t)((0 - inv) & GORBN_MAX_VAL);
+
+	/*NOTE(dima): R mod m and R ^ 2 mod m by doublings. Done only once*/
+	gorbn_init(ctx->one, GORBN_SZARR);
+	ctx->one[0] = 1;
+	for (i = 0; i < ctx->n * GORBN_SZWORD_BITS; i++) {
+		gorbn_add_mod_n(ctx->one, ctx->one, ctx->one, m, ctx->n);
+	}
+
+	gorbn_copy(ctx->rr, ctx->one);
+	for (i = 0; i < ctx->n * GORBN_SZWORD_BITS; i++) {
+		gorbn_add_mod_n(ctx->rr, ctx->rr, ctx->rr, m, ctx->n);
+	}
+}
+
+void gorbn_mont_mul(gorbn_t* r, gorbn_t* a, gorbn_t* b, gorbn_mont* ctx) {
+	GORBN_STAT_BEGIN(GORBN_STAT_MUL_MOD);
+	gorbn_t mul_res[GORBN_SZARR * 2];
+	gorbn_mul_n(mul_res, a, b, ctx->n);
+
+	_gorbn_mont_reduce(r, mul_res, ctx);
+	GORBN_STAT_END(GORBN_STAT_MUL_MOD);
+}
+
+void gorbn_mont_sqr(gorbn_t* r, gorbn_t* a, gorbn_mont* ctx) {
+	GORBN_STAT_BEGIN(GORBN_STAT_SQR_MOD);
+	gorbn_t mul_res[GORBN_SZARR * 2];
+	gorbn_sqr_n(mul_res, a, ctx->n);
+
+	_gorbn_mont_reduce(r, mul_res, ctx);
+	GORBN_STAT_END(GORBN_STAT_SQR_MOD);
+}
+
+void gorbn_to_mont(gorbn_t* r, gorbn_t* a, gorbn_mont* ctx) {
+	gorbn_mont_mul(r, a, ctx->rr, ctx);
+}
+
+void gorbn_from_mont(gorbn_t* r, gorbn_t* a, gorbn_mont* ctx) {
+	gorbn_t tmp[GORBN_SZARR * 2];
+
+	gorbn_copy_internal(tmp, a, ctx->n);
+	_gorbn_zero_number(tmp + ctx->n, ctx->n);
+
+	_gorbn_mont_reduce(r, tmp, ctx);
+}
+
+void gorbn_barrett_init(gorbn_barrett* ctx, gorbn_t* m) {
+	gorbn_t pow_buf[GORBN_DIV_MAX_WORDS];
+	gorbn_t q_buf[GORBN_DIV_MAX_WORDS];
+	gorbn_t r_buf[GORBN_SZARR];
+
+	gorbn_copy(ctx->m, m);
+	ctx->n = _gorbn_get_ndigits(m, GORBN_SZARR);
+
+	//NOTE(dima): mu = b ^ (2 * n) / m takes n + 1 words as m > b ^ (n - 1)
+	_gorbn_zero_number(pow_buf, ctx->n * 2 + 1);
+	pow_buf[ctx->n * 2] = 1;
+
+	_gorbn_div_core(q_buf, r_buf, pow_buf, ctx->n * 2 + 1, m, ctx->n);
+	gorbn_copy_internal(ctx->mu, q_buf, ctx->n + 1);
+}
+
+/*
+	NOTE(dima):
+		Barrett reduction (HAC 14.42). q3 = ((x / b ^ (n - 1)) * mu) / b ^ (n + 1)
+		is below x / m by at most 2. Words of the product below n - 1 are
+		not computed, that makes q3 smaller by at most one more, so r = x - q3 * m
+		is below 4 * m. Only n + 1 low words of x - q3 * m are needed, and
+		r - m, r - 2 * m and r - 3 * m are computed in one pass over them.
+		mu[n] is 1 when the top bit of m is set (as for group orders), then
+		its row of the product is an addition.
+*/
+void gorbn_barrett_reduce(gorbn_t* r, gorbn_t* x, gorbn_barrett* ctx) {
+	GORBN_STAT_BEGIN(GORBN_STAT_DIV);
+	gorbn_t prod[GORBN_SZARR * 2 + 2];
+	gorbn_t q3m[GORBN_SZARR + 1];
+	gorbn_t rem[GORBN_SZARR + 1];
+	gorbn_t d1[GORBN_SZARR + 1];
+	gorbn_t d2[GORBN_SZARR + 1];
+	gorbn_t d3[GORBN_SZARR + 1];
+	gorbn_utmp_t uv;
+	gorbn_utmp_t c;
+	gorbn_utmp_t b1, b2, b3;
+	int n = ctx->n;
+	int mu_top_is_one = (ctx->mu[n] == 1);
+	int i, j;
+
+	gorbn_t* q1 = x + n - 1;
+	gorbn_t* q3 = prod + n + 1;
+
+	_gorbn_zero_number(prod + n - 1, n + 3);
+	for (i = 0; i <= n; i++) {
+		c = 0;
+		for (j = GORBN_MAX(n - 1 - i, 0); j < n; j++) {
+			uv = (gorbn_utmp_t)prod[i + j] + (gorbn_utmp_t)q1[i] * ctx->mu[j] + c;
+			prod[i + j] = (gorbn_t)uv;
+			c = uv >> GORBN_SZWORD_BITS;
+		}
+
+		if (mu_top_is_one) {
+			uv = (gorbn_utmp_t)prod[i + n] + q1[i] + c;
+		}
+		else {
+			uv = (gorbn_utmp_t)prod[i + n] + (gorbn_utmp_t)q1[i] * ctx->mu[n] + c;
+		}
+		prod[i + n] = (gorbn_t)uv;
+		prod[i + n + 1] = (gorbn_t)(uv >> GORBN_SZWORD_BITS);
+	}
+
+	//NOTE(dima): q3m = q3 * m mod b ^ (n + 1)
+	c = 0;
+	for (j = 0; j < n; j++) {
+		uv = (gorbn_utmp_t)q3[0] * ctx->m[j] + c;
+		q3m[j] = (gorbn_t)uv;
+		c = uv >> GORBN_SZWORD_BITS;
+	}
+	q3m[n] = (gorbn_t)c;
+
+	for (i = 1; i <= n; i++) {
+		c = 0;
+		for (j = 0; j < n + 1 - i; j++) {
+			uv = (gorbn_utmp_t)q3m[i + j] + (gorbn_utmp_t)q3[i] * ctx->m[j] + c;
+			q3m[i + j] = (gorbn_t)uv;
+			c = uv >> GORBN_SZWORD_BITS;
+		}
+	}
+
+	b1 = 0;
+	for (i = 0; i <= n; i++) {
+		uv = (gorbn_utmp_t)x[i] - q3m[i] - b1;
+		rem[i] = (gorbn_t)uv;
+		b1 = (uv >> GORBN_SZWORD_BITS) & 1;
+	}
+
+	//NOTE(dima): d1 = rem - m, d2 = rem - 2 * m, d3 = d1 - 2 * m. Words of 2 * m are shifted on the fly
+	b1 = 0;
+	b2 = 0;
+	b3 = 0;
+	for (i = 0; i <= n; i++) {
+		gorbn_t m_word = (i < n) ? ctx->m[i] : 0;
+		gorbn_t m_prev = (i > 0) ? ctx->m[i - 1] : 0;
+		gorbn_t m2_word = (gorbn_t)((m_word << 1) | (m_prev >> GORBN_SZWORD_BITS_MINUS_ONE));
+
+		uv = (gorbn_utmp_t)rem[i] - m_word - b1;
+		d1[i] = (gorbn_t)uv;
+		b1 = (uv >> GORBN_SZWORD_BITS) & 1;
+
+		uv = (gorbn_utmp_t)rem[i] - m2_word - b2;
+		d2[i] = (gorbn_t)uv;
+		b2 = (uv >> GORBN_SZWORD_BITS) & 1;
+
+		uv = (gorbn_utmp_t)d1[i] - m2_word - b3;
+		d3[i] = (gorbn_t)uv;
+		b3 = (uv >> GORBN_SZWORD_BITS) & 1;
+	}
+
+	//NOTE(dima): rem >= 2 * m implies rem >= m, d3 is taken only if d1 did not borrow
+	gorbn_t mask1 = (gorbn_t)(b1 - 1);
+	gorbn_t mask2 = (gorbn_t)(b2 - 1);
+	gorbn_t mask3 = (gorbn_t)((b3 | b1) - 1);
+	for (i = 0; i < n; i++) {
+		gorbn_t w = rem[i];
+		w = (gorbn_t)((w & ~mask1) | (d1[i] & mask1));
+		w = (gorbn_t)((w & ~mask2) | (d2[i] & mask2));
+		w = (gorbn_t)((w & ~mask3) | (d3[i] & mask3));
+		r[i] = w;
+	}
+	GORBN_STAT_END(GORBN_STAT_DIV);
+}
+
+void gorbn_barrett_mul(gorbn_t* r, gorbn_t* a, gorbn_t* b, gorbn_barrett* ctx) {
+	GORBN_STAT_BEGIN(GORBN_STAT_MUL_MOD);
+	gorbn_t mul_res[GORBN_SZARR * 2];
+	gorbn_mul_n(mul_res, a, b, ctx->n);
+
+	gorbn_barrett_reduce(r, mul_res, ctx);
+	GORBN_STAT_END(GORBN_STAT_MUL_MOD);
+}
+
+void gorbn_barrett_sqr(gorbn_t* r, gorbn_t* a, gorbn_barrett* ctx) {
+	GORBN_STAT_BEGIN(GORBN_STAT_SQR_MOD);
+	gorbn_t mul_res[GORBN_SZARR * 2];
+	gorbn_sqr_n(mul_res, a, ctx->n);
+
+	gorbn_barrett_reduce(r, mul_res, ctx);
+	GORBN_STAT_END(GORBN_STAT_SQR_MOD);
+}
+
+/*
+	NOTE(dima):
+		Sliding window exponentiation. Table keeps odd powers
+		a, a ^ 3, ..., a ^ (2 ^ w - 1), so every window of the exponent
+		starting and ending with 1 costs one multiplication, zero bits
+		cost only squarings. mul and sqr get the ctx of the caller.
+*/
+typedef void _gorbn_pow_mul_type(gorbn_t* r, gorbn_t* a, gorbn_t* b, void* ctx);
+typedef void _gorbn_pow_sqr_type(gorbn_t* r, gorbn_t* a, void* ctx);
+
+static int _gorbn_pow_window_bits(int e_nbits) {
+	int result = 1;
+
+	if (e_nbits > 671) {
+		result = 6;
+	}
+	else if (e_nbits > 239) {
+		result = 5;
+	}
+	else if (e_nbits > 79) {
+		result = 4;
+	}
+	else if (e_nbits > 23) {
+		result = 3;
+	}
+
+	if (result > GORBN_POW_WINDOW_MAX) {
+		result = GORBN_POW_WINDOW_MAX;
+	}
+
+	return(result);
+}
+
+static void _gorbn_pow_window(
+	gorbn_t* r,
 	gorbn_t* a,
-	gorbn_t w)
+	gorbn_t* e,
+	gorbn_t* one,
+	_gorbn_pow_mul_type* mul,
+	_gorbn_pow_sqr_type* sqr,
+	void* ctx)
+{
+	gorbn_t table[1 << (GORBN_POW_WINDOW_MAX - 1)][GORBN_SZARR];
+	gorbn_t a2[GORBN_SZARR];
+	gorbn_t acc[GORBN_SZARR];
+	int e_nbits = _gorbn_get_nbits(e, GORBN_SZARR);
+	int started = 0;
+	int w, i, j, k;
+	int val;
+
+	if (e_nbits == 0) {
+		gorbn_copy(r, one);
+		return;
+	}
+
+	w = _gorbn_pow_window_bits(e_nbits);
+
+	/*NOTE(dima): Functions may write only significant words, so upper words are zeroed here*/
+	_gorbn_zero_number((gorbn_t*)table, (1 << (w - 1)) * GORBN_SZARR);
+	gorbn_init(a2, GORBN_SZARR);
+	gorbn_init(acc, GORBN_SZARR);
+
+	gorbn_copy(table[0], a);
+	if (w > 1) {
+		sqr(a2, a, ctx);
+		for (i = 1; i < (1 << (w - 1)); i++) {
+			mul(table[i], table[i - 1], a2, ctx);
+		}
+	}
+
+	i = e_nbits - 1;
+	while (i >= 0) {
+		if (!_gorbn_testbit(e, i)) {
+			sqr(acc, acc, ctx);
+			i--;
+			continue;
+		}
+
+		/*NOTE(dima): Longest window [j, i] of at most w bits that ends with 1*/
+		j = i - w + 1;
+		if (j < 0) {
+			j = 0;
+		}
+		while (!_gorbn_testbit(e, j)) {
+			j++;
+		}
+
+		val = 0;
+		for (k = i; k >= j; k--) {
+			val = (val << 1) | _gorbn_testbit(e, k);
+		}
+
+		if (started) {
+			for (k = i; k >= j; k--) {
+				sqr(acc, acc, ctx);
+			}
+			mul(acc, acc, table[val >> 1], ctx);
+		}
+		else {
+			gorbn_copy(acc, table[val >> 1]);
+			started = 1;
+		}
+
+		i = j - 1;
+	}
+
+	gorbn_copy(r, acc);
+}
+
+static void _gorbn_pow_mont_mul(gorbn_t* r, gorbn_t* a, gorbn_t* b, void* ctx) {
+	gorbn_mont_mul(r, a, b, (gorbn_mont*)ctx);
+}
+
+static void _gorbn_pow_mont_sqr(gorbn_t* r, gorbn_t* a, void* ctx) {
+	gorbn_mont_sqr(r, a, (gorbn_mont*)ctx);
+}
+
+static void _gorbn_pow_mul_mod(gorbn_t* r, gorbn_t* a, gorbn_t* b, void* ctx) {
+	gorbn_mul_mod(r, a, b, (gorbn_t*)ctx);
+}
+
+static void _gorbn_pow_sqr_mod(gorbn_t* r, gorbn_t* a, void* ctx) {
+	gorbn_sqr_mod(r, a, (gorbn_t*)ctx);
+}
+
+static void _gorbn_pow_mul(gorbn_t* r, gorbn_t* a, gorbn_t* b, void* ctx) {
+	gorbn_t mul_res[GORBN_SZARR * 2];
+	(void)ctx;
+	gorbn_mul(mul_res, a, b);
+
+	gorbn_copy(r, mul_res);
+}
+
+static void _gorbn_pow_sqr(gorbn_t* r, gorbn_t* a, void* ctx) {
+	gorbn_t mul_res[GORBN_SZARR * 2];
+	(void)ctx;
+	gorbn_sqr(mul_res, a);
+
+	gorbn_copy(r, mul_res);
+}
+
+void gorbn_mont_pow(gorbn_t* r, gorbn_t* a, gorbn_t* e, gorbn_mont* ctx) {
+	_gorbn_pow_window(r, a, e, ctx->one, _gorbn_pow_mont_mul, _gorbn_pow_mont_sqr, ctx);
+}
+
+void gorbn_pow_mod(gorbn_t* r, gorbn_t* a, gorbn_t* e, gorbn_t* m) {
+	gorbn_t base[GORBN_SZARR];
+	gorbn_t one[GORBN_SZARR];
+
+	gorbn_mod(base, a, GORBN_SZARR, m);
+
+	if (!_gorbn_is_even(m) && gorbn_cmp_word(m, 1) > 0) {
+		gorbn_mont ctx;
+		gorbn_mont_init(&ctx, m);
+
+		gorbn_to_mont(base, base, &ctx);
+		gorbn_mont_pow(r, base, e, &ctx);
+		gorbn_from_mont(r, r, &ctx);
+	}
+	else {
+		/*NOTE(dima): Even moduli have no Montgomery form, reduction is done by division*/
+		gorbn_from_int(one, 1);
+		gorbn_mod(one, one, GORBN_SZARR, m);
+
+		_gorbn_pow_window(r, base, e, one, _gorbn_pow_mul_mod, _gorbn_pow_sqr_mod, m);
+	}
+}
+
+void gorbn_pow(gorbn_t* r, gorbn_t* a, gorbn_t* b) {
+	gorbn_t one[GORBN_SZARR];
+	gorbn_from_int(one, 1);
+
+	_gorbn_pow_window(r, a, b, one, _gorbn_pow_mul, _gorbn_pow_sqr, 0);
+}
+
+/*
+	NOTE(dima):
+		Batched binary GCD (T. Pornin, "Optimized Binary GCD for Modular
+		Inversion"). Classic step is a = a / 2 for even a, and for odd a
+		swap a and b if a < b, then a = (a - b) / 2. u and v follow a and b
+		so that a = x * u and b = x * v mod m. GORBN_GCD_BATCH steps are run
+		at once on 64-bit approximations of a and b made of their low bits and
+		top bits, the factors obtained there are applied to full numbers
+		after that. Numbers are kept in 32-bit words for any GORBN_SZWORD, so
+		that products of words and factors fit 64 bits.
+*/
+#define GORBN_GCD_BATCH 30
+#define GORBN_GCD_WORDS ((GORBN_SZARR * GORBN_SZWORD + 3) / 4 + 2)
+
+static void _gorbn_gcd_from(uint32_t* r, gorbn_t* a) {
+	int i;
+
+	for (i = 0; i < GORBN_GCD_WORDS; i++) {
+		r[i] = 0;
+	}
+
+	for (i = 0; i < GORBN_SZARR * GORBN_SZWORD; i++) {
+		uint32_t byte = (uint32_t)(a[i / GORBN_SZWORD] >> (8 * (i % GORBN_SZWORD))) & 0xFF;
+		r[i / 4] |= byte << (8 * (i % 4));
+	}
+}
+
+static void _gorbn_gcd_to(gorbn_t* r, uint32_t* a) {
+	int i;
+
+	gorbn_init(r, GORBN_SZARR);
+
+	for (i = 0; i < GORBN_SZARR * GORBN_SZWORD; i++) {
+		gorbn_t byte = (gorbn_t)((a[i / 4] >> (8 * (i % 4))) & 0xFF);
+		r[i / GORBN_SZWORD] |= (gorbn_t)(byte << (8 * (i % GORBN_SZWORD)));
+	}
+}
+
+static int _gorbn_gcd_nbits(uint32_t* a, int n) {
+	int i;
+	uint32_t w;
+
+	while (n > 0 && a[n - 1] == 0) {
+		n--;
+	}
+
+	if (n == 0) {
+		return(0);
+	}
+
+	w = a[n - 1];
+	for (i = 0; w; i++) {
+		w >>= 1;
+	}
+
+	return((n - 1) * 32 + i);
+}
+
+/*NOTE(dima): floor(t / 2 ^ bits) without shifts of negative numbers*/
+static inline int64_t _gorbn_gcd_hi(int64_t t, int bits) {
+	int64_t low = (int64_t)((uint64_t)t & (((uint64_t)1 << bits) - 1));
+	return((t - low) / ((int64_t)1 << bits));
+}
+
+/*NOTE(dima): Low GORBN_GCD_BATCH bits and top 64 - GORBN_GCD_BATCH bits of len-bit a*/
+static uint64_t _gorbn_gcd_approx(uint32_t* a, int len) {
+	int pos = len - (64 - GORBN_GCD_BATCH);
+	int w = pos / 32;
+	int s = pos % 32;
+
+	uint64_t hi = ((uint64_t)a[w] | ((uint64_t)a[w + 1] << 32)) >> s;
+	if (s) {
+		hi |= (uint64_t)a[w + 2] << (64 - s);
+	}
+	hi &= ((uint64_t)1 << (64 - GORBN_GCD_BATCH)) - 1;
+
+	return((hi << GORBN_GCD_BATCH) | (a[0] & (((uint32_t)1 << GORBN_GCD_BATCH) - 1)));
+}
+
+/*
+	NOTE(dima): s = a * fa + b * fb in n words, the rest of the value
+	goes to *top. |fa| + |fb| <= 2 ^ GORBN_GCD_BATCH.
+*/
+static void _gorbn_gcd_lincomb(uint32_t* s, int64_t* top, uint32_t* a, int64_t fa, uint32_t* b, int64_t fb, int n) {
+	int64_t t;
+	int64_t carry = 0;
+	int i;
+
+	for (i = 0; i < n; i++) {
+		t = (int64_t)a[i] * fa + (int64_t)b[i] * fb + carry;
+		s[i] = (uint32_t)t;
+		carry = _gorbn_gcd_hi(t, 32);
+	}
+
+	*top = carry;
+}
+
+/*NOTE(dima): r = s / 2 ^ GORBN_GCD_BATCH, where s is n words and top, returns the top of result*/
+static int64_t _gorbn_gcd_shift(uint32_t* r, uint32_t* s, int64_t top, int n) {
+	int i;
+
+	for (i = 0; i < n - 1; i++) {
+		r[i] = (s[i] >> GORBN_GCD_BATCH) | (s[i + 1] << (32 - GORBN_GCD_BATCH));
+	}
+	r[n - 1] = (s[n - 1] >> GORBN_GCD_BATCH) | ((uint32_t)top << (32 - GORBN_GCD_BATCH));
+
+	return(_gorbn_gcd_hi(top, GORBN_GCD_BATCH));
+}
+
+/*NOTE(dima): r = |a * fa + b * fb| / 2 ^ GORBN_GCD_BATCH, returns 1 if the value was negative*/
+static int _gorbn_gcd_update_ab(uint32_t* r, uint32_t* a, int64_t fa, uint32_t* b, int64_t fb, int n) {
+	uint32_t s[GORBN_GCD_WORDS];
+	int64_t top;
+	int i;
+
+	_gorbn_gcd_lincomb(s, &top, a, fa, b, fb, n);
+	if (_gorbn_gcd_shift(r, s, top, n) >= 0) {
+		return(0);
+	}
+
+	uint64_t carry = 1;
+	for (i = 0; i < n; i++) {
+		carry += (uint32_t)~r[i];
+		r[i] = (uint32_t)carry;
+		carry >>= 32;
+	}
+
+	return(1);
+}
+
+/*NOTE(dima): r = (u * fu + v * fv) / 2 ^ GORBN_GCD_BATCH mod m, m_inv = -(m ^ -1) mod 2 ^ 32*/
+static void _gorbn_gcd_update_uv(
+	uint32_t* r,
+	uint32_t* u, int64_t fu,
+	uint32_t* v, int64_t fv,
+	uint32_t* m, uint32_t m_inv, int n)
+{
+	uint32_t s[GORBN_GCD_WORDS];
+	int64_t top;
+	uint64_t t;
+	uint64_t c = 0;
+	int i;
+
+	_gorbn_gcd_lincomb(s, &top, u, fu, v, fv, n);
+
+	/*NOTE(dima): s + q * m is divisible by 2 ^ GORBN_GCD_BATCH*/
+	uint32_t q = (s[0] * m_inv) & (((uint32_t)1 << GORBN_GCD_BATCH) - 1);
+	for (i = 0; i < n; i++) {
+		t = (uint64_t)s[i] + (uint64_t)q * m[i] + c;
+		s[i] = (uint32_t)t;
+		c = t >> 32;
+	}
+	top += (int64_t)c;
+
+	/*NOTE(dima): Result is in (-2 * m, 2 * m)*/
+	top = _gorbn_gcd_shift(r, s, top, n);
+	while (top < 0) {
+		c = 0;
+		for (i = 0; i < n; i++) {
+			t = (uint64_t)r[i] + m[i] + c;
+			r[i] = (uint32_t)t;
+			c = t >> 32;
+		}
+		top += (int64_t)c;
+	}
+
+	for (;;) {
+		if (top == 0) {
+			for (i = n - 1; i > 0 && r[i] == m[i]; i--);
+			if (r[i] < m[i]) {
+				break;
+			}
+		}
+
+		c = 0;
+		for (i = 0; i < n; i++) {
+			t = (uint64_t)r[i] - m[i] - c;
+			r[i] = (uint32_t)t;
+			c = (t >> 32) & 1;
+		}
+		top -= (int64_t)c;
+	}
+}
+
+/*NOTE(dima): m is odd, result is 0 if gcd(x, m) != 1*/
+static void _gorbn_inv_mod_batched(gorbn_t* result, gorbn_t* x, gorbn_t* m) {
+	uint32_t a[GORBN_GCD_WORDS];
+	uint32_t b[GORBN_GCD_WORDS];
+	uint32_t u[GORBN_GCD_WORDS];
+	uint32_t v[GORBN_GCD_WORDS];
+	uint32_t mm[GORBN_GCD_WORDS];
+	uint32_t t0[GORBN_GCD_WORDS];
+	uint32_t t1[GORBN_GCD_WORDS];
+	uint32_t m_inv;
+	int n, len, len_b, i, j;
+
+	gorbn_t xr[GORBN_SZARR];
+	if (gorbn_cmp(x, m) >= 0) {
+		gorbn_mod(xr, x, GORBN_SZARR, m);
+		x = xr;
+	}
+
+	_gorbn_gcd_from(a, x);
+	_gorbn_gcd_from(b, m);
+	_gorbn_gcd_from(mm, m);
+	for (i = 0; i < GORBN_GCD_WORDS; i++) {
+		u[i] = 0;
+		v[i] = 0;
+		t0[i] = 0;
+		t1[i] = 0;
+	}
+	u[0] = 1;
+
+	n = (_gorbn_gcd_nbits(mm, GORBN_GCD_WORDS) + 31) / 32;
+
+	/*NOTE(dima): Newton iteration doubles count of correct low bits of m ^ -1*/
+	m_inv = mm[0];
+	for (i = 0; i < 4; i++) {
+		m_inv *= 2 - mm[0] * m_inv;
+	}
+	m_inv = 0 - m_inv;
+
+	while (_gorbn_gcd_nbits(a, n)) {
+		len = _gorbn_gcd_nbits(a, n);
+		len_b = _gorbn_gcd_nbits(b, n);
+		if (len < len_b) {
+			len = len_b;
+		}
+		if (len < 64) {
+			len = 64;
+		}
+
+		uint64_t a_apx = _gorbn_gcd_approx(a, len);
+		uint64_t b_apx = _gorbn_gcd_approx(b, len);
+		int64_t f0 = 1, g0 = 0, f1 = 0, g1 = 1;
+		for (j = 0; j < GORBN_GCD_BATCH; j++) {
+			if (a_apx & 1) {
+				if (a_apx < b_apx) {
+					uint64_t tmp = a_apx; a_apx = b_apx; b_apx = tmp;
+					int64_t tf = f0; f0 = f1; f1 = tf;
+					int64_t tg = g0; g0 = g1; g1 = tg;
+				}
+				a_apx -= b_apx;
+				f0 -= f1;
+				g0 -= g1;
+			}
+			a_apx >>= 1;
+			f1 *= 2;
+			g1 *= 2;
+		}
+
+		if (_gorbn_gcd_update_ab(t0, a, f0, b, g0, n)) {
+			f0 = -f0;
+			g0 = -g0;
+		}
+		if (_gorbn_gcd_update_ab(t1, a, f1, b, g1, n)) {
+			f1 = -f1;
+			g1 = -g1;
+		}
+		for (i = 0; i < n; i++) {
+			a[i] = t0[i];
+			b[i] = t1[i];
+		}
+
+		_gorbn_gcd_update_uv(t0, u, f0, v, g0, mm, m_inv, n);
+		_gorbn_gcd_update_uv(t1, u, f1, v, g1, mm, m_inv, n);
+		for (i = 0; i < n; i++) {
+			u[i] = t0[i];
+			v[i] = t1[i];
+		}
+	}
+
+	/*NOTE(dima): Here b = gcd(x, m)*/
+	if (_gorbn_gcd_nbits(b, n) != 1) {
+		gorbn_init(result, GORBN_SZARR);
+		return;
+	}
+
+	_gorbn_gcd_to(result, v);
+}
+
+/* Binary extended Euclid, bit at a time */
+static void _gorbn_inv_mod_binary(gorbn_t* result, gorbn_t *a, gorbn_t* m) {
+	gorbn_t u[GORBN_SZARR]; 
+	gorbn_t v[GORBN_SZARR];
+	gorbn_t r[GORBN_SZARR];
+	gorbn_t s[GORBN_SZARR];
+
+	gorbn_copy(u, m);
+	gorbn_copy(v, a);
+	gorbn_init(r, GORBN_SZARR);
+	gorbn_init(s, GORBN_SZARR);
+	s[0] = 1;
+
+	while (!gorbn_is_zero(v)) {
+		if (GORBN_EVEN(u)) {
+			if (GORBN_EVEN(r)) {
+				gorbn_rshift_one_bit(u);
+				gorbn_rshift_one_bit(r);
+			}
+			else {
+				gorbn_rshift_one_bit(u);
+				int carry = gorbn_add(r, r, m);
+				gorbn_rshift_one_bit(r);
+				if (carry) {
+					r[GORBN_SZARR - 1] |= GORBN_HIGH_BIT_SET;
+				}
+			}
+		}
+		else if (GORBN_EVEN(v)) {
+			if (GORBN_EVEN(s)) {
+				gorbn_rshift_one_bit(v);
+				gorbn_rshift_one_bit(s);
+			}
+			else {
+				gorbn_rshift_one_bit(v);
+				int carry = gorbn_add(s, s, m);
+				gorbn_rshift_one_bit(s);
+				if (carry) {
+					s[GORBN_SZARR - 1] |= GORBN_HIGH_BIT_SET;
+				}
+			}
+		}
+		else {
+			if (gorbn_cmp(u, v) > 0) {
+				gorbn_sub(u, u, v);
+				int borrow = gorbn_sub(r, r, s);
+				if (borrow) {
+					gorbn_add(r, r, m);
+				}
+			}
+			else {
+				gorbn_sub(v, v, u);
+				int borrow = gorbn_sub(s, s, r);
+				if (borrow) {
+					gorbn_add(s, s, m);
+				}
+			}
+		}
+	}
+
+	if (gorbn_cmp(r, m) > 0) {
+		gorbn_sub(r, r, m);
+	}
+
+	gorbn_copy(result, r);
+}
+
+/*
+	Getting inverse by modulo. Odd m goes to the batched binary GCD,
+	the bit at a time Euclid is kept for the rest.
+*/
+void gorbn_inv_mod(gorbn_t* result, gorbn_t *a, gorbn_t* m) {
+	GORBN_STAT_BEGIN(GORBN_STAT_INV_MOD);
+	if (!GORBN_EVEN(m)) {
+		_gorbn_inv_mod_batched(result, a, m);
+	}
+	else {
+		_gorbn_inv_mod_binary(result, a, m);
+	}
+	GORBN_STAT_END(GORBN_STAT_INV_MOD);
+}
+
+/* logical AND */
+void gorbn_and(gorbn_t* r, gorbn_t* a, gorbn_t* b, int digit_count)
+{
+	int walk_count = digit_count;
+
+	int i;
+	for (i = 0; i < walk_count; i++) {
+		r[i] = a[i] & b[i];
+	}
+}
+
+/* logical OR */
+void gorbn_or(gorbn_t* r, gorbn_t* a, gorbn_t* b, int digit_count) {
+	int walk_count = digit_count;
+
+	int i;
+	for (i = 0; i < walk_count; i++) {
+		r[i] = a[i] | b[i];
+	}
+}
+
+/* logical XOR */
+void gorbn_xor(gorbn_t* r, gorbn_t* a, gorbn_t* b, int digit_count) {
+	int walk_count = digit_count;
+
+	int i;
+	for (i = 0; i < walk_count; i++) {
+		r[i] = a[i] ^ b[i];
+	}
+}
+
+/* Shifting big number to left with by nbits*/
+void gorbn_lshift(gorbn_t* r, gorbn_t* a, int nbits) {
+	int i;
+	gorbn_copy(r, a);
+
+	int words_count = nbits / GORBN_SZWORD_BITS;
+	int bit_offset = nbits & GORBN_SZWORD_BITS_MINUS_ONE;
+
+	gorbn_lshift_words(r, words_count);
+	if (bit_offset == 0) {
+		return;
+	}
+
+	for (i = (GORBN_SZARR - 1); i > 0; --i) {
+		r[i] = (r[i] << bit_offset) | (r[i - 1] >> (GORBN_SZWORD_BITS - bit_offset));
+	}
+	r[0] <<= bit_offset;
+}
+
+/* Shifting big number to right by nbits */
+void gorbn_rshift(gorbn_t* r, gorbn_t* b, int nbits) {
+	int i;
+	gorbn_copy(r, b);
+	
+	int words_count = nbits / GORBN_SZWORD_BITS;
+	int bit_offset = nbits & GORBN_SZWORD_BITS_MINUS_ONE;
+
+	gorbn_rshift_words(r, words_count);
+	if (bit_offset == 0) {
+		return;
+	}
+
+	for (i = 0; i < GORBN_SZARR - 1; i++) {
+		r[i] = (r[i] >> bit_offset) | (r[i + 1] << (GORBN_SZWORD_BITS - bit_offset));
+	}
+	r[i] >>= bit_offset;
+}
+
+/* Comparing two big numbers internal function */
+static int _gorbn_cmp_internal(gorbn_t* a, gorbn_t* b, int num_digits) {
+	int i;
+
+	for (i = num_digits - 1; i >= 0; --i) {
+		if (a[i] > b[i])
+		{
+			return(GORBN_CMP_LARGER);
+		}
+		else if (a[i] < b[i])
+		{
+			return(GORBN_CMP_SMALLER);
+		}
+	}
+
+	return(GORBN_CMP_EQUAL);
+}
+
+/* Comparing two big numbers */
+int gorbn_cmp(
+	gorbn_t* a, 
+	gorbn_t* b)
+{
+	return(_gorbn_cmp_internal(a, b, GORBN_SZARR));
+}
+
+int gorbn_cmp_n(gorbn_t* a, gorbn_t* b, int n) {
+	return(_gorbn_cmp_internal(a, b, n));
+}
+
+/* Comparing big number with word */
+int gorbn_cmp_word(
+	gorbn_t* a,
+	gorbn_t w)
+{
+	int i;
+
+	for (i = 1; i < GORBN_SZARR; i++) {
+		if (a[i]) {
+			return(GORBN_CMP_LARGER);
+		}
+	}
+
+	if (a[0] > w) {
+		return(GORBN_CMP_LARGER);
+	}
+	else if (a[0] < w) {
+		return(GORBN_CMP_SMALLER);
+	}
+	else {
+		return(GORBN_CMP_EQUAL);
+	}
+}
+
+/*
+	NOTE(dima): Sized routines write only crv->n words, words above
+	are cleared so that field elements can still be used as GORBN_SZARR
+	numbers (compared, copied and returned to the user).
+*/
+static void _gorec_clear_high(gorbn_t* r, gorec_curve* crv) {
+	_gorbn_zero_number(r + crv->n, GORBN_SZARR - crv->n);
+}
+
+static void _gorec_add_mod(gorbn_t* r, gorbn_t* a, gorbn_t* b, gorec_curve* crv) {
+	gorbn_add_mod_n(r, a, b, crv->p, crv->n);
+	_gorec_clear_high(r, crv);
+}
+
+static void _gorec_sub_mod(gorbn_t* r, gorbn_t* a, gorbn_t* b, gorec_curve* crv) {
+	gorbn_sub_mod_n(r, a, b, crv->p, crv->n);
+	_gorec_clear_high(r, crv);
+}
+
+/* Field routines of the curve: generic modulus */
+static GOREC_FIELD_MUL(_gorec_mul_mod_div) { gorbn_mul_mod(r, a, b, crv->p); }
+static GOREC_FIELD_UNARY(_gorec_sqr_mod_div) { gorbn_sqr_mod(r, a, crv->p); }
+static GOREC_FIELD_MULWORD(_gorec_mulword_mod_div) { gorbn_mulword_mod(r, a, w, crv->p); }
+static GOREC_FIELD_UNARY(_gorec_inv_mod_div) { gorbn_inv_mod(r, a, crv->p); }
+static GOREC_FIELD_UNARY(_gorec_copy_field) { (void)crv; gorbn_copy(r, a); }
+
+/* Field routines of the curve: pseudo-Mersenne modulus */
+static GOREC_FIELD_MUL(_gorec_mul_mod_pm) {
+	gorbn_mul_mod_pm_n(r, a, b, crv->p, crv->n);
+	_gorec_clear_high(r, crv);
+}
+
+static GOREC_FIELD_UNARY(_gorec_sqr_mod_pm) {
+	gorbn_sqr_mod_pm_n(r, a, crv->p, crv->n);
+	_gorec_clear_high(r, crv);
+}
+
+static GOREC_FIELD_MULWORD(_gorec_mulword_mod_pm) {
+	gorbn_mulword_mod_pm_n(r, a, w, crv->p, crv->n);
+	_gorec_clear_high(r, crv);
+}
+
+/* Field routines of the curve: Montgomery domain */
+static GOREC_FIELD_MUL(_gorec_mul_mod_mont) {
+	gorbn_mont_mul(r, a, b, &crv->mont);
+	_gorec_clear_high(r, crv);
+}
+
+static GOREC_FIELD_UNARY(_gorec_sqr_mod_mont) {
+	gorbn_mont_sqr(r, a, &crv->mont);
+	_gorec_clear_high(r, crv);
+}
+
+static GOREC_FIELD_UNARY(_gorec_to_mont) {
+	gorbn_to_mont(r, a, &crv->mont);
+	_gorec_clear_high(r, crv);
+}
+
+static GOREC_FIELD_UNARY(_gorec_from_mont) {
+	gorbn_from_mont(r, a, &crv->mont);
+	_gorec_clear_high(r, crv);
+}
+
+/*
+	Multiplication by small public constant with modular additions.
+	Works in any representation and does not depend on a.
+*/
+static GOREC_FIELD_MULWORD(_gorec_mulword_mod_dbl) {
+	gorbn_t res[GORBN_SZARR];
+	gorbn_t base[GORBN_SZARR];
+
+	gorbn_init(res, GORBN_SZARR);
+	gorbn_copy(base, a);
+
+	while (w) {
+		if (w & 1) {
+			_gorec_add_mod(res, res, base, crv);
+		}
+
+		w >>= 1;
+		if (w) {
+			_gorec_add_mod(base, base, base, crv);
+		}
+	}
+
+	gorbn_copy(r, res);
+}
+
+/*
+	r = a ^ e in the field representation with fixed 4-bit windows.
+	Sequence of operations depends only on e, so this runs in constant
+	time whenever field multiplication does.
+*/
+static void _gorec_pow_window(gorbn_t* r, gorbn_t* a, gorbn_t* e, gorec_curve* crv) {
+	gorbn_t table[1 << GOREC_FERMAT_WINDOW_W][GORBN_SZARR];
+	gorbn_t res[GORBN_SZARR];
+	int i, j;
+
+	gorbn_from_int(table[0], 1);
+	crv->to_field(table[0], table[0], crv);
+	gorbn_copy(table[1], a);
+	for (i = 2; i < (1 << GOREC_FERMAT_WINDOW_W); i++) {
+		crv->mul_mod(table[i], table[i - 1], a, crv);
+	}
+
+	gorbn_copy(res, table[0]);
+	int windows_count = (_gorbn_get_nbits(e, GORBN_SZARR) + GOREC_FERMAT_WINDOW_W - 1) / GOREC_FERMAT_WINDOW_W;
+	for (i = windows_count - 1; i >= 0; i--) {
+		int window = 0;
+		for (j = GOREC_FERMAT_WINDOW_W - 1; j >= 0; j--) {
+			crv->sqr_mod(res, res, crv);
+			window = (window << 1) | _gorbn_testbit(e, i * GOREC_FERMAT_WINDOW_W + j);
+		}
+
+		if (window) {
+			crv->mul_mod(res, res, table[window], crv);
+		}
+	}
+
+	gorbn_copy(r, res);
+}
+
+/*
+	Inversion as a ^ (p - 2) for prime p. Exponent is public, so
+	fixed 4-bit window exponentiation here runs in constant time
+	whenever field multiplication does.
+*/
+static GOREC_FIELD_UNARY(_gorec_inv_mod_fermat) {
+	GORBN_STAT_BEGIN(GORBN_STAT_INV_MOD);
+	gorbn_t e[GORBN_SZARR];
+
+	gorbn_from_int(e, 2);
+	gorbn_sub(e, crv->p, e);
+	_gorec_pow_window(r, a, e, crv);
+	GORBN_STAT_END(GORBN_STAT_INV_MOD);
+}
+
+/*
+	r = a ^ e in the field representation by addition chain for
+	e = (2 ^ L - 1) * 2 ^ t + tail, tail < 2 ^ t. Exponents that come from
+	pseudo-Mersenne primes have this form with small t: for STB
+	p - 2 = (2 ^ 248 - 1) * 2 ^ 8 + 0x41 and (p + 1) / 4 = (2 ^ 248 - 1) * 2 ^ 6 + 0x11.
+	x_k = a ^ (2 ^ k - 1) is built along the bits of L with
+	x_2k = x_k ^ (2 ^ k) * x_k and x_(k + 1) = x_k ^ 2 * a, then the
+	t bits of the tail are taken one by one. This costs log2(e) squarings
+	and about 2 * log2(L) + popcount(tail) multiplications. Sequence of
+	operations depends only on e, so this runs in constant time whenever
+	field multiplication does.
+*/
+static void _gorec_pow_chain(gorbn_t* r, gorbn_t* a, gorbn_t* e, gorec_curve* crv) {
+	gorbn_t base[GORBN_SZARR];
+	gorbn_t x[GORBN_SZARR];
+	gorbn_t y[GORBN_SZARR];
+	int e_nbits, run_len, run_nbits;
+	int i, j, k;
+
+	e_nbits = _gorbn_get_nbits(e, GORBN_SZARR);
+
+	for (run_len = 0; run_len < e_nbits; run_len++) {
+		if (!_gorbn_testbit(e, e_nbits - 1 - run_len)) {
+			break;
+		}
+	}
+
+	for (run_nbits = 0; (run_len >> run_nbits) != 0; run_nbits++);
+
+	gorbn_copy(base, a);
+	gorbn_copy(x, a);
+	k = 1;
+	for (i = run_nbits - 2; i >= 0; i--) {
+		gorbn_copy(y, x);
+		for (j = 0; j < k; j++) {
+			crv->sqr_mod(x, x, crv);
+		}
+		crv->mul_mod(x, x, y, crv);
+		k *= 2;
+
+		if ((run_len >> i) & 1) {
+			crv->sqr_mod(x, x, crv);
+			crv->mul_mod(x, x, base, crv);
+			k++;
+		}
+	}
+
+	for (i = e_nbits - run_len - 1; i >= 0; i--) {
+		crv->sqr_mod(x, x, crv);
+		if (_gorbn_testbit(e, i)) {
+			crv->mul_mod(x, x, base, crv);
+		}
+	}
+
+	gorbn_copy(r, x);
+}
+
+/*Inversion as a ^ (p - 2) by addition chain, for pseudo-Mersenne p*/
+static GOREC_FIELD_UNARY(_gorec_inv_mod_chain) {
+	GORBN_STAT_BEGIN(GORBN_STAT_INV_MOD);
+	gorbn_t e[GORBN_SZARR];
+
+	gorbn_from_int(e, 2);
+	gorbn_sub(e, crv->p, e);
+	_gorec_pow_chain(r, a, e, crv);
+	GORBN_STAT_END(GORBN_STAT_INV_MOD);
+}
+
+static GOREC_FIELD_UNARY(_gorec_inv_mod_mont) {
+	/*NOTE(dima): (a * R) ^ -1 * R = (a / R) ^ -1 * (R ^ 2) / R */
+	_gorec_from_mont(r, a, crv);
+	gorbn_inv_mod(r, r, crv->p);
+	_gorec_to_mont(r, r, crv);
+}
+
+/*
+	Choosing field arithmetic routines for the curve modulus.
+	Should be called every time after p, a, b or q of the curve are changed.
+*/
+static void _gorec_curve_select_routines(gorec_curve* crv) {
+	crv->n = _gorbn_get_ndigits(crv->p, GORBN_SZARR);
+
+	if (gorbn_is_pseudo_mersenne_n(crv->p, crv->n)) {
+		crv->mul_mod = _gorec_mul_mod_pm;
+		crv->sqr_mod = _gorec_sqr_mod_pm;
+		crv->mulword_mod = _gorec_mulword_mod_pm;
+		crv->inv_mod = _gorec_inv_mod_div;
+		crv->to_field = _gorec_copy_field;
+		crv->from_field = _gorec_copy_field;
+	}
+	else if (!GORBN_EVEN(crv->p)) {
+		crv->mul_mod = _gorec_mul_mod_mont;
+		crv->sqr_mod = _gorec_sqr_mod_mont;
+		/*NOTE(dima): Multiplication by small constant does not leave Montgomery domain*/
+		crv->mulword_mod = _gorec_mulword_mod_dbl;
+		crv->inv_mod = _gorec_inv_mod_mont;
+		crv->to_field = _gorec_to_mont;
+		crv->from_field = _gorec_from_mont;
+	}
+	else {
+		crv->mul_mod = _gorec_mul_mod_div;
+		crv->sqr_mod = _gorec_sqr_mod_div;
+		crv->mulword_mod = _gorec_mulword_mod_div;
+		crv->inv_mod = _gorec_inv_mod_div;
+		crv->to_field = _gorec_copy_field;
+		crv->from_field = _gorec_copy_field;
+	}
+
+	crv->to_field(crv->fa, crv->a, crv);
+	crv->to_field(crv->fb, crv->b, crv);
+
+	gorbn_t a_plus_3[GORBN_SZARR];
+	gorbn_t three[GORBN_SZARR];
+	gorbn_from_int(three, 3);
+	_gorec_add_mod(a_plus_3, crv->a, three, crv);
+	if (gorbn_is_zero(a_plus_3)) {
+		crv->pt_double = gorec_pt_double_jacobian_a3;
+	}
+	else {
+		crv->pt_double = gorec_pt_double_jacobian;
+	}
+}
+
+void gorec_curve_setup(gorec_curve* crv) {
+	//NOTE(dima): Montgomery context is set for any odd p, so that gorbn_mont_* can be used with crv->mont
+	if (!GORBN_EVEN(crv->p)) {
+		gorbn_mont_init(&crv->mont, crv->p);
+	}
+
+	if (!gorbn_is_zero(crv->q)) {
+		gorbn_barrett_init(&crv->q_barrett, crv->q);
+	}
+
+	_gorec_curve_select_routines(crv);
+
+	//NOTE(dima): Comb table depends on p and g so it should be rebuilt
+	crv->base_table_ready = 0;
+	crv->mapped_base_table = 0;
+	crv->mapped_base_wnaf_table = 0;
+}
+
+/* Loading standard belarussian parameters*/
+void gorec_load_stb128(gorec_curve* crv) {
+	unsigned char lwo_bign_std_curve128_p[32] = {
+		0x43, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+		0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+		0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+		0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	};
+
+	unsigned char lwo_bign_std_curve128_a[32] = {
+		0x40, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+		0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+		0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+		0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	};
+
+	unsigned char lwo_bign_std_curve128_b[32] = {
+		0xF1, 0x03, 0x9C, 0xD6, 0x6B, 0x7D, 0x2E, 0xB2,
+		0x53, 0x92, 0x8B, 0x97, 0x69, 0x50, 0xF5, 0x4C,
+		0xBE, 0xFB, 0xD8, 0xE4, 0xAB, 0x3A, 0xC1, 0xD2,
+		0xED, 0xA8, 0xF3, 0x15, 0x15, 0x6C, 0xCE, 0x77,
+	};
+
+	unsigned char lwo_bign_std_curve128_q[32] = {
+		0x07, 0x66, 0x3D, 0x26, 0x99, 0xBF, 0x5A, 0x7E,
+		0xFC, 0x4D, 0xFB, 0x0D, 0xD6, 0x8E, 0x5C, 0xD9,
+		0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+		0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	};
+
+	unsigned char lwo_bign_std_curve128_yG[32] = {
+		0x93, 0x6A, 0x51, 0x04, 0x18, 0xCF, 0x29, 0x1E,
+		0x52, 0xF6, 0x08, 0xC4, 0x66, 0x39, 0x91, 0x78,
+		0x5D, 0x83, 0xD6, 0x51, 0xA3, 0xC9, 0xE4, 0x5C,
+		0x9F, 0xD6, 0x16, 0xFB, 0x3C, 0xFC, 0xF7, 0x6B,
+	};
+
+	unsigned char lwo_bign_std_curve128_xG[32] = {
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	};
+
+	gorbn_from_data(crv->a, (void*)lwo_bign_std_curve128_a, sizeof(lwo_bign_std_curve128_a));
+	gorbn_from_data(crv->b, (void*)lwo_bign_std_curve128_b, sizeof(lwo_bign_std_curve128_b));
+	gorbn_from_data(crv->p, (void*)lwo_bign_std_curve128_p, sizeof(lwo_bign_std_curve128_p));
+	gorbn_from_data(crv->q, (void*)lwo_bign_std_curve128_q, sizeof(lwo_bign_std_curve128_q));
+
+	gorbn_from_data(crv->g.x, (void*)lwo_bign_std_curve128_xG, sizeof(lwo_bign_std_curve128_xG));
+	gorbn_from_data(crv->g.y, (void*)lwo_bign_std_curve128_yG, sizeof(lwo_bign_std_curve128_yG));
+	gorbn_from_int(crv->g.z, 1);
+	crv->g.is_inf = 0;
+
+	gorec_curve_setup(crv);
+	gorec_curve_precompute_base(crv);
+}
+
+/* point clearing */
+void gorec_pt_clear(gorec_point* p) {
+	gorbn_init(p->x, GORBN_SZARR);
+	gorbn_init(p->y, GORBN_SZARR);
+	gorbn_from_int(p->z, 1);
+	p->is_inf = 1;
+}
+
+/* point copying */
+void gorec_pt_copy(gorec_point* r, gorec_point* p) {
+	gorbn_copy(r->x, p->x);
+	gorbn_copy(r->y, p->y);
+	gorbn_copy(r->z, p->z);
+	r->is_inf = p->is_inf;
+}
+
+/* point conversion to the representation of the curve field routines */
+void gorec_pt_to_field(gorec_point* r, gorec_point* p, gorec_curve* crv) {
+	crv->to_field(r->x, p->x, crv);
+	crv->to_field(r->y, p->y, crv);
+	crv->to_field(r->z, p->z, crv);
+	r->is_inf = p->is_inf;
+}
+
+/* point conversion from the representation of the curve field routines */
+void gorec_pt_from_field(gorec_point* r, gorec_point* p, gorec_curve* crv) {
+	crv->from_field(r->x, p->x, crv);
+	crv->from_field(r->y, p->y, crv);
+	crv->from_field(r->z, p->z, crv);
+	r->is_inf = p->is_inf;
+}
+
+/*
+	Square root for p = 3 mod 4. From a ^ ((p - 1) / 2) = 1 for quadratic
+	residues follows (a ^ ((p + 1) / 4)) ^ 2 = a, so one exponentiation
+	and one check squaring are enough. Exponent is public, so the chain
+	of _gorec_pow_chain() is taken for pseudo-Mersenne p, where it is about
+	as long as the chain of inversion.
+*/
+int gorec_sqrt_mod(gorbn_t* r, gorbn_t* a, gorec_curve* crv) {
+	gorbn_t e[GORBN_SZARR];
+	gorbn_t fa[GORBN_SZARR];
+	gorbn_t res[GORBN_SZARR];
+	gorbn_t check[GORBN_SZARR];
+
+	if ((crv->p[0] & 3) != 3) {
+		return(0);
+	}
+
+	//NOTE(dima): p = 3 mod 4, so p + 1 does not overflow and (p + 1) / 4 = (p >> 2) + 1
+	gorbn_rshift(e, crv->p, 2);
+	gorbn_from_int(check, 1);
+	gorbn_add(e, e, check);
+
+	crv->to_field(fa, a, crv);
+	if (gorbn_is_pseudo_mersenne_n(crv->p, crv->n)) {
+		_gorec_pow_chain(res, fa, e, crv);
+	}
+	else {
+		_gorec_pow_window(res, fa, e, crv);
+	}
+
+	crv->sqr_mod(check, res, crv);
+	if (gorbn_cmp(check, fa) != GORBN_CMP_EQUAL) {
+		return(0);
+	}
+
+	crv->from_field(r, res, crv);
+	return(1);
+}
+
+/* y ^ 2 = x ^ 3 + a * x + b in the representation of the field routines */
+static void _gorec_curve_rhs(gorbn_t* r, gorbn_t* fx, gorec_curve* crv) {
+	gorbn_t tmp[GORBN_SZARR];
+
+	crv->sqr_mod(tmp, fx, crv);
+	_gorec_add_mod(tmp, tmp, crv->fa, crv);
+	crv->mul_mod(tmp, tmp, fx, crv);
+	_gorec_add_mod(r, tmp, crv->fb, crv);
+}
+
+int gorec_pt_is_on_curve(gorec_point* p, gorec_curve* crv) {
+	gorbn_t fx[GORBN_SZARR];
+	gorbn_t fy[GORBN_SZARR];
+	gorbn_t lhs[GORBN_SZARR];
+	gorbn_t rhs[GORBN_SZARR];
+
+	if (p->is_inf) {
+		return(1);
+	}
+
+	if (gorbn_cmp(p->x, crv->p) != GORBN_CMP_SMALLER ||
+		gorbn_cmp(p->y, crv->p) != GORBN_CMP_SMALLER)
+	{
+		return(0);
+	}
+
+	crv->to_field(fx, p->x, crv);
+	crv->to_field(fy, p->y, crv);
+
+	crv->sqr_mod(lhs, fy, crv);
+	_gorec_curve_rhs(rhs, fx, crv);
+
+	int result = (gorbn_cmp(lhs, rhs) == GORBN_CMP_EQUAL);
+	return(result);
+}
+
+int gorec_pt_from_x(gorec_point* r, gorbn_t* x, int y_is_odd, gorec_curve* crv) {
+	gorbn_t fx[GORBN_SZARR];
+	gorbn_t rhs[GORBN_SZARR];
+	gorbn_t y[GORBN_SZARR];
+	gorbn_t zero[GORBN_SZARR];
+
+	if (gorbn_cmp(x, crv->p) != GORBN_CMP_SMALLER) {
+		return(0);
+	}
+
+	crv->to_field(fx, x, crv);
+	_gorec_curve_rhs(rhs, fx, crv);
+	crv->from_field(rhs, rhs, crv);
+
+	if (!gorec_sqrt_mod(y, rhs, crv)) {
+		return(0);
+	}
+
+	if ((int)(y[0] & 1) != (y_is_odd != 0)) {
+		//NOTE(dima): y = 0 has no odd pair
+		if (gorbn_is_zero(y)) {
+			return(0);
+		}
+
+		gorbn_init(zero, GORBN_SZARR);
+		_gorec_sub_mod(y, zero, y, crv);
+	}
+
+	gorbn_copy(r->x, x);
+	gorbn_copy(r->y, y);
+	gorbn_from_int(r->z, 1);
+	r->is_inf = 0;
+
+	return(1);
+}
+
+int gorec_pt_compressed_size(gorec_curve* crv) {
+	int result = 1 + (_gorbn_get_nbits(crv->p, GORBN_SZARR) + 7) / 8;
+	return(result);
+}
+
+void gorec_pt_compress(void* data, gorec_point* p, gorec_curve* crv) {
+	unsigned char* at = (unsigned char*)data;
+	int x_size = gorec_pt_compressed_size(crv) - 1;
+
+	if (p->is_inf) {
+		int i;
+		for (i = 0; i <= x_size; i++) {
+			at[i] = 0;
+		}
+		return;
+	}
+
+	at[0] = (unsigned char)(0x02 | (p->y[0] & 1));
+	gorbn_to_data(at + 1, x_size, p->x);
+}
+
+int gorec_pt_decompress(gorec_point* r, void* data, uint32_t data_size, gorec_curve* crv) {
+	unsigned char* at = (unsigned char*)data;
+	gorbn_t x[GORBN_SZARR];
+	uint32_t i;
+
+	if (data_size != (uint32_t)gorec_pt_compressed_size(crv)) {
+		return(0);
+	}
+
+	if (at[0] == 0) {
+		for (i = 1; i < data_size; i++) {
+			if (at[i]) {
+				return(0);
+			}
+		}
+
+		gorec_pt_clear(r);
+		return(1);
+	}
+
+	if ((at[0] & 0xFE) != 0x02) {
+		return(0);
+	}
+
+	gorbn_from_data(x, at + 1, data_size - 1);
+
+	int result = gorec_pt_from_x(r, x, at[0] & 1, crv);
+	return(result);
+}
+
+/* Point addition in affine coordinates */
+void gorec_pt_add(gorec_point* r, gorec_point* a, gorec_point* b, gorec_curve* crv) {
+	if (a->is_inf) {
+		gorec_pt_copy(r, b);
+		return;
+	}
+
+	if (b->is_inf) {
+		gorec_pt_copy(r, a);
+		return;
+	}
+
+	gorbn_t lambda[GORBN_SZARR];
+	gorbn_t tmp[GORBN_SZARR];
+
+	gorbn_t res_x[GORBN_SZARR];
+	gorbn_t res_y[GORBN_SZARR];
+
+	gorbn_init(lambda, GORBN_SZARR);
+	gorbn_init(tmp, GORBN_SZARR);
+
+	/*lambda = (y2 - y1)/(x2 - x1)*/
+	_gorec_sub_mod(lambda, b->y, a->y, crv);
+	_gorec_sub_mod(tmp, b->x, a->x, crv);
+	crv->inv_mod(tmp, tmp, crv);
+	crv->mul_mod(lambda, lambda, tmp, crv);
+
+	/*x3 = lambda*lambda - x1 - x2*/
+	crv->sqr_mod(res_x, lambda, crv);
+	_gorec_sub_mod(res_x, res_x, a->x, crv);
+	_gorec_sub_mod(res_x, res_x, b->x, crv);
+
+	/*y3 = lambda * (x1 - x3) - y1 */
+	_gorec_sub_mod(res_y, a->x, res_x, crv);
+	crv->mul_mod(res_y, lambda, res_y, crv);
+	_gorec_sub_mod(res_y, res_y, a->y, crv);
+
+	gorbn_copy(r->x, res_x);
+	gorbn_copy(r->y, res_y);
+}
+
+/* Point doubling in affine coordinates */
+void gorec_pt_double(gorec_point* r, gorec_point* a, gorec_curve* crv) {
+	if (!a->is_inf) {
+		gorbn_t res_x[GORBN_SZARR];
+		gorbn_t res_y[GORBN_SZARR];
+		
+		gorbn_t lambda[GORBN_SZARR];
+		gorbn_t tmp[GORBN_SZARR];
+
+		gorbn_init(lambda, GORBN_SZARR);
+		gorbn_init(tmp, GORBN_SZARR);
+
+		/*lambda = (3x1x1 + a)/(2y1) */
+		crv->sqr_mod(lambda, a->x, crv);
+		crv->mulword_mod(lambda, lambda, 3, crv);
+		_gorec_add_mod(lambda, lambda, crv->fa, crv);
+		crv->mulword_mod(tmp, a->y, 2, crv);
+		crv->inv_mod(tmp, tmp, crv);
+		crv->mul_mod(lambda, lambda, tmp, crv);
+
+		/*x3 = lambda*lambda - x1 - x2*/
+		crv->sqr_mod(res_x, lambda, crv);
+		_gorec_sub_mod(res_x, res_x, a->x, crv);
+		_gorec_sub_mod(res_x, res_x, a->x, crv);
+
+		/*y3 = lambda * (x1 - x3) - y1 */
+		_gorec_sub_mod(res_y, a->x, res_x, crv);
+		crv->mul_mod(res_y, lambda, res_y, crv);
+		_gorec_sub_mod(res_y, res_y, a->y, crv);
+
+		gorbn_copy(r->x, res_x);
+		gorbn_copy(r->y, res_y);
+	}
+}
+
+/* Point doubling in Jacobian coordinates */
+void gorec_pt_double_jacobian(gorec_point* r, gorec_point* a, gorec_curve* crv) {
+	GORBN_STAT_BEGIN(GORBN_STAT_PT_DOUBLE);
+	gorbn_t S[GORBN_SZARR];
+	gorbn_t M[GORBN_SZARR];
+	gorbn_t TMP[GORBN_SZARR];
+	gorbn_t YSQ[GORBN_SZARR];
+
+	gorec_point rp;
+	gorec_pt_clear(&rp);
+
+	if (a->is_inf) {
+		gorec_pt_copy(r, a);
+		GORBN_STAT_END(GORBN_STAT_PT_DOUBLE);
+		return;
+	}
+
+	// S = 4*X*Y^2
+	crv->sqr_mod(YSQ, a->y, crv);
+	crv->mul_mod(S, a->x, YSQ, crv);
+	crv->mulword_mod(S, S, 4, crv);
+
+	// M = 3*X^2 + a*Z^4
+	crv->sqr_mod(M, a->x, crv);
+	crv->mulword_mod(M, M, 3, crv);
+	crv->sqr_mod(TMP, a->z, crv);
+	crv->sqr_mod(TMP, TMP, crv);
+	crv->mul_mod(TMP, TMP, crv->fa, crv);
+	_gorec_add_mod(M, M, TMP, crv);
+
+	// X' = M^2 - 2*S
+	crv->sqr_mod(rp.x, M, crv);
+	crv->mulword_mod(TMP, S, 2, crv);
+	_gorec_sub_mod(rp.x, rp.x, TMP, crv);
+
+	// Y' = M*(S - X') - 8 * Y ^ 4
+	_gorec_sub_mod(rp.y, S, rp.x, crv);
+	crv->mul_mod(rp.y, M, rp.y, crv);
+	crv->sqr_mod(TMP, YSQ, crv);
+	crv->mulword_mod(TMP, TMP, 8, crv);
+	_gorec_sub_mod(rp.y, rp.y, TMP, crv);
+	
+	// Z' = 2*Y*Z
+	crv->mul_mod(rp.z, a->y, a->z, crv);
+	crv->mulword_mod(rp.z, rp.z, 2, crv);
+
+	rp.is_inf = 0;
+	gorec_pt_copy(r, &rp);
+	GORBN_STAT_END(GORBN_STAT_PT_DOUBLE);
+}
+
+/*
+	Point doubling in Jacobian coordinates for a = -3:
+	3*X^2 + a*Z^4 = 3*(X - Z^2)*(X + Z^2)
+*/
+void gorec_pt_double_jacobian_a3(gorec_point* r, gorec_point* a, gorec_curve* crv) {
+	GORBN_STAT_BEGIN(GORBN_STAT_PT_DOUBLE);
+	gorbn_t DELTA[GORBN_SZARR];
+	gorbn_t GAMMA[GORBN_SZARR];
+	gorbn_t BETA[GORBN_SZARR];
+	gorbn_t ALPHA[GORBN_SZARR];
+	gorbn_t TMP[GORBN_SZARR];
+
+	if (a->is_inf) {
+		gorec_pt_copy(r, a);
+		GORBN_STAT_END(GORBN_STAT_PT_DOUBLE);
+		return;
+	}
+
+	// DELTA = Z^2, GAMMA = Y^2, BETA = X*Y^2
+	crv->sqr_mod(DELTA, a->z, crv);
+	crv->sqr_mod(GAMMA, a->y, crv);
+	crv->mul_mod(BETA, a->x, GAMMA, crv);
+
+	// ALPHA = 3*(X - DELTA)*(X + DELTA)
+	_gorec_sub_mod(TMP, a->x, DELTA, crv);
+	_gorec_add_mod(ALPHA, a->x, DELTA, crv);
+	crv->mul_mod(ALPHA, ALPHA, TMP, crv);
+	crv->mulword_mod(ALPHA, ALPHA, 3, crv);
+
+	// Z' = 2*Y*Z
+	crv->mul_mod(r->z, a->y, a->z, crv);
+	crv->mulword_mod(r->z, r->z, 2, crv);
+
+	// X' = ALPHA^2 - 8*BETA
+	crv->mulword_mod(BETA, BETA, 4, crv);
+	crv->sqr_mod(r->x, ALPHA, crv);
+	_gorec_sub_mod(r->x, r->x, BETA, crv);
+	_gorec_sub_mod(r->x, r->x, BETA, crv);
+
+	// Y' = ALPHA*(4*BETA - X') - 8*GAMMA^2
+	_gorec_sub_mod(TMP, BETA, r->x, crv);
+	crv->mul_mod(TMP, TMP, ALPHA, crv);
+	crv->sqr_mod(GAMMA, GAMMA, crv);
+	crv->mulword_mod(GAMMA, GAMMA, 8, crv);
+	_gorec_sub_mod(r->y, TMP, GAMMA, crv);
+
+	r->is_inf = 0;
+	GORBN_STAT_END(GORBN_STAT_PT_DOUBLE);
+}
+
+/*
+	Point addition in Jacobian projective coordinates.
+	If check_special is 0, a = b and a = -b are not detected. It
+	is used by constant-time code where these cases do not happen
+	and comparison of U1 and U2 would leak timing.
+*/
+static void _gorec_pt_add_jacobian(gorec_point* r, gorec_point* a, gorec_point* b, gorec_curve* crv, int check_special) {
+	GORBN_STAT_BEGIN(GORBN_STAT_PT_ADD);
+	gorbn_t U1[GORBN_SZARR];
+	gorbn_t U2[GORBN_SZARR];
+	gorbn_t S1[GORBN_SZARR];
+	gorbn_t S2[GORBN_SZARR];
+	gorbn_t TMP[GORBN_SZARR];
+	gorbn_t H[GORBN_SZARR];
+	gorbn_t R[GORBN_SZARR];
+
+	if (a->is_inf) {
+		gorec_pt_copy(r, b);
+		GORBN_STAT_END(GORBN_STAT_PT_ADD);
+		return;
+	}
+
+	if (b->is_inf) {
+		gorec_pt_copy(r, a);
+		GORBN_STAT_END(GORBN_STAT_PT_ADD);
+		return;
+	}
+
+	// U1 = X1*Z2^2
+	// U2 = X2*Z1^2
+	// S1 = Y1*Z2^3
+	// S2 = Y2*Z1^3
+	crv->sqr_mod(TMP, b->z, crv);
+	crv->mul_mod(U1, a->x, TMP, crv);
+	crv->mul_mod(S1, TMP, a->y, crv);
+	crv->mul_mod(S1, S1, b->z, crv);
+	crv->sqr_mod(TMP, a->z, crv);
+	crv->mul_mod(U2, TMP, b->x, crv);
+	crv->mul_mod(S2, TMP, b->y, crv);
+	crv->mul_mod(S2, S2, a->z, crv);
+
+	if (check_special && gorbn_cmp(U1, U2) == GORBN_CMP_EQUAL) {
+		if (gorbn_cmp(S1, S2) != GORBN_CMP_EQUAL) {
+			//NOTE(dima): Return POINT_AT_INFINITY
+			gorec_pt_clear(r);
+			GORBN_STAT_END(GORBN_STAT_PT_ADD);
+			return;
+		}
+		else {
+			crv->pt_double(r, a, crv);
+			GORBN_STAT_END(GORBN_STAT_PT_ADD);
+			return;
+		}
+	}
+
+	// H = U2 - U1
+	_gorec_sub_mod(H, U2, U1, crv);
+
+	// R = S2 - S1
+	_gorec_sub_mod(R, S2, S1, crv);
+
+	// X3 = R^2 - H^3 - 2*U1*H^2
+	crv->sqr_mod(r->x, R, crv);
+	crv->sqr_mod(U2, H, crv);
+	crv->mul_mod(U2, U2, H, crv);
+	_gorec_sub_mod(r->x, r->x, U2, crv);
+	crv->sqr_mod(TMP, H, crv);
+	crv->mul_mod(TMP, TMP, U1, crv);
+	crv->mulword_mod(TMP, TMP, 2, crv);
+	_gorec_sub_mod(r->x, r->x, TMP, crv);
+
+	// Y3 = R*(U1*H^2 - X3) - S1*H^3
+	crv->sqr_mod(TMP, H, crv);
+	crv->mul_mod(TMP, TMP, U1, crv);
+	_gorec_sub_mod(TMP, TMP, r->x, crv);
+	crv->mul_mod(TMP, TMP, R, crv);
+	crv->mul_mod(U2, U2, S1, crv);
+	_gorec_sub_mod(r->y, TMP, U2, crv);
+
+	// Z3 = H*Z1*Z2
+	crv->mul_mod(r->z, a->z, b->z, crv);
+	crv->mul_mod(r->z, r->z, H, crv);
+	r->is_inf = 0;
+	GORBN_STAT_END(GORBN_STAT_PT_ADD);
+}
+
+void gorec_pt_add_jacobian(gorec_point* r, gorec_point* a, gorec_point* b, gorec_curve* crv) {
+	_gorec_pt_add_jacobian(r, a, b, crv, 1);
+}
+
+/*Point subtraction in Jacobian projective coordinates*/
+void gorec_pt_sub_jacobian(gorec_point* r, gorec_point* a, gorec_point* b, gorec_curve* crv) {
+	gorbn_t SaveY[GORBN_SZARR];
+
+	//NOTE(dima): Save b->y for later reassigning
+	gorbn_copy(SaveY, b->y);
+
+	//NOTE(dima): 0 - b->y
+	gorbn_init(b->y, GORBN_SZARR);
+
+	_gorec_sub_mod(b->y, b->y, SaveY, crv);
+
+	//NOTE(dima): Adding initial A and negated B
+	gorec_pt_add_jacobian(r, a, b, crv);
+
+	//NOTE(dima): Returning old saved b->y value
+	gorbn_copy(b->y, SaveY);
+}
+
+/*
+	Mixed point addition: a in Jacobian coordinates, b is affine
+	(b->z is unity of the field routines, as in normalized points).
+	Saves 4 multiplications and 1 squaring on Z2 = 1.
+*/
+static void _gorec_pt_add_mixed(gorec_point* r, gorec_point* a, gorec_point* b, gorec_curve* crv, int check_special) {
+	GORBN_STAT_BEGIN(GORBN_STAT_PT_ADD_MIXED);
+	gorbn_t Z1Z1[GORBN_SZARR];
+	gorbn_t U2[GORBN_SZARR];
+	gorbn_t S2[GORBN_SZARR];
+	gorbn_t H[GORBN_SZARR];
+	gorbn_t HH[GORBN_SZARR];
+	gorbn_t R[GORBN_SZARR];
+	gorbn_t V[GORBN_SZARR];
+	gorbn_t TMP[GORBN_SZARR];
+	gorbn_t X3[GORBN_SZARR];
+	gorbn_t Y3[GORBN_SZARR];
+
+	if (a->is_inf) {
+		gorec_pt_copy(r, b);
+		GORBN_STAT_END(GORBN_STAT_PT_ADD_MIXED);
+		return;
+	}
+
+	if (b->is_inf) {
+		gorec_pt_copy(r, a);
+		GORBN_STAT_END(GORBN_STAT_PT_ADD_MIXED);
+		return;
+	}
+
+	// U2 = X2*Z1^2
+	// S2 = Y2*Z1^3
+	crv->sqr_mod(Z1Z1, a->z, crv);
+	crv->mul_mod(U2, b->x, Z1Z1, crv);
+	crv->mul_mod(S2, a->z, Z1Z1, crv);
+	crv->mul_mod(S2, S2, b->y, crv);
+
+	// H = U2 - X1
+	// R = S2 - Y1
+	_gorec_sub_mod(H, U2, a->x, crv);
+	_gorec_sub_mod(R, S2, a->y, crv);
+
+	if (check_special && gorbn_is_zero(H)) {
+		if (gorbn_is_zero(R)) {
+			crv->pt_double(r, a, crv);
+		}
+		else {
+			gorec_pt_clear(r);
+		}
+		GORBN_STAT_END(GORBN_STAT_PT_ADD_MIXED);
+		return;
+	}
+
+	// V = X1*H^2
+	// HHH = H^3 (stored in TMP)
+	crv->sqr_mod(HH, H, crv);
+	crv->mul_mod(V, a->x, HH, crv);
+	crv->mul_mod(TMP, HH, H, crv);
+
+	// X3 = R^2 - H^3 - 2*V
+	crv->sqr_mod(X3, R, crv);
+	_gorec_sub_mod(X3, X3, TMP, crv);
+	_gorec_sub_mod(X3, X3, V, crv);
+	_gorec_sub_mod(X3, X3, V, crv);
+
+	// Y3 = R*(V - X3) - Y1*H^3
+	_gorec_sub_mod(Y3, V, X3, crv);
+	crv->mul_mod(Y3, Y3, R, crv);
+	crv->mul_mod(TMP, TMP, a->y, crv);
+	_gorec_sub_mod(Y3, Y3, TMP, crv);
+
+	// Z3 = Z1*H
+	crv->mul_mod(r->z, a->z, H, crv);
+	gorbn_copy(r->x, X3);
+	gorbn_copy(r->y, Y3);
+	r->is_inf = 0;
+	GORBN_STAT_END(GORBN_STAT_PT_ADD_MIXED);
+}
+
+void gorec_pt_add_mixed(gorec_point* r, gorec_point* a, gorec_point* b, gorec_curve* crv) {
+	_gorec_pt_add_mixed(r, a, b, crv, 1);
+}
+
+/*Mixed point subtraction: a in Jacobian coordinates, b is affine*/
+void gorec_pt_sub_mixed(gorec_point* r, gorec_point* a, gorec_point* b, gorec_curve* crv) {
+	gorec_point neg_b;
+
+	gorec_pt_copy(&neg_b, b);
+	gorbn_init(neg_b.y, GORBN_SZARR);
+	_gorec_sub_mod(neg_b.y, neg_b.y, b->y, crv);
+
+	gorec_pt_add_mixed(r, a, &neg_b, crv);
+}
+
+/*
+	NOTE(dima): count bits of k starting from bit pos, count <= 7.
+	Window can cross the boundary of words, bits above k are zero.
+*/
+static int _gorec_naf_get_bits(gorbn_t* k, int pos, int count) {
+	int word_index = pos / GORBN_SZWORD_BITS;
+	int bit_index = pos % GORBN_SZWORD_BITS;
+	int result = 0;
+	int have = 0;
+
+	while (have < count && word_index < GORBN_SZARR) {
+		result |= (int)((k[word_index] >> bit_index) & (gorbn_t)((1 << count) - 1)) << have;
+		have += GORBN_SZWORD_BITS - bit_index;
+		word_index++;
+		bit_index = 0;
+	}
+
+	return(result & ((1 << count) - 1));
+}
+
+/*
+	NOTE(dima): Width-w NAF of k. Digits are zero or odd in
+	(-2 ^ (w - 1), 2 ^ (w - 1)), NAF[0] is the lowest. Bits of k are read
+	by windows and k is not changed: instead of subtracting a negative
+	digit from k a carry goes to the next window. w should not be
+	greater than 7 (<=7).
+*/
+static void gorec_compute_naf(char* NAF, int* NAFLength, gorbn_t k[GORBN_SZARR], int w) {
+	int nbits = _gorbn_get_nbits(k, GORBN_SZARR);
+	int last_digit = -1;
+	int carry = 0;
+	int bit = 0;
+	int i;
+
+	//NOTE(dima): NAF can be one digit longer than k
+	for (i = 0; i <= nbits; i++) {
+		NAF[i] = 0;
+	}
+
+	while (bit <= nbits) {
+		if (_gorec_naf_get_bits(k, bit, 1) == carry) {
+			bit++;
+			continue;
+		}
+
+		int digit = _gorec_naf_get_bits(k, bit, w) + carry;
+		carry = (digit >> (w - 1)) & 1;
+		digit -= carry << w;
+
+		NAF[bit] = (char)digit;
+		last_digit = bit;
+		bit += w;
+	}
+
+	*NAFLength = last_digit + 1;
+}
+
+int gorec_wnaf_width(int nbits) {
+	int w;
+
+	//NOTE(dima): Same choice as ecNAFWidth() of ecurva.h
+	if (nbits >= 336) {
+		w = 6;
+	}
+	else if (nbits >= 120) {
+		w = 5;
+	}
+	else if (nbits >= 40) {
+		w = 4;
+	}
+	else {
+		w = 3;
+	}
+
+	return(GORBN_MIN(w, GOREC_WNAF_W_MAX));
+}
+
+/*
+	Odd multiples table[i] = (2 * i + 1) * p, normalized so that
+	they can be used with mixed addition. p is in field representation.
+*/
+static void _gorec_precompute_odd_multiples(gorec_point* table, int count, gorec_point* p, gorec_curve* crv) {
+	gorec_point p_double;
+	int i;
+
+	gorec_pt_copy(&table[0], p);
+	crv->pt_double(&p_double, p, crv);
+	for (i = 1; i < count; i++) {
+		gorec_pt_add_jacobian(&table[i], &table[i - 1], &p_double, crv);
+	}
+
+	gorec_pt_normalize_batch(table, count, crv);
+}
+
+void gorec_pt_mul_wnaf_jacobian(
+	gorec_point* p_result,
+	gorec_point *p_point,
+	gorbn_t *p_scalar,
+	gorec_curve* crv)
+{
+	gorec_pt_mul_wnaf_jacobian_w(p_result, p_point, p_scalar, 0, crv);
+}
+
+void gorec_pt_mul_wnaf_jacobian_w(
+	gorec_point* p_result,
+	gorec_point *p_point,
+	gorbn_t *p_scalar,
+	int w,
+	gorec_curve* crv) 
+{
+	int i;
+
+	//NOTE(dima): I think that this is the maximum possible size of this thing
+	char NAF[GORBN_SZARR_BITS_TOTAL + 1];
+	int NAFLength;
+
+	gorec_point PrecomputePoints[GOREC_WNAF_TABLE_MAX];
+
+	gorec_point result;
+	gorec_point pt;
+
+	if (w == 0) {
+		w = gorec_wnaf_width(_gorbn_get_nbits(p_scalar, GORBN_SZARR));
+	}
+	w = GORBN_CLAMP(w, 2, GOREC_WNAF_W_MAX);
+	int table_count = 1 << (w - 2);
+
+	//NOTE(dima): Step1 - Computing Non-Adjacent Form (NAF)
+	gorec_compute_naf(NAF, &NAFLength, p_scalar, w);
+
+	gorec_pt_to_field(&pt, p_point, crv);
+
+	//NOTE(dima): Step2 - Precomputing points. Normalized points allow mixed addition
+	_gorec_precompute_odd_multiples(PrecomputePoints, table_count, &pt, crv);
+
+	gorec_pt_clear(&result);
+	//NOTE(dima): Step 3 - Compute result using precomputed values
+	for (i = NAFLength - 1; i >= 0; i--) {
+		crv->pt_double(&result, &result, crv);
+		if (NAF[i] != 0) {
+			if (NAF[i] > 0) {
+				gorec_pt_add_mixed(&result, &result, &PrecomputePoints[NAF[i] >> 1], crv);
+			}
+			else {
+				gorec_pt_sub_mixed(&result, &result, &PrecomputePoints[(-NAF[i]) >> 1], crv);
+			}
+		}
+	}
+
+	//NOTE(dima): Exit from Jacobian coordinates
+	gorec_pt_normalize(&result, &result, crv);
+
+	crv->from_field(result.x, result.x, crv);
+	crv->from_field(result.y, result.y, crv);
+	gorbn_from_int(result.z, 1);
+
+	gorec_pt_copy(p_result, &result);
+}
+
+/*
+	Умножение точки эллиптической кривой на скаляр
+
+	p_result - указатель на результат - точку эллиптической кривой
+	p_point - указатель на точку, которую будем умножать
+	p_scalar - указатель на скалял, на который будем умножать p_point
+	crv - указатель на структуру с параметрами эллиптической кривой
+*/
+
+/*
+	Jacobian point to affine point. Both are in the representation
+	of the curve field routines.
+
+	x = X / Z^2, y = Y / Z^3
+*/
+void gorec_pt_normalize(gorec_point* r, gorec_point* p, gorec_curve* crv) {
+	gorbn_t z_inv[GORBN_SZARR];
+	gorbn_t z_inv_sq[GORBN_SZARR];
+
+	if (p->is_inf) {
+		gorec_pt_clear(r);
+		crv->to_field(r->z, r->z, crv);
+		return;
+	}
+
+	crv->inv_mod(z_inv, p->z, crv);
+	crv->sqr_mod(z_inv_sq, z_inv, crv);
+
+	crv->mul_mod(r->x, p->x, z_inv_sq, crv);
+	crv->mul_mod(z_inv_sq, z_inv_sq, z_inv, crv);
+	crv->mul_mod(r->y, p->y, z_inv_sq, crv);
+
+	gorbn_from_int(r->z, 1);
+	crv->to_field(r->z, r->z, crv);
+	r->is_inf = 0;
+}
+
+/*
+	Montgomery's simultaneous inversion: 
+	prod[i] = z[0] * ... * z[i], then one inversion of prod[n - 1] and
+	walking back z[i] ^ -1 = prod[i - 1] * (prod[i] ^ -1).
+	Points at infinity are skipped.
+*/
+static void _gorec_pt_normalize_chunk(gorec_point* pts, int pts_count, gorec_curve* crv) {
+	gorbn_t prod[GOREC_NORMALIZE_BATCH_CHUNK][GORBN_SZARR];
+	gorbn_t inv[GORBN_SZARR];
+	gorbn_t z_inv[GORBN_SZARR];
+	gorbn_t z_inv_sq[GORBN_SZARR];
+	int i;
+
+	gorbn_from_int(inv, 1);
+	crv->to_field(inv, inv, crv);
+
+	for (i = 0; i < pts_count; i++) {
+		if (pts[i].is_inf) {
+			gorbn_copy(prod[i], inv);
+		}
+		else {
+			crv->mul_mod(prod[i], inv, pts[i].z, crv);
+		}
+		gorbn_copy(inv, prod[i]);
+	}
+
+	crv->inv_mod(inv, inv, crv);
+
+	for (i = pts_count - 1; i >= 0; i--) {
+		if (pts[i].is_inf) {
+			gorec_pt_clear(&pts[i]);
+			crv->to_field(pts[i].z, pts[i].z, crv);
+			continue;
+		}
+
+		if (i > 0) {
+			crv->mul_mod(z_inv, inv, prod[i - 1], crv);
+			crv->mul_mod(inv, inv, pts[i].z, crv);
+		}
+		else {
+			gorbn_copy(z_inv, inv);
+		}
+
+		crv->sqr_mod(z_inv_sq, z_inv, crv);
+		crv->mul_mod(pts[i].x, pts[i].x, z_inv_sq, crv);
+		crv->mul_mod(z_inv_sq, z_inv_sq, z_inv, crv);
+		crv->mul_mod(pts[i].y, pts[i].y, z_inv_sq, crv);
+
+		gorbn_from_int(pts[i].z, 1);
+		crv->to_field(pts[i].z, pts[i].z, crv);
+	}
+}
+
+void gorec_pt_normalize_batch(gorec_point* pts, int pts_count, gorec_curve* crv) {
+	int i;
+	for (i = 0; i < pts_count; i += GOREC_NORMALIZE_BATCH_CHUNK) {
+		_gorec_pt_normalize_chunk(
+			pts + i,
+			GORBN_MIN(GOREC_NORMALIZE_BATCH_CHUNK, pts_count - i),
+			crv);
+	}
+}
+
+/*
+	Scalars are less than q, so they take the words of p or of q.
+	Loops over scalar bits stop there instead of GORBN_SZARR_BITS_TOTAL.
+*/
+static int _gorec_scalar_bits(gorec_curve* crv) {
+	int q_ndigits = _gorbn_get_ndigits(crv->q, GORBN_SZARR);
+
+	return(GORBN_MAX(crv->n, q_ndigits) * GORBN_SZWORD_BITS);
+}
+
+static gorec_point* _gorec_base_table(gorec_curve* crv) {
+	gorec_point* result = crv->mapped_base_table ? crv->mapped_base_table : crv->base_table;
+	return(result);
+}
+
+static gorec_point* _gorec_base_wnaf_table(gorec_curve* crv) {
+	gorec_point* result = crv->mapped_base_wnaf_table ? crv->mapped_base_wnaf_table : crv->base_wnaf_table;
+	return(result);
+}
+
+/*
+	Building comb table for g:
+	base_table[i] = sum(bit_j(i) * 2 ^ (j * columns) * g)
+*/
+void gorec_curve_precompute_base(gorec_curve* crv) {
+	gorec_point teeth[GOREC_COMB_TEETH];
+	int columns = (_gorec_scalar_bits(crv) + GOREC_COMB_TEETH - 1) / GOREC_COMB_TEETH;
+	int i, j;
+
+	gorec_pt_to_field(&teeth[0], &crv->g, crv);
+	for (j = 1; j < GOREC_COMB_TEETH; j++) {
+		gorec_pt_copy(&teeth[j], &teeth[j - 1]);
+		for (i = 0; i < columns; i++) {
+			crv->pt_double(&teeth[j], &teeth[j], crv);
+		}
+	}
+
+	gorec_pt_clear(&crv->base_table[0]);
+	crv->to_field(crv->base_table[0].z, crv->base_table[0].z, crv);
+
+	for (i = 1; i < GOREC_COMB_TABLE_COUNT; i++) {
+		//NOTE(dima): Adding highest tooth to the entry without it
+		int high_tooth = 0;
+		while ((i >> (high_tooth + 1)) != 0) {
+			high_tooth++;
+		}
+
+		gorec_pt_add_jacobian(&crv->base_table[i], &crv->base_table[i ^ (1 << high_tooth)], &teeth[high_tooth], crv);
+	}
+
+	gorec_pt_normalize_batch(crv->base_table, GOREC_COMB_TABLE_COUNT, crv);
+
+	_gorec_precompute_odd_multiples(crv->base_wnaf_table, GOREC_BASE_WNAF_COUNT, &teeth[0], crv);
+
+	crv->base_table_ready = 1;
+	crv->mapped_base_table = 0;
+	crv->mapped_base_wnaf_table = 0;
+}
+
+static void _gorec_blob_copy_mont(gorbn_mont* r, gorbn_mont* a) {
+	gorbn_copy(r->m, a->m);
+	gorbn_copy(r->rr, a->rr);
+	gorbn_copy(r->one, a->one);
+	r->m_inv = a->m_inv;
+	r->n = a->n;
+}
+
+static void _gorec_blob_copy_barrett(gorbn_barrett* r, gorbn_barrett* a) {
+	gorbn_copy(r->m, a->m);
+	gorbn_copy_n(r->mu, a->mu, GORBN_SZARR + 1);
+	r->n = a->n;
+}
+
+uint32_t gorec_curve_save(void* data, uint32_t data_size, gorec_curve* crv) {
+	uint8_t* at = (uint8_t*)data;
+	uint32_t i;
+
+	if (data_size < GOREC_CURVE_BLOB_SIZE) {
+		return(0);
+	}
+
+	//NOTE(dima): Fields are copied one by one over zeroed blob, so padding is zero and the same curve always gives the same file
+	for (i = 0; i < GOREC_CURVE_BLOB_SIZE; i++) {
+		at[i] = 0;
+	}
+
+	gorec_curve_blob_header* header = (gorec_curve_blob_header*)at;
+	header->magic = GOREC_CURVE_BLOB_MAGIC;
+	header->version = GOREC_CURVE_BLOB_VERSION;
+	header->blob_size = GOREC_CURVE_BLOB_SIZE;
+	header->word_size = GORBN_SZWORD;
+	header->words_count = GORBN_SZARR;
+	header->point_size = sizeof(gorec_point);
+	header->comb_teeth = GOREC_COMB_TEETH;
+	header->base_wnaf_w = GOREC_BASE_WNAF_W;
+	header->params_offset = GOREC_CURVE_BLOB_PARAMS_OFFSET;
+	header->params_size = sizeof(gorec_curve_blob_params);
+	header->base_table_offset = GOREC_CURVE_BLOB_BASE_TABLE_OFFSET;
+	header->base_wnaf_table_offset = GOREC_CURVE_BLOB_BASE_WNAF_TABLE_OFFSET;
+	header->base_table_ready = crv->base_table_ready;
+
+	gorec_curve_blob_params* params = (gorec_curve_blob_params*)(at + GOREC_CURVE_BLOB_PARAMS_OFFSET);
+	gorbn_copy(params->a, crv->a);
+	gorbn_copy(params->b, crv->b);
+	gorbn_copy(params->p, crv->p);
+	gorbn_copy(params->q, crv->q);
+	gorec_pt_copy(&params->g, &crv->g);
+	_gorec_blob_copy_mont(&params->mont, &crv->mont);
+	_gorec_blob_copy_barrett(&params->q_barrett, &crv->q_barrett);
+
+	if (crv->base_table_ready) {
+		gorec_point* base_table = _gorec_base_table(crv);
+		gorec_point* base_wnaf_table = _gorec_base_wnaf_table(crv);
+		gorec_point* to_base_table = (gorec_point*)(at + GOREC_CURVE_BLOB_BASE_TABLE_OFFSET);
+		gorec_point* to_base_wnaf_table = (gorec_point*)(at + GOREC_CURVE_BLOB_BASE_WNAF_TABLE_OFFSET);
+
+		for (i = 0; i < GOREC_COMB_TABLE_COUNT; i++) {
+			gorec_pt_copy(&to_base_table[i], &base_table[i]);
+		}
+
+		for (i = 0; i < GOREC_BASE_WNAF_COUNT; i++) {
+			gorec_pt_copy(&to_base_wnaf_table[i], &base_wnaf_table[i]);
+		}
+	}
+
+	return(GOREC_CURVE_BLOB_SIZE);
+}
+
+int gorec_curve_load(gorec_curve* crv, void* data, uint32_t data_size) {
+	uint8_t* at = (uint8_t*)data;
+
+	if (data_size < GOREC_CURVE_BLOB_SIZE ||
+		((size_t)at & (GOREC_CURVE_BLOB_ALIGN - 1)) != 0)
+	{
+		return(0);
+	}
+
+	gorec_curve_blob_header* header = (gorec_curve_blob_header*)at;
+	if (header->magic != GOREC_CURVE_BLOB_MAGIC ||
+		header->version != GOREC_CURVE_BLOB_VERSION ||
+		header->blob_size != GOREC_CURVE_BLOB_SIZE ||
+		header->word_size != GORBN_SZWORD ||
+		header->words_count != GORBN_SZARR ||
+		header->point_size != sizeof(gorec_point) ||
+		header->comb_teeth != GOREC_COMB_TEETH ||
+		header->base_wnaf_w != GOREC_BASE_WNAF_W ||
+		header->params_offset != GOREC_CURVE_BLOB_PARAMS_OFFSET ||
+		header->params_size != sizeof(gorec_curve_blob_params) ||
+		header->base_table_offset != GOREC_CURVE_BLOB_BASE_TABLE_OFFSET ||
+		header->base_wnaf_table_offset != GOREC_CURVE_BLOB_BASE_WNAF_TABLE_OFFSET)
+	{
+		return(0);
+	}
+
+	gorec_curve_blob_params* params = (gorec_curve_blob_params*)(at + GOREC_CURVE_BLOB_PARAMS_OFFSET);
+	gorbn_copy(crv->a, params->a);
+	gorbn_copy(crv->b, params->b);
+	gorbn_copy(crv->p, params->p);
+	gorbn_copy(crv->q, params->q);
+	gorec_pt_copy(&crv->g, &params->g);
+	_gorec_blob_copy_mont(&crv->mont, &params->mont);
+	_gorec_blob_copy_barrett(&crv->q_barrett, &params->q_barrett);
+
+	_gorec_curve_select_routines(crv);
+
+	crv->base_table_ready = (header->base_table_ready != 0);
+	if (crv->base_table_ready) {
+		crv->mapped_base_table = (gorec_point*)(at + GOREC_CURVE_BLOB_BASE_TABLE_OFFSET);
+		crv->mapped_base_wnaf_table = (gorec_point*)(at + GOREC_CURVE_BLOB_BASE_WNAF_TABLE_OFFSET);
+	}
+	else {
+		crv->mapped_base_table = 0;
+		crv->mapped_base_wnaf_table = 0;
+	}
+
+	return(1);
+}
+
+void gorec_pt_mul_base(
+	gorec_point* p_result,
+	gorbn_t *p_scalar,
+	gorec_curve* crv)
+{
+	if (!crv->base_table_ready) {
+		gorec_pt_mul_wnaf_jacobian(p_result, &crv->g, p_scalar, crv);
+		return;
+	}
+
+	int i, j;
+	int scalar_bits = _gorec_scalar_bits(crv);
+	int columns = (scalar_bits + GOREC_COMB_TEETH - 1) / GOREC_COMB_TEETH;
+	gorec_point* base_table = _gorec_base_table(crv);
+	gorec_point result;
+	gorec_pt_clear(&result);
+
+	for (i = columns - 1; i >= 0; i--) {
+		int index = 0;
+		for (j = 0; j < GOREC_COMB_TEETH; j++) {
+			int bit_index = j * columns + i;
+			if (bit_index < scalar_bits && _gorbn_testbit(p_scalar, bit_index)) {
+				index |= (1 << j);
+			}
+		}
+
+		crv->pt_double(&result, &result, crv);
+		if (index) {
+			gorec_pt_add_mixed(&result, &result, &base_table[index], crv);
+		}
+	}
+
+	gorec_pt_normalize(&result, &result, crv);
+
+	crv->from_field(result.x, result.x, crv);
+	crv->from_field(result.y, result.y, crv);
+	gorbn_from_int(result.z, 1);
+
+	gorec_pt_copy(p_result, &result);
+}
+
+/*
+	Double-scalar multiplication (Straus-Shamir): both wNAF
+	representations are walked with one doubling chain. Odd multiples of
+	g are taken from the curve if gorec_curve_precompute_base() was
+	called, with wider window than for p.
+*/
+void gorec_pt_mul2_arena(
+	gorec_point* p_result,
+	gorbn_t *p_scalar_g,
+	gorec_point *p_point,
+	gorbn_t *p_scalar_p,
+	gorec_curve* crv,
+	gorec_arena* arena)
+{
+	char NAF_g[GORBN_SZARR_BITS_TOTAL + 1];
+	char NAF_p[GORBN_SZARR_BITS_TOTAL + 1];
+	int NAFLength_g;
+	int NAFLength_p;
+
+	gorec_point* PrecomputePoints_g = arena->table_g;
+	gorec_point* PrecomputePoints_p = arena->table;
+	gorec_point* table_g;
+
+	gorec_point* result = &arena->result;
+	gorec_point* pt = &arena->pt;
+	int i;
+
+	if (crv->base_table_ready) {
+		table_g = _gorec_base_wnaf_table(crv);
+		gorec_compute_naf(NAF_g, &NAFLength_g, p_scalar_g, GOREC_BASE_WNAF_W);
+	}
+	else {
+		int w_g = gorec_wnaf_width(_gorbn_get_nbits(p_scalar_g, GORBN_SZARR));
+
+		table_g = PrecomputePoints_g;
+		gorec_pt_to_field(pt, &crv->g, crv);
+		_gorec_precompute_odd_multiples(table_g, 1 << (w_g - 2), pt, crv);
+		gorec_compute_naf(NAF_g, &NAFLength_g, p_scalar_g, w_g);
+	}
+
+	int w_p = gorec_wnaf_width(_gorbn_get_nbits(p_scalar_p, GORBN_SZARR));
+	gorec_pt_to_field(pt, p_point, crv);
+	_gorec_precompute_odd_multiples(PrecomputePoints_p, 1 << (w_p - 2), pt, crv);
+	gorec_compute_naf(NAF_p, &NAFLength_p, p_scalar_p, w_p);
+
+	gorec_pt_clear(result);
+	for (i = GORBN_MAX(NAFLength_g, NAFLength_p) - 1; i >= 0; i--) {
+		crv->pt_double(result, result, crv);
+
+		if (i < NAFLength_g && NAF_g[i] != 0) {
+			if (NAF_g[i] > 0) {
+				gorec_pt_add_mixed(result, result, &table_g[NAF_g[i] >> 1], crv);
+			}
+			else {
+				gorec_pt_sub_mixed(result, result, &table_g[(-NAF_g[i]) >> 1], crv);
+			}
+		}
+
+		if (i < NAFLength_p && NAF_p[i] != 0) {
+			if (NAF_p[i] > 0) {
+				gorec_pt_add_mixed(result, result, &PrecomputePoints_p[NAF_p[i] >> 1], crv);
+			}
+			else {
+				gorec_pt_sub_mixed(result, result, &PrecomputePoints_p[(-NAF_p[i]) >> 1], crv);
+			}
+		}
+	}
+
+	gorec_pt_normalize(result, result, crv);
+
+	crv->from_field(result->x, result->x, crv);
+	crv->from_field(result->y, result->y, crv);
+	gorbn_from_int(result->z, 1);
+
+	gorec_pt_copy(p_result, result);
+}
+
+void gorec_pt_mul2(
+	gorec_point* p_result,
+	gorbn_t *p_scalar_g,
+	gorec_point *p_point,
+	gorbn_t *p_scalar_p,
+	gorec_curve* crv)
+{
+	gorec_arena arena;
+	gorec_pt_mul2_arena(p_result, p_scalar_g, p_point, p_scalar_p, crv, &arena);
+}
+
+/*NOTE(dima): 1 if the number is zero. Does not branch on data, unlike gorbn_is_zero()*/
+static int _gorbn_is_zero_ct(gorbn_t* num, int n) {
+	gorbn_t acc = 0;
+	int i;
+
+	for (i = 0; i < n; i++) {
+		acc |= num[i];
+	}
+
+	return((int)((((gorbn_utmp_t)acc - 1) >> (GORBN_SZWORD * 8)) & 1));
+}
+
+/*
+	r = table[index] without branches and without index-dependent memory
+	access. Table is normalized, so only x and y are read, r->z is left as is.
+*/
+static void _gorec_pt_select_ct(gorec_point* r, gorec_point* table, int table_count, int index) {
+	int i;
+
+	gorbn_init(r->x, GORBN_SZARR);
+	gorbn_init(r->y, GORBN_SZARR);
+	r->is_inf = 0;
+
+	for (i = 0; i < table_count; i++) {
+		int is_needed = (i == index);
+		gorbn_cmov(r->x, table[i].x, is_needed);
+		gorbn_cmov(r->y, table[i].y, is_needed);
+	}
+}
+
+/*
+	Constant-time scalar multiplication. s should be in [1, q - 1].
+
+	Scalar is made odd (s or q - s, the result is negated for the
+	latter) and recoded to regular signed odd digits
+	d_i in [-(2 ^ w - 1), 2 ^ w - 1]:
+	d_i = (s mod 2 ^ (w + 1)) - 2 ^ w, s = (s >> w) | 1.
+	Every window does w doublings and one mixed addition of a point that
+	is selected from the table of odd multiples with a masked lookup.
+	Partial sums before the last window are multiples of 2 ^ w and can not
+	be equal to the odd selected multiple, but the last one can (for
+	s = q - 2 * |d_0|), so the last addition is complete: it is replaced
+	with doubling by a masked move when H = 0.
+	The table depends only on p, so it is normalized with one ordinary
+	inversion. The final inversion is done by Fermat's little theorem.
+	No branches and memory accesses depend on s.
+*/
+void gorec_pt_mul_ct_arena(
+	gorec_point* p_result,
+	gorec_point *p_point,
+	gorbn_t *p_scalar,
+	gorec_curve* crv,
+	gorec_arena* arena)
+{
+	gorec_point* table = arena->table;
+	gorec_point* result = &arena->result;
+	gorec_point* selected = &arena->selected;
+	gorec_point* doubled = &arena->doubled;
+	gorec_point* pt = &arena->pt;
+
+	signed char digits[GOREC_CT_DIGITS_COUNT];
+	gorbn_t k[GORBN_SZARR];
+	gorbn_t temp[GORBN_SZARR];
+	gorbn_t neg_y[GORBN_SZARR];
+	int i, j;
+
+	int digit_mask = (1 << (GOREC_CT_WINDOW_W + 1)) - 1;
+	int digits_count = (_gorec_scalar_bits(crv) + GOREC_CT_WINDOW_W - 1) / GOREC_CT_WINDOW_W;
+	int is_even = !(p_scalar[0] & 1);
+	gorbn_copy(k, p_scalar);
+	gorbn_sub(temp, crv->q, p_scalar);
+	gorbn_cmov(k, temp, is_even);
+
+	for (i = 0; i < digits_count; i++) {
+		digits[i] = (signed char)((int)(k[0] & digit_mask) - (1 << GOREC_CT_WINDOW_W));
+		gorbn_rshift(k, k, GOREC_CT_WINDOW_W);
+		k[0] |= 1;
+	}
+
+	//NOTE(dima): Odd multiples: table[i] = (2 * i + 1) * p, affine
+	gorec_pt_to_field(pt, p_point, crv);
+	_gorec_precompute_odd_multiples(table, GOREC_CT_TABLE_COUNT, pt, crv);
+	gorec_pt_copy(selected, &table[0]);
+
+	//NOTE(dima): Top digit is always 1 after digits_count steps
+	gorec_pt_copy(result, &table[0]);
+	for (i = digits_count - 1; i >= 0; i--) {
+		for (j = 0; j < GOREC_CT_WINDOW_W; j++) {
+			crv->pt_double(result, result, crv);
+		}
+
+		int digit = digits[i];
+		int is_negative = (digit < 0);
+		int digit_abs = (digit ^ -is_negative) + is_negative;
+
+		_gorec_pt_select_ct(selected, table, GOREC_CT_TABLE_COUNT, digit_abs >> 1);
+
+		gorbn_init(neg_y, GORBN_SZARR);
+		_gorec_sub_mod(neg_y, neg_y, selected->y, crv);
+		gorbn_cmov(selected->y, neg_y, is_negative);
+
+		if (i > 0) {
+			_gorec_pt_add_mixed(result, result, selected, crv, 0);
+		}
+		else {
+			/*NOTE(dima): Result can not be -selected, as s is not 0 mod q*/
+			crv->pt_double(doubled, result, crv);
+			_gorec_pt_add_mixed(result, result, selected, crv, 0);
+
+			int is_same = _gorbn_is_zero_ct(result->z, GORBN_SZARR);
+			gorbn_cmov(result->x, doubled->x, is_same);
+			gorbn_cmov(result->y, doubled->y, is_same);
+			gorbn_cmov(result->z, doubled->z, is_same);
+		}
+	}
+
+	//NOTE(dima): Exit from Jacobian coordinates. Time of GCD in crv->inv_mod depends on z, so it is not used here
+	if (gorbn_is_pseudo_mersenne_n(crv->p, crv->n)) {
+		_gorec_inv_mod_chain(temp, result->z, crv);
+	}
+	else {
+		_gorec_inv_mod_fermat(temp, result->z, crv);
+	}
+	crv->sqr_mod(neg_y, temp, crv);
+	crv->mul_mod(result->x, result->x, neg_y, crv);
+	crv->mul_mod(neg_y, neg_y, temp, crv);
+	crv->mul_mod(result->y, result->y, neg_y, crv);
+
+	gorbn_init(neg_y, GORBN_SZARR);
+	_gorec_sub_mod(neg_y, neg_y, result->y, crv);
+	gorbn_cmov(result->y, neg_y, is_even);
+
+	crv->from_field(result->x, result->x, crv);
+	crv->from_field(result->y, result->y, crv);
+	gorbn_from_int(result->z, 1);
+	result->is_inf = 0;
+
+	gorec_pt_copy(p_result, result);
+}
+
+void gorec_pt_mul_ct(
+	gorec_point* p_result,
+	gorec_point *p_point,
+	gorbn_t *p_scalar,
+	gorec_curve* crv)
 {
+	gorec_arena arena;
+	gorec_pt_mul_ct_arena(p_result, p_point, p_scalar, crv, &arena);
+}
+
+uint32_t gorec_arena_deep(void) {
+	return((uint32_t)sizeof(gorec_arena));
+}
+
+/*
+	Lanes of gorec_pt_mul_batch(). gorec_lane is GOREC_LANES 64-bit lanes
+	in GOREC_LANES_REGS registers, a field element is GOREC_LANES_LIMBS of
+	them: limb i of every lane. Lanes never mix, so the SIMD primitives
+	and the plain C ones below give the same bits.
+*/
+#if defined(GOREC_LANES_AVX512) || defined(GOREC_LANES_AVX2)
+#if defined(GOREC_LANES_AVX512)
+typedef __m512i gorec_lane_reg;
+#define _GOREC_REG_SET1(a) _mm512_set1_epi64((long long)(a))
+#define _GOREC_REG_LOAD(a) _mm512_loadu_si512((void*)(a))
+#define _GOREC_REG_STORE(r, a) _mm512_storeu_si512((void*)(r), a)
+#define _GOREC_REG_ADD(a, b) _mm512_add_epi64(a, b)
+#define _GOREC_REG_SUB(a, b) _mm512_sub_epi64(a, b)
+#define _GOREC_REG_MUL(a, b) _mm512_mul_epu32(a, b)
+#define _GOREC_REG_AND(a, b) _mm512_and_si512(a, b)
+#define _GOREC_REG_ANDNOT(a, b) _mm512_andnot_si512(a, b)
+#define _GOREC_REG_OR(a, b) _mm512_or_si512(a, b)
+#define _GOREC_REG_SHR(a, n) _mm512_srli_epi64(a, n)
+#define _GOREC_REG_EQ(a, b) _mm512_maskz_mov_epi64(_mm512_cmpeq_epi64_mask(a, b), _mm512_set1_epi64(-1))
+#else
+typedef __m256i gorec_lane_reg;
+#define _GOREC_REG_SET1(a) _mm256_set1_epi64x((long long)(a))
+#define _GOREC_REG_LOAD(a) _mm256_loadu_si256((__m256i*)(a))
+#define _GOREC_REG_STORE(r, a) _mm256_storeu_si256((__m256i*)(r), a)
+#define _GOREC_REG_ADD(a, b) _mm256_add_epi64(a, b)
+#define _GOREC_REG_SUB(a, b) _mm256_sub_epi64(a, b)
+#define _GOREC_REG_MUL(a, b) _mm256_mul_epu32(a, b)
+#define _GOREC_REG_AND(a, b) _mm256_and_si256(a, b)
+#define _GOREC_REG_ANDNOT(a, b) _mm256_andnot_si256(a, b)
+#define _GOREC_REG_OR(a, b) _mm256_or_si256(a, b)
+#define _GOREC_REG_SHR(a, n) _mm256_srli_epi64(a, n)
+#define _GOREC_REG_EQ(a, b) _mm256_cmpeq_epi64(a, b)
+#endif
+
+#define GOREC_LANES_PER_REG (GOREC_LANES / GOREC_LANES_REGS)
+
+typedef struct gorec_lane { gorec_lane_reg v[GOREC_LANES_REGS]; } gorec_lane;
+
+#define _GOREC_LANE_BINARY(name, op) static inline gorec_lane name(gorec_lane a, gorec_lane b) {\
+		gorec_lane r;\
+		int i;\
+		for (i = 0; i < GOREC_LANES_REGS; i++) {\
+			r.v[i] = op(a.v[i], b.v[i]);\
+		}\
+		return(r);\
+	}
+
+_GOREC_LANE_BINARY(_gorec_lane_add, _GOREC_REG_ADD)
+_GOREC_LANE_BINARY(_gorec_lane_sub, _GOREC_REG_SUB)
+/*Low 32 bits of a times low 32 bits of b*/
+_GOREC_LANE_BINARY(_gorec_lane_mul, _GOREC_REG_MUL)
+_GOREC_LANE_BINARY(_gorec_lane_and, _GOREC_REG_AND)
+_GOREC_LANE_BINARY(_gorec_lane_or, _GOREC_REG_OR)
+/*All ones in lanes where a == b*/
+_GOREC_LANE_BINARY(_gorec_lane_eq, _GOREC_REG_EQ)
+
+static inline gorec_lane _gorec_lane_set1(uint64_t a) {
+	gorec_lane r;
+	int i;
+	for (i = 0; i < GOREC_LANES_REGS; i++) {
+		r.v[i] = _GOREC_REG_SET1(a);
+	}
+	return(r);
+}
+static inline gorec_lane _gorec_lane_load(uint64_t* a) {
+	gorec_lane r;
+	int i;
+	for (i = 0; i < GOREC_LANES_REGS; i++) {
+		r.v[i] = _GOREC_REG_LOAD(a + i * GOREC_LANES_PER_REG);
+	}
+	return(r);
+}
+static inline void _gorec_lane_store(uint64_t* r, gorec_lane a) {
+	int i;
+	for (i = 0; i < GOREC_LANES_REGS; i++) {
+		_GOREC_REG_STORE(r + i * GOREC_LANES_PER_REG, a.v[i]);
+	}
+}
+static inline gorec_lane _gorec_lane_shr_radix(gorec_lane a) {
+	int i;
+	for (i = 0; i < GOREC_LANES_REGS; i++) {
+		a.v[i] = _GOREC_REG_SHR(a.v[i], GOREC_LANES_RADIX);
+	}
+	return(a);
+}
+/*mask ? a : b, mask lanes are 0 or all ones*/
+static inline gorec_lane _gorec_lane_select(gorec_lane mask, gorec_lane a, gorec_lane b) {
 	int i;
+	for (i = 0; i < GOREC_LANES_REGS; i++) {
+		a.v[i] = _GOREC_REG_OR(_GOREC_REG_AND(mask.v[i], a.v[i]), _GOREC_REG_ANDNOT(mask.v[i], b.v[i]));
+	}
+	return(a);
+}
+#else
+typedef struct gorec_lane { uint64_t v[GOREC_LANES]; } gorec_lane;
 
-	for (i = 1; i < GORBN_SZARR; i++) {
-		if (a[i]) {
-			return(GORBN_CMP_LARGER);
+static inline gorec_lane _gorec_lane_set1(uint64_t a) {
+	gorec_lane r;
+	int l;
+	for (l = 0; l < GOREC_LANES; l++) {
+		r.v[l] = a;
+	}
+	return(r);
+}
+static inline gorec_lane _gorec_lane_load(uint64_t* a) {
+	gorec_lane r;
+	int l;
+	for (l = 0; l < GOREC_LANES; l++) {
+		r.v[l] = a[l];
+	}
+	return(r);
+}
+static inline void _gorec_lane_store(uint64_t* r, gorec_lane a) {
+	int l;
+	for (l = 0; l < GOREC_LANES; l++) {
+		r[l] = a.v[l];
+	}
+}
+static inline gorec_lane _gorec_lane_add(gorec_lane a, gorec_lane b) {
+	int l;
+	for (l = 0; l < GOREC_LANES; l++) {
+		a.v[l] += b.v[l];
+	}
+	return(a);
+}
+static inline gorec_lane _gorec_lane_sub(gorec_lane a, gorec_lane b) {
+	int l;
+	for (l = 0; l < GOREC_LANES; l++) {
+		a.v[l] -= b.v[l];
+	}
+	return(a);
+}
+static inline gorec_lane _gorec_lane_mul(gorec_lane a, gorec_lane b) {
+	int l;
+	for (l = 0; l < GOREC_LANES; l++) {
+		a.v[l] = (uint64_t)(uint32_t)a.v[l] * (uint32_t)b.v[l];
+	}
+	return(a);
+}
+static inline gorec_lane _gorec_lane_and(gorec_lane a, gorec_lane b) {
+	int l;
+	for (l = 0; l < GOREC_LANES; l++) {
+		a.v[l] &= b.v[l];
+	}
+	return(a);
+}
+static inline gorec_lane _gorec_lane_or(gorec_lane a, gorec_lane b) {
+	int l;
+	for (l = 0; l < GOREC_LANES; l++) {
+		a.v[l] |= b.v[l];
+	}
+	return(a);
+}
+static inline gorec_lane _gorec_lane_shr_radix(gorec_lane a) {
+	int l;
+	for (l = 0; l < GOREC_LANES; l++) {
+		a.v[l] >>= GOREC_LANES_RADIX;
+	}
+	return(a);
+}
+static inline gorec_lane _gorec_lane_select(gorec_lane mask, gorec_lane a, gorec_lane b) {
+	int l;
+	for (l = 0; l < GOREC_LANES; l++) {
+		a.v[l] = (mask.v[l] & a.v[l]) | (~mask.v[l] & b.v[l]);
+	}
+	return(a);
+}
+static inline gorec_lane _gorec_lane_eq(gorec_lane a, gorec_lane b) {
+	int l;
+	for (l = 0; l < GOREC_LANES; l++) {
+		a.v[l] = (uint64_t)0 - (uint64_t)(a.v[l] == b.v[l]);
+	}
+	return(a);
+}
+#endif
+
+#define GOREC_LANES_MASK ((((uint64_t)1) << GOREC_LANES_RADIX) - 1)
+/*NOTE(dima): Added before carrying limbs that can be negative, so that logical shift works. A multiple of the radix*/
+#define GOREC_LANES_BIAS (((uint64_t)1) << 62)
+
+typedef struct gorec_lanes_fe {
+	gorec_lane w[GOREC_LANES_LIMBS];
+} gorec_lanes_fe;
+
+typedef struct gorec_lanes_point {
+	gorec_lanes_fe x;
+	gorec_lanes_fe y;
+	gorec_lanes_fe z;
+} gorec_lanes_point;
+
+/*
+	NOTE(dima): Constants of p for the lanes: p and 2p as limbs,
+	N0 = -p^(-1) mod 2^29, R^2 mod p and R mod p (one in Montgomery form,
+	both below 2p), a in Montgomery form for curves with a != -3.
+*/
+typedef struct gorec_lanes_ctx {
+	gorec_lanes_fe p;
+	gorec_lanes_fe p2;
+	gorec_lane n0;
+	gorec_lane mask;
+	gorec_lanes_fe r2;
+	gorec_lanes_fe one;
+	gorec_lanes_fe a;
+	int is_a3;
+} gorec_lanes_ctx;
+
+/*Number below 2 ^ 261 to 29-bit limbs, least significant first*/
+static void _gorec_lanes_limbs_from_gorbn(uint64_t* limbs, int stride, gorbn_t* a) {
+	unsigned char bytes[GOREC_LANES_LIMBS * 4 + 8];
+	int i, j;
+
+	gorbn_to_data(bytes, sizeof(bytes), a);
+
+	for (i = 0; i < GOREC_LANES_LIMBS; i++) {
+		int bit = i * GOREC_LANES_RADIX;
+		uint64_t v = 0;
+		for (j = 0; j < 8; j++) {
+			v |= (uint64_t)bytes[bit / 8 + j] << (8 * j);
 		}
+		limbs[i * stride] = (v >> (bit % 8)) & GOREC_LANES_MASK;
 	}
+}
 
-	if (a[i] > w) {
-		return(GORBN_CMP_LARGER);
+static void _gorec_lanes_limbs_to_gorbn(gorbn_t* r, uint64_t* limbs, int stride) {
+	unsigned char bytes[GOREC_LANES_LIMBS * 4 + 8];
+	uint64_t acc = 0;
+	int acc_bits = 0;
+	int count = 0;
+	int i;
+
+	for (i = 0; i < GOREC_LANES_LIMBS; i++) {
+		acc |= limbs[i * stride] << acc_bits;
+		acc_bits += GOREC_LANES_RADIX;
+		while (acc_bits >= 8) {
+			bytes[count++] = (unsigned char)acc;
+			acc >>= 8;
+			acc_bits -= 8;
+		}
 	}
-	else if (a[i] < w) {
-		return(GORBN_CMP_SMALLER);
+	while (count < (int)sizeof(bytes)) {
+		bytes[count++] = (unsigned char)acc;
+		acc >>= 8;
 	}
-	else {
-		return(GORBN_CMP_EQUAL);
+
+	gorbn_from_data(r, bytes, GORBN_MIN((uint32_t)sizeof(bytes), (uint32_t)(GORBN_SZARR * GORBN_SZWORD)));
+}
+
+/*Element from GOREC_LANES_LIMBS rows of GOREC_LANES numbers and back*/
+static void _gorec_lanes_fe_load(gorec_lanes_fe* r, uint64_t* limbs) {
+	int i;
+	for (i = 0; i < GOREC_LANES_LIMBS; i++) {
+		r->w[i] = _gorec_lane_load(limbs + i * GOREC_LANES);
 	}
 }
 
-/* Loading standard belarussian parameters*/
-void gorec_load_stb128(gorec_curve* crv) {
-	unsigned char lwo_bign_std_curve128_p[32] = {
-		0x43, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
-		0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
-		0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
-		0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
-	};
+static void _gorec_lanes_fe_store(uint64_t* limbs, gorec_lanes_fe* a) {
+	int i;
+	for (i = 0; i < GOREC_LANES_LIMBS; i++) {
+		_gorec_lane_store(limbs + i * GOREC_LANES, a->w[i]);
+	}
+}
 
-	unsigned char lwo_bign_std_curve128_a[32] = {
-		0x40, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
-		0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
-		0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
-		0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
-	};
+static void _gorec_lanes_fe_set1(gorec_lanes_fe* r, uint64_t* limbs) {
+	int i;
+	for (i = 0; i < GOREC_LANES_LIMBS; i++) {
+		r->w[i] = _gorec_lane_set1(limbs[i]);
+	}
+}
 
-	unsigned char lwo_bign_std_curve128_b[32] = {
-		0xF1, 0x03, 0x9C, 0xD6, 0x6B, 0x7D, 0x2E, 0xB2,
-		0x53, 0x92, 0x8B, 0x97, 0x69, 0x50, 0xF5, 0x4C,
-		0xBE, 0xFB, 0xD8, 0xE4, 0xAB, 0x3A, 0xC1, 0xD2,
-		0xED, 0xA8, 0xF3, 0x15, 0x15, 0x6C, 0xCE, 0x77,
-	};
+/*
+	Carries of limbs that may be negative (two's complement), value of
+	t must be in (-2^261, 2^261). Returns the carry out of the top limb:
+	0 for t >= 0, all ones for t < 0.
+*/
+static inline gorec_lane _gorec_lanes_carry_signed(gorec_lane* t, gorec_lane mask) {
+	gorec_lane bias = _gorec_lane_set1(GOREC_LANES_BIAS);
+	gorec_lane bias_carry = _gorec_lane_set1(GOREC_LANES_BIAS >> GOREC_LANES_RADIX);
+	gorec_lane carry = _gorec_lane_set1(0);
+	int i;
 
-	unsigned char lwo_bign_std_curve128_q[32] = {
-		0x07, 0x66, 0x3D, 0x26, 0x99, 0xBF, 0x5A, 0x7E,
-		0xFC, 0x4D, 0xFB, 0x0D, 0xD6, 0x8E, 0x5C, 0xD9,
-		0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
-		0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
-	};
+	for (i = 0; i < GOREC_LANES_LIMBS; i++) {
+		t[i] = _gorec_lane_add(t[i], carry);
+		carry = _gorec_lane_sub(_gorec_lane_shr_radix(_gorec_lane_add(t[i], bias)), bias_carry);
+		t[i] = _gorec_lane_and(t[i], mask);
+	}
 
-	unsigned char lwo_bign_std_curve128_yG[32] = {
-		0x93, 0x6A, 0x51, 0x04, 0x18, 0xCF, 0x29, 0x1E,
-		0x52, 0xF6, 0x08, 0xC4, 0x66, 0x39, 0x91, 0x78,
-		0x5D, 0x83, 0xD6, 0x51, 0xA3, 0xC9, 0xE4, 0x5C,
-		0x9F, 0xD6, 0x16, 0xFB, 0x3C, 0xFC, 0xF7, 0x6B,
-	};
+	return(carry);
+}
 
-	unsigned char lwo_bign_std_curve128_xG[32] = {
-		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-	};
+static inline void _gorec_lanes_carry(gorec_lane* t, gorec_lane mask) {
+	int i;
+	for (i = 0; i < GOREC_LANES_LIMBS - 1; i++) {
+		t[i + 1] = _gorec_lane_add(t[i + 1], _gorec_lane_shr_radix(t[i]));
+		t[i] = _gorec_lane_and(t[i], mask);
+	}
+}
 
-	gorbn_from_data(crv->a, (void*)lwo_bign_std_curve128_a, sizeof(lwo_bign_std_curve128_a));
-	gorbn_from_data(crv->b, (void*)lwo_bign_std_curve128_b, sizeof(lwo_bign_std_curve128_b));
-	gorbn_from_data(crv->p, (void*)lwo_bign_std_curve128_p, sizeof(lwo_bign_std_curve128_p));
-	gorbn_from_data(crv->q, (void*)lwo_bign_std_curve128_q, sizeof(lwo_bign_std_curve128_q));
+/*
+	Montgomery reduction of 2 * GOREC_LANES_LIMBS columns: r = t / R mod p.
+	For t < 4p^2 r is below 2p, as 4p < R.
+*/
+static inline void _gorec_lanes_redc(gorec_lanes_fe* r, gorec_lane* t, gorec_lanes_ctx* ctx) {
+	int i, j;
 
-	gorbn_from_data(crv->g.x, (void*)lwo_bign_std_curve128_xG, sizeof(lwo_bign_std_curve128_xG));
-	gorbn_from_data(crv->g.y, (void*)lwo_bign_std_curve128_yG, sizeof(lwo_bign_std_curve128_yG));
-	gorbn_from_int(crv->g.z, 1);
-	crv->g.is_inf = 0;
+	for (i = 0; i < GOREC_LANES_LIMBS; i++) {
+		gorec_lane m = _gorec_lane_and(_gorec_lane_mul(t[i], ctx->n0), ctx->mask);
+		for (j = 0; j < GOREC_LANES_LIMBS; j++) {
+			t[i + j] = _gorec_lane_add(t[i + j], _gorec_lane_mul(m, ctx->p.w[j]));
+		}
+		t[i + 1] = _gorec_lane_add(t[i + 1], _gorec_lane_shr_radix(t[i]));
+	}
+
+	for (i = 0; i < GOREC_LANES_LIMBS; i++) {
+		r->w[i] = t[GOREC_LANES_LIMBS + i];
+	}
+	_gorec_lanes_carry(r->w, ctx->mask);
 }
 
-/* point clearing */
-void gorec_pt_clear(gorec_point* p) {
-	gorbn_init(p->x, GORBN_SZARR);
-	gorbn_init(p->y, GORBN_SZARR);
-	gorbn_from_int(p->z, 1);
-	p->is_inf = 1;
+static void _gorec_lanes_mul(gorec_lanes_fe* r, gorec_lanes_fe* a, gorec_lanes_fe* b, gorec_lanes_ctx* ctx) {
+	gorec_lane t[GOREC_LANES_LIMBS * 2];
+	int i, j;
+
+	for (i = 0; i < GOREC_LANES_LIMBS * 2; i++) {
+		t[i] = _gorec_lane_set1(0);
+	}
+	for (i = 0; i < GOREC_LANES_LIMBS; i++) {
+		for (j = 0; j < GOREC_LANES_LIMBS; j++) {
+			t[i + j] = _gorec_lane_add(t[i + j], _gorec_lane_mul(a->w[i], b->w[j]));
+		}
+	}
+
+	_gorec_lanes_redc(r, t, ctx);
 }
 
-/* point copying */
-void gorec_pt_copy(gorec_point* r, gorec_point* p) {
-	gorbn_copy(r->x, p->x);
-	gorbn_copy(r->y, p->y);
-	gorbn_copy(r->z, p->z);
-	r->is_inf = p->is_inf;
+static void _gorec_lanes_sqr(gorec_lanes_fe* r, gorec_lanes_fe* a, gorec_lanes_ctx* ctx) {
+	gorec_lane t[GOREC_LANES_LIMBS * 2];
+	int i, j;
+
+	for (i = 0; i < GOREC_LANES_LIMBS * 2; i++) {
+		t[i] = _gorec_lane_set1(0);
+	}
+	for (i = 0; i < GOREC_LANES_LIMBS; i++) {
+		gorec_lane a2 = _gorec_lane_add(a->w[i], a->w[i]);
+		t[2 * i] = _gorec_lane_add(t[2 * i], _gorec_lane_mul(a->w[i], a->w[i]));
+		for (j = i + 1; j < GOREC_LANES_LIMBS; j++) {
+			t[i + j] = _gorec_lane_add(t[i + j], _gorec_lane_mul(a2, a->w[j]));
+		}
+	}
+
+	_gorec_lanes_redc(r, t, ctx);
 }
 
-/* Point addition in affine coordinates */
-void gorec_pt_add(gorec_point* r, gorec_point* a, gorec_point* b, gorec_curve* crv) {
-	if (a->is_inf) {
-		gorec_pt_copy(r, b);
-		return;
+/*r = a + b, below 2p for a, b below 2p*/
+static void _gorec_lanes_add(gorec_lanes_fe* r, gorec_lanes_fe* a, gorec_lanes_fe* b, gorec_lanes_ctx* ctx) {
+	gorec_lane s[GOREC_LANES_LIMBS];
+	gorec_lane d[GOREC_LANES_LIMBS];
+	int i;
+
+	for (i = 0; i < GOREC_LANES_LIMBS; i++) {
+		s[i] = _gorec_lane_add(a->w[i], b->w[i]);
 	}
+	_gorec_lanes_carry(s, ctx->mask);
 
-	if (b->is_inf) {
-		gorec_pt_copy(r, a);
-		return;
+	for (i = 0; i < GOREC_LANES_LIMBS; i++) {
+		d[i] = _gorec_lane_sub(s[i], ctx->p2.w[i]);
 	}
+	gorec_lane is_below = _gorec_lanes_carry_signed(d, ctx->mask);
 
-	gorbn_t lambda[GORBN_SZARR];
-	gorbn_t tmp[GORBN_SZARR];
+	for (i = 0; i < GOREC_LANES_LIMBS; i++) {
+		r->w[i] = _gorec_lane_select(is_below, s[i], d[i]);
+	}
+}
 
-	gorbn_t res_x[GORBN_SZARR];
-	gorbn_t res_y[GORBN_SZARR];
+/*r = a - b, below 2p for a, b below 2p*/
+static void _gorec_lanes_sub(gorec_lanes_fe* r, gorec_lanes_fe* a, gorec_lanes_fe* b, gorec_lanes_ctx* ctx) {
+	gorec_lane d[GOREC_LANES_LIMBS];
+	int i;
 
-	gorbn_init(lambda, GORBN_SZARR);
-	gorbn_init(tmp, GORBN_SZARR);
+	for (i = 0; i < GOREC_LANES_LIMBS; i++) {
+		d[i] = _gorec_lane_sub(a->w[i], b->w[i]);
+	}
+	gorec_lane is_negative = _gorec_lanes_carry_signed(d, ctx->mask);
 
-	/*lambda = (y2 - y1)/(x2 - x1)*/
-	gorbn_sub_mod(lambda, b->y, a->y, crv->p);
-	gorbn_sub_mod(tmp, b->x, a->x, crv->p);
-	gorbn_inv_mod(tmp, tmp, crv->p);
-	gorbn_mul_mod(lambda, lambda, tmp, crv->p);
+	//NOTE(dima): d + 2p carries out of the top limb exactly when d was negative, that carry is dropped
+	for (i = 0; i < GOREC_LANES_LIMBS; i++) {
+		d[i] = _gorec_lane_add(d[i], _gorec_lane_and(is_negative, ctx->p2.w[i]));
+	}
+	_gorec_lanes_carry(d, ctx->mask);
+	d[GOREC_LANES_LIMBS - 1] = _gorec_lane_and(d[GOREC_LANES_LIMBS - 1], ctx->mask);
 
-	/*x3 = lambda*lambda - x1 - x2*/
-	gorbn_sqr_mod(res_x, lambda, crv->p);
-	gorbn_sub_mod(res_x, res_x, a->x, crv->p);
-	gorbn_sub_mod(res_x, res_x, b->x, crv->p);
+	for (i = 0; i < GOREC_LANES_LIMBS; i++) {
+		r->w[i] = d[i];
+	}
+}
 
-	/*y3 = lambda * (x1 - x3) - y1 */
-	gorbn_sub_mod(res_y, a->x, res_x, crv->p);
-	gorbn_mul_mod(res_y, lambda, res_y, crv->p);
-	gorbn_sub_mod(res_y, res_y, a->y, crv->p);
+static void _gorec_lanes_neg(gorec_lanes_fe* r, gorec_lanes_fe* a, gorec_lanes_ctx* ctx) {
+	gorec_lanes_fe zero;
+	int i;
 
-	gorbn_copy(r->x, res_x);
-	gorbn_copy(r->y, res_y);
+	for (i = 0; i < GOREC_LANES_LIMBS; i++) {
+		zero.w[i] = _gorec_lane_set1(0);
+	}
+	_gorec_lanes_sub(r, &zero, a, ctx);
 }
 
-/* Point doubling in affine coordinates */
-void gorec_pt_double(gorec_point* r, gorec_point* a, gorec_curve* crv) {
-	if (!a->is_inf) {
-		gorbn_t res_x[GORBN_SZARR];
-		gorbn_t res_y[GORBN_SZARR];
-		
-		gorbn_t lambda[GORBN_SZARR];
-		gorbn_t tmp[GORBN_SZARR];
+/*Fully reduced a: below p*/
+static void _gorec_lanes_reduce(gorec_lanes_fe* r, gorec_lanes_fe* a, gorec_lanes_ctx* ctx) {
+	gorec_lane d[GOREC_LANES_LIMBS];
+	int i;
 
-		gorbn_init(lambda, GORBN_SZARR);
-		gorbn_init(tmp, GORBN_SZARR);
+	for (i = 0; i < GOREC_LANES_LIMBS; i++) {
+		d[i] = _gorec_lane_sub(a->w[i], ctx->p.w[i]);
+	}
+	gorec_lane is_below = _gorec_lanes_carry_signed(d, ctx->mask);
 
-		/*lambda = (3x1x1 + a)/(2y1) */
-		gorbn_sqr_mod(lambda, a->x, crv->p);
-		tmp[0] = 3;
-		gorbn_mul_mod(lambda, lambda, tmp, crv->p);
-		gorbn_add_mod(lambda, lambda, crv->a, crv->p);
-		tmp[0] = 2;
-		gorbn_mul_mod(tmp, tmp, a->y, crv->p);
-		gorbn_inv_mod(tmp, tmp, crv->p);
-		gorbn_mul_mod(lambda, lambda, tmp, crv->p);
+	for (i = 0; i < GOREC_LANES_LIMBS; i++) {
+		r->w[i] = _gorec_lane_select(is_below, a->w[i], d[i]);
+	}
+}
 
-		/*x3 = lambda*lambda - x1 - x2*/
-		gorbn_sqr_mod(res_x, lambda, crv->p);
-		gorbn_sub_mod(res_x, res_x, a->x, crv->p);
-		gorbn_sub_mod(res_x, res_x, a->x, crv->p);
+/*All ones in lanes where a = 0 mod p*/
+static gorec_lane _gorec_lanes_is_zero(gorec_lanes_fe* a, gorec_lanes_ctx* ctx) {
+	gorec_lanes_fe reduced;
+	gorec_lane acc = _gorec_lane_set1(0);
+	int i;
 
-		/*y3 = lambda * (x1 - x3) - y1 */
-		gorbn_sub_mod(res_y, a->x, res_x, crv->p);
-		gorbn_mul_mod(res_y, lambda, res_y, crv->p);
-		gorbn_sub_mod(res_y, res_y, a->y, crv->p);
+	_gorec_lanes_reduce(&reduced, a, ctx);
+	for (i = 0; i < GOREC_LANES_LIMBS; i++) {
+		acc = _gorec_lane_or(acc, reduced.w[i]);
+	}
 
-		gorbn_copy(r->x, res_x);
-		gorbn_copy(r->y, res_y);
+	return(_gorec_lane_eq(acc, _gorec_lane_set1(0)));
+}
+
+static void _gorec_lanes_fe_select(gorec_lanes_fe* r, gorec_lane mask, gorec_lanes_fe* a, gorec_lanes_fe* b) {
+	int i;
+	for (i = 0; i < GOREC_LANES_LIMBS; i++) {
+		r->w[i] = _gorec_lane_select(mask, a->w[i], b->w[i]);
 	}
 }
 
-/* Point doubling in Jacobian coordinates */
-void gorec_pt_double_jacobian(gorec_point* r, gorec_point* a, gorec_curve* crv) {
-	gorbn_t S[GORBN_SZARR];
-	gorbn_t M[GORBN_SZARR];
-	gorbn_t TMP[GORBN_SZARR];
-	gorbn_t YSQ[GORBN_SZARR];
+/*
+	r = a ^ (p - 2), fixed 4-bit windows. The exponent is public, so only
+	the work per window is fixed, windows of zero bits are skipped.
+*/
+static void _gorec_lanes_inv(gorec_lanes_fe* r, gorec_lanes_fe* a, gorbn_t* p_minus_2, gorec_lanes_ctx* ctx) {
+	gorec_lanes_fe table[1 << GOREC_FERMAT_WINDOW_W];
+	gorec_lanes_fe acc;
+	int nbits = _gorbn_get_nbits(p_minus_2, GORBN_SZARR);
+	int i, j;
+
+	table[0] = ctx->one;
+	table[1] = *a;
+	for (i = 2; i < (1 << GOREC_FERMAT_WINDOW_W); i++) {
+		_gorec_lanes_mul(&table[i], &table[i - 1], a, ctx);
+	}
+
+	acc = ctx->one;
+	for (i = ((nbits + GOREC_FERMAT_WINDOW_W - 1) / GOREC_FERMAT_WINDOW_W - 1) * GOREC_FERMAT_WINDOW_W; i >= 0; i -= GOREC_FERMAT_WINDOW_W) {
+		int window = 0;
+
+		for (j = 0; j < GOREC_FERMAT_WINDOW_W; j++) {
+			_gorec_lanes_sqr(&acc, &acc, ctx);
+		}
+		for (j = GOREC_FERMAT_WINDOW_W - 1; j >= 0; j--) {
+			window = (window << 1) | _gorbn_testbit(p_minus_2, i + j);
+		}
+		if (window) {
+			_gorec_lanes_mul(&acc, &acc, &table[window], ctx);
+		}
+	}
 
-	gorec_point rp;
-	gorec_pt_clear(&rp);
+	*r = acc;
+}
 
-	if (a->is_inf) {
-		return;
+/*Jacobian doubling, dbl-2001-b for a = -3 and dbl-2007-bl otherwise, as gorec_pt_double_jacobian*()*/
+static void _gorec_lanes_pt_double(gorec_lanes_point* r, gorec_lanes_point* a, gorec_lanes_ctx* ctx) {
+	gorec_lanes_fe t0, t1, t2, t3, t4;
+
+	if (ctx->is_a3) {
+		//NOTE(dima): t0 = delta, t1 = gamma, t2 = beta, t3 = alpha
+		_gorec_lanes_sqr(&t0, &a->z, ctx);
+		_gorec_lanes_sqr(&t1, &a->y, ctx);
+		_gorec_lanes_mul(&t2, &a->x, &t1, ctx);
+
+		_gorec_lanes_sub(&t3, &a->x, &t0, ctx);
+		_gorec_lanes_add(&t4, &a->x, &t0, ctx);
+		_gorec_lanes_mul(&t3, &t3, &t4, ctx);
+		_gorec_lanes_add(&t4, &t3, &t3, ctx);
+		_gorec_lanes_add(&t3, &t4, &t3, ctx);
+
+		//NOTE(dima): z3 = (y + z)^2 - gamma - delta
+		_gorec_lanes_add(&r->z, &a->y, &a->z, ctx);
+		_gorec_lanes_sqr(&r->z, &r->z, ctx);
+		_gorec_lanes_sub(&r->z, &r->z, &t1, ctx);
+		_gorec_lanes_sub(&r->z, &r->z, &t0, ctx);
+
+		//NOTE(dima): x3 = alpha^2 - 8 beta
+		_gorec_lanes_add(&t2, &t2, &t2, ctx);
+		_gorec_lanes_add(&t2, &t2, &t2, ctx);
+		_gorec_lanes_add(&t4, &t2, &t2, ctx);
+		_gorec_lanes_sqr(&r->x, &t3, ctx);
+		_gorec_lanes_sub(&r->x, &r->x, &t4, ctx);
+
+		//NOTE(dima): y3 = alpha (4 beta - x3) - 8 gamma^2
+		_gorec_lanes_sub(&t2, &t2, &r->x, ctx);
+		_gorec_lanes_mul(&t2, &t3, &t2, ctx);
+		_gorec_lanes_sqr(&t1, &t1, ctx);
+		_gorec_lanes_add(&t1, &t1, &t1, ctx);
+		_gorec_lanes_add(&t1, &t1, &t1, ctx);
+		_gorec_lanes_add(&t1, &t1, &t1, ctx);
+		_gorec_lanes_sub(&r->y, &t2, &t1, ctx);
 	}
+	else {
+		//NOTE(dima): t0 = XX, t1 = YY, t2 = YYYY, t3 = ZZ
+		_gorec_lanes_sqr(&t0, &a->x, ctx);
+		_gorec_lanes_sqr(&t1, &a->y, ctx);
+		_gorec_lanes_sqr(&t2, &t1, ctx);
+		_gorec_lanes_sqr(&t3, &a->z, ctx);
+
+		//NOTE(dima): z3 = (y + z)^2 - YY - ZZ
+		_gorec_lanes_add(&r->z, &a->y, &a->z, ctx);
+		_gorec_lanes_sqr(&r->z, &r->z, ctx);
+		_gorec_lanes_sub(&r->z, &r->z, &t1, ctx);
+		_gorec_lanes_sub(&r->z, &r->z, &t3, ctx);
+
+		//NOTE(dima): S = 2 ((x + YY)^2 - XX - YYYY), into t1
+		_gorec_lanes_add(&t1, &a->x, &t1, ctx);
+		_gorec_lanes_sqr(&t1, &t1, ctx);
+		_gorec_lanes_sub(&t1, &t1, &t0, ctx);
+		_gorec_lanes_sub(&t1, &t1, &t2, ctx);
+		_gorec_lanes_add(&t1, &t1, &t1, ctx);
+
+		//NOTE(dima): M = 3 XX + a ZZ^2, into t0
+		_gorec_lanes_sqr(&t3, &t3, ctx);
+		_gorec_lanes_mul(&t3, &t3, &ctx->a, ctx);
+		_gorec_lanes_add(&t4, &t0, &t0, ctx);
+		_gorec_lanes_add(&t0, &t4, &t0, ctx);
+		_gorec_lanes_add(&t0, &t0, &t3, ctx);
+
+		//NOTE(dima): x3 = M^2 - 2 S, y3 = M (S - x3) - 8 YYYY
+		_gorec_lanes_sqr(&r->x, &t0, ctx);
+		_gorec_lanes_sub(&r->x, &r->x, &t1, ctx);
+		_gorec_lanes_sub(&r->x, &r->x, &t1, ctx);
+		_gorec_lanes_sub(&t1, &t1, &r->x, ctx);
+		_gorec_lanes_mul(&t1, &t0, &t1, ctx);
+		_gorec_lanes_add(&t2, &t2, &t2, ctx);
+		_gorec_lanes_add(&t2, &t2, &t2, ctx);
+		_gorec_lanes_add(&t2, &t2, &t2, ctx);
+		_gorec_lanes_sub(&r->y, &t1, &t2, ctx);
+	}
+}
 
-	// S = 4*X*Y^2
-	gorbn_sqr_mod(YSQ, a->y, crv->p);
-	gorbn_mul_mod(S, a->x, YSQ, crv->p);
-	gorbn_mulword_mod(S, S, 4, crv->p);
+/*
+	r = a + b for affine b, madd-2007-bl. Like _gorec_pt_add_mixed()
+	without special cases: z3 = 0 when x of both points is the same.
+*/
+static void _gorec_lanes_pt_add_mixed(gorec_lanes_point* r, gorec_lanes_point* a, gorec_lanes_fe* bx, gorec_lanes_fe* by, gorec_lanes_ctx* ctx) {
+	gorec_lanes_fe z1z1, u2, s2, h, hh, i4, j, rr, v, t;
+
+	_gorec_lanes_sqr(&z1z1, &a->z, ctx);
+	_gorec_lanes_mul(&u2, bx, &z1z1, ctx);
+	_gorec_lanes_mul(&s2, &a->z, &z1z1, ctx);
+	_gorec_lanes_mul(&s2, by, &s2, ctx);
+
+	_gorec_lanes_sub(&h, &u2, &a->x, ctx);
+	_gorec_lanes_sqr(&hh, &h, ctx);
+	_gorec_lanes_add(&i4, &hh, &hh, ctx);
+	_gorec_lanes_add(&i4, &i4, &i4, ctx);
+	_gorec_lanes_mul(&j, &h, &i4, ctx);
+	_gorec_lanes_sub(&rr, &s2, &a->y, ctx);
+	_gorec_lanes_add(&rr, &rr, &rr, ctx);
+	_gorec_lanes_mul(&v, &a->x, &i4, ctx);
+
+	//NOTE(dima): z3 = (z1 + h)^2 - z1z1 - hh, before z1 is overwritten
+	_gorec_lanes_add(&t, &a->z, &h, ctx);
+	_gorec_lanes_sqr(&t, &t, ctx);
+	_gorec_lanes_sub(&t, &t, &z1z1, ctx);
+	_gorec_lanes_sub(&r->z, &t, &hh, ctx);
+
+	//NOTE(dima): x3 = rr^2 - j - 2 v
+	_gorec_lanes_sqr(&t, &rr, ctx);
+	_gorec_lanes_sub(&t, &t, &j, ctx);
+	_gorec_lanes_add(&u2, &v, &v, ctx);
+	_gorec_lanes_sub(&r->x, &t, &u2, ctx);
+
+	//NOTE(dima): y3 = rr (v - x3) - 2 y1 j
+	_gorec_lanes_mul(&j, &a->y, &j, ctx);
+	_gorec_lanes_add(&j, &j, &j, ctx);
+	_gorec_lanes_sub(&t, &v, &r->x, ctx);
+	_gorec_lanes_mul(&t, &rr, &t, ctx);
+	_gorec_lanes_sub(&r->y, &t, &j, ctx);
+}
 
-	// M = 3*X^2 + a*Z^4
-	gorbn_sqr_mod(M, a->x, crv->p);
-	gorbn_mulword_mod(M, M, 3, crv->p);
-	gorbn_sqr_mod(TMP, a->z, crv->p);
-	gorbn_sqr_mod(TMP, TMP, crv->p);
-	gorbn_mul_mod(TMP, TMP, crv->a, crv->p);
-	gorbn_add_mod(M, M, TMP, crv->p);
+static void _gorec_lanes_ctx_init(gorec_lanes_ctx* ctx, gorec_curve* crv) {
+	uint64_t limbs[GOREC_LANES_LIMBS];
+	gorec_lanes_fe plain;
+	int i;
 
-	// X' = M^2 - 2*S
-	gorbn_sqr_mod(rp.x, M, crv->p);
-	gorbn_mulword_mod(TMP, S, 2, crv->p);
-	gorbn_sub_mod(rp.x, rp.x, TMP, crv->p);
+	ctx->mask = _gorec_lane_set1(GOREC_LANES_MASK);
 
-	// Y' = M*(S - X') - 8 * Y ^ 4
-	gorbn_sub_mod(rp.y, S, rp.x, crv->p);
-	gorbn_mul_mod(rp.y, M, rp.y, crv->p);
-	gorbn_sqr_mod(TMP, YSQ, crv->p);
-	gorbn_mulword_mod(TMP, TMP, 8, crv->p);
-	gorbn_sub_mod(rp.y, rp.y, TMP, crv->p);
-	
-	// Z' = 2*Y*Z
-	gorbn_mul_mod(rp.z, a->y, a->z, crv->p);
-	gorbn_mulword_mod(rp.z, rp.z, 2, crv->p);
+	_gorec_lanes_limbs_from_gorbn(limbs, 1, crv->p);
+	_gorec_lanes_fe_set1(&ctx->p, limbs);
 
-	rp.is_inf = 0;
-	gorec_pt_copy(r, &rp);
-}
+	//NOTE(dima): Newton iteration doubles correct low bits of p ^ (-1): 1, 2, 4, .. 32
+	uint32_t p0 = (uint32_t)limbs[0];
+	uint32_t inv = 1;
+	for (i = 0; i < 5; i++) {
+		inv *= 2 - p0 * inv;
+	}
+	ctx->n0 = _gorec_lane_set1((uint64_t)(0 - inv) & GOREC_LANES_MASK);
 
-/*Point addition in Jacobian projective coordinates*/
-void gorec_pt_add_jacobian(gorec_point* r, gorec_point* a, gorec_point* b, gorec_curve* crv){
-	gorbn_t U1[GORBN_SZARR];
-	gorbn_t U2[GORBN_SZARR];
-	gorbn_t S1[GORBN_SZARR];
-	gorbn_t S2[GORBN_SZARR];
-	gorbn_t TMP[GORBN_SZARR];
-	gorbn_t H[GORBN_SZARR];
-	gorbn_t R[GORBN_SZARR];
+	//NOTE(dima): 2p in limbs, it may not fit into the words of gorbn_t
+	for (i = 0; i < GOREC_LANES_LIMBS; i++) {
+		limbs[i] *= 2;
+	}
+	for (i = 0; i < GOREC_LANES_LIMBS - 1; i++) {
+		limbs[i + 1] += limbs[i] >> GOREC_LANES_RADIX;
+		limbs[i] &= GOREC_LANES_MASK;
+	}
+	_gorec_lanes_fe_set1(&ctx->p2, limbs);
 
-	if (a->is_inf) {
-		gorec_pt_copy(r, b);
-		return;
+	//NOTE(dima): R ^ 2 = 2 ^ 522 mod p by doublings of 1, every sum stays below 2p
+	for (i = 0; i < GOREC_LANES_LIMBS; i++) {
+		ctx->r2.w[i] = _gorec_lane_set1(i == 0);
+	}
+	for (i = 0; i < GOREC_LANES_LIMBS * GOREC_LANES_RADIX * 2; i++) {
+		_gorec_lanes_add(&ctx->r2, &ctx->r2, &ctx->r2, ctx);
 	}
 
-	if (b->is_inf) {
-		gorec_pt_copy(r, a);
-		return;
+	for (i = 0; i < GOREC_LANES_LIMBS; i++) {
+		plain.w[i] = _gorec_lane_set1(i == 0);
 	}
+	_gorec_lanes_mul(&ctx->one, &ctx->r2, &plain, ctx);
 
-	// U1 = X1*Z2^2
-	// U2 = X2*Z1^2
-	// S1 = Y1*Z2^3
-	// S2 = Y2*Z1^3
-	gorbn_sqr_mod(TMP, b->z, crv->p);
-	gorbn_mul_mod(U1, a->x, TMP, crv->p);
-	gorbn_mul_mod(S1, TMP, a->y, crv->p);
-	gorbn_mul_mod(S1, S1, b->z, crv->p);
-	gorbn_sqr_mod(TMP, a->z, crv->p);
-	gorbn_mul_mod(U2, TMP, b->x, crv->p);
-	gorbn_mul_mod(S2, TMP, b->y, crv->p);
-	gorbn_mul_mod(S2, S2, a->z, crv->p);
-
-	if (gorbn_cmp(U1, U2) == GORBN_CMP_EQUAL) {
-		if (gorbn_cmp(S1, S2) != GORBN_CMP_EQUAL) {
-			//NOTE(dima): Return POINT_AT_INFINITY
-			int a = 1;
+	ctx->is_a3 = (crv->pt_double == gorec_pt_double_jacobian_a3);
+	_gorec_lanes_limbs_from_gorbn(limbs, 1, crv->a);
+	_gorec_lanes_fe_set1(&plain, limbs);
+	_gorec_lanes_mul(&ctx->a, &plain, &ctx->r2, ctx);
+}
+
+/*
+	Up to GOREC_LANES points of gorec_pt_mul_batch_arena(), steps are
+	those of gorec_pt_mul_ct_arena() done for all lanes at once. Every
+	lane has its own digits, so digit selection and negation are masked
+	per lane. Lanes from count on repeat lane 0, their results are dropped.
+*/
+static void _gorec_pt_mul_lanes(
+	gorec_point* p_results,
+	gorec_point* p_points,
+	gorbn_t* p_scalars,
+	int count,
+	gorec_curve* crv,
+	gorec_lanes_ctx* ctx,
+	gorec_arena* arena)
+{
+	gorec_point* table = arena->table;
+	gorec_point* pt = &arena->pt;
+
+	signed char digits[GOREC_LANES][GOREC_CT_DIGITS_COUNT];
+	uint64_t is_even[GOREC_LANES];
+	uint64_t index[GOREC_LANES];
+	uint64_t is_negative[GOREC_LANES];
+	gorbn_t k[GORBN_SZARR];
+	gorbn_t temp[GORBN_SZARR];
+	gorec_lanes_point result;
+	gorec_lanes_point doubled;
+	gorec_lanes_fe sel_x, sel_y, neg_y, zinv, zinv2;
+	gorbn_t p_minus_2[GORBN_SZARR];
+	int i, j, e, l, c;
+
+	int digit_mask = (1 << (GOREC_CT_WINDOW_W + 1)) - 1;
+	int digits_count = (_gorec_scalar_bits(crv) + GOREC_CT_WINDOW_W - 1) / GOREC_CT_WINDOW_W;
+
+	for (l = 0; l < GOREC_LANES; l++) {
+		gorbn_t* scalar = p_scalars + ((l < count) ? l : 0) * GORBN_SZARR;
+		int lane_is_even = !(scalar[0] & 1);
+
+		gorbn_copy(k, scalar);
+		gorbn_sub(temp, crv->q, scalar);
+		gorbn_cmov(k, temp, lane_is_even);
+		is_even[l] = (uint64_t)0 - (uint64_t)lane_is_even;
+
+		for (i = 0; i < digits_count; i++) {
+			digits[l][i] = (signed char)((int)(k[0] & digit_mask) - (1 << GOREC_CT_WINDOW_W));
+			gorbn_rshift(k, k, GOREC_CT_WINDOW_W);
+			k[0] |= 1;
+		}
+	}
+
+	//NOTE(dima): Odd multiples of every lane as plain numbers, then to Montgomery form of the lanes
+	for (l = 0; l < GOREC_LANES; l++) {
+		if (l < count) {
+			gorec_pt_to_field(pt, p_points + l, crv);
+			_gorec_precompute_odd_multiples(table, GOREC_CT_TABLE_COUNT, pt, crv);
+
+			for (e = 0; e < GOREC_CT_TABLE_COUNT; e++) {
+				crv->from_field(temp, table[e].x, crv);
+				_gorec_lanes_limbs_from_gorbn(&arena->lanes_table[e][0][0][l], GOREC_LANES, temp);
+				crv->from_field(temp, table[e].y, crv);
+				_gorec_lanes_limbs_from_gorbn(&arena->lanes_table[e][1][0][l], GOREC_LANES, temp);
+			}
 		}
 		else {
-			//NOTE(dima):
-			return gorec_pt_double_jacobian(r, a, crv);
+			for (e = 0; e < GOREC_CT_TABLE_COUNT; e++) {
+				for (c = 0; c < 2; c++) {
+					for (i = 0; i < GOREC_LANES_LIMBS; i++) {
+						arena->lanes_table[e][c][i][l] = arena->lanes_table[e][c][i][0];
+					}
+				}
+			}
 		}
 	}
 
-	// H = U2 - U1
-	gorbn_sub_mod(H, U2, U1, crv->p);
-
-	// R = S2 - S1
-	gorbn_sub_mod(R, S2, S1, crv->p);
-
-	// X3 = R^2 - H^3 - 2*U1*H^2
-	gorbn_sqr_mod(r->x, R, crv->p);
-	gorbn_sqr_mod(U2, H, crv->p);
-	gorbn_mul_mod(U2, U2, H, crv->p);
-	gorbn_sub_mod(r->x, r->x, U2, crv->p);
-	gorbn_sqr_mod(TMP, H, crv->p);
-	gorbn_mul_mod(TMP, TMP, U1, crv->p);
-	gorbn_mulword_mod(TMP, TMP, 2, crv->p);
-	gorbn_sub_mod(r->x, r->x, TMP, crv->p);
-
-	// Y3 = R*(U1*H^2 - X3) - S1*H^3
-	gorbn_sqr_mod(TMP, H, crv->p);
-	gorbn_mul_mod(TMP, TMP, U1, crv->p);
-	gorbn_sub_mod(TMP, TMP, r->x, crv->p);
-	gorbn_mul_mod(TMP, TMP, R, crv->p);
-	gorbn_mul_mod(U2, U2, S1, crv->p);
-	gorbn_sub_mod(r->y, TMP, U2, crv->p);
+	for (e = 0; e < GOREC_CT_TABLE_COUNT; e++) {
+		for (c = 0; c < 2; c++) {
+			gorec_lanes_fe v;
+			_gorec_lanes_fe_load(&v, &arena->lanes_table[e][c][0][0]);
+			_gorec_lanes_mul(&v, &v, &ctx->r2, ctx);
+			_gorec_lanes_fe_store(&arena->lanes_table[e][c][0][0], &v);
+		}
+	}
 
-	// Z3 = H*Z1*Z2
-	gorbn_mul_mod(r->z, a->z, b->z, crv->p);
-	gorbn_mul_mod(r->z, r->z, H, crv->p);
-}
+	//NOTE(dima): Top digit is always 1 after digits_count steps
+	_gorec_lanes_fe_load(&result.x, &arena->lanes_table[0][0][0][0]);
+	_gorec_lanes_fe_load(&result.y, &arena->lanes_table[0][1][0][0]);
+	result.z = ctx->one;
+	for (i = digits_count - 1; i >= 0; i--) {
+		for (j = 0; j < GOREC_CT_WINDOW_W; j++) {
+			_gorec_lanes_pt_double(&result, &result, ctx);
+		}
 
-/*Point subtraction in Jacobian projective coordinates*/
-void gorec_pt_sub_jacobian(gorec_point* r, gorec_point* a, gorec_point* b, gorec_curve* crv) {
-	gorbn_t SaveY[GORBN_SZARR];
+		for (l = 0; l < GOREC_LANES; l++) {
+			int digit = digits[l][i];
+			int lane_is_negative = (digit < 0);
+			int digit_abs = (digit ^ -lane_is_negative) + lane_is_negative;
 
-	//NOTE(dima): Save b->y for later reassigning
-	gorbn_copy(SaveY, b->y);
+			index[l] = (uint64_t)(digit_abs >> 1);
+			is_negative[l] = (uint64_t)0 - (uint64_t)lane_is_negative;
+		}
 
-	//NOTE(dima): 0 - b->y
-	gorbn_init(b->y, GORBN_SZARR);
+		//NOTE(dima): Masked lookup, every entry of the table is read for every lane
+		gorec_lane lane_index = _gorec_lane_load(index);
+		for (c = 0; c < GOREC_LANES_LIMBS; c++) {
+			sel_x.w[c] = _gorec_lane_set1(0);
+			sel_y.w[c] = _gorec_lane_set1(0);
+		}
+		for (e = 0; e < GOREC_CT_TABLE_COUNT; e++) {
+			gorec_lane is_needed = _gorec_lane_eq(lane_index, _gorec_lane_set1((uint64_t)e));
+			for (c = 0; c < GOREC_LANES_LIMBS; c++) {
+				sel_x.w[c] = _gorec_lane_or(sel_x.w[c], _gorec_lane_and(is_needed, _gorec_lane_load(arena->lanes_table[e][0][c])));
+				sel_y.w[c] = _gorec_lane_or(sel_y.w[c], _gorec_lane_and(is_needed, _gorec_lane_load(arena->lanes_table[e][1][c])));
+			}
+		}
 
-	gorbn_sub_mod(b->y, b->y, SaveY, crv->p);
+		_gorec_lanes_neg(&neg_y, &sel_y, ctx);
+		_gorec_lanes_fe_select(&sel_y, _gorec_lane_load(is_negative), &neg_y, &sel_y);
 
-	//NOTE(dima): Adding initial A and negated B
-	gorec_pt_add_jacobian(r, a, b, crv);
+		if (i > 0) {
+			_gorec_lanes_pt_add_mixed(&result, &result, &sel_x, &sel_y, ctx);
+		}
+		else {
+			/*NOTE(dima): Result can not be -selected, as s is not 0 mod q*/
+			_gorec_lanes_pt_double(&doubled, &result, ctx);
+			_gorec_lanes_pt_add_mixed(&result, &result, &sel_x, &sel_y, ctx);
+
+			gorec_lane is_same = _gorec_lanes_is_zero(&result.z, ctx);
+			_gorec_lanes_fe_select(&result.x, is_same, &doubled.x, &result.x);
+			_gorec_lanes_fe_select(&result.y, is_same, &doubled.y, &result.y);
+			_gorec_lanes_fe_select(&result.z, is_same, &doubled.z, &result.z);
+		}
+	}
 
-	//NOTE(dima): Returning old saved b->y value
-	gorbn_copy(b->y, SaveY);
+	//NOTE(dima): Exit from Jacobian coordinates by Fermat's little theorem, as gorec_pt_mul_ct()
+	gorbn_from_int(temp, 2);
+	gorbn_sub(p_minus_2, crv->p, temp);
+	_gorec_lanes_inv(&zinv, &result.z, p_minus_2, ctx);
+	_gorec_lanes_sqr(&zinv2, &zinv, ctx);
+	_gorec_lanes_mul(&result.x, &result.x, &zinv2, ctx);
+	_gorec_lanes_mul(&zinv2, &zinv2, &zinv, ctx);
+	_gorec_lanes_mul(&result.y, &result.y, &zinv2, ctx);
+
+	_gorec_lanes_neg(&neg_y, &result.y, ctx);
+	_gorec_lanes_fe_select(&result.y, _gorec_lane_load(is_even), &neg_y, &result.y);
+
+	//NOTE(dima): Out of Montgomery form: multiplication by plain 1
+	for (c = 0; c < GOREC_LANES_LIMBS; c++) {
+		zinv.w[c] = _gorec_lane_set1(c == 0);
+	}
+	_gorec_lanes_mul(&result.x, &result.x, &zinv, ctx);
+	_gorec_lanes_reduce(&result.x, &result.x, ctx);
+	_gorec_lanes_mul(&result.y, &result.y, &zinv, ctx);
+	_gorec_lanes_reduce(&result.y, &result.y, ctx);
+	_gorec_lanes_fe_store(&arena->lanes_table[0][0][0][0], &result.x);
+	_gorec_lanes_fe_store(&arena->lanes_table[0][1][0][0], &result.y);
+
+	for (l = 0; l < count; l++) {
+		gorec_point* r = p_results + l;
+
+		_gorec_lanes_limbs_to_gorbn(r->x, &arena->lanes_table[0][0][0][l], GOREC_LANES);
+		_gorec_lanes_limbs_to_gorbn(r->y, &arena->lanes_table[0][1][0][l], GOREC_LANES);
+		gorbn_from_int(r->z, 1);
+		r->is_inf = 0;
+	}
 }
 
-//NOTE(dima): window width w should not be greater than 7 (<=7)
-
-static void gorec_compute_naf(char* NAF, int* NAFLength, gorbn_t k[GORBN_SZARR], int w) {
-	gorbn_t kk[GORBN_SZARR];
-	gorbn_t temp[GORBN_SZARR];
+void gorec_pt_mul_batch_arena(
+	gorec_point* p_results,
+	gorec_point* p_points,
+	gorbn_t* p_scalars,
+	int count,
+	gorec_curve* crv,
+	gorec_arena* arena)
+{
+	gorec_lanes_ctx ctx;
 	int i;
 
-	gorbn_copy(kk, k);
-	gorbn_init(temp, GORBN_SZARR);
+	if (_gorbn_get_nbits(crv->p, GORBN_SZARR) > GOREC_LANES_MAX_BITS) {
+		for (i = 0; i < count; i++) {
+			gorec_pt_mul_ct_arena(p_results + i, p_points + i, p_scalars + i * GORBN_SZARR, crv, arena);
+		}
+		return;
+	}
 
-	int two_pow_w = 1 << w;
-	int half_pow_w = two_pow_w >> 1;
+	_gorec_lanes_ctx_init(&ctx, crv);
+	for (i = 0; i < count; i += GOREC_LANES) {
+		_gorec_pt_mul_lanes(
+			p_results + i,
+			p_points + i,
+			p_scalars + i * GORBN_SZARR,
+			GORBN_MIN(count - i, GOREC_LANES),
+			crv,
+			&ctx,
+			arena);
+	}
+}
 
-	i = 0;
-	while (!gorbn_is_zero(kk)) {
-		int ExitOnTheEndOfIteration = 0;
-		if (gorbn_is_one(kk)) {
-			ExitOnTheEndOfIteration = 1;
-		}
+void gorec_pt_mul_batch(
+	gorec_point* p_results,
+	gorec_point* p_points,
+	gorbn_t* p_scalars,
+	int count,
+	gorec_curve* crv)
+{
+	gorec_arena arena;
+	gorec_pt_mul_batch_arena(p_results, p_points, p_scalars, count, crv, &arena);
+}
 
-		if (!GORBN_EVEN(kk)) {
-			int word_mod_res = kk[0] & (two_pow_w - 1);
+#ifdef GOREC_THREAD_POOL
+#if defined(_WIN32)
+#define GOREC_MUTEX_INIT(m) InitializeSRWLock(m)
+#define GOREC_MUTEX_FREE(m)
+#define GOREC_MUTEX_LOCK(m) AcquireSRWLockExclusive(m)
+#define GOREC_MUTEX_UNLOCK(m) ReleaseSRWLockExclusive(m)
+#define GOREC_CONDVAR_INIT(c) InitializeConditionVariable(c)
+#define GOREC_CONDVAR_FREE(c)
+#define GOREC_CONDVAR_WAIT(c, m) SleepConditionVariableSRW(c, m, INFINITE, 0)
+#define GOREC_CONDVAR_BROADCAST(c) WakeAllConditionVariable(c)
+/*NOTE(dima): Returns previous value*/
+#define GOREC_ATOMIC_FETCH_INC(p) (InterlockedIncrement(p) - 1)
+#else
+#define GOREC_MUTEX_INIT(m) pthread_mutex_init(m, 0)
+#define GOREC_MUTEX_FREE(m) pthread_mutex_destroy(m)
+#define GOREC_MUTEX_LOCK(m) pthread_mutex_lock(m)
+#define GOREC_MUTEX_UNLOCK(m) pthread_mutex_unlock(m)
+#define GOREC_CONDVAR_INIT(c) pthread_cond_init(c, 0)
+#define GOREC_CONDVAR_FREE(c) pthread_cond_destroy(c)
+#define GOREC_CONDVAR_WAIT(c, m) pthread_cond_wait(c, m)
+#define GOREC_CONDVAR_BROADCAST(c) pthread_cond_broadcast(c)
+#define GOREC_ATOMIC_FETCH_INC(p) __atomic_fetch_add(p, 1, __ATOMIC_RELAXED)
+#endif
 
-			if (word_mod_res >= half_pow_w) {
-				NAF[i] = word_mod_res - two_pow_w;
-			}
-			else {
-				NAF[i] = word_mod_res;
-			}
+static void _gorec_pool_work(gorec_pool* pool, gorec_arena* arena) {
+	while (1) {
+		int chunk = (int)GOREC_ATOMIC_FETCH_INC(&pool->next_chunk);
+		if (chunk >= pool->chunks_count) {
+			break;
+		}
 
-			if (NAF[i] > 0) {
-				gorbn_from_int(temp, NAF[i]);
-				int borrow = gorbn_sub(kk, kk, temp);
+		int first = chunk * GOREC_POOL_CHUNK;
+		pool->job(pool, first, GORBN_MIN(GOREC_POOL_CHUNK, pool->jobs_count - first), arena);
+	}
+}
 
-				if (borrow) {
-					ExitOnTheEndOfIteration = 1;
-				}
-			}
-			else {
-				gorbn_from_int(temp, -NAF[i]);
-				gorbn_add(kk, kk, temp);
+static void _gorec_pool_worker_loop(gorec_pool_worker* worker) {
+	gorec_pool* pool = worker->pool;
+	int seen_generation = 0;
 
-				if (ExitOnTheEndOfIteration) {
-					ExitOnTheEndOfIteration = 0;
-				}
-			}
+	GOREC_MUTEX_LOCK(&pool->mutex);
+	while (1) {
+		while (!pool->quit && pool->generation == seen_generation) {
+			GOREC_CONDVAR_WAIT(&pool->cond_work, &pool->mutex);
 		}
-		else {
-			NAF[i] = 0;
+
+		if (pool->quit) {
+			break;
 		}
 
-		i++;
-		gorbn_rshift_one_bit(kk);
+		seen_generation = pool->generation;
+		GOREC_MUTEX_UNLOCK(&pool->mutex);
 
-		if (ExitOnTheEndOfIteration) {
-			break;
+		_gorec_pool_work(pool, worker->arena);
+
+		GOREC_MUTEX_LOCK(&pool->mutex);
+		if (--pool->working_count == 0) {
+			GOREC_CONDVAR_BROADCAST(&pool->cond_done);
 		}
 	}
+	GOREC_MUTEX_UNLOCK(&pool->mutex);
+}
+
+#if defined(_WIN32)
+static DWORD WINAPI _gorec_pool_thread_proc(LPVOID param) {
+	_gorec_pool_worker_loop((gorec_pool_worker*)param);
 
-	*NAFLength = i;
+	return(0);
 }
+#else
+static void* _gorec_pool_thread_proc(void* param) {
+	_gorec_pool_worker_loop((gorec_pool_worker*)param);
 
-#define GOREC_WINDOW_W 4
-#define GOREC_PRECOMPUTE_ARRAYS_COUNT (1 << (GOREC_WINDOW_W - 2))
-void gorec_pt_mul_wnaf_jacobian(
-	gorec_point* p_result,
-	gorec_point *p_point,
-	gorbn_t *p_scalar,
-	gorec_curve* crv) 
-{
-	int PrecomputeIndex;
+	return(0);
+}
+#endif
+
+static void _gorec_pool_stop(gorec_pool* pool, int started_count) {
 	int i;
 
-	//NOTE(dima): I think that this is the maximum possible size of this thing
-	char NAF[GORBN_SZARR_BITS_TOTAL + 1];
-	int NAFLength;
+	GOREC_MUTEX_LOCK(&pool->mutex);
+	pool->quit = 1;
+	GOREC_CONDVAR_BROADCAST(&pool->cond_work);
+	GOREC_MUTEX_UNLOCK(&pool->mutex);
 
-	int w = GOREC_WINDOW_W;
-	gorec_point PrecomputePoints[GOREC_PRECOMPUTE_ARRAYS_COUNT];
+	for (i = 1; i <= started_count; i++) {
+#if defined(_WIN32)
+		WaitForSingleObject(pool->threads[i], INFINITE);
+		CloseHandle(pool->threads[i]);
+#else
+		pthread_join(pool->threads[i], 0);
+#endif
+	}
 
-	gorec_point result;
-	gorbn_t temp_for_exit[GORBN_SZARR];
+	GOREC_CONDVAR_FREE(&pool->cond_work);
+	GOREC_CONDVAR_FREE(&pool->cond_done);
+	GOREC_MUTEX_FREE(&pool->mutex);
+}
 
-	//NOTE(dima): Step1 - Computing Non-Adjacent Form (NAF)
-	gorec_compute_naf(NAF, &NAFLength, p_scalar, w);
+uint32_t gorec_pool_deep(int threads_count) {
+	return((uint32_t)(GORBN_CLAMP(threads_count, 1, GOREC_POOL_MAX_THREADS) * sizeof(gorec_arena)));
+}
 
-	//NOTE(dima): Using p_result as temp variable
-	gorec_pt_copy(&result, p_point);
-	gorec_pt_copy(&PrecomputePoints[0], &result);
-	//NOTE(dima): Step2 - Precomputing points
-	for (PrecomputeIndex = 0;
-		PrecomputeIndex < GOREC_PRECOMPUTE_ARRAYS_COUNT;
-		PrecomputeIndex++)
-	{
-		if (PrecomputeIndex != 0) {
-			//NOTE(dima): Incrementing 2 times by p_point to save odd'ness
-			gorec_pt_add_jacobian(&result, &result, p_point, crv);
-			gorec_pt_add_jacobian(&result, &result, p_point, crv);
+int gorec_pool_init(gorec_pool* pool, int threads_count, void* stack) {
+	int i;
 
-			gorec_pt_copy(&PrecomputePoints[PrecomputeIndex], &result);
-		}
+	pool->threads_count = GORBN_CLAMP(threads_count, 1, GOREC_POOL_MAX_THREADS);
+	pool->generation = 0;
+	pool->working_count = 0;
+	pool->quit = 0;
+	pool->job = 0;
+	pool->job_data = 0;
+	pool->jobs_count = 0;
+	pool->chunks_count = 0;
+	pool->next_chunk = 0;
+
+	GOREC_MUTEX_INIT(&pool->mutex);
+	GOREC_CONDVAR_INIT(&pool->cond_work);
+	GOREC_CONDVAR_INIT(&pool->cond_done);
+
+	for (i = 0; i < pool->threads_count; i++) {
+		pool->workers[i].pool = pool;
+		pool->workers[i].index = i;
+		pool->workers[i].arena = (gorec_arena*)stack + i;
 	}
 
-	gorec_pt_clear(&result);
-	//NOTE(dima): Step 3 - Compute result using precomputed values
-	for (i = NAFLength - 1; i >= 0; i--) {
-		gorec_pt_double_jacobian(&result, &result, crv);
-		if (NAF[i] != 0) {
-			if (NAF[i] > 0) {
-				gorec_pt_add_jacobian(&result, &result, &PrecomputePoints[NAF[i] >> 1], crv);
-			}
-			else {
-				gorec_pt_sub_jacobian(&result, &result, &PrecomputePoints[(-NAF[i]) >> 1], crv);
-			}
+	for (i = 1; i < pool->threads_count; i++) {
+#if defined(_WIN32)
+		pool->threads[i] = CreateThread(0, 0, _gorec_pool_thread_proc, &pool->workers[i], 0, 0);
+		int started = (pool->threads[i] != 0);
+#else
+		int started = (pthread_create(&pool->threads[i], 0, _gorec_pool_thread_proc, &pool->workers[i]) == 0);
+#endif
+		if (!started) {
+			_gorec_pool_stop(pool, i - 1);
+
+			return(0);
 		}
 	}
 
-	//NOTE(dima): Exit from Jacobian coordinates
-	gorbn_sqr_mod(temp_for_exit, result.z, crv->p);
-	gorbn_inv_mod(temp_for_exit, temp_for_exit, crv->p);
-	gorbn_mul_mod(result.x, temp_for_exit, result.x, crv->p);
+	return(1);
+}
 
-	gorbn_sqr_mod(temp_for_exit, result.z, crv->p);
-	gorbn_mul_mod(temp_for_exit, temp_for_exit, result.z, crv->p);
-	gorbn_inv_mod(temp_for_exit, temp_for_exit, crv->p);
-	gorbn_mul_mod(result.y, temp_for_exit, result.y, crv->p);
+void gorec_pool_free(gorec_pool* pool) {
+	_gorec_pool_stop(pool, pool->threads_count - 1);
+}
 
-	gorbn_from_int(result.z, 1);
+/*Runs job on jobs_count jobs on all workers and waits for completion*/
+static void _gorec_pool_run(gorec_pool* pool, gorec_pool_job_type* job, void* job_data, int jobs_count) {
+	GOREC_MUTEX_LOCK(&pool->mutex);
+	pool->job = job;
+	pool->job_data = job_data;
+	pool->jobs_count = jobs_count;
+	pool->chunks_count = (jobs_count + GOREC_POOL_CHUNK - 1) / GOREC_POOL_CHUNK;
+	pool->next_chunk = 0;
+	pool->working_count = pool->threads_count - 1;
+	pool->generation++;
+	GOREC_CONDVAR_BROADCAST(&pool->cond_work);
+	GOREC_MUTEX_UNLOCK(&pool->mutex);
+
+	_gorec_pool_work(pool, pool->workers[0].arena);
+
+	GOREC_MUTEX_LOCK(&pool->mutex);
+	while (pool->working_count > 0) {
+		GOREC_CONDVAR_WAIT(&pool->cond_done, &pool->mutex);
+	}
+	GOREC_MUTEX_UNLOCK(&pool->mutex);
+}
 
-	gorec_pt_copy(p_result, &result);
+typedef struct gorec_pool_mul_data {
+	gorec_point* p_results;
+	gorec_point* p_points;
+	gorbn_t* p_scalars;
+	gorec_curve* crv;
+} gorec_pool_mul_data;
+
+static GOREC_POOL_JOB(_gorec_pool_job_mul) {
+	gorec_pool_mul_data* data = (gorec_pool_mul_data*)pool->job_data;
+#if defined(GOREC_LANES_AVX512) || defined(GOREC_LANES_AVX2)
+	gorec_pt_mul_batch_arena(
+		data->p_results + first,
+		data->p_points + first,
+		data->p_scalars + first * GORBN_SZARR,
+		count,
+		data->crv,
+		arena);
+#else
+	int i;
+
+	for (i = first; i < first + count; i++) {
+		gorec_pt_mul_ct_arena(
+			data->p_results + i,
+			data->p_points + i,
+			data->p_scalars + i * GORBN_SZARR,
+			data->crv,
+			arena);
+	}
+#endif
 }
 
-/*
-	Умножение точки эллиптической кривой на скаляр
+void gorec_mul_batch(
+	gorec_pool* pool,
+	gorec_point* p_results,
+	gorec_point* p_points,
+	gorbn_t* p_scalars,
+	int count,
+	gorec_curve* crv)
+{
+	gorec_pool_mul_data data;
+	data.p_results = p_results;
+	data.p_points = p_points;
+	data.p_scalars = p_scalars;
+	data.crv = crv;
 
-	p_result - указатель на результат - точку эллиптической кривой
-	p_point - указатель на точку, которую будем умножать
-	p_scalar - указатель на скалял, на который будем умножать p_point
-	crv - указатель на структуру с параметрами эллиптической кривой
-*/
+	_gorec_pool_run(pool, _gorec_pool_job_mul, &data, count);
+}
+
+typedef struct gorec_pool_verify_data {
+	int* p_results;
+	gorec_point* p_points;
+	gorbn_t* p_scalars_g;
+	gorbn_t* p_scalars_p;
+	gorbn_t* p_rs;
+	gorec_curve* crv;
+} gorec_pool_verify_data;
+
+static GOREC_POOL_JOB(_gorec_pool_job_verify) {
+	gorec_pool_verify_data* data = (gorec_pool_verify_data*)pool->job_data;
+	gorec_point* res = &arena->job_result;
+	int i;
+
+	for (i = first; i < first + count; i++) {
+		gorec_pt_mul2_arena(
+			res,
+			data->p_scalars_g + i * GORBN_SZARR,
+			data->p_points + i,
+			data->p_scalars_p + i * GORBN_SZARR,
+			data->crv,
+			arena);
+
+		int is_valid = 0;
+		if (!res->is_inf) {
+			gorbn_t x_wide[GORBN_SZARR * 2];
+			gorbn_init(x_wide, GORBN_SZARR * 2);
+			gorbn_copy(x_wide, res->x);
+
+			gorbn_init(res->x, GORBN_SZARR);
+			gorbn_barrett_reduce(res->x, x_wide, &data->crv->q_barrett);
+			is_valid = (gorbn_cmp(res->x, data->p_rs + i * GORBN_SZARR) == GORBN_CMP_EQUAL);
+		}
+
+		data->p_results[i] = is_valid;
+	}
+}
+
+void gorec_verify_batch(
+	gorec_pool* pool,
+	int* p_results,
+	gorec_point* p_points,
+	gorbn_t* p_scalars_g,
+	gorbn_t* p_scalars_p,
+	gorbn_t* p_rs,
+	int count,
+	gorec_curve* crv)
+{
+	gorec_pool_verify_data data;
+	data.p_results = p_results;
+	data.p_points = p_points;
+	data.p_scalars_g = p_scalars_g;
+	data.p_scalars_p = p_scalars_p;
+	data.p_rs = p_rs;
+	data.crv = crv;
+
+	_gorec_pool_run(pool, _gorec_pool_job_verify, &data, count);
+}
+#endif
 
 void gorec_pt_mul(
 	gorec_point* p_result,
@@ -1522,15 +5609,23 @@ void gorec_pt_mul(
 	int i;
 	int t = _gorbn_get_nbits(p_scalar, GORBN_SZARR);
 
+	gorec_point pt;
+	gorec_pt_to_field(&pt, p_point, crv);
+
 	gorec_pt_clear(p_result);
 
 	for (i = t - 1; i >= 0; i--) {
 		gorec_pt_double(p_result, p_result, crv);
 
 		if (_gorbn_testbit(p_scalar, i)) {
-			gorec_pt_add(p_result, p_result, p_point, crv);
+			gorec_pt_add(p_result, p_result, &pt, crv);
 		}
 	}
+
+	crv->from_field(p_result->x, p_result->x, crv);
+	crv->from_field(p_result->y, p_result->y, crv);
+	//NOTE(dima): z of affine routines is one of the field representation
+	gorbn_from_int(p_result->z, 1);
 }
 
 void gorec_pt_mul_jacobian(
@@ -1543,153 +5638,270 @@ void gorec_pt_mul_jacobian(
 	int t = _gorbn_get_nbits(s, GORBN_SZARR);
 
 	gorec_point result;
-	gorbn_t temp[GORBN_SZARR];
+	gorec_point pt;
 	gorec_pt_clear(&result);
+	gorec_pt_to_field(&pt, p, crv);
 
 	for (i = t - 1; i >= 0; i--) {
-		gorec_pt_double_jacobian(&result, &result, crv);
+		crv->pt_double(&result, &result, crv);
 
 		if (_gorbn_testbit(s, i)) {
-			gorec_pt_add_jacobian(&result, &result, p, crv);
+			gorec_pt_add_jacobian(&result, &result, &pt, crv);
 		}
 	}
 
 	//NOTE(dima): Exit from Jacobian coordinates
-	gorbn_sqr_mod(temp, result.z, crv->p);
-	gorbn_inv_mod(temp, temp, crv->p);
-	gorbn_mul_mod(result.x, temp, result.x, crv->p);
-
-	gorbn_sqr_mod(temp, result.z, crv->p);
-	gorbn_mul_mod(temp, temp, result.z, crv->p);
-	gorbn_inv_mod(temp, temp, crv->p);
-	gorbn_mul_mod(result.y, temp, result.y, crv->p);
+	gorec_pt_normalize(&result, &result, crv);
 
+	crv->from_field(result.x, result.x, crv);
+	crv->from_field(result.y, result.y, crv);
 	gorbn_from_int(result.z, 1);
 
 	gorec_pt_copy(r, &result);
 }
 
+/*a <-> b if cond, without branches*/
+static void _gorec_cswap(gorbn_t* a, gorbn_t* b, int cond) {
+	gorbn_t mask = (gorbn_t)0 - (gorbn_t)(cond != 0);
+	int i;
+
+	for (i = 0; i < GORBN_SZARR; i++) {
+		gorbn_t t = (a[i] ^ b[i]) & mask;
+		a[i] ^= t;
+		b[i] ^= t;
+	}
+}
+
+/*
+	Co-Z addition with update (Meloni): P = (x1, y1) and Q = (x2, y2)
+	share Z. Gives P + Q in (x2, y2) and P in (x1, y1), both with
+	Z' = Z * dz, dz = x2 - x1. 4M + 2S.
+*/
+static void _gorec_xycz_add(gorbn_t* x1, gorbn_t* y1, gorbn_t* x2, gorbn_t* y2, gorbn_t* dz, gorec_curve* crv) {
+	gorbn_t A[GORBN_SZARR];
+	gorbn_t B[GORBN_SZARR];
+	gorbn_t C[GORBN_SZARR];
+	gorbn_t D[GORBN_SZARR];
+
+	_gorec_sub_mod(dz, x2, x1, crv);
+	crv->sqr_mod(A, dz, crv);
+	crv->mul_mod(B, x1, A, crv);
+	crv->mul_mod(C, x2, A, crv);
+
+	_gorec_sub_mod(D, y2, y1, crv);
+	crv->sqr_mod(A, D, crv);
+
+	/*y1 = E = y1 * (C - B)*/
+	_gorec_sub_mod(C, C, B, crv);
+	crv->mul_mod(y1, y1, C, crv);
+
+	/*x3 = D ^ 2 - B - C, C already holds C - B*/
+	_gorec_sub_mod(x2, A, B, crv);
+	_gorec_sub_mod(x2, x2, B, crv);
+	_gorec_sub_mod(x2, x2, C, crv);
+
+	/*y3 = (y2 - y1) * (B - x3) - E*/
+	_gorec_sub_mod(A, B, x2, crv);
+	crv->mul_mod(y2, D, A, crv);
+	_gorec_sub_mod(y2, y2, y1, crv);
+
+	gorbn_copy(x1, B);
+}
+
+/*
+	Conjugate co-Z addition (Goundar, Joye, Miyaji): P + Q in (x2, y2)
+	and P - Q in (x1, y1), both with Z' = Z * dz, dz = x2 - x1. 5M + 3S.
+*/
+static void _gorec_xycz_addc(gorbn_t* x1, gorbn_t* y1, gorbn_t* x2, gorbn_t* y2, gorbn_t* dz, gorec_curve* crv) {
+	gorbn_t A[GORBN_SZARR];
+	gorbn_t B[GORBN_SZARR];
+	gorbn_t C[GORBN_SZARR];
+	gorbn_t D[GORBN_SZARR];
+	gorbn_t E[GORBN_SZARR];
+	gorbn_t F[GORBN_SZARR];
+
+	_gorec_sub_mod(dz, x2, x1, crv);
+	crv->sqr_mod(A, dz, crv);
+	crv->mul_mod(B, x1, A, crv);
+	crv->mul_mod(C, x2, A, crv);
+
+	/*E = y1 * (C - B), C becomes B + C*/
+	_gorec_sub_mod(A, C, B, crv);
+	crv->mul_mod(E, y1, A, crv);
+	_gorec_add_mod(C, C, B, crv);
+
+	_gorec_sub_mod(D, y2, y1, crv);
+	_gorec_add_mod(F, y2, y1, crv);
+
+	/*x3 = (y2 - y1) ^ 2 - B - C, y3 = (y2 - y1) * (B - x3) - E*/
+	crv->sqr_mod(A, D, crv);
+	_gorec_sub_mod(x2, A, C, crv);
+	_gorec_sub_mod(A, B, x2, crv);
+	crv->mul_mod(y2, D, A, crv);
+	_gorec_sub_mod(y2, y2, E, crv);
+
+	/*x3' = (y1 + y2) ^ 2 - B - C, y3' = (y1 + y2) * (x3' - B) - E*/
+	crv->sqr_mod(A, F, crv);
+	_gorec_sub_mod(x1, A, C, crv);
+	_gorec_sub_mod(A, x1, B, crv);
+	crv->mul_mod(y1, F, A, crv);
+	_gorec_sub_mod(y1, y1, E, crv);
+}
+
+/*
+	Co-Z Montgomery ladder on (X, Y) coordinates (Rivain, "Fast and
+	regular algorithms for scalar multiplication over elliptic curves").
+	R0 = m * p and R1 = (m + 1) * p share Z, every bit is one conjugate
+	addition and one addition with update, 9M + 5S, so the sequence of
+	operations does not depend on s.
+
+	s is taken as k = min(s, q - s) with the result negated for q - s,
+	and is padded to k + q or k + 2q of exactly bits(q) + 1 bits. This
+	leaves k = 1 as the only scalar for which the ladder meets a point
+	at infinity or two equal x, and it is selected out with cmov. Z is
+	not kept: at the end R_b = +-p and Z = +-Y_b * x / (X_b * y), so the
+	only inversion gives both coordinates. Z is tracked for x = 0
+	(g of STB), this branches only on p.
+*/
 void gorec_pt_mul_monty(
 	gorec_point* p_result,
 	gorec_point *p_point,
 	gorbn_t *p_scalar,
 	gorec_curve* crv)
 {
-	int t = _gorbn_get_nbits(p_scalar, GORBN_SZARR);
-
+	gorbn_t k[GORBN_SZARR];
+	gorbn_t temp[GORBN_SZARR];
+	gorbn_t X0[GORBN_SZARR];
+	gorbn_t Y0[GORBN_SZARR];
 	gorbn_t X1[GORBN_SZARR];
-	gorbn_t Z1[GORBN_SZARR];
-	gorbn_t X2[GORBN_SZARR];
-	gorbn_t Z2[GORBN_SZARR];
-	gorbn_t T[GORBN_SZARR];
+	gorbn_t Y1[GORBN_SZARR];
+	gorbn_t Z[GORBN_SZARR];
+	gorbn_t dz[GORBN_SZARR];
+	gorbn_t lambda[GORBN_SZARR];
+	gorec_point pt;
+	int i;
 
-	gorbn_t TMP[GORBN_SZARR];
-	gorbn_t TMP2[GORBN_SZARR];
-
-	gorbn_init(X1, GORBN_SZARR);
-	gorbn_init(X2, GORBN_SZARR);
-	gorbn_init(Z1, GORBN_SZARR);
-	gorbn_init(Z2, GORBN_SZARR);
-	gorbn_init(T, GORBN_SZARR);
-	gorbn_init(TMP, GORBN_SZARR);
-	gorbn_init(TMP2, GORBN_SZARR);
-
-	/*X1 <- x*/
-	gorbn_copy(X1, p_point->x);
-	/*Z1 <- 1*/
-	gorbn_from_int(Z1, 1);
-	/*X2 <- x^4 + b*/
-	gorbn_sqr_mod(X2, p_point->x, crv->p);
-	gorbn_sqr_mod(X2, X2, crv->p);
-	gorbn_add_mod(X2, X2, crv->b, crv->p);
-	/*Z2<-x^2*/
-	//gorbn_copy(X2, p_point->x, GORBN_SZARR);
-	gorbn_sqr_mod(Z2, p_point->x, crv->p);
-
-	for (int i = t - 2; i >= 0; i--) {
-		int bit_is_set = _gorbn_testbit(p_scalar, i);
-		if (bit_is_set) {
-			/*T<-Z1*/
-			gorbn_copy(T, Z1);
-			/*Z1 <- (X1Z2 + X2Z1)^2 */
-			gorbn_mul_mod(Z1, X2, Z1, crv->p);
-			gorbn_mul_mod(TMP, X1, Z2, crv->p);
-			gorbn_add_mod(Z1, TMP, Z1, crv->p);
-			gorbn_sqr_mod(Z1, Z1, crv->p);
-			/*X1 <- xZ1 + X1X2TZ2*/
-			gorbn_mul_mod(X1, X1, X2, crv->p);
-			gorbn_mul_mod(X1, X1, T, crv->p);
-			gorbn_mul_mod(X1, X1, Z2, crv->p);
-			gorbn_mul_mod(TMP, p_point->x, Z1, crv->p);
-			gorbn_add_mod(X1, X1, TMP, crv->p);
-			/*T <- X2*/
-			gorbn_copy(T, X2);
-			/*X2 <- X2^4 + b*Z2^4 */
-			gorbn_sqr_mod(X2, X2, crv->p);
-			gorbn_sqr_mod(X2, X2, crv->p);
-			gorbn_sqr_mod(TMP2, Z2, crv->p);
-			gorbn_sqr_mod(TMP, TMP2, crv->p);
-			gorbn_mul_mod(TMP, TMP, crv->b, crv->p);
-			gorbn_add_mod(X2, X2, TMP, crv->p);
-			/*Z2 <- (T^2)(Z2^2)*/
-			gorbn_sqr_mod(TMP, T, crv->p);
-			gorbn_mul_mod(Z2, TMP2, TMP, crv->p);
+	if (p_point->is_inf || gorbn_is_zero(crv->q)) {
+		gorec_pt_mul_wnaf_jacobian(p_result, p_point, p_scalar, crv);
+		return;
+	}
+
+	gorec_pt_to_field(&pt, p_point, crv);
+	int track_z = gorbn_is_zero(p_point->x);
+	int q_bits = _gorbn_get_nbits(crv->q, GORBN_SZARR);
+
+	//NOTE(dima): k = min(s, q - s), borrow of (q - 1) / 2 - s tells which one without branches
+	gorbn_rshift(temp, crv->q, 1);
+	int is_negated = gorbn_sub(temp, temp, p_scalar);
+	gorbn_sub(temp, crv->q, p_scalar);
+	gorbn_copy(k, p_scalar);
+	gorbn_cmov(k, temp, is_negated);
+
+	gorbn_t k_diff_one = k[0] ^ 1;
+	gorbn_t k_nonzero = k[0];
+	for (i = 1; i < GORBN_SZARR; i++) {
+		k_diff_one |= k[i];
+		k_nonzero |= k[i];
+	}
+
+	//NOTE(dima): k + q has the top bit q_bits or k + 2 * q has, the bit can be the carry for q of full length
+	int carry = gorbn_add(k, k, crv->q);
+	int has_top = (q_bits == GORBN_SZARR_BITS_TOTAL) ? carry : _gorbn_testbit(k, q_bits);
+	gorbn_add(temp, k, crv->q);
+	gorbn_cmov(k, temp, !has_top);
+
+	/*(R1, R0) = (2p, p) with Z = 2y*/
+	crv->sqr_mod(temp, pt.x, crv);
+	_gorec_add_mod(lambda, temp, temp, crv);
+	_gorec_add_mod(lambda, lambda, temp, crv);
+	_gorec_add_mod(lambda, lambda, crv->fa, crv);
+	crv->sqr_mod(temp, pt.y, crv);
+	crv->mul_mod(X0, pt.x, temp, crv);
+	_gorec_add_mod(X0, X0, X0, crv);
+	_gorec_add_mod(X0, X0, X0, crv);
+	crv->sqr_mod(Y0, temp, crv);
+	_gorec_add_mod(Y0, Y0, Y0, crv);
+	_gorec_add_mod(Y0, Y0, Y0, crv);
+	_gorec_add_mod(Y0, Y0, Y0, crv);
+	crv->sqr_mod(X1, lambda, crv);
+	_gorec_sub_mod(X1, X1, X0, crv);
+	_gorec_sub_mod(X1, X1, X0, crv);
+	_gorec_sub_mod(temp, X0, X1, crv);
+	crv->mul_mod(Y1, lambda, temp, crv);
+	_gorec_sub_mod(Y1, Y1, Y0, crv);
+	_gorec_add_mod(Z, pt.y, pt.y, crv);
+
+	//NOTE(dima): R_b is kept in (X0, Y0) and R_(1 - b) in (X1, Y1), swapping when b changes
+	int swapped = 0;
+	for (i = q_bits - 1; i >= 0; i--) {
+		int b = _gorbn_testbit(k, i);
+		_gorec_cswap(X0, X1, b ^ swapped);
+		_gorec_cswap(Y0, Y1, b ^ swapped);
+		swapped = b;
+
+		/*(R_(1 - b), R_b) = (R_b + R_(1 - b), R_b - R_(1 - b))*/
+		_gorec_xycz_addc(X0, Y0, X1, Y1, dz, crv);
+		if (track_z) {
+			crv->mul_mod(Z, Z, dz, crv);
 		}
-		else {
-			/*T <- Z2*/
-			gorbn_copy(T, Z2);
-			/*Z2 <- (X1Z2 + X2Z1)^2 */
-			gorbn_mul_mod(Z2, X1, Z2, crv->p);
-			gorbn_mul_mod(TMP, X2, Z1, crv->p);
-			gorbn_add_mod(Z2, TMP, Z2, crv->p);
-			gorbn_sqr_mod(Z2, Z2, crv->p);
-			/*X2 <- xZ2 + X1X2Z1T*/
-			gorbn_mul_mod(X2, X1, X2, crv->p);
-			gorbn_mul_mod(X2, X2, Z1, crv->p);
-			gorbn_mul_mod(X2, X2, T, crv->p);
-			gorbn_mul_mod(TMP, Z2, p_point->x, crv->p);
-			gorbn_add_mod(X2, X2, TMP, crv->p);
-			/*T <- X1*/
-			gorbn_copy(T, X1);
-			/*X1 <- (X1^4) + (b * Z1^4) */
-			gorbn_sqr_mod(X1, X1, crv->p);
-			gorbn_sqr_mod(X1, X1, crv->p);
-			gorbn_sqr_mod(TMP2, Z1, crv->p);
-			gorbn_sqr_mod(TMP, TMP2, crv->p);
-			gorbn_mul_mod(TMP, TMP, crv->b, crv->p);
-			gorbn_add_mod(X1, X1, TMP, crv->p);
-			/*Z1 <- T^2 * Z1^2 */
-			gorbn_sqr_mod(TMP, T, crv->p);
-			gorbn_mul_mod(Z1, TMP2, TMP, crv->p);
-		}
-	}
-
-	/*x3 <- X1/Z1*/
-	gorbn_inv_mod(TMP, Z1, crv->p);
-	gorbn_mul_mod(p_result->x, X1, TMP, crv->p);
-
-	/*y3 <- (x + X1/Z1)[(X1 + xZ1)(X2 + xZ2) + (XX + y)(Z1Z2)](xZ1Z2)^-1 + y */
-	gorbn_add_mod(p_result->y, p_point->x, p_result->x, crv->p);
-	gorbn_mul_mod(TMP2, Z1, Z2, crv->p); /*TMP2 = Z1 * Z2;*/
-
-	gorbn_mul_mod(Z1, p_point->x, Z1, crv->p);/*Z1 no longer needed after this operation*/
-	gorbn_add_mod(Z1, Z1, X1, crv->p);/*X1 no longer needed after this operation*/
-
-	gorbn_mul_mod(Z2, p_point->x, Z2, crv->p);/*Z2 no longer needed after this operation*/
-	gorbn_add_mod(Z2, Z2, X2, crv->p);/*X2 no longer needed after this operation*/
-
-	gorbn_mul_mod(Z1, Z1, Z2, crv->p);
-
-	gorbn_sqr_mod(TMP, p_point->x, crv->p);
-	gorbn_add_mod(TMP, TMP, p_point->y, crv->p);
-	gorbn_mul_mod(TMP, TMP, TMP2, crv->p);
-	gorbn_add_mod(TMP, TMP, Z1, crv->p);
-
-	gorbn_mul_mod(TMP2, TMP2, p_point->x, crv->p);
-	gorbn_inv_mod(TMP2, TMP2, crv->p);
-	gorbn_mul_mod(TMP, TMP, TMP2, crv->p);
-	gorbn_mul_mod(p_result->y, p_result->y, TMP, crv->p);
-	gorbn_add_mod(p_result->y, p_result->y, p_point->y, crv->p);
+
+		if (i == 0) {
+			/*R_b = +-p now, lambda = 1 / Z of the final addition*/
+			if (track_z) {
+				_gorec_sub_mod(dz, X0, X1, crv);
+				crv->mul_mod(temp, Z, dz, crv);
+			}
+			else {
+				_gorec_sub_mod(dz, X0, X1, crv);
+				crv->mul_mod(temp, Y0, pt.x, crv);
+				crv->mul_mod(temp, temp, dz, crv);
+
+				//NOTE(dima): R_b = -p for b = 0
+				gorbn_init(lambda, GORBN_SZARR);
+				_gorec_sub_mod(lambda, lambda, temp, crv);
+				gorbn_cmov(temp, lambda, !b);
+			}
+
+			if (gorbn_is_pseudo_mersenne_n(crv->p, crv->n)) {
+				_gorec_inv_mod_chain(lambda, temp, crv);
+			}
+			else {
+				_gorec_inv_mod_fermat(lambda, temp, crv);
+			}
+
+			if (!track_z) {
+				crv->mul_mod(lambda, lambda, X0, crv);
+				crv->mul_mod(lambda, lambda, pt.y, crv);
+			}
+		}
+
+		/*R_b = R_(1 - b) + R_b = 2 * R_b, R_(1 - b) gets updated Z*/
+		_gorec_xycz_add(X1, Y1, X0, Y0, dz, crv);
+		if (track_z) {
+			crv->mul_mod(Z, Z, dz, crv);
+		}
+	}
+
+	//NOTE(dima): R0 = k * p is R_b for b = 0 and R_(1 - b) for b = 1
+	_gorec_cswap(X0, X1, swapped);
+	_gorec_cswap(Y0, Y1, swapped);
+
+	crv->sqr_mod(temp, lambda, crv);
+	crv->mul_mod(X0, X0, temp, crv);
+	crv->mul_mod(temp, temp, lambda, crv);
+	crv->mul_mod(Y0, Y0, temp, crv);
+
+	gorbn_cmov(X0, pt.x, k_diff_one == 0);
+	gorbn_cmov(Y0, pt.y, k_diff_one == 0);
+
+	gorbn_init(temp, GORBN_SZARR);
+	_gorec_sub_mod(temp, temp, Y0, crv);
+	gorbn_cmov(Y0, temp, is_negated);
+
+	crv->from_field(p_result->x, X0, crv);
+	crv->from_field(p_result->y, Y0, crv);
+	gorbn_from_int(p_result->z, 1);
+	p_result->is_inf = (k_nonzero == 0);
 }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,897 @@
+/*
+	ABOUT:
+		Microbenchmark of the big number engines of this repository:
+		gorbn_ (gor_bignum.h), BN_ (bignum_roma.h), bignum_ (dima_bignum.h),
+		ec/zz (ecurva.h) and the templates of gor_fixed.h ("gorfx").
+		Measures time and cycles per operation for basic arithmetic, modular
+		arithmetic and scalar multiplication on the STB 34.101.45 curve.
+
+	BUILD:
+		g++ -O2 gor_bignum_bench.cpp bignum_roma.cpp gor_fixed_c.cpp -o gor_bignum_bench
+
+		Word sizes are chosen at compile time, so one executable measures
+		one configuration. Build one per configuration to cover all of them:
+			for w in 1 2 4 8; do
+				g++ -O2 -DGORBN_SZWORD=$w gor_bignum_bench.cpp bignum_roma.cpp gor_fixed_c.cpp -o bench_$w
+				./bench_$w > bench_$w.json
+			done
+		DBN_SZWORD (1, 2 or 4) selects word size of dima_bignum.h the same way.
+		bignum_roma.h has fixed 8-bit words. gor_fixed.h takes sizes as template
+		parameters, so every build measures its 256, 384 and 512-bit fields
+		with 64-bit limbs (32-bit without unsigned __int128). It needs C++14.
+		gor_fixed_c.cpp gives its fields to gorec_curve through the C
+		interface of gor_fixed_c.h, measured as "gorfx" c_* operations.
+
+		gorec_pt_mul_batch() runs its lanes on AVX2 or AVX-512F when the
+		compiler targets them, pt_mul_batch is time per point:
+			g++ -O2 -mavx2 gor_bignum_bench.cpp bignum_roma.cpp gor_fixed_c.cpp -o bench_avx2
+			g++ -O2 -mavx512f gor_bignum_bench.cpp bignum_roma.cpp gor_fixed_c.cpp -o bench_avx512
+
+		ecMulA() of ecurva.h (the bee2 engine of this repository) is measured
+		as "ecurva". Define GORBN_BENCH_BEE2 and build against bee2 to measure
+		the original library as "bee2" instead:
+			g++ -O2 -DGORBN_BENCH_BEE2 -I<bee2>/include gor_bignum_bench.cpp bignum_roma.cpp gor_fixed_c.cpp -lbee2
+
+	USAGE:
+		gor_bignum_bench [min_ms]
+
+		Every operation runs for at least min_ms milliseconds (100 by default).
+		JSON with configuration and results is written to stdout, readable
+		table to stderr. Results are integers: total iterations, nanoseconds
+		and cycles (0 where the time stamp counter is not available), so
+		per-operation values are total / iterations.
+
+		Results of gorec_pt_mul_ct(), of gorec_pt_mul_batch() and ecMulA()
+		against it and of the gor_fixed.h fields are checked before measurements, the benchmark
+		exits with 1 and writes nothing to stdout if they are wrong.
+*/
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#include <intrin.h>
+#else
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+#endif
+
+#define GOR_BIGNUM_IMPLEMENTATION
+#include "gor_bignum.h"
+
+#include "bignum_roma.h"
+
+#define DIMA_BIGNUM_IMPLEMENTATION
+#include "dima_bignum.h"
+
+#define DIMA_JSON_WRITER_IMPLEMENTATION
+#include "dima_json_writer.h"
+
+#include "gor_fixed.h"
+#include "gor_fixed_c.h"
+
+#ifdef GORBN_BENCH_BEE2
+#include <bee2/crypto/bign.h>
+#include <bee2/math/ec.h>
+#include <bee2/math/ww.h>
+
+/*NOTE(dima): Not in public headers of bee2, see bignStart() in ecurva.h*/
+extern "C" err_t bignStart(void* state, const bign_params* params);
+extern "C" size_t bignStart_keep(size_t l, bign_deep_i deep);
+#define BENCH_BEE2_ENGINE "bee2"
+#else
+#define ECURVA_IMPLEMENTATION
+#include "ecurva.h"
+#define BENCH_BEE2_ENGINE "ecurva"
+#endif
+
+#if defined(GOREC_LANES_AVX512)
+#define BENCH_LANES_SIMD "avx512"
+#elif defined(GOREC_LANES_AVX2)
+#define BENCH_LANES_SIMD "avx2"
+#else
+#define BENCH_LANES_SIMD "none"
+#endif
+
+#if defined(_WIN32) || defined(__x86_64__) || defined(__i386__)
+#define BENCH_HAS_RDTSC 1
+#else
+#define BENCH_HAS_RDTSC 0
+#endif
+
+static uint64_t bench_nanoseconds() {
+#if defined(_WIN32)
+	LARGE_INTEGER counter, freq;
+	QueryPerformanceCounter(&counter);
+	QueryPerformanceFrequency(&freq);
+
+	return((uint64_t)((double)counter.QuadPart * 1000000000.0 / (double)freq.QuadPart));
+#else
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return((uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec);
+#endif
+}
+
+static uint64_t bench_cycles() {
+#if BENCH_HAS_RDTSC
+	return(__rdtsc());
+#else
+	return(0);
+#endif
+}
+
+typedef struct bench_state {
+	uint64_t min_ns;
+
+	uint64_t iterations;
+	uint64_t total_ns;
+	uint64_t total_cycles;
+
+	uint64_t batch;
+	uint64_t start_ns;
+	uint64_t start_cycles;
+} bench_state;
+
+static json_writer bench_writer;
+static uint64_t bench_min_ns = 100000000ull;
+
+/*NOTE(dima): Results are folded in here so that compiler can not drop benchmarked calls*/
+static volatile uint64_t bench_sink;
+
+static void bench_begin(bench_state* st) {
+	st->min_ns = bench_min_ns;
+	st->iterations = 0;
+	st->total_ns = 0;
+	st->total_cycles = 0;
+	st->batch = 1;
+	st->start_ns = bench_nanoseconds();
+	st->start_cycles = bench_cycles();
+}
+
+/*Returns 1 while another batch of iterations is needed*/
+static int bench_step(bench_state* st) {
+	uint64_t end_cycles = bench_cycles();
+	uint64_t end_ns = bench_nanoseconds();
+
+	st->iterations += st->batch;
+	st->total_ns += end_ns - st->start_ns;
+	st->total_cycles += end_cycles - st->start_cycles;
+
+	if (st->total_ns >= st->min_ns) {
+		return(0);
+	}
+
+	//NOTE(dima): Batches grow so that timer overhead stays small for fast operations
+	if (st->total_ns < st->min_ns / 8) {
+		st->batch *= 2;
+	}
+
+	st->start_ns = bench_nanoseconds();
+	st->start_cycles = bench_cycles();
+
+	return(1);
+}
+
+static void bench_report(const char* engine, const char* op, bench_state* st) {
+	JSONBegin(&bench_writer);
+	JSONAddSTR(&bench_writer, (char*)"engine", (char*)engine);
+	JSONAddSTR(&bench_writer, (char*)"op", (char*)op);
+	JSONAddU64(&bench_writer, (char*)"iterations", st->iterations);
+	JSONAddU64(&bench_writer, (char*)"total_ns", st->total_ns);
+	JSONAddU64(&bench_writer, (char*)"total_cycles", st->total_cycles);
+	JSONEnd(&bench_writer);
+
+	fprintf(stderr, "%-8s %-24s %14.1f ns/op %14.1f cycles/op\n",
+		engine, op,
+		(double)st->total_ns / (double)st->iterations,
+		(double)st->total_cycles / (double)st->iterations);
+}
+
+/*
+	NOTE(dima): Runs code in growing batches until bench_min_ns passed,
+	then reports results. Warm-up run is done before measurement.
+	BENCH_PER is for code that does per operations at once, results are
+	per operation.
+*/
+#define BENCH_PER(engine, op, per, code) do {\
+		bench_state bench_st;\
+		uint64_t bench_i;\
+		{ code; }\
+		bench_begin(&bench_st);\
+		do {\
+			for (bench_i = 0; bench_i < bench_st.batch; bench_i++) {\
+				code;\
+			}\
+		} while (bench_step(&bench_st));\
+		bench_st.iterations *= (per);\
+		bench_report(engine, op, &bench_st);\
+	} while (0)
+#define BENCH(engine, op, code) BENCH_PER(engine, op, 1, code)
+
+/*NOTE(dima): Points of pt_mul_batch, a multiple of lanes of every build*/
+#define BENCH_BATCH_COUNT 64
+
+/*NOTE(dima): xorshift64, so that inputs are the same from run to run*/
+static uint64_t bench_rng_state = 0x9E3779B97F4A7C15ull;
+
+static void bench_random_bytes(unsigned char* data, int count) {
+	int i;
+	for (i = 0; i < count; i++) {
+		bench_rng_state ^= bench_rng_state << 13;
+		bench_rng_state ^= bench_rng_state >> 7;
+		bench_rng_state ^= bench_rng_state << 17;
+
+		data[i] = (unsigned char)(bench_rng_state >> 32);
+	}
+}
+
+/*
+	NOTE(dima): Inputs of all engines are the same numbers: two field
+	elements below p (the top byte is cleared), and a scalar below q.
+*/
+static unsigned char bench_a_data[32];
+static unsigned char bench_b_data[32];
+static unsigned char bench_k_data[32];
+
+/*
+	NOTE(dima): Self-check of gorec_pt_mul_ct() against the variable-time
+	wNAF multiplication, run before measurements. Besides the random
+	scalar of the benchmark it takes scalars whose last window adds the
+	point to itself: s = 34 and s = q - 34 on NIST P-192 (q mod 64 = 49),
+	they are recoded to the same odd scalar q - 34 with d_0 = -17.
+	Numbers are big-endian here, as in the standard.
+*/
+static void bench_load_be(gorbn_t* n, const unsigned char* data, int size) {
+	unsigned char le[GORBN_SZARR * GORBN_SZWORD];
+	int i;
+	for (i = 0; i < size; i++) {
+		le[i] = data[size - 1 - i];
+	}
+	gorbn_from_data(n, le, (uint32_t)size);
+}
+
+static int bench_check_ct_scalar(gorec_curve* crv, gorbn_t* k, const char* name) {
+	gorec_point r_ct;
+	gorec_point r_wnaf;
+
+	gorec_pt_mul_ct(&r_ct, &crv->g, k, crv);
+	gorec_pt_mul_wnaf_jacobian(&r_wnaf, &crv->g, k, crv);
+
+	if (r_ct.is_inf != r_wnaf.is_inf ||
+		gorbn_cmp(r_ct.x, r_wnaf.x) != 0 ||
+		gorbn_cmp(r_ct.y, r_wnaf.y) != 0)
+	{
+		fprintf(stderr, "CHECK FAILED: gorec_pt_mul_ct, %s\n", name);
+		return(0);
+	}
+
+	return(1);
+}
+
+/*
+	NOTE(dima): Self-check of gorec_pt_mul_batch() against gorec_pt_mul_ct():
+	count is not a multiple of GOREC_LANES, so the last group is padded.
+	Points are g and its multiples by the scalars themselves.
+*/
+static int bench_check_batch(gorec_curve* crv, gorbn_t* scalars, int count, const char* name) {
+	gorec_point points[GOREC_LANES * 2 + 1];
+	gorec_point r_batch[GOREC_LANES * 2 + 1];
+	gorec_point r_ct;
+	int i;
+
+	for (i = 0; i < count; i++) {
+		if (i & 1) {
+			gorec_pt_mul_wnaf_jacobian(&points[i], &crv->g, scalars + i * GORBN_SZARR, crv);
+		}
+		else {
+			gorec_pt_copy(&points[i], &crv->g);
+		}
+	}
+
+	gorec_pt_mul_batch(r_batch, points, scalars, count, crv);
+
+	for (i = 0; i < count; i++) {
+		gorec_pt_mul_ct(&r_ct, &points[i], scalars + i * GORBN_SZARR, crv);
+
+		if (r_ct.is_inf != r_batch[i].is_inf ||
+			gorbn_cmp(r_ct.x, r_batch[i].x) != 0 ||
+			gorbn_cmp(r_ct.y, r_batch[i].y) != 0 ||
+			gorbn_cmp(r_ct.z, r_batch[i].z) != 0)
+		{
+			fprintf(stderr, "CHECK FAILED: gorec_pt_mul_batch, %s, point %d\n", name, i);
+			return(0);
+		}
+	}
+
+	return(1);
+}
+
+static int bench_check_gorbn() {
+	static const unsigned char p192_p[24] = {
+		0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+		0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFE,
+		0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	};
+	static const unsigned char p192_a[24] = {
+		0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+		0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFE,
+		0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFC,
+	};
+	static const unsigned char p192_b[24] = {
+		0x64, 0x21, 0x05, 0x19, 0xE5, 0x9C, 0x80, 0xE7,
+		0x0F, 0xA7, 0xE9, 0xAB, 0x72, 0x24, 0x30, 0x49,
+		0xFE, 0xB8, 0xDE, 0xEC, 0xC1, 0x46, 0xB9, 0xB1,
+	};
+	static const unsigned char p192_q[24] = {
+		0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+		0xFF, 0xFF, 0xFF, 0xFF, 0x99, 0xDE, 0xF8, 0x36,
+		0x14, 0x6B, 0xC9, 0xB1, 0xB4, 0xD2, 0x28, 0x31,
+	};
+	static const unsigned char p192_xG[24] = {
+		0x18, 0x8D, 0xA8, 0x0E, 0xB0, 0x30, 0x90, 0xF6,
+		0x7C, 0xBF, 0x20, 0xEB, 0x43, 0xA1, 0x88, 0x00,
+		0xF4, 0xFF, 0x0A, 0xFD, 0x82, 0xFF, 0x10, 0x12,
+	};
+	static const unsigned char p192_yG[24] = {
+		0x07, 0x19, 0x2B, 0x95, 0xFF, 0xC8, 0xDA, 0x78,
+		0x63, 0x10, 0x11, 0xED, 0x6B, 0x24, 0xCD, 0xD5,
+		0x73, 0xF9, 0x77, 0xA1, 0x1E, 0x79, 0x48, 0x11,
+	};
+
+	static gorec_curve crv;
+	memset(&crv, 0, sizeof(crv));
+	bench_load_be(crv.p, p192_p, sizeof(p192_p));
+	bench_load_be(crv.a, p192_a, sizeof(p192_a));
+	bench_load_be(crv.b, p192_b, sizeof(p192_b));
+	bench_load_be(crv.q, p192_q, sizeof(p192_q));
+	bench_load_be(crv.g.x, p192_xG, sizeof(p192_xG));
+	bench_load_be(crv.g.y, p192_yG, sizeof(p192_yG));
+	gorbn_from_int(crv.g.z, 1);
+	crv.g.is_inf = 0;
+	gorec_curve_setup(&crv);
+
+	gorbn_t k[GORBN_SZARR];
+	gorbn_t t[GORBN_SZARR];
+	int ok = 1;
+
+	gorbn_from_int(k, 34);
+	ok &= bench_check_ct_scalar(&crv, k, "P-192, s = 34");
+	gorbn_sub(k, crv.q, k);
+	ok &= bench_check_ct_scalar(&crv, k, "P-192, s = q - 34");
+
+	static gorec_curve stb;
+	gorec_load_stb128(&stb);
+	gorbn_from_data(t, bench_k_data, sizeof(bench_k_data));
+	gorbn_mod(k, t, GORBN_SZARR, stb.q);
+	ok &= bench_check_ct_scalar(&stb, k, "STB, random s");
+	gorbn_sub(k, stb.q, k);
+	ok &= bench_check_ct_scalar(&stb, k, "STB, q - random s");
+
+	//NOTE(dima): s = 34 and q - 34 in lanes next to random scalars
+	const int batch_count = GOREC_LANES * 2 + 1;
+	gorbn_t scalars[(GOREC_LANES * 2 + 1) * GORBN_SZARR];
+	int i;
+
+	for (i = 0; i < batch_count; i++) {
+		unsigned char data[24];
+		bench_random_bytes(data, sizeof(data));
+		gorbn_from_data(t, data, sizeof(data));
+		gorbn_mod(scalars + i * GORBN_SZARR, t, GORBN_SZARR, crv.q);
+	}
+	gorbn_from_int(scalars, 34);
+	gorbn_sub(scalars + 3 * GORBN_SZARR, crv.q, scalars);
+	ok &= bench_check_batch(&crv, scalars, batch_count, "P-192");
+
+	for (i = 0; i < batch_count; i++) {
+		unsigned char data[32];
+		bench_random_bytes(data, sizeof(data));
+		gorbn_from_data(t, data, sizeof(data));
+		gorbn_mod(scalars + i * GORBN_SZARR, t, GORBN_SZARR, stb.q);
+	}
+	gorbn_sub(scalars + GORBN_SZARR, stb.q, scalars);
+	ok &= bench_check_batch(&stb, scalars, batch_count, "STB");
+
+	return(ok);
+}
+
+/*
+	NOTE(dima): Self-check of ecMulA() against gorec_pt_mul_ct() on the STB
+	curve: the random scalar of the benchmark, 1, 2, q - 1 and 32 more
+	random scalars. Coordinates are compared as little-endian octets.
+*/
+static int bench_check_bee2() {
+	static gorec_curve stb;
+	gorec_load_stb128(&stb);
+
+	bign_params params;
+	bignStdParams(&params, "1.2.112.0.2.0.34.101.45.3.1");
+
+	void* state = malloc(bignStart_keep(params.l, 0));
+	bignStart(state, &params);
+
+	ec_o* ec = (ec_o*)state;
+	size_t n = ec->f->n;
+	size_t m = ec->f->n;
+	size_t no = ec->f->no;
+
+	word* d = (word*)malloc(O_OF_W(m));
+	word* res = (word*)malloc(O_OF_W(2 * n));
+	void* stack = malloc(ecMulA_deep(n, ec->d, ec->deep, m));
+
+	gorbn_t k[GORBN_SZARR];
+	gorbn_t t[GORBN_SZARR];
+	gorec_point r_ct;
+	unsigned char k_data[32];
+	unsigned char x_data[32];
+	unsigned char y_data[32];
+	unsigned char expected[32];
+	int ok = 1;
+	int i;
+
+	for (i = 0; ok && i < 36; i++) {
+		if (i == 0) {
+			gorbn_from_data(t, bench_k_data, sizeof(bench_k_data));
+			gorbn_mod(k, t, GORBN_SZARR, stb.q);
+		}
+		else if (i == 1 || i == 2) {
+			gorbn_from_int(k, i);
+		}
+		else if (i == 3) {
+			gorbn_from_int(t, 1);
+			gorbn_sub(k, stb.q, t);
+		}
+		else {
+			bench_random_bytes(k_data, sizeof(k_data));
+			gorbn_from_data(t, k_data, sizeof(k_data));
+			gorbn_mod(k, t, GORBN_SZARR, stb.q);
+		}
+		gorbn_to_data(k_data, sizeof(k_data), k);
+
+		wwFrom(d, k_data, no);
+		gorec_pt_mul_ct(&r_ct, &stb.g, k, &stb);
+
+		if (!ecMulA(res, ec->base, ec, d, m, stack) || r_ct.is_inf) {
+			ok = 0;
+		}
+		else {
+			qrTo(x_data, res, ec->f, stack);
+			qrTo(y_data, res + n, ec->f, stack);
+
+			gorbn_to_data(expected, sizeof(expected), r_ct.x);
+			ok = (memcmp(x_data, expected, no) == 0);
+			gorbn_to_data(expected, sizeof(expected), r_ct.y);
+			ok &= (memcmp(y_data, expected, no) == 0);
+		}
+
+		if (!ok) {
+			fprintf(stderr, "CHECK FAILED: ecMulA against gorec_pt_mul_ct, scalar %d\n", i);
+		}
+	}
+
+	free(stack);
+	free(res);
+	free(d);
+	free(state);
+
+	return(ok);
+}
+
+static void bench_gorbn() {
+	static gorec_curve crv;
+	gorec_load_stb128(&crv);
+
+	gorbn_t a[GORBN_SZARR];
+	gorbn_t b[GORBN_SZARR];
+	gorbn_t k[GORBN_SZARR];
+	gorbn_t k2[GORBN_SZARR];
+	gorbn_t r[GORBN_SZARR];
+	gorbn_t wide[GORBN_SZARR * 2];
+	gorbn_t q[GORBN_SZARR * 2];
+
+	gorbn_from_data(a, bench_a_data, sizeof(bench_a_data));
+	gorbn_from_data(b, bench_b_data, sizeof(bench_b_data));
+	gorbn_from_data(k, bench_k_data, sizeof(bench_k_data));
+	gorbn_copy(k2, a);
+	gorbn_mod(k2, k2, GORBN_SZARR, crv.q);
+
+	BENCH("gorbn", "add", gorbn_add(r, a, b); bench_sink += r[0]);
+	BENCH("gorbn", "sub", gorbn_sub(r, a, b); bench_sink += r[0]);
+	BENCH("gorbn", "mul", gorbn_mul(wide, a, b); bench_sink += wide[0]);
+	BENCH("gorbn", "sqr", gorbn_sqr(wide, a); bench_sink += wide[0]);
+	BENCH("gorbn", "mul_mod", gorbn_mul_mod(r, a, b, crv.p); bench_sink += r[0]);
+	BENCH("gorbn", "sqr_mod", gorbn_sqr_mod(r, a, crv.p); bench_sink += r[0]);
+	BENCH("gorbn", "mul_mod_pm", gorbn_mul_mod_pm(r, a, b, crv.p); bench_sink += r[0]);
+	BENCH("gorbn", "mont_mul", gorbn_mont_mul(r, a, b, &crv.mont); bench_sink += r[0]);
+	BENCH("gorbn", "field_mul", crv.mul_mod(r, a, b, &crv); bench_sink += r[0]);
+	BENCH("gorbn", "inv_mod", gorbn_inv_mod(r, a, crv.p); bench_sink += r[0]);
+	BENCH("gorbn", "field_inv", crv.inv_mod(r, a, &crv); bench_sink += r[0]);
+	BENCH("gorbn", "pow_mod", gorbn_pow_mod(r, a, k, crv.q); bench_sink += r[0]);
+
+	gorbn_mul(wide, a, b);
+	BENCH("gorbn", "div", gorbn_div(q, r, wide, GORBN_SZARR * 2, crv.q, GORBN_SZARR); bench_sink += r[0]);
+	BENCH("gorbn", "mul_mod_q", gorbn_mul_mod(r, a, k2, crv.q); bench_sink += r[0]);
+	BENCH("gorbn", "barrett_mul_q", gorbn_barrett_mul(r, a, k2, &crv.q_barrett); bench_sink += r[0]);
+
+	gorec_point res;
+	gorec_point p;
+	gorec_pt_mul_wnaf_jacobian(&p, &crv.g, k2, &crv);
+
+	BENCH("gorbn", "pt_mul", gorec_pt_mul(&res, &p, k, &crv); bench_sink += res.x[0]);
+	BENCH("gorbn", "pt_mul_jacobian", gorec_pt_mul_jacobian(&res, &p, k, &crv); bench_sink += res.x[0]);
+	BENCH("gorbn", "pt_mul_wnaf_jacobian", gorec_pt_mul_wnaf_jacobian(&res, &p, k, &crv); bench_sink += res.x[0]);
+	BENCH("gorbn", "pt_mul_ct", gorec_pt_mul_ct(&res, &p, k, &crv); bench_sink += res.x[0]);
+
+	static gorec_point batch_points[BENCH_BATCH_COUNT];
+	static gorec_point batch_results[BENCH_BATCH_COUNT];
+	static gorbn_t batch_scalars[BENCH_BATCH_COUNT * GORBN_SZARR];
+	for (int i = 0; i < BENCH_BATCH_COUNT; i++) {
+		gorec_pt_copy(&batch_points[i], &p);
+		gorbn_copy(batch_scalars + i * GORBN_SZARR, k);
+	}
+	BENCH_PER("gorbn", "pt_mul_batch", BENCH_BATCH_COUNT,
+		gorec_pt_mul_batch(batch_results, batch_points, batch_scalars, BENCH_BATCH_COUNT, &crv);
+		bench_sink += batch_results[0].x[0]);
+	BENCH("gorbn", "pt_mul_monty", gorec_pt_mul_monty(&res, &p, k, &crv); bench_sink += res.x[0]);
+	BENCH("gorbn", "pt_mul_base", gorec_pt_mul_base(&res, k, &crv); bench_sink += res.x[0]);
+	BENCH("gorbn", "pt_mul2", gorec_pt_mul2(&res, k, &p, k2, &crv); bench_sink += res.x[0]);
+
+	unsigned char compressed[1 + GORBN_SZARR * GORBN_SZWORD];
+	gorec_pt_compress(compressed, &p, &crv);
+	BENCH("gorbn", "sqrt_mod", gorec_sqrt_mod(r, crv.b, &crv); bench_sink += r[0]);
+	BENCH("gorbn", "pt_decompress", gorec_pt_decompress(&res, compressed, gorec_pt_compressed_size(&crv), &crv); bench_sink += res.y[0]);
+
+	//NOTE(dima): Startup of a worker: building base tables against taking them from a saved blob
+	alignas(GOREC_CURVE_BLOB_ALIGN) static unsigned char curve_blob[GOREC_CURVE_BLOB_SIZE];
+	static gorec_curve loaded_crv;
+	gorec_curve_save(curve_blob, sizeof(curve_blob), &crv);
+	BENCH("gorbn", "curve_precompute_base", gorec_curve_precompute_base(&crv); bench_sink += crv.base_table[1].x[0]);
+	BENCH("gorbn", "curve_load", gorec_curve_load(&loaded_crv, curve_blob, sizeof(curve_blob)); bench_sink += loaded_crv.n);
+}
+
+static void bench_bn() {
+	static EC_curve crv;
+	EC_load_stb128(&crv);
+
+	BN_t a[BN_arr_size];
+	BN_t b[BN_arr_size];
+	BN_t k[BN_arr_size];
+	BN_t r[BN_arr_size];
+	BN_t wide[BN_arr_size * 2];
+	BN_t q[BN_arr_size * 2];
+
+	BN_from_data(a, bench_a_data, sizeof(bench_a_data));
+	BN_from_data(b, bench_b_data, sizeof(bench_b_data));
+	BN_from_data(k, bench_k_data, sizeof(bench_k_data));
+
+	BENCH("BN", "add", BN_add(r, a, b); bench_sink += r[0]);
+	BENCH("BN", "sub", BN_sub(r, a, b); bench_sink += r[0]);
+	BENCH("BN", "mul", BN_mul(wide, a, b); bench_sink += wide[0]);
+	BENCH("BN", "sqr", BN_sqr(wide, a); bench_sink += wide[0]);
+	BENCH("BN", "mul_mod", BN_MulM(r, a, b, crv.p); bench_sink += r[0]);
+	BENCH("BN", "inv_mod", BN_InvM(r, a, crv.p); bench_sink += r[0]);
+
+	BN_mul(wide, a, b);
+	BENCH("BN", "div", BN_div(q, r, wide, BN_arr_size * 2, crv.q, BN_arr_size); bench_sink += r[0]);
+
+	EC_point res;
+	BENCH("BN", "pt_mul", EC_pt_mul(&res, &crv.g, k, &crv); bench_sink += res.x[0]);
+}
+
+static void bench_dbn() {
+	struct bn a;
+	struct bn b;
+	struct bn m;
+	struct bn r;
+	struct bn wide;
+	DBN_T scratch[DBN_KARATSUBA_SCRATCH_LEN];
+
+	gorec_curve crv;
+	unsigned char p_data[32];
+	gorec_load_stb128(&crv);
+	gorbn_to_data(p_data, sizeof(p_data), crv.p);
+
+	bignum_init(&a);
+	bignum_init(&b);
+	bignum_init(&m);
+	bignum_from_data(&a, bench_a_data, sizeof(bench_a_data));
+	bignum_from_data(&b, bench_b_data, sizeof(bench_b_data));
+	bignum_from_data(&m, p_data, sizeof(p_data));
+
+	BENCH("bignum", "add", bignum_add(&a, &b, &r); bench_sink += r.array[0]);
+	BENCH("bignum", "sub", bignum_sub(&a, &b, &r); bench_sink += r.array[0]);
+	BENCH("bignum", "mul", bignum_mul(&a, &b, &r); bench_sink += r.array[0]);
+	BENCH("bignum", "mul_karatsuba", bignum_mul_karatsuba(&a, &b, &r, scratch); bench_sink += r.array[0]);
+	BENCH("bignum", "sqr", bignum_mul(&a, &a, &r); bench_sink += r.array[0]);
+	BENCH("bignum", "sqr_karatsuba", bignum_sqr_karatsuba(&a, &r, scratch); bench_sink += r.array[0]);
+
+	/*NOTE(dima): dima_bignum has no modular multiplication, it is mul + mod*/
+	BENCH("bignum", "mul_mod", bignum_mul(&a, &b, &wide); bignum_mod(&wide, &m, &r); bench_sink += r.array[0]);
+	BENCH("bignum", "pow_mod", bignum_pow_mod(&a, &b, &m, &r); bench_sink += r.array[0]);
+
+	bignum_mul(&a, &b, &wide);
+	BENCH("bignum", "div", bignum_div(&wide, &m, &r); bench_sink += r.array[0]);
+
+	char hex[2 * sizeof(p_data) + 1];
+	unsigned char bytes[sizeof(p_data)];
+	int nhex = bignum_to_hex(&m, hex, sizeof(hex));
+	BENCH("bignum", "from_hex", bignum_from_hex(&r, hex, nhex); bench_sink += r.array[0]);
+	BENCH("bignum", "to_hex", bignum_to_hex(&m, hex, sizeof(hex)); bench_sink += hex[0]);
+	BENCH("bignum", "from_bytes_be", bignum_from_bytes_be(&r, p_data, sizeof(p_data)); bench_sink += r.array[0]);
+	BENCH("bignum", "to_bytes_be", bignum_to_bytes_be(&m, bytes, sizeof(bytes)); bench_sink += bytes[0]);
+}
+
+#if defined(__SIZEOF_INT128__)
+typedef uint64_t bench_fx_limb;
+#else
+typedef uint32_t bench_fx_limb;
+#endif
+
+/*
+	NOTE(dima): Inputs are bench_a_data and bench_b_data, below every modulus
+	as the top byte is zero. The calls are inlined, so every iteration takes
+	the previous result or the compiler would hoist them out of the loop.
+*/
+template<typename M>
+static void bench_gorfx_field(const char* mul_name, const char* sqr_name, const char* inv_name) {
+	typedef gor::PrimeField<M> F;
+
+	typename F::Uint x;
+	typename F::Uint y;
+	typename F::Element a;
+	typename F::Element b;
+	typename F::Element r;
+
+	gor::FromData(x, bench_a_data, sizeof(bench_a_data));
+	gor::FromData(y, bench_b_data, sizeof(bench_b_data));
+	F::FromUint(a, x);
+	F::FromUint(b, y);
+	r = a;
+
+	BENCH("gorfx", mul_name, F::Mul(r, r, b); bench_sink += r.w[0]);
+	BENCH("gorfx", sqr_name, F::Sqr(r, r); bench_sink += r.w[0]);
+	BENCH("gorfx", inv_name, F::Inv(r, r); bench_sink += r.w[0]);
+}
+
+static void bench_gorfx() {
+	bench_gorfx_field<gor::StbP128<bench_fx_limb> >("field_mul_256", "field_sqr_256", "field_inv_256");
+	bench_gorfx_field<gor::StbP192<bench_fx_limb> >("field_mul_384", "field_sqr_384", "field_inv_384");
+	bench_gorfx_field<gor::StbP256<bench_fx_limb> >("field_mul_512", "field_sqr_512", "field_inv_512");
+	bench_gorfx_field<gor::StbQ128<bench_fx_limb> >("mont_mul_q256", "mont_sqr_q256", "mont_inv_q256");
+
+	//NOTE(dima): The same kernels through gor_fixed_c.h, as C code gets them
+	static gorec_curve crv;
+	gorec_load_stb128(&crv);
+	gorfx_curve_use_stb128(&crv);
+
+	gorbn_t a[GORBN_SZARR];
+	gorbn_t b[GORBN_SZARR];
+	gorbn_t k[GORBN_SZARR];
+	gorbn_t r[GORBN_SZARR];
+	gorbn_from_data(a, bench_a_data, sizeof(bench_a_data));
+	gorbn_from_data(b, bench_b_data, sizeof(bench_b_data));
+	gorbn_from_data(k, bench_k_data, sizeof(bench_k_data));
+
+	gorec_point res;
+	BENCH("gorfx", "c_field_mul", crv.mul_mod(r, a, b, &crv); bench_sink += r[0]);
+	BENCH("gorfx", "c_field_inv", crv.inv_mod(r, a, &crv); bench_sink += r[0]);
+	BENCH("gorfx", "c_pt_mul_ct", gorec_pt_mul_ct(&res, &crv.g, k, &crv); bench_sink += res.x[0]);
+}
+
+/*
+	NOTE(dima): Self-check of gor_fixed.h against gorbn_mul_mod() and
+	gorbn_inv_mod(). Montgomery N0 of 16-bit limbs is the case that
+	overflowed: 2^64 - 59 has a large low limb, unlike q of STB.
+*/
+struct bench_p64 {
+	typedef gor::FixedUInt<64, uint16_t> Uint;
+	static constexpr uint32_t C = 0;
+	static constexpr Uint P() { return(gor::FromHex<Uint>("FFFFFFFFFFFFFFC5")); }
+};
+
+template<typename M>
+static int bench_check_gorfx_field(const char* name) {
+	typedef gor::PrimeField<M> F;
+
+	const int size = (int)sizeof(typename F::Uint);
+	unsigned char data[sizeof(typename F::Uint)];
+	unsigned char expected[sizeof(typename F::Uint)];
+
+	gorbn_t p[GORBN_SZARR];
+	gorbn_t a[GORBN_SZARR];
+	gorbn_t b[GORBN_SZARR];
+	gorbn_t r[GORBN_SZARR];
+
+	typename F::Uint x;
+	typename F::Uint y;
+	typename F::Uint z;
+	typename F::Element ea;
+	typename F::Element eb;
+	typename F::Element er;
+
+	//NOTE(dima): The top byte is cleared, so that inputs are below p
+	gor::ToData(data, size, F::P);
+	gorbn_from_data(p, data, size);
+	memcpy(data, bench_a_data, size);
+	data[size - 1] = 0;
+	gor::FromData(x, data, size);
+	gorbn_from_data(a, data, size);
+	memcpy(data, bench_b_data, size);
+	data[size - 1] = 0;
+	gor::FromData(y, data, size);
+	gorbn_from_data(b, data, size);
+
+	F::FromUint(ea, x);
+	F::FromUint(eb, y);
+	F::Mul(er, ea, eb);
+	F::ToUint(z, er);
+	gor::ToData(data, size, z);
+	gorbn_mul_mod(r, a, b, p);
+	gorbn_to_data(expected, size, r);
+	if (memcmp(data, expected, size) != 0) {
+		fprintf(stderr, "CHECK FAILED: gorfx mul, %s\n", name);
+		return(0);
+	}
+
+	F::Inv(er, ea);
+	F::ToUint(z, er);
+	gor::ToData(data, size, z);
+	gorbn_inv_mod(r, a, p);
+	gorbn_to_data(expected, size, r);
+	if (memcmp(data, expected, size) != 0) {
+		fprintf(stderr, "CHECK FAILED: gorfx inv, %s\n", name);
+		return(0);
+	}
+
+	return(1);
+}
+
+/* G = (0, yG), so yG^2 = b, and a = -3 */
+template<typename Curve>
+static int bench_check_gorfx_curve(const char* name) {
+	typedef gor::PrimeField<typename Curve::FieldModulus> F;
+
+	typename F::Element y, b, a, r;
+	F::FromUint(y, Curve::Gy());
+	F::FromUint(b, Curve::B());
+	F::FromUint(a, Curve::A());
+	F::Sqr(r, y);
+
+	typename F::Element three, s;
+	F::Add(three, F::One(), F::One());
+	F::Add(three, three, F::One());
+	F::Add(s, a, three);
+
+	if (!F::Eq(r, b) || !F::IsZero(s) || !gor::IsZero(Curve::Gx())) {
+		fprintf(stderr, "CHECK FAILED: gorfx curve, %s\n", name);
+		return(0);
+	}
+
+	return(1);
+}
+
+/*
+	NOTE(dima): gorec_pt_mul_ct() on the STB curve with field routines of
+	gor_fixed_c.h has to give the same point as with those of gorbn.
+*/
+static int bench_check_gorfx_c() {
+	static gorec_curve stb;
+	static gorec_curve stb_fx;
+	gorec_load_stb128(&stb);
+	gorec_load_stb128(&stb_fx);
+
+	if (!gorfx_curve_use_stb128(&stb_fx)) {
+		fprintf(stderr, "CHECK FAILED: gorfx_curve_use_stb128\n");
+		return(0);
+	}
+
+	gorbn_t k[GORBN_SZARR];
+	gorbn_t t[GORBN_SZARR];
+	gorec_point r;
+	gorec_point r_fx;
+
+	gorbn_from_data(t, bench_k_data, sizeof(bench_k_data));
+	gorbn_mod(k, t, GORBN_SZARR, stb.q);
+	gorec_pt_mul_ct(&r, &stb.g, k, &stb);
+	gorec_pt_mul_ct(&r_fx, &stb_fx.g, k, &stb_fx);
+
+	if (r.is_inf != r_fx.is_inf ||
+		gorbn_cmp(r.x, r_fx.x) != 0 ||
+		gorbn_cmp(r.y, r_fx.y) != 0)
+	{
+		fprintf(stderr, "CHECK FAILED: gorec_pt_mul_ct with gor_fixed_c.h fields\n");
+		return(0);
+	}
+
+	return(1);
+}
+
+static int bench_check_gorfx() {
+	int ok = 1;
+	ok &= bench_check_gorfx_curve<gor::Stb128Curve<bench_fx_limb> >("bign-curve256v1");
+	ok &= bench_check_gorfx_curve<gor::Stb192Curve<bench_fx_limb> >("bign-curve384v1");
+	ok &= bench_check_gorfx_curve<gor::Stb256Curve<bench_fx_limb> >("bign-curve512v1");
+	ok &= bench_check_gorfx_c();
+	ok &= bench_check_gorfx_field<gor::StbP128<bench_fx_limb> >("STB p");
+	ok &= bench_check_gorfx_field<gor::StbQ128<bench_fx_limb> >("STB q");
+	ok &= bench_check_gorfx_field<gor::StbQ128<uint16_t> >("STB q, 16-bit limbs");
+	ok &= bench_check_gorfx_field<bench_p64>("2^64 - 59, 16-bit limbs");
+	return(ok);
+}
+
+static void bench_bee2() {
+	bign_params params;
+	bignStdParams(&params, "1.2.112.0.2.0.34.101.45.3.1");
+
+	void* state = malloc(bignStart_keep(params.l, 0));
+	bignStart(state, &params);
+
+	ec_o* ec = (ec_o*)state;
+	size_t n = ec->f->n;
+	size_t m = ec->f->n;
+
+	word* d = (word*)malloc(O_OF_W(m));
+	word* res = (word*)malloc(O_OF_W(2 * n));
+	void* stack = malloc(ecMulA_deep(n, ec->d, ec->deep, m));
+	wwFrom(d, bench_k_data, sizeof(bench_k_data));
+
+	BENCH(BENCH_BEE2_ENGINE, "pt_mul", ecMulA(res, ec->base, ec, d, m, stack); bench_sink += res[0]);
+
+	free(stack);
+	free(res);
+	free(d);
+	free(state);
+}
+
+int main(int argc, char** argv) {
+	if (argc > 1) {
+		bench_min_ns = (uint64_t)atoi(argv[1]) * 1000000ull;
+	}
+
+	bench_random_bytes(bench_a_data, sizeof(bench_a_data));
+	bench_random_bytes(bench_b_data, sizeof(bench_b_data));
+	bench_random_bytes(bench_k_data, sizeof(bench_k_data));
+	bench_a_data[31] = 0;
+	bench_b_data[31] = 0;
+	bench_k_data[31] = 0;
+
+	if (!bench_check_gorbn() || !bench_check_bee2() || !bench_check_gorfx()) {
+		return(1);
+	}
+
+	JSONInitFILE(&bench_writer, JSONWriterFlag_Pretty, stdout);
+	JSONBegin(&bench_writer);
+
+	JSONBeginName(&bench_writer, (char*)"config");
+	JSONAddS32(&bench_writer, (char*)"gorbn_szword", GORBN_SZWORD);
+	JSONAddS32(&bench_writer, (char*)"bn_szword", BN_SZWORD);
+	JSONAddS32(&bench_writer, (char*)"dbn_szword", DBN_SZWORD);
+	JSONAddS32(&bench_writer, (char*)"gorfx_limb_bits", (int32_t)(sizeof(bench_fx_limb) * 8));
+	JSONAddS32(&bench_writer, (char*)"gorec_lanes", GOREC_LANES);
+	JSONAddSTR(&bench_writer, (char*)"gorec_lanes_simd", (char*)BENCH_LANES_SIMD);
+	JSONAddS32(&bench_writer, (char*)"has_cycles", BENCH_HAS_RDTSC);
+	JSONAddU64(&bench_writer, (char*)"min_ns", bench_min_ns);
+	JSONEnd(&bench_writer);
+
+	JSONBeginArr(&bench_writer, (char*)"results");
+	bench_gorbn();
+	bench_bn();
+	bench_dbn();
+	bench_gorfx();
+	bench_bee2();
+	JSONEndArr(&bench_writer);
+
+	JSONEnd(&bench_writer);
+
+	JSONFlush(&bench_writer);
+	JSONFree(&bench_writer);
+
+	return(0);
+}
@@ -0,0 +1,679 @@
+#ifndef GOR_FIXED_H
+#define GOR_FIXED_H
+
+/*
+	ABOUT:
+		Fixed-size unsigned integers and prime fields as C++ templates:
+		FixedUInt<Bits, Limb> and PrimeField<Modulus>.
+
+		gor_bignum.h, bignum_roma.h and dima_bignum.h pick one word size and
+		one maximal size per translation unit (GORBN_SZWORD, BN_SZWORD,
+		DBN_SZWORD). Here both are template parameters, so one binary can
+		carry 256, 384 and 512-bit fields with any limb type at once. Limb
+		loops are expanded at compile time (Unroll below), so every kernel
+		is straight-line code for its size.
+
+		This is an engine of field arithmetic only, there are no point
+		routines here. gor_fixed_c.h gives its STB fields to C code as
+		field routines of gorec_curve, so gorec_pt_mul*() of gor_bignum.h
+		run on these kernels while C includers stay C: the templates are
+		compiled in gor_fixed_c.cpp only. Elsewhere numbers move between
+		the engines as bytes (see USAGE).
+
+		Reduction is chosen by the modulus type:
+			C != 0  p = 2^Bits - C (STB 34.101.45 primes), folding by C
+			C == 0  any odd modulus, Montgomery (CIOS)
+
+		Header-only, C++14, no allocation. Field operations run in time that
+		depends only on the sizes, Pow also on its exponent. Inv is Fermat
+		exponentiation: it does not branch on the input, but is several
+		times slower than the binary GCD of gorbn_inv_mod(). Limb may be
+		uint8_t, uint16_t, uint32_t, or uint64_t where the compiler has
+		unsigned __int128. C has to fit into one limb, so uint8_t limbs
+		cover StbP128 only.
+
+	USAGE:
+		typedef gor::PrimeField<gor::StbP128<uint64_t> > F;
+
+		F::Uint x = gor::FromHex<F::Uint>("1234");
+		F::Uint y = gor::FromHex<F::Uint>("5678");
+		F::Uint z;
+		F::Element a, b, r;
+		F::FromUint(a, x);
+		F::FromUint(b, y);
+		F::Mul(r, a, b);
+		F::ToUint(z, r);
+
+		Limbs are stored least significant first, and FromData() / ToData()
+		use little-endian octets like gorbn_from_data() and
+		bignum_from_data(), so numbers move between the engines as bytes.
+*/
+
+#include <stdint.h>
+#include <stddef.h>
+
+#if !defined(__cplusplus) || ((__cplusplus < 201402L) && (!defined(_MSVC_LANG) || (_MSVC_LANG < 201402L)))
+#error "gor_fixed.h needs C++14"
+#endif
+
+#if defined(_MSC_VER)
+#define GORFX_INLINE __forceinline
+#else
+#define GORFX_INLINE inline __attribute__((always_inline))
+#endif
+
+namespace gor {
+
+/* Double-width type of a limb, for products and carries */
+template<typename Limb> struct LimbTraits;
+template<> struct LimbTraits<uint8_t> { typedef uint16_t Double; };
+template<> struct LimbTraits<uint16_t> { typedef uint32_t Double; };
+template<> struct LimbTraits<uint32_t> { typedef uint64_t Double; };
+#if defined(__SIZEOF_INT128__)
+template<> struct LimbTraits<uint64_t> { typedef unsigned __int128 Double; };
+#endif
+
+/*
+	Unroll<Begin, End>::Run(f) calls f(Index<I>()) for I = Begin .. End - 1.
+	The calls are expanded by the compiler, and Index converts to a constant
+	int, so w[i] inside f is a fixed offset.
+*/
+template<int I> struct Index {
+	constexpr operator int() const { return(I); }
+};
+
+template<int Begin, int End> struct Unroll {
+	template<typename F> static GORFX_INLINE void Run(F&& f) {
+		f(Index<Begin>());
+		Unroll<Begin + 1, End>::Run(f);
+	}
+};
+
+template<int End> struct Unroll<End, End> {
+	template<typename F> static GORFX_INLINE void Run(F&&) {}
+};
+
+template<int Bits, typename Limb = uint32_t>
+struct FixedUInt {
+	typedef Limb LimbType;
+	typedef typename LimbTraits<Limb>::Double Double;
+
+	enum {
+		BitCount = Bits,
+		LimbBits = (int)sizeof(Limb) * 8,
+		Count = (Bits + LimbBits - 1) / LimbBits,
+	};
+
+	Limb w[Count]; /*least significant limb first*/
+};
+
+/* Number of twice the limbs of U, for full products */
+template<typename U> struct Wide {
+	typedef FixedUInt<2 * U::Count * U::LimbBits, typename U::LimbType> Type;
+};
+
+/*
+*******************************************************************************
+Compile-time helpers: plain loops, they are only used to build constants
+*******************************************************************************
+*/
+
+/* Most significant digit first, no prefix. Characters that are not hex digits count as 0 */
+template<typename U>
+constexpr U FromHex(const char* hex) {
+	U r = {};
+
+	int len = 0;
+	while (hex[len]) {
+		len++;
+	}
+
+	for (int i = 0; i < len; i++) {
+		char c = hex[len - 1 - i];
+		unsigned v = 0;
+		if (c >= '0' && c <= '9') v = (unsigned)(c - '0');
+		else if (c >= 'a' && c <= 'f') v = (unsigned)(c - 'a' + 10);
+		else if (c >= 'A' && c <= 'F') v = (unsigned)(c - 'A' + 10);
+
+		int bit = 4 * i;
+		if (bit < U::Count * U::LimbBits) {
+			r.w[bit / U::LimbBits] |= (typename U::LimbType)((typename U::LimbType)v << (bit % U::LimbBits));
+		}
+	}
+
+	return(r);
+}
+
+template<typename U>
+constexpr U FromLimb(typename U::LimbType v) {
+	U r = {};
+	r.w[0] = v;
+	return(r);
+}
+
+/* Returns 1, -1 or 0 like gorbn_cmp(). Not constant-time */
+template<typename U>
+constexpr int Cmp(const U& a, const U& b) {
+	for (int i = U::Count - 1; i >= 0; i--) {
+		if (a.w[i] > b.w[i]) return(1);
+		if (a.w[i] < b.w[i]) return(-1);
+	}
+	return(0);
+}
+
+/* (2 * x) mod p for x < p */
+template<typename U>
+constexpr U ConstDoubleMod(const U& x, const U& p) {
+	typedef typename U::LimbType Limb;
+
+	U r = {};
+	Limb carry = 0;
+	for (int i = 0; i < U::Count; i++) {
+		r.w[i] = (Limb)((x.w[i] << 1) | carry);
+		carry = (Limb)(x.w[i] >> (U::LimbBits - 1));
+	}
+
+	if (carry || Cmp(r, p) >= 0) {
+		Limb borrow = 0;
+		for (int i = 0; i < U::Count; i++) {
+			Limb d = (Limb)(r.w[i] - p.w[i] - borrow);
+			borrow = (Limb)((r.w[i] < p.w[i]) || (r.w[i] == p.w[i] && borrow));
+			r.w[i] = d;
+		}
+	}
+
+	return(r);
+}
+
+/* 2^e mod p */
+template<typename U>
+constexpr U ConstPow2Mod(int e, const U& p) {
+	U r = FromLimb<U>(1);
+	for (int i = 0; i < e; i++) {
+		r = ConstDoubleMod(r, p);
+	}
+	return(r);
+}
+
+/* 2^Bits - c, that is ~(c - 1) over the whole number */
+template<typename U>
+constexpr U ConstPseudoMersenne(uint32_t c) {
+	typedef typename U::LimbType Limb;
+
+	U r = {};
+	for (int i = 0; i < U::Count; i++) {
+		int shift = i * U::LimbBits;
+		r.w[i] = (Limb)~(Limb)((shift < 32) ? ((c - 1) >> shift) : 0);
+	}
+	return(r);
+}
+
+/* -p^(-1) mod 2^LimbBits for odd p. Newton steps double the count of correct low bits, p * p = 1 mod 8 gives the first 3 */
+template<typename U>
+constexpr typename U::LimbType ConstMontN0(const U& p) {
+	typedef typename U::LimbType Limb;
+	typedef typename U::Double Double;
+
+	/*products are taken in Double: uint16_t limbs would be multiplied as signed int and overflow*/
+	Limb inv = p.w[0];
+	for (int i = 0; i < 5; i++) {
+		inv = (Limb)((Double)inv * (Limb)(2 - (Limb)((Double)p.w[0] * inv)));
+	}
+	return((Limb)(0 - inv));
+}
+
+template<typename U>
+constexpr U ConstSubLimb(const U& a, typename U::LimbType v) {
+	typedef typename U::LimbType Limb;
+
+	U r = a;
+	Limb borrow = v;
+	for (int i = 0; i < U::Count; i++) {
+		Limb d = (Limb)(r.w[i] - borrow);
+		borrow = (Limb)(r.w[i] < borrow);
+		r.w[i] = d;
+	}
+	return(r);
+}
+
+/*
+*******************************************************************************
+Run-time kernels, constant-time and unrolled
+*******************************************************************************
+*/
+
+template<typename U>
+GORFX_INLINE typename U::LimbType Add(U& r, const U& a, const U& b) {
+	typedef typename U::LimbType Limb;
+	typedef typename U::Double Double;
+
+	Limb carry = 0;
+	Unroll<0, U::Count>::Run([&](int i) {
+		Double s = (Double)a.w[i] + b.w[i] + carry;
+		r.w[i] = (Limb)s;
+		carry = (Limb)(s >> U::LimbBits);
+	});
+	return(carry);
+}
+
+template<typename U>
+GORFX_INLINE typename U::LimbType Sub(U& r, const U& a, const U& b) {
+	typedef typename U::LimbType Limb;
+	typedef typename U::Double Double;
+
+	Limb borrow = 0;
+	Unroll<0, U::Count>::Run([&](int i) {
+		Double d = (Double)a.w[i] - b.w[i] - borrow;
+		r.w[i] = (Limb)d;
+		borrow = (Limb)((d >> U::LimbBits) & 1);
+	});
+	return(borrow);
+}
+
+/* r = flag ? a : b, flag is 0 or 1 */
+template<typename U>
+GORFX_INLINE void Select(U& r, typename U::LimbType flag, const U& a, const U& b) {
+	typedef typename U::LimbType Limb;
+
+	Limb mask = (Limb)(0 - flag);
+	Unroll<0, U::Count>::Run([&](int i) {
+		r.w[i] = (Limb)((a.w[i] & mask) | (b.w[i] & ~mask));
+	});
+}
+
+template<typename U>
+GORFX_INLINE bool IsZero(const U& a) {
+	typename U::LimbType diff = 0;
+	Unroll<0, U::Count>::Run([&](int i) {
+		diff |= a.w[i];
+	});
+	return(diff == 0);
+}
+
+template<typename U>
+GORFX_INLINE bool Eq(const U& a, const U& b) {
+	typename U::LimbType diff = 0;
+	Unroll<0, U::Count>::Run([&](int i) {
+		diff |= a.w[i] ^ b.w[i];
+	});
+	return(diff == 0);
+}
+
+template<typename U>
+GORFX_INLINE int Bit(const U& a, int n) {
+	return((int)((a.w[n / U::LimbBits] >> (n % U::LimbBits)) & 1));
+}
+
+/* Full product, schoolbook */
+template<typename U>
+GORFX_INLINE void MulWide(typename Wide<U>::Type& r, const U& a, const U& b) {
+	typedef typename U::LimbType Limb;
+	typedef typename U::Double Double;
+
+	Unroll<0, U::Count>::Run([&](int i) {
+		r.w[i] = 0;
+	});
+
+	Unroll<0, U::Count>::Run([&](auto i) {
+		Limb carry = 0;
+		Unroll<0, U::Count>::Run([&](auto j) {
+			Double t = (Double)a.w[i] * b.w[j] + r.w[i + j] + carry;
+			r.w[i + j] = (Limb)t;
+			carry = (Limb)(t >> U::LimbBits);
+		});
+		r.w[i + U::Count] = carry;
+	});
+}
+
+/* Little-endian octets, like gorbn_from_data(). Extra input octets must be zero */
+template<typename U>
+inline void FromData(U& r, const void* data, size_t size) {
+	const uint8_t* at = (const uint8_t*)data;
+
+	for (int i = 0; i < U::Count; i++) {
+		r.w[i] = 0;
+	}
+	for (size_t i = 0; (i < size) && (i < sizeof(r.w)); i++) {
+		r.w[i / sizeof(typename U::LimbType)] |= (typename U::LimbType)((typename U::LimbType)at[i] << (8 * (i % sizeof(typename U::LimbType))));
+	}
+}
+
+template<typename U>
+inline void ToData(void* data, size_t size, const U& a) {
+	uint8_t* to = (uint8_t*)data;
+
+	for (size_t i = 0; i < size; i++) {
+		to[i] = (i < sizeof(a.w)) ? (uint8_t)(a.w[i / sizeof(typename U::LimbType)] >> (8 * (i % sizeof(typename U::LimbType)))) : 0;
+	}
+}
+
+/*
+*******************************************************************************
+Reduction, picked by the modulus type
+*******************************************************************************
+*/
+
+template<typename M, bool PseudoMersenne = (M::C != 0)>
+struct FieldReducer;
+
+/*
+	NOTE(dima): p = 2^Bits - C, so 2^Bits = C (mod p) and the high half of a
+	product folds onto the low half with one multiply by C per limb. The
+	second fold takes the carry of the first one, after that the sum exceeds
+	2^Bits at most once more and one conditional subtraction of p is left.
+*/
+template<typename M>
+struct FieldReducer<M, true> {
+	typedef typename M::Uint Uint;
+	typedef typename Uint::LimbType Limb;
+	typedef typename Uint::Double Double;
+
+	static_assert((int)Uint::BitCount == Uint::Count * Uint::LimbBits, "pseudo-Mersenne modulus must fill whole limbs");
+	static_assert((Double)M::C <= (Double)(Limb)~(Limb)0, "C of the modulus must fit into one limb");
+
+	static constexpr Uint P = M::P();
+
+	static GORFX_INLINE void Reduce(Uint& r, const typename Wide<Uint>::Type& t) {
+		const int N = Uint::Count;
+
+		Limb carry = 0;
+		Unroll<0, N>::Run([&](auto i) {
+			Double s = (Double)t.w[i + N] * M::C + t.w[i] + carry;
+			r.w[i] = (Limb)s;
+			carry = (Limb)(s >> Uint::LimbBits);
+		});
+
+		Double s = (Double)carry * M::C;
+		Unroll<0, N>::Run([&](int i) {
+			s += r.w[i];
+			r.w[i] = (Limb)s;
+			s >>= Uint::LimbBits;
+		});
+
+		/*r is now below C * C if it wrapped, so adding C again can not carry*/
+		s = (Double)((Limb)s) * M::C;
+		Unroll<0, N>::Run([&](int i) {
+			s += r.w[i];
+			r.w[i] = (Limb)s;
+			s >>= Uint::LimbBits;
+		});
+
+		Uint d;
+		Limb borrow = Sub(d, r, P);
+		Select(r, borrow, r, d);
+	}
+
+	static GORFX_INLINE void Mul(Uint& r, const Uint& a, const Uint& b) {
+		typename Wide<Uint>::Type t;
+		MulWide(t, a, b);
+		Reduce(r, t);
+	}
+
+	static GORFX_INLINE void ToField(Uint& r, const Uint& a) { r = a; }
+	static GORFX_INLINE void FromField(Uint& r, const Uint& a) { r = a; }
+	static constexpr Uint One() { return(FromLimb<Uint>(1)); }
+};
+
+template<typename M>
+constexpr typename M::Uint FieldReducer<M, true>::P;
+
+/*
+	NOTE(dima): Montgomery multiplication, coarsely integrated operand
+	scanning: a * b * 2^(-Bits) mod p for odd p. N0 = -p^(-1) mod 2^LimbBits
+	and R^2 mod p are computed by the compiler.
+*/
+template<typename M>
+struct FieldReducer<M, false> {
+	typedef typename M::Uint Uint;
+	typedef typename Uint::LimbType Limb;
+	typedef typename Uint::Double Double;
+
+	static constexpr Uint P = M::P();
+
+	static constexpr Limb N0 = ConstMontN0(M::P());
+	static constexpr Uint R2 = ConstPow2Mod(2 * Uint::Count * Uint::LimbBits, M::P());
+	static constexpr Uint R = ConstPow2Mod(Uint::Count * Uint::LimbBits, M::P());
+
+	static GORFX_INLINE void Mul(Uint& r, const Uint& a, const Uint& b) {
+		const int N = Uint::Count;
+
+		Limb t[N + 2] = {};
+		Unroll<0, N>::Run([&](auto i) {
+			Limb c = 0;
+			Unroll<0, N>::Run([&](auto j) {
+				Double s = (Double)a.w[j] * b.w[i] + t[j] + c;
+				t[j] = (Limb)s;
+				c = (Limb)(s >> Uint::LimbBits);
+			});
+			Double s = (Double)t[N] + c;
+			t[N] = (Limb)s;
+			t[N + 1] = (Limb)(s >> Uint::LimbBits);
+
+			Limb m = (Limb)((Double)t[0] * N0);
+			s = (Double)m * P.w[0] + t[0];
+			c = (Limb)(s >> Uint::LimbBits);
+			Unroll<1, N>::Run([&](auto j) {
+				Double u = (Double)m * P.w[j] + t[j] + c;
+				t[j - 1] = (Limb)u;
+				c = (Limb)(u >> Uint::LimbBits);
+			});
+			s = (Double)t[N] + c;
+			t[N - 1] = (Limb)s;
+			t[N] = (Limb)(t[N + 1] + (Limb)(s >> Uint::LimbBits));
+		});
+
+		Uint v, d;
+		Unroll<0, N>::Run([&](int i) {
+			v.w[i] = t[i];
+		});
+		Limb borrow = Sub(d, v, P);
+		/*the result is v - p unless v < p without the top limb*/
+		Select(r, (Limb)(borrow & (Limb)(t[N] ^ 1)), v, d);
+	}
+
+	static GORFX_INLINE void ToField(Uint& r, const Uint& a) { Mul(r, a, R2); }
+	static GORFX_INLINE void FromField(Uint& r, const Uint& a) { Mul(r, a, FromLimb<Uint>(1)); }
+	static constexpr Uint One() { return(R); }
+};
+
+template<typename M>
+constexpr typename M::Uint FieldReducer<M, false>::P;
+template<typename M>
+constexpr typename M::Uint::LimbType FieldReducer<M, false>::N0;
+template<typename M>
+constexpr typename M::Uint FieldReducer<M, false>::R2;
+template<typename M>
+constexpr typename M::Uint FieldReducer<M, false>::R;
+
+/*
+*******************************************************************************
+Prime field
+	Elements are Uint below p, in the representation of the reducer
+	(Montgomery form or as is). FromUint / ToUint convert, inputs of
+	FromUint are below p.
+*******************************************************************************
+*/
+
+template<typename M>
+struct PrimeField {
+	typedef typename M::Uint Uint;
+	typedef Uint Element;
+	typedef typename Uint::LimbType Limb;
+	typedef FieldReducer<M> Reducer;
+
+	static constexpr Uint P = M::P();
+	static constexpr Uint PMinus2 = ConstSubLimb(M::P(), 2);
+
+	static GORFX_INLINE void FromUint(Element& r, const Uint& a) { Reducer::ToField(r, a); }
+	static GORFX_INLINE void ToUint(Uint& r, const Element& a) { Reducer::FromField(r, a); }
+
+	static constexpr Element Zero() { return(Uint()); }
+	static constexpr Element One() { return(Reducer::One()); }
+
+	static GORFX_INLINE void Add(Element& r, const Element& a, const Element& b) {
+		Uint s, d;
+		Limb carry = gor::Add(s, a, b);
+		Limb borrow = gor::Sub(d, s, P);
+		/*keep s only if it did not wrap and is below p*/
+		Select(r, (Limb)(borrow & (Limb)(carry ^ 1)), s, d);
+	}
+
+	static GORFX_INLINE void Sub(Element& r, const Element& a, const Element& b) {
+		Uint d, s;
+		Limb borrow = gor::Sub(d, a, b);
+		gor::Add(s, d, P);
+		Select(r, borrow, s, d);
+	}
+
+	static GORFX_INLINE void Neg(Element& r, const Element& a) {
+		Sub(r, Zero(), a);
+	}
+
+	static GORFX_INLINE void Mul(Element& r, const Element& a, const Element& b) {
+		Reducer::Mul(r, a, b);
+	}
+
+	static GORFX_INLINE void Sqr(Element& r, const Element& a) {
+		Reducer::Mul(r, a, a);
+	}
+
+	/*
+		r = a ^ e, fixed 4-bit window: 15 multiplications for the table, then
+		4 squarings and one multiplication per window. The time depends on
+		e, which is public for Inv
+	*/
+	static inline void Pow(Element& r, const Element& a, const Uint& e) {
+		Element table[16];
+		table[0] = One();
+		table[1] = a;
+		for (int i = 2; i < 16; i++) {
+			Mul(table[i], table[i - 1], a);
+		}
+
+		const int nbits = Uint::Count * Uint::LimbBits;
+		Element acc = One();
+		for (int i = ((nbits + 3) / 4) * 4 - 4; i >= 0; i -= 4) {
+			Sqr(acc, acc);
+			Sqr(acc, acc);
+			Sqr(acc, acc);
+			Sqr(acc, acc);
+
+			int window = 0;
+			for (int j = 3; j >= 0; j--) {
+				window = (window << 1) | ((i + j < nbits) ? Bit(e, i + j) : 0);
+			}
+			if (window) {
+				Mul(acc, acc, table[window]);
+			}
+		}
+		r = acc;
+	}
+
+	/* Fermat: a ^ (p - 2), 0 for a = 0 */
+	static inline void Inv(Element& r, const Element& a) {
+		Pow(r, a, PMinus2);
+	}
+
+	static GORFX_INLINE bool IsZero(const Element& a) { return(gor::IsZero(a)); }
+	static GORFX_INLINE bool Eq(const Element& a, const Element& b) { return(gor::Eq(a, b)); }
+};
+
+template<typename M>
+constexpr typename M::Uint PrimeField<M>::P;
+template<typename M>
+constexpr typename M::Uint PrimeField<M>::PMinus2;
+
+/*
+*******************************************************************************
+STB 34.101.45 constants
+	Field primes of the three security levels are p = 2^(2l) - C, the
+	largest primes below 2^(2l) with p = 3 mod 4. Curves are the standard
+	ones, bign-curve256v1 is the curve of gorec_load_stb128() and
+	bignStdParams(). All of them have a = p - 3 and G = (0, yG).
+*******************************************************************************
+*/
+
+template<typename Limb = uint32_t>
+struct StbP128 {
+	typedef FixedUInt<256, Limb> Uint;
+	static constexpr uint32_t C = 189;
+	static constexpr Uint P() { return(ConstPseudoMersenne<Uint>(C)); }
+};
+
+template<typename Limb = uint32_t>
+struct StbP192 {
+	typedef FixedUInt<384, Limb> Uint;
+	static constexpr uint32_t C = 317;
+	static constexpr Uint P() { return(ConstPseudoMersenne<Uint>(C)); }
+};
+
+template<typename Limb = uint32_t>
+struct StbP256 {
+	typedef FixedUInt<512, Limb> Uint;
+	static constexpr uint32_t C = 569;
+	static constexpr Uint P() { return(ConstPseudoMersenne<Uint>(C)); }
+};
+
+/* Order of the base point of the level 128 curve, a generic prime: Montgomery */
+template<typename Limb = uint32_t>
+struct StbQ128 {
+	typedef FixedUInt<256, Limb> Uint;
+	static constexpr uint32_t C = 0;
+	static constexpr Uint P() { return(FromHex<Uint>("FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFD95C8ED60DFB4DFC7E5ABF99263D6607")); }
+};
+
+/* bign-curve256v1: y^2 = x^3 + a x + b over StbP128, base point G = (0, yG) of order q */
+template<typename Limb = uint32_t>
+struct Stb128Curve {
+	typedef FixedUInt<256, Limb> Uint;
+	typedef StbP128<Limb> FieldModulus;
+	typedef StbQ128<Limb> OrderModulus;
+
+	static constexpr Uint A() { return(FromHex<Uint>("FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF40")); }
+	static constexpr Uint B() { return(FromHex<Uint>("77CE6C1515F3A8EDD2C13AABE4D8FBBE4CF55069978B9253B22E7D6BD69C03F1")); }
+	static constexpr Uint Q() { return(OrderModulus::P()); }
+	static constexpr Uint Gx() { return(Uint()); }
+	static constexpr Uint Gy() { return(FromHex<Uint>("6BF7FC3CFB16D69F5CE4C9A351D6835D78913966C408F6521E29CF1804516A93")); }
+};
+
+/*
+	bign-curve384v1 over StbP192. The order of G is not here: it could not
+	be checked against the standard, and an unchecked q is worse than none.
+	Use Q() of the standard parameters when it is needed.
+*/
+template<typename Limb = uint32_t>
+struct Stb192Curve {
+	typedef FixedUInt<384, Limb> Uint;
+	typedef StbP192<Limb> FieldModulus;
+
+	static constexpr Uint A() { return(FromHex<Uint>("FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFEC0")); }
+	static constexpr Uint B() { return(FromHex<Uint>("3C75DFE1959CEF2033075AAB655D34D2712748BB0FFBB196A6216AF9E9712E3A14BDE2F0F3CEBD7CBCA7FC236873BF64")); }
+	static constexpr Uint Gx() { return(Uint()); }
+	static constexpr Uint Gy() { return(FromHex<Uint>("5D438224A82E9E9E6330117E432DBF893A729A11DC86FFA00549E79E66B1D35584403E276B2A42F9EA5ECB31F733C451")); }
+};
+
+/* Order of the base point of the level 256 curve */
+template<typename Limb = uint32_t>
+struct StbQ256 {
+	typedef FixedUInt<512, Limb> Uint;
+	static constexpr uint32_t C = 0;
+	static constexpr Uint P() { return(FromHex<Uint>("FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFB2C0092C0198004EF26BEBB02E2113F4361BCAE59556DF32DCFFAD490D068EF1")); }
+};
+
+/* bign-curve512v1 over StbP256 */
+template<typename Limb = uint32_t>
+struct Stb256Curve {
+	typedef FixedUInt<512, Limb> Uint;
+	typedef StbP256<Limb> FieldModulus;
+	typedef StbQ256<Limb> OrderModulus;
+
+	static constexpr Uint A() { return(FromHex<Uint>("FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFDC4")); }
+	static constexpr Uint B() { return(FromHex<Uint>("6CB45944933B8C43D88C5D6A60FD58895BC6A9EEDD5D255117CE13E3DAADB0882711DCB5C4245E952933008C87ACA243EA8622273A49A27A09346998D6139C90")); }
+	static constexpr Uint Q() { return(OrderModulus::P()); }
+	static constexpr Uint Gx() { return(Uint()); }
+	static constexpr Uint Gy() { return(FromHex<Uint>("A826FF7AE4037681B182E6F7A0D18FABB0AB41B3B361BCE2D2EDF81B00CCCADA6973DDE20EFA6FD2FF777395EEE8226167AA83B9C94C0D04B792AE6FCEEFEDBD")); }
+};
+
+} /*namespace gor*/
+
+#endif /*GOR_FIXED_H*/
@@ -0,0 +1,176 @@
+/*
+	NOTE(dima): Field routines of gor_fixed_c.h. This is the only place
+	where the C interface meets the templates: gorbn_t words are converted
+	to limbs of FixedUInt, PrimeField does the work, and the result is
+	converted back. gor_bignum.h is included for its declarations only.
+*/
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "gor_bignum.h"
+#include "gor_fixed.h"
+#include "gor_fixed_c.h"
+
+#if defined(__SIZEOF_INT128__)
+typedef uint64_t gorfx_limb;
+#else
+typedef uint32_t gorfx_limb;
+#endif
+
+/*
+	NOTE(dima): Words and limbs are both least significant first, so one of
+	them is a whole number of the other: a limb takes Ratio words, or a
+	word takes Ratio limbs.
+*/
+template<typename U>
+static inline void _gorfx_from_words(U& r, const gorbn_t* a) {
+	typedef typename U::LimbType Limb;
+
+	if (sizeof(Limb) >= GORBN_SZWORD) {
+		const int Ratio = (int)(sizeof(Limb) / GORBN_SZWORD);
+		for (int i = 0; i < U::Count; i++) {
+			Limb limb = 0;
+			for (int j = 0; j < Ratio; j++) {
+				limb |= (Limb)((Limb)a[i * Ratio + j] << ((j * GORBN_SZWORD_BITS) % U::LimbBits));
+			}
+			r.w[i] = limb;
+		}
+	}
+	else {
+		const int Ratio = (int)(GORBN_SZWORD / sizeof(Limb));
+		for (int i = 0; i < U::Count; i++) {
+			r.w[i] = (Limb)(a[i / Ratio] >> ((i % Ratio) * U::LimbBits));
+		}
+	}
+}
+
+/* Limbs to all GORBN_SZARR words, zero above the size of U */
+template<typename U>
+static inline void _gorfx_to_words(gorbn_t* r, const U& a) {
+	typedef typename U::LimbType Limb;
+
+	for (int i = 0; i < GORBN_SZARR; i++) {
+		r[i] = 0;
+	}
+
+	if (sizeof(Limb) >= GORBN_SZWORD) {
+		const int Ratio = (int)(sizeof(Limb) / GORBN_SZWORD);
+		for (int i = 0; i < U::Count; i++) {
+			for (int j = 0; j < Ratio; j++) {
+				r[i * Ratio + j] = (gorbn_t)(a.w[i] >> ((j * GORBN_SZWORD_BITS) % U::LimbBits));
+			}
+		}
+	}
+	else {
+		const int Ratio = (int)(GORBN_SZWORD / sizeof(Limb));
+		for (int i = 0; i < U::Count; i++) {
+			r[i / Ratio] |= (gorbn_t)((gorbn_t)a.w[i] << ((i % Ratio) * U::LimbBits));
+		}
+	}
+}
+
+template<typename M>
+static void _gorfx_mul(gorbn_t* r, gorbn_t* a, gorbn_t* b) {
+	typedef gor::PrimeField<M> F;
+	static_assert((int)F::Uint::BitCount <= GORBN_SZARR_BITS_TOTAL, "field does not fit into gorbn_t arrays");
+
+	typename F::Element x, y;
+	_gorfx_from_words(x, a);
+	_gorfx_from_words(y, b);
+	F::Mul(x, x, y);
+	_gorfx_to_words(r, x);
+}
+
+template<typename M>
+static void _gorfx_sqr(gorbn_t* r, gorbn_t* a) {
+	typedef gor::PrimeField<M> F;
+
+	typename F::Element x;
+	_gorfx_from_words(x, a);
+	F::Sqr(x, x);
+	_gorfx_to_words(r, x);
+}
+
+template<typename M>
+static void _gorfx_inv(gorbn_t* r, gorbn_t* a) {
+	typedef gor::PrimeField<M> F;
+
+	typename F::Element x;
+	_gorfx_from_words(x, a);
+	F::Inv(x, x);
+	_gorfx_to_words(r, x);
+}
+
+/*
+	NOTE(dima): STB primes are pseudo-Mersenne, elements of PrimeField are
+	plain numbers below p like those of gorec_curve, so no conversion of
+	the representation is needed.
+*/
+typedef gor::StbP128<gorfx_limb> gorfx_stb128_p;
+
+extern "C" GOREC_FIELD_MUL(gorfx_stb128_mul_mod) {
+	(void)crv;
+	_gorfx_mul<gorfx_stb128_p>(r, a, b);
+}
+
+extern "C" GOREC_FIELD_UNARY(gorfx_stb128_sqr_mod) {
+	(void)crv;
+	_gorfx_sqr<gorfx_stb128_p>(r, a);
+}
+
+extern "C" GOREC_FIELD_UNARY(gorfx_stb128_inv_mod) {
+	(void)crv;
+	_gorfx_inv<gorfx_stb128_p>(r, a);
+}
+
+extern "C" int gorfx_curve_use_stb128(gorec_curve* crv) {
+	gorbn_t p[GORBN_SZARR];
+	_gorfx_to_words(p, gor::PrimeField<gorfx_stb128_p>::P);
+
+	for (int i = 0; i < GORBN_SZARR; i++) {
+		if (p[i] != crv->p[i]) {
+			return(0);
+		}
+	}
+
+	crv->mul_mod = gorfx_stb128_mul_mod;
+	crv->sqr_mod = gorfx_stb128_sqr_mod;
+	crv->inv_mod = gorfx_stb128_inv_mod;
+
+	return(1);
+}
+
+#if (GORBN_SZARR_BITS_TOTAL >= 384)
+extern "C" GOREC_FIELD_MUL(gorfx_stb192_mul_mod) {
+	(void)crv;
+	_gorfx_mul<gor::StbP192<gorfx_limb> >(r, a, b);
+}
+
+extern "C" GOREC_FIELD_UNARY(gorfx_stb192_sqr_mod) {
+	(void)crv;
+	_gorfx_sqr<gor::StbP192<gorfx_limb> >(r, a);
+}
+
+extern "C" GOREC_FIELD_UNARY(gorfx_stb192_inv_mod) {
+	(void)crv;
+	_gorfx_inv<gor::StbP192<gorfx_limb> >(r, a);
+}
+#endif
+
+#if (GORBN_SZARR_BITS_TOTAL >= 512)
+extern "C" GOREC_FIELD_MUL(gorfx_stb256_mul_mod) {
+	(void)crv;
+	_gorfx_mul<gor::StbP256<gorfx_limb> >(r, a, b);
+}
+
+extern "C" GOREC_FIELD_UNARY(gorfx_stb256_sqr_mod) {
+	(void)crv;
+	_gorfx_sqr<gor::StbP256<gorfx_limb> >(r, a);
+}
+
+extern "C" GOREC_FIELD_UNARY(gorfx_stb256_inv_mod) {
+	(void)crv;
+	_gorfx_inv<gor::StbP256<gorfx_limb> >(r, a);
+}
+#endif
@@ -0,0 +1,75 @@
+#ifndef GOR_FIXED_C_H
+#define GOR_FIXED_C_H
+
+/*
+	ABOUT:
+		C interface to the fields of gor_fixed.h. The functions are field
+		routines of gorec_curve (GOREC_FIELD_MUL / GOREC_FIELD_UNARY of
+		gor_bignum.h) that run PrimeField kernels, so C code uses the
+		template engine without being compiled as C++. They are built in
+		gor_fixed_c.cpp, the only C++ translation unit.
+
+		Numbers are gorbn_t words as everywhere in gorec_: elements below p,
+		as is (STB primes are pseudo-Mersenne, so there is no Montgomery
+		form), words above the size of p are zero on output.
+
+	BUILD:
+		gor_fixed_c.cpp includes gor_bignum.h, and must be compiled with the
+		same GORBN_SZWORD and GORBN_MAX_BITS as the C code, since gorbn_t
+		and gorec_curve depend on them:
+			g++ -O2 -c -DGORBN_SZWORD=4 gor_fixed_c.cpp
+			cc -O2 -DGORBN_SZWORD=4 main.c gor_fixed_c.o -lstdc++
+
+		Level 192 and 256 routines exist only when GORBN_MAX_BITS covers
+		their 384 and 512-bit p.
+
+	USAGE:
+		#include <stdint.h>
+		#include <stddef.h>
+		#include "gor_bignum.h"
+		#include "gor_fixed_c.h"
+
+		gorec_curve crv;
+		gorec_load_stb128(&crv);
+		gorfx_curve_use_stb128(&crv);
+		gorec_pt_mul_ct(&r, &crv.g, k, &crv);
+
+		gorfx_curve_use_stb128() replaces mul_mod, sqr_mod and inv_mod of
+		a curve whose p is the level 128 prime, and returns 0 leaving the
+		curve as it is otherwise. Inversion is Fermat exponentiation of
+		PrimeField::Inv(), so it does not branch on the input but is slower
+		than gorbn_inv_mod().
+
+	gor_bignum.h has to be included before this file.
+*/
+
+#ifndef GORBN_SZWORD
+#error "gor_bignum.h has to be included before gor_fixed_c.h"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+	GOREC_FIELD_MUL(gorfx_stb128_mul_mod);
+	GOREC_FIELD_UNARY(gorfx_stb128_sqr_mod);
+	GOREC_FIELD_UNARY(gorfx_stb128_inv_mod);
+	int gorfx_curve_use_stb128(gorec_curve* crv);
+
+#if (GORBN_SZARR_BITS_TOTAL >= 384)
+	GOREC_FIELD_MUL(gorfx_stb192_mul_mod);
+	GOREC_FIELD_UNARY(gorfx_stb192_sqr_mod);
+	GOREC_FIELD_UNARY(gorfx_stb192_inv_mod);
+#endif
+
+#if (GORBN_SZARR_BITS_TOTAL >= 512)
+	GOREC_FIELD_MUL(gorfx_stb256_mul_mod);
+	GOREC_FIELD_UNARY(gorfx_stb256_sqr_mod);
+	GOREC_FIELD_UNARY(gorfx_stb256_inv_mod);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /*GOR_FIXED_C_H*/